@@ -21,9 +21,11 @@ struct AffineAlignmentParams
     float GapOpen;
     float GapExtend;
     float PartialMatchScore;
+    // restrict the alignment to a band, as AlignConfig::BandWidth
+    int BandWidth;
 
     AffineAlignmentParams(float matchScore, float mismatchScore, float gapOpen, float gapExtend,
-                          float partialMatchScore = 0);
+                          float partialMatchScore = 0, int bandWidth = 0);
 };
 
 AffineAlignmentParams DefaultAffineAlignmentParams();
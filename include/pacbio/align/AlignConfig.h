@@ -34,8 +34,13 @@ struct AlignConfig
 {
     AlignParams Params;
     AlignMode Mode;
+    // GLOBAL pairwise alignments may be restricted to a band of BandWidth
+    // diagonals on either side of the ones between the corners of the
+    // matrix; the band is doubled until the alignment no longer runs along
+    // its edge.  0 aligns the whole matrix.
+    int BandWidth;
 
-    AlignConfig(AlignParams params, AlignMode mode);
+    AlignConfig(AlignParams params, AlignMode mode, int bandWidth = 0);
 
     // Default corresponds to global alignment mode, edit distance params
     static AlignConfig Default();
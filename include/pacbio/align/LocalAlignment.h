@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -83,5 +85,60 @@ std::vector<LocalAlignment> LocalAlign(
     const std::string& target, const std::vector<std::string>& queries,
     const LocalAlignConfig& config = LocalAlignConfig::Default());
 
+///
+/// \brief Local aligner of one query against many targets
+///
+/// LocalAlign builds the scoring matrix and the striped profile of the query
+/// for every alignment. A LocalAligner builds them once and keeps them for all
+/// the targets it aligns the query to. Its alignments are identical to those
+/// of LocalAlign(target, query, config).
+///
+/// A LocalAligner reuses buffers between calls, so use one per thread.
+///
+class LocalAligner
+{
+public:
+    explicit LocalAligner(const std::string& query,
+                          const LocalAlignConfig& config = LocalAlignConfig::Default());
+
+    LocalAligner(const LocalAligner&) = delete;
+    LocalAligner(LocalAligner&&);
+    LocalAligner& operator=(const LocalAligner&) = delete;
+    LocalAligner& operator=(LocalAligner&&);
+    ~LocalAligner(void);
+
+public:
+    ///
+    /// \brief Align the query to a target
+    ///
+    /// \return the best local alignment, with score 0 and no CIGAR if the
+    ///         target is empty
+    ///
+    LocalAlignment Align(const std::string& target);
+
+    ///
+    /// \brief Align the query to each of targets
+    ///
+    std::vector<LocalAlignment> Align(const std::vector<std::string>& targets);
+
+    ///
+    /// \brief Score of the best local alignment of the query to a target
+    ///
+    /// Equal to Align(target).Score(), but skips the traceback for the
+    /// alignment begin positions and the CIGAR.
+    ///
+    uint16_t Score(const std::string& target);
+
+    ///
+    /// \brief Scores of the best local alignments of the query to each of
+    ///        targets
+    ///
+    std::vector<uint16_t> Score(const std::vector<std::string>& targets);
+
+private:
+    struct Profile;
+    std::unique_ptr<Profile> profile_;
+};
+
 }  // namespace Align
 }  // namespace PacBio
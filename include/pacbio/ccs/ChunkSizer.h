@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+namespace PacBio {
+namespace CCS {
+
+/// Decides when a ccs work chunk is full.
+///
+/// Chunks are filled with whole ZMWs until their estimated work reaches a
+/// target. The work of a ZMW is estimated by its number of subread bases, as
+/// the POA and every banded alpha/beta fill scale with the read length, summed
+/// over all passes. Libraries of short inserts thus get many ZMWs per task and
+/// do not drown in scheduling overhead, while long inserts still get a task of
+/// their own and load-balance across threads.
+class ChunkSizer
+{
+public:
+    ChunkSizer(const size_t targetBases, const size_t maxZmws)
+        : targetBases_{targetBases}, maxZmws_{maxZmws}, bases_{0}, zmws_{0}
+    {
+    }
+
+    /// Account for a new ZMW in the current chunk.
+    void AddZmw() { ++zmws_; }
+    /// Account for the subread bases of the current ZMW.
+    void AddBases(const size_t bases) { bases_ += bases; }
+
+    /// Returns if the current chunk has reached its target amount of work.
+    bool IsFull() const { return zmws_ > 0 && (bases_ >= targetBases_ || zmws_ >= maxZmws_); }
+
+    /// Start a new chunk.
+    void Reset()
+    {
+        bases_ = 0;
+        zmws_ = 0;
+    }
+
+private:
+    const size_t targetBases_;
+    const size_t maxZmws_;
+    size_t bases_;
+    size_t zmws_;
+};
+
+}  // namespace CCS
+}  // namespace PacBio
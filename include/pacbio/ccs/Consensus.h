@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <stdexcept>
@@ -15,6 +16,8 @@
 #include <boost/optional.hpp>
 
 #include <pacbio/ccs/ConsensusSettings.h>
+#include <pacbio/ccs/StageTimings.h>
+#include <pacbio/consensus/AbstractMatrix.h>
 #include <pacbio/consensus/Integrator.h>
 #include <pacbio/consensus/Polish.h>
 #include <pacbio/data/State.h>
@@ -46,6 +49,7 @@ using StrandType = PacBio::Data::StrandType;
 using SubreadResultCounter = PacBio::Data::SubreadResultCounter;
 using Timer = PacBio::Util::Timer;
 using PoaAlignmentSummary = PacBio::Poa::PoaAlignmentSummary;
+using PoaOrientationCounts = PacBio::Poa::PoaOrientationCounts;
 using SparsePoa = PacBio::Poa::SparsePoa;
 using AlignConfig = PacBio::Align::AlignConfig;
 using AlignMode = PacBio::Align::AlignMode;
@@ -103,6 +107,7 @@ public:
     size_t PoorQuality;
     size_t ExceptionThrown;
     SubreadResultCounter SubreadCounter;
+    ThreadTimings Timings;
 
     ResultType()
         : Success{0}
@@ -116,6 +121,7 @@ public:
         , PoorQuality{0}
         , ExceptionThrown{0}
         , SubreadCounter{}
+        , Timings{}
     {
     }
 
@@ -132,6 +138,7 @@ public:
         PoorQuality += other.PoorQuality;
         ExceptionThrown += other.ExceptionThrown;
         SubreadCounter += other.SubreadCounter;
+        Timings += other.Timings;
         return *this;
     }
 
@@ -297,6 +304,7 @@ template <typename TRead>
 std::pair<std::string, size_t> PoaConsensus(const std::vector<const TRead*>& reads,
                                             std::vector<SparsePoa::ReadKey>* readKeys,
                                             std::vector<PoaAlignmentSummary>* summaries,
+                                            PoaOrientationCounts* orientationCounts,
                                             const size_t maxPoaCov)
 {
     SparsePoa poa;
@@ -332,29 +340,22 @@ std::pair<std::string, size_t> PoaConsensus(const std::vector<const TRead*>& rea
     // at least 50% of the reads should cover
     // TODO(lhepler) revisit this minimum coverage equation
     const size_t minCov = (cov < 5) ? 1 : (cov + 1) / 2 - 1;
+    *orientationCounts = poa.OrientationCounts();
     return std::make_pair(poa.FindConsensus(minCov, &(*summaries))->Sequence, nPasses);
 }
 
-// pass unique_ptr by reference to satisfy finickyness wrt move semantics in <future>
-//   but then take ownership here with a local unique_ptr
+// Generate the consensus of a single ZMW
 template <typename TChunk>
-ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunksRef,
-                                    const ConsensusSettings& settings)
+ResultType<ConsensusType> ZmwConsensus(const TChunk& chunk, const ConsensusSettings& settings)
 {
     using namespace PacBio::Consensus;
 
-    auto chunks(std::move(chunksRef));
     ResultType<ConsensusType> result;
-
-    if (!chunks) return result;
-    // We should only be dealing with chunks of size 1
-    if (chunks->size() != 1) {
-        throw std::runtime_error("CCS chunk was of size != 1");
-    }
-    const auto& chunk = chunks->at(0);
+    StageTimings& timings = result.Timings[ThreadIndex()];
 
     try {
         Timer timer;
+        auto filterTimer = std::make_unique<ScopedStageTimer>(Stage::FILTER, &timings);
 
         // Do read level SNR filtering first
         size_t readsBelowMinSNR = 0;
@@ -369,6 +370,7 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
         }
 
         auto reads = FilterReads(chunk.Reads, settings, &result.SubreadCounter);
+        filterTimer.reset();
 
         if (reads.empty() ||  // Check if subread are present
             std::accumulate(reads.begin(), reads.end(), 0, std::plus<bool>()) == 0) {
@@ -400,10 +402,15 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
 
         std::vector<SparsePoa::ReadKey> readKeys;
         std::vector<PoaAlignmentSummary> summaries;
+        PoaOrientationCounts orientationCounts;
         std::string poaConsensus;
         size_t nPasses = 0;
-        std::tie(poaConsensus, nPasses) =
-            PoaConsensus(reads, &readKeys, &summaries, settings.MaxPoaCoverage);
+        std::tie(poaConsensus, nPasses) = Timed(Stage::POA, &timings, [&]() {
+            return PoaConsensus(reads, &readKeys, &summaries, &orientationCounts,
+                                settings.MaxPoaCoverage);
+        });
+        timings.PoaOrientedBySeeds += orientationCounts.BySeeds;
+        timings.PoaOrientedByAlignment += orientationCounts.ByAlignment;
 
         if (poaConsensus.length() < settings.MinLength) {
             result.TooShort += 1;
@@ -440,6 +447,13 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
                         // setup the arrow integrator
                         IntegratorConfig cfg(settings.MinZScore);
                         Integrator ai(poaConsensus, cfg);
+                        // count the cells filled however this attempt ends
+                        struct CellCounter
+                        {
+                            const Integrator& Ai;
+                            StageTimings& Timings;
+                            ~CellCounter() { Timings.MatrixCells += Ai.FilledEntries(); }
+                        } cellCounter{ai, timings};
                         const size_t nReads = readKeys.size();
                         size_t nPasses = 0, nDropped = 0;
 
@@ -455,12 +469,16 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
                                 continue;
                             }
 
-                            if (auto mr = ExtractMappedRead(*reads[i], summaries[readKeys[i]],
-                                                            poaConsensus.length(), settings,
-                                                            &result.SubreadCounter)) {
+                            auto mr = Timed(Stage::MAP_READS, &timings, [&]() {
+                                return ExtractMappedRead(*reads[i], summaries[readKeys[i]],
+                                                         poaConsensus.length(), settings,
+                                                         &result.SubreadCounter);
+                            });
+                            if (mr) {
                                 // skip reads not belonging to this strand, if we're --byStrand
                                 if (strand && mr->Strand != *strand) continue;
-                                auto status = ai.AddRead(*mr);
+                                auto status = Timed(Stage::ADD_READS, &timings,
+                                                    [&]() { return ai.AddRead(*mr); });
                                 // increment the status count
                                 result.SubreadCounter.AddResult(status);
                                 if (status == State::VALID &&
@@ -474,6 +492,11 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
                             }
                         }
 
+                        for (size_t i = 0; i < ai.NumEvaluators(); ++i) {
+                            const Evaluator& eval = ai.GetEvaluator(i);
+                            if (eval.IsValid()) timings.FlipFlops += eval.NumFlipFlops();
+                        }
+
                         if (nPasses < settings.MinPasses) {
                             // Reassign all the successful reads to the other category
                             result.SubreadCounter.AssignSuccessToOther();
@@ -517,7 +540,10 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
                         const auto zScores = ai.ZScores();
 
                         // find consensus!!
-                        const PolishResult polishResult = Polish(&ai, PolishConfig());
+                        PolishConfig polishCfg;
+                        polishCfg.NumThreads = settings.PolishThreads;
+                        const PolishResult polishResult = Timed(
+                            Stage::POLISH, &timings, [&]() { return Polish(&ai, polishCfg); });
 
                         if (!polishResult.hasConverged) {
                             result.NonConvergent += 1;
@@ -528,7 +554,9 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
 
                         // compute predicted accuracy
                         double predAcc = 0.0;
-                        QualityValues qvs = ConsensusQVs(ai);
+                        QualityValues qvs = Timed(Stage::QVS, &timings, [&]() {
+                            return ConsensusQVs(ai, settings.PolishThreads);
+                        });
                         for (const int qv : qvs.Qualities) {
                             predAcc += pow(10.0, static_cast<double>(qv) / -10.0);
                         }
@@ -580,5 +608,32 @@ ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunks
     return result;
 }
 
+// pass unique_ptr by reference to satisfy finickyness wrt move semantics in <future>
+//   but then take ownership here with a local unique_ptr
+template <typename TChunk>
+ResultType<ConsensusType> Consensus(std::unique_ptr<std::vector<TChunk>>& chunksRef,
+                                    const ConsensusSettings& settings)
+{
+    auto chunks(std::move(chunksRef));
+    ResultType<ConsensusType> result;
+
+    if (!chunks) return result;
+
+    const int64_t allocations = ThreadBufferAllocations();
+
+    // each ZMW keeps its own subread counts, as they are reported per consensus
+    for (const auto& chunk : *chunks) {
+        auto zmwResult = ZmwConsensus(chunk, settings);
+        result += zmwResult;
+        std::move(zmwResult.begin(), zmwResult.end(), std::back_inserter(result));
+    }
+
+    StageTimings& timings = result.Timings[ThreadIndex()];
+    timings.Zmws += chunks->size();
+    timings.BufferAllocations += ThreadBufferAllocations() - allocations;
+
+    return result;
+}
+
 }  // namespace CCS
 }  // namespace PacBio
@@ -20,7 +20,10 @@ namespace CCS {
 struct ConsensusSettings
 {
     bool ByStrand;
-    const size_t ChunkSize = 1;
+    // ZMWs are batched into chunks of about ChunkBases subread bases,
+    // but no more than MaxChunkSize ZMWs, see ChunkSizer
+    const size_t ChunkBases = 50000;
+    const size_t MaxChunkSize = 256;
     bool ForceOutput;
     std::string LogFile;
     Logging::LogLevel LogLevel;
@@ -34,14 +37,20 @@ struct ConsensusSettings
     double MinSNR;
     double MinIdentity;
     double MinZScore;
+    // models shared between subreads of similar SNR, see ConfigureModelCache
+    const size_t ModelCacheSize = 256;
     std::string ModelPath;
     std::string ModelSpec;
     bool NoPolish;
     size_t PolishRepeats;
+    size_t PolishThreads;
     size_t NThreads;
     bool PbIndex;
     std::string ReportFile;
     bool RichQVs;
+    bool SinglePrecision;
+    double SnrResolution;
+    bool TimeStages;
     std::string WlSpec;
     bool ZmwTimings;
 
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+
+#include <pacbio/util/Timer.h>
+
+namespace PacBio {
+namespace CCS {
+
+/// The stages of generating and writing the consensus of a ZMW.
+enum class Stage : uint8_t
+{
+    FILTER,     // SNR and length filtering of the subreads
+    POA,        // the draft consensus
+    MAP_READS,  // ExtractMappedRead
+    ADD_READS,  // Integrator::AddRead, i.e. the initial alpha/beta fills
+    POLISH,     // Polish
+    QVS,        // ConsensusQVs
+    WRITE,      // writing the records to the output file
+    NUM_STAGES
+};
+
+/// The name of stage in the JSON output.
+const char* StageName(Stage stage);
+
+/// The time spent in a stage, and how often it was entered.
+struct StageTime
+{
+    int64_t Calls = 0;
+    double WallMilliseconds = 0.0;
+    double CpuMilliseconds = 0.0;
+};
+
+/// Timings and counters of the ZMWs processed by one thread. The CPU times
+/// and buffer allocations include those of the thread's ForkJoinPool
+/// helpers, which work on the same ZMWs.
+struct StageTimings
+{
+    std::array<StageTime, static_cast<size_t>(Stage::NUM_STAGES)> Stages;
+    int64_t Zmws = 0;
+    // DP matrix cells filled, from adding the reads through the QVs
+    int64_t MatrixCells = 0;
+    // alpha/beta flip flops of all added reads
+    int64_t FlipFlops = 0;
+    // POA reads whose strand was clear from their k-mer seeds, and those
+    // for which both strands had to be aligned, see SparsePoa
+    int64_t PoaOrientedBySeeds = 0;
+    int64_t PoaOrientedByAlignment = 0;
+    // matrix buffers allocated on the heap instead of taken from the
+    // thread's pool, or from those of its helpers
+    int64_t BufferAllocations = 0;
+
+    StageTime& operator[](Stage stage) { return Stages[static_cast<size_t>(stage)]; }
+    const StageTime& operator[](Stage stage) const { return Stages[static_cast<size_t>(stage)]; }
+
+    StageTimings& operator+=(const StageTimings& other);
+};
+
+/// StageTimings by ThreadIndex().
+using ThreadTimings = std::map<size_t, StageTimings>;
+
+/// Adds the timings of other to those of the same thread in timings.
+ThreadTimings& operator+=(ThreadTimings& timings, const ThreadTimings& other);
+
+/// A small index of the calling thread, counting threads in the order they
+/// first ask for it.
+size_t ThreadIndex();
+
+/// The number of matrix buffers the calling thread and the helpers of its
+/// ForkJoinPool allocated so far, see StageTimings::BufferAllocations.
+/// Reading the counts of the helpers wakes them, so this is meant to be
+/// called once per ZMW rather than per stage.
+int64_t ThreadBufferAllocations();
+
+/// Writes the timings of each thread and their total as a JSON object.
+void WriteStageTimings(std::ostream& os, const ThreadTimings& timings);
+
+///
+/// Adds the wall and CPU time of the calling thread, and the CPU time of
+/// the helpers of its ForkJoinPool, from its construction to its
+/// destruction to a stage. Timing a stage costs two reads of each
+/// clock, which is negligible even for the per-read stages.
+///
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer(Stage stage, StageTimings* timings);
+    ~ScopedStageTimer();
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    StageTime* time_;
+    Util::Timer wall_;
+    int64_t cpuStart_;
+};
+
+/// Returns f(), adding the time it took to stage.
+template <typename F>
+auto Timed(const Stage stage, StageTimings* const timings, F&& f) -> decltype(f())
+{
+    ScopedStageTimer timer(stage, timings);
+    return f();
+}
+
+}  // namespace CCS
+}  // namespace PacBio
@@ -5,12 +5,16 @@
 #include <cassert>
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <pbcopper/utility/StringUtils.h>
@@ -19,8 +23,10 @@
 
 #include <pacbio/align/LocalAlignment.h>
 #include <pacbio/data/Sequence.h>
+#include <pacbio/parallel/ForkJoinPool.h>
 
 #include "ChimeraLabel.h"
+#include "KmerIndex.h"
 
 namespace PacBio {
 namespace Chimera {
@@ -37,19 +43,27 @@ namespace Chimera {
 /// This is probably not as scalable as doing chunkwise alignments and only
 /// considering the best alignment to each chunk, but it's presumably more
 /// sensitive...
-/// May need to speed this up (and lot's of other things) if the number of
-/// haplotypes gets very large.
+/// To scale to large numbers of haplotypes, each chunk can be aligned to only
+/// the maxCandidates possible parents sharing the most k-mers with it, and the
+/// alignments of all chunks are spread over numThreads threads. The shortlist
+/// is off by default, as a parent it misses can change the labels.
 ///
 class ChimeraLabeler
 {
 public:  // structors
     // Default constructor
+    //   maxCandidatesArg: possible parents aligned per chunk, each in both
+    //                     orientations, 0 to align to all
+    //   numThreadsArg: threads aligning chunks to their candidate parents
     explicit ChimeraLabeler(double minChimeraScoreArg = 1.0, size_t maxChimeraSupportArg = 100,
-                            bool verboseArg = false)
+                            bool verboseArg = false, size_t maxCandidatesArg = 0,
+                            size_t numThreadsArg = 1)
         : minChimeraScore(minChimeraScoreArg)
         , maxChimeraSupport(maxChimeraSupportArg)
         , chunks(4)
-        , verbose(verboseArg){};
+        , verbose(verboseArg)
+        , maxCandidates(maxCandidatesArg)
+        , numThreads(std::max<size_t>(1, numThreadsArg)){};
     // Move constructor
     ChimeraLabeler(ChimeraLabeler&& src) = delete;
     // Copy constructor
@@ -74,10 +88,13 @@ private:  // Instance variables
     const size_t maxChimeraSupport;
     const size_t chunks;
     const bool verbose;
+    const size_t maxCandidates;
+    const size_t numThreads;
 
 private:  // State variables
     std::vector<std::string> ids_;
     std::vector<std::string> nonChimeras_;
+    KmerIndex nonChimeraKmers_;
     size_t minSize_ = std::numeric_limits<size_t>::max();
     size_t numAnalyzed_ = 0;
 
@@ -88,6 +105,7 @@ public:  // Modifying methods
     {
         ids_.clear();
         nonChimeras_.clear();
+        nonChimeraKmers_.Clear();
         minSize_ = std::numeric_limits<size_t>::max();
         numAnalyzed_ = 0;
     }
@@ -236,6 +254,8 @@ private:
         ids_.push_back(id);
         nonChimeras_.push_back(sequence);
         nonChimeras_.push_back(PacBio::Data::ReverseComplement(sequence));
+        // one entry per parent, covering both orientations
+        nonChimeraKmers_.Add({nonChimeras_[nonChimeras_.size() - 2], nonChimeras_.back()});
         minSize_ = std::min(size, minSize_);
     }
 
@@ -261,41 +281,61 @@ private:
         const PacBio::Align::LocalAlignConfig alignConfig =
             PacBio::Align::LocalAlignConfig::Default();
 
-        // Iterate over each chunk, aligning it to all possible parents
+        // Shortlist the possible parents of each chunk, unless there are
+        //    few enough to align to all of them. A chunk sharing no k-mer
+        //    with any parent is aligned to all of them, so it still votes.
+        const bool shortlist = maxCandidates > 0 && ids_.size() > maxCandidates;
+        std::vector<std::string> targets;
+        std::vector<std::vector<size_t>> candidates;   // both orientations
+        std::vector<std::pair<size_t, size_t>> pairs;  // (chunk, parent)
         for (size_t i = 0; i < chunks; ++i) {
-            // Initialize the alignment with the current sequence chunk
-            const size_t chunkStart = i * chunkSize;
-            const auto target = sequence.substr(chunkStart, chunkSize);
-
-            // Initialize loop variables;
-            size_t score = 0;
-            size_t maxScore = 0;
-            size_t maxParent = 0;
-
-            // iterate over each non-Chimeric sequence
-            for (size_t j = 0; j < nonChimeras_.size(); ++j) {
-                // Fill out the alignment with the current parents
-                const auto& query = nonChimeras_[j];
-
-                // The underlying SSW impl finds a region in Seq2 to which to align Seq1.
-                // This leads to banding problems and can crash if Seq2 is large or
-                // repetitve, so we need to use the smaller sequence as Seq2 to avoid this.
-                if (target.size() > query.size()) {
-                    const auto al = PacBio::Align::LocalAlign(target, query, alignConfig);
-                    score = al.Score();
-                } else {
-                    const auto al = PacBio::Align::LocalAlign(query, target, alignConfig);
-                    score = al.Score();
+            targets.push_back(sequence.substr(i * chunkSize, chunkSize));
+            std::vector<size_t> parents;
+            if (shortlist) parents = nonChimeraKmers_.Candidates(targets[i], maxCandidates);
+            if (parents.empty()) {
+                candidates.emplace_back(nonChimeras_.size());
+                std::iota(candidates[i].begin(), candidates[i].end(), 0);
+            } else {
+                candidates.emplace_back();
+                for (const size_t parent : parents) {
+                    candidates[i].push_back(2 * parent);
+                    candidates[i].push_back(2 * parent + 1);
                 }
+            }
+            for (const size_t j : candidates[i])
+                pairs.emplace_back(i, j);
+        }
+
+        // Align each chunk to its candidate parents, handing out the
+        //    alignments dynamically to balance load over this thread and
+        //    the helpers it keeps between queries
+        std::vector<size_t> scores(pairs.size());
+        std::atomic_size_t nextPair{0};
+        const auto worker = [&]() {
+            // The profiles of the chunks this thread aligned, built on first
+            //    use; pairs are ordered by chunk, so few are built per thread
+            std::vector<std::unique_ptr<PacBio::Align::LocalAligner>> aligners(chunks);
+            for (size_t p; (p = nextPair++) < pairs.size();) {
+                const size_t i = pairs[p].first;
+                scores[p] = AlignmentScore(targets[i], nonChimeras_[pairs[p].second], alignConfig,
+                                           &aligners[i]);
+            }
+        };
+        PacBio::Parallel::ForkJoinPool::ThreadLocal().Run(std::min(numThreads, pairs.size()),
+                                                          worker);
 
+        // Add the best parent for each chunk to the set, the first one on ties
+        for (size_t i = 0, p = 0; i < chunks; ++i) {
+            size_t maxScore = 0;
+            size_t maxParent = candidates[i].front();
+            for (const size_t j : candidates[i]) {
                 // If the current parent is better than the best, keep it
-                if (score > maxScore) {
-                    maxScore = score;
+                if (scores[p] > maxScore) {
+                    maxScore = scores[p];
                     maxParent = j;
                 }
+                ++p;
             }
-
-            // Add the best parent for this chunk to the set
             parentIds.insert(maxParent);
         }
 
@@ -304,6 +344,32 @@ private:
         return output;
     }
 
+    /// \brief Score the local alignment of a chunk to a possible parent
+    ///
+    /// \param The chunk of the query sequence
+    /// \param The possible parent sequence
+    /// \param The alignment scoring scheme
+    /// \param The aligner profiling the chunk, created on first use and
+    ///        reused for the other parents of the chunk
+    ///
+    /// \return The score of the best local alignment
+    ///
+    static size_t AlignmentScore(const std::string& target, const std::string& query,
+                                 const PacBio::Align::LocalAlignConfig& alignConfig,
+                                 std::unique_ptr<PacBio::Align::LocalAligner>* targetAligner)
+    {
+        // The underlying SSW impl finds a region in Seq2 to which to align Seq1.
+        // This leads to banding problems and can crash if Seq2 is large or
+        // repetitve, so we need to use the smaller sequence as Seq2 to avoid this.
+        if (target.size() > query.size())
+            return PacBio::Align::LocalAlign(target, query, alignConfig).Score();
+        if (target.empty()) return 0;
+
+        if (!*targetAligner)
+            targetAligner->reset(new PacBio::Align::LocalAligner(target, alignConfig));
+        return (*targetAligner)->Score(query);
+    }
+
     /// \brief Identify the highest-scoring chimeric explaination for a query
     ///        from a list of possible parents
     ///
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PacBio {
+namespace Chimera {
+
+///
+/// Index of the k-mers of a growing set of sequences, used to shortlist the
+/// sequences sharing the most k-mers with a query before aligning any of them.
+/// Sequences are numbered in the order they are added. K-mers containing a
+/// base other than A, C, G or T are skipped.
+///
+class KmerIndex
+{
+public:  // structors
+    explicit KmerIndex(const size_t k = 12) : k_(k)
+    {
+        if (k_ == 0 || k_ > 32) throw std::invalid_argument("k-mer size must be in [1, 32]");
+    }
+
+public:  // Modifying methods
+    /// \brief Clear all indexed sequences
+    ///
+    void Clear()
+    {
+        postings_.clear();
+        size_ = 0;
+    }
+
+    /// \brief Index the k-mers of the next sequence
+    ///
+    /// \param The sequence as a string
+    ///
+    /// \return The index of the sequence
+    ///
+    size_t Add(const std::string& sequence)
+    {
+        const auto idx = static_cast<uint32_t>(size_++);
+        Index(idx, sequence);
+        return idx;
+    }
+
+    /// \brief Index the k-mers of several sequences as a single entry, e.g.
+    ///        both orientations of one sequence
+    ///
+    /// \param The sequences as strings
+    ///
+    /// \return The index of the entry
+    ///
+    size_t Add(const std::vector<std::string>& sequences)
+    {
+        const auto idx = static_cast<uint32_t>(size_++);
+        for (const auto& sequence : sequences)
+            Index(idx, sequence);
+        return idx;
+    }
+
+public:  // Non-modifying methods
+    /// \brief The number of indexed sequences
+    ///
+    size_t Size() const { return size_; }
+
+    /// \brief Shortlist the indexed sequences most similar to a query
+    ///
+    /// \param The query sequence as a string
+    /// \param The maximum number of sequences to return
+    ///
+    /// \return Up to maxCandidates indices of the sequences sharing the most
+    ///         distinct k-mers with the query, in increasing order. Sequences
+    ///         sharing no k-mer are never returned; ties are broken in favor
+    ///         of the earlier sequence.
+    ///
+    std::vector<size_t> Candidates(const std::string& query, const size_t maxCandidates) const
+    {
+        std::vector<uint64_t> kmers;
+        ForEachKmer(query, [&kmers](const uint64_t kmer) { kmers.push_back(kmer); });
+        std::sort(kmers.begin(), kmers.end());
+        kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+
+        std::vector<uint32_t> shared(size_, 0);
+        for (const auto kmer : kmers) {
+            const auto it = postings_.find(kmer);
+            if (it == postings_.cend()) continue;
+            for (const auto idx : it->second)
+                ++shared[idx];
+        }
+
+        std::vector<size_t> result;
+        for (size_t i = 0; i < size_; ++i)
+            if (shared[i] > 0) result.push_back(i);
+
+        if (result.size() > maxCandidates) {
+            const auto byShared = [&shared](const size_t a, const size_t b) {
+                return shared[a] > shared[b] || (shared[a] == shared[b] && a < b);
+            };
+            std::nth_element(result.begin(), result.begin() + maxCandidates, result.end(),
+                             byShared);
+            result.resize(maxCandidates);
+            std::sort(result.begin(), result.end());
+        }
+
+        return result;
+    }
+
+private:
+    void Index(const uint32_t idx, const std::string& sequence)
+    {
+        ForEachKmer(sequence, [this, idx](const uint64_t kmer) {
+            auto& posting = postings_[kmer];
+            // sequences are added in increasing order, repeats are adjacent
+            if (posting.empty() || posting.back() != idx) posting.push_back(idx);
+        });
+    }
+
+    // calls f with the 2-bit encoding of each k-mer of sequence
+    template <typename F>
+    void ForEachKmer(const std::string& sequence, F f) const
+    {
+        const uint64_t mask = (k_ == 32) ? ~uint64_t(0) : ((uint64_t(1) << (2 * k_)) - 1);
+        uint64_t kmer = 0;
+        size_t valid = 0;  // length of the run of ACGT ending at i
+        for (const char base : sequence) {
+            uint64_t code;
+            switch (base) {
+                case 'A':
+                case 'a':
+                    code = 0;
+                    break;
+                case 'C':
+                case 'c':
+                    code = 1;
+                    break;
+                case 'G':
+                case 'g':
+                    code = 2;
+                    break;
+                case 'T':
+                case 't':
+                    code = 3;
+                    break;
+                default:
+                    valid = 0;
+                    continue;
+            }
+            kmer = ((kmer << 2) | code) & mask;
+            if (++valid >= k_) f(kmer);
+        }
+    }
+
+private:
+    size_t k_;
+    size_t size_ = 0;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> postings_;
+};
+
+}  // namespace Chimera
+}  // namespace PacBio
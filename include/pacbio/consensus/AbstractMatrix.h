@@ -3,6 +3,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 // Initialize data structures, do NOT remove
 #include <pacbio/consensus/internal/ModelInternalInitializer.h>
@@ -10,6 +11,25 @@
 namespace PacBio {
 namespace Consensus {
 
+/// The storage type of the cells of the DP matrices.
+///
+/// DOUBLE is the default. FLOAT halves the memory and bandwidth of the
+/// matrices, the recursions still compute in double precision and only round
+/// when storing a cell. Columns are scaled to a maximum of 1, so the range of
+/// float suffices, but the rounding errors add up over long templates, so the
+/// matrices of an Evaluator whose alpha and beta disagree fall back to DOUBLE.
+enum class CellPrecision : uint8_t
+{
+    DOUBLE,
+    FLOAT
+};
+
+/// Select the cell precision of all subsequently created matrices (process-wide).
+void SetCellPrecision(CellPrecision precision);
+
+/// Returns the cell precision of newly created matrices.
+CellPrecision GetCellPrecision();
+
 /// AbstractMatrix is a superclass of the matrix types used in the arrow
 /// banded dynamic programming.  It exposes a minimal interface only
 /// intended for diagnostic purposes (looking at a matrix from Python,
@@ -87,6 +87,15 @@ public:
     /// LLs for all your mutations of interest, as this Evaluator will be invalid.
     double LL(const Mutation& mut);
 
+    /// Returns LL(mut) for each of the provided mutations, bit-identical to
+    /// calling LL(mut) in turn, but sharing the alpha extensions of
+    /// mutations at the same site.
+    /// Returns -INF for each if deactivated.
+    ///
+    /// Throws an exception if any mutation caused a corner-case failure,
+    /// after deactivating this Evaluator.
+    std::vector<double> LL(const std::vector<Mutation>& muts);
+
     /// Returns the LL of the Read, given the current template.
     /// Returns -INF if deactivated.
     double LL() const;
@@ -119,6 +128,10 @@ public:
     /// Returns -INF if deactivated.
     int NumFlipFlops() const;
 
+    /// Returns the number of DP matrix cells filled for this read so far,
+    /// counting every refill. Still counts the fills of a deactivated Evaluator.
+    size_t FilledEntries() const;
+
     /// Manually releases this Evaluator from its implementation.
     /// Cannot be used afterwards.
     void Release();
@@ -140,6 +153,10 @@ private:
     /// This filter noops for Sequel models.
     void CheckZScore(const double minZScore, const std::string& model);
 
+    /// Scores a multi-base mutation by filling alpha and beta over the
+    /// mutated template; returns -INF for other mutations.
+    double FullFillLL(const Mutation& mut) const;
+
     /// Sets the state of the Evaluator.
     /// Allows transition from VALID to anything and from anything to DISABLED.
     /// Disables the Evaluator if not VALID.
@@ -148,6 +165,7 @@ private:
 private:
     std::unique_ptr<EvaluatorImpl> impl_;
     PacBio::Data::State curState_;
+    size_t releasedEntries_;  // FilledEntries of the released implementation
 };
 
 }  // namespace Consensus
@@ -8,6 +8,8 @@
 #include <iostream>
 #include <memory>
 #include <numeric>
+#include <utility>
+#include <vector>
 
 // Initialize data structures, do NOT remove
 #include <pacbio/consensus/internal/ModelInternalInitializer.h>
@@ -62,6 +64,18 @@ public:
     virtual double LL(const Mutation& mut);
     virtual double LL() const;
 
+    /// Returns LL(mut) for each of the provided mutations, bit-identical to
+    /// calling LL(mut) in turn.
+    ///
+    /// Each Evaluator scores all mutations in one batch, see
+    /// Evaluator::LL(muts). With nThreads > 1, the Evaluators are sharded
+    /// across the calling thread and up to nThreads - 1 helpers of its
+    /// ForkJoinPool, which are reused by later calls; the per-Evaluator LLs
+    /// are then summed in Evaluator order.
+    /// Throws InvalidEvaluatorException like LL(mut), after every Evaluator
+    /// that fails on any of the mutations has been invalidated.
+    std::vector<double> LL(const std::vector<Mutation>& muts, size_t nThreads = 1);
+
     /// Masks intervals of the template for each read where the observed error rate is
     /// greater than maxErrRate in 1+2*radius template bases
     void MaskIntervals(size_t radius, double maxErrRate);
@@ -124,8 +138,13 @@ public:
     /// Returns the strand of each Evaluator.
     std::vector<PacBio::Data::StrandType> StrandTypes() const;
 
+    /// Returns the number of Evaluators, including invalid ones.
+    size_t NumEvaluators() const;
     /// Returns read-only access to Evaluator idx.
     const Evaluator& GetEvaluator(size_t idx) const;
+    /// Returns the number of DP matrix cells filled by all Evaluators so far,
+    /// see Evaluator::FilledEntries.
+    size_t FilledEntries() const;
 
 public:
     // Abstract matrix access for SWIG and diagnostics
@@ -140,11 +159,27 @@ protected:
 
     std::unique_ptr<AbstractTemplate> GetTemplate(const PacBio::Data::MappedRead& read);
 
+    /// The store of the strand's template shared by the reads of a model, or
+    /// nullptr for the first such read, which gets a Template of its own
+    std::shared_ptr<TemplateStore> Store(PacBio::Data::StrandType strand,
+                                         const std::shared_ptr<const ModelConfig>& model);
+
 protected:
     IntegratorConfig cfg_;
     std::vector<Evaluator> evals_;
     std::string fwdTpl_;
     std::string revTpl_;
+    /// Templates shared by the Evaluators of each strand and model. All
+    /// reads of a ZMW share one model, but in gcpp each read usually has a
+    /// model of its own: a store spans the whole template and is copied on
+    /// each mutation, so it is only started once a second read shares it.
+    struct SharedTemplate
+    {
+        PacBio::Data::StrandType Strand;
+        std::shared_ptr<const ModelConfig> Model;
+        std::shared_ptr<TemplateStore> Store;
+    };
+    std::vector<SharedTemplate> stores_;
 
 private:
     /// Return LL for a single Evaluator
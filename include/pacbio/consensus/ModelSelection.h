@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <set>
 #include <string>
+#include <utility>
 
 // Initialize data structures, do NOT remove
 #include <pacbio/consensus/internal/ModelInternalInitializer.h>
@@ -18,5 +20,13 @@ bool OverrideModel(const std::string& model);
 bool UnOverrideModel();
 
 size_t LoadModels(const std::string& path);
+
+// Share a model between the reads whose SNRs round to the same multiple of
+//   snrResolution, or only between identical SNRs if it is 0, keeping up
+//   to capacity models. Clears the models shared so far.
+void ConfigureModelCache(size_t capacity, double snrResolution);
+
+// The hits and misses of the shared models since the last configuration
+std::pair<size_t, size_t> ModelCacheStatistics();
 }
 }
@@ -25,8 +25,12 @@ struct PolishConfig
 
     bool Diploid;
 
+    // Number of threads used to score mutations within one Integrator;
+    // results are identical for any number of threads.
+    size_t NumThreads;
+
     PolishConfig(size_t iterations = 40, size_t separation = 10, size_t neighborhood = 20,
-                 bool diploid = false);
+                 bool diploid = false, size_t threads = 1);
 };
 
 struct RepeatConfig
@@ -34,8 +38,10 @@ struct RepeatConfig
     size_t MaximumRepeatSize;
     size_t MinimumElementCount;
     size_t MaximumIterations;
+    size_t NumThreads;
 
-    RepeatConfig(size_t repeatSize = 3, size_t elementCount = 3, size_t iterations = 40);
+    RepeatConfig(size_t repeatSize = 3, size_t elementCount = 3, size_t iterations = 40,
+                 size_t threads = 1);
 };
 
 /// Given an Integrator and a PolishConfig,
@@ -57,10 +63,15 @@ struct QualityValues
 };
 
 /// Generates phred qualities of the current template.
-std::vector<int> ConsensusQualities(Integrator& ai);
-
-/// Generates individual and compound phred qualities of the current template.
-QualityValues ConsensusQVs(Integrator& ai);
+///
+/// The candidate mutations of each site are scored together, and the reads
+/// spread over nThreads threads; results are identical for any number of
+/// threads.
+std::vector<int> ConsensusQualities(Integrator& ai, size_t nThreads = 1);
+
+/// Generates individual and compound phred qualities of the current template,
+/// see ConsensusQualities.
+QualityValues ConsensusQVs(Integrator& ai, size_t nThreads = 1);
 
 /// Returns a list of all possible mutations that can be applied to the template
 /// of the provided integrator.
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -24,6 +25,7 @@ namespace Consensus {
 
 // fwd decl
 class MutatedTemplate;
+class TemplateView;
 class AbstractRecursor;
 class ScaledMatrix;
 
@@ -83,9 +85,10 @@ class Template : public AbstractTemplate
 {
 public:
     Template(Template&&) = default;
-    Template(const std::string& tpl, std::unique_ptr<ModelConfig>&& cfg);
-    Template(const std::string& tpl, std::unique_ptr<ModelConfig>&& cfg, size_t start, size_t end,
-             bool pinStart, bool pinEnd);
+    // cfg may be shared with other templates, see ModelFactory::CreateShared
+    Template(const std::string& tpl, std::shared_ptr<const ModelConfig> cfg);
+    Template(const std::string& tpl, std::shared_ptr<const ModelConfig> cfg, size_t start,
+             size_t end, bool pinStart, bool pinEnd);
     size_t Length() const override;
     const TemplatePosition& operator[](size_t i) const override;
 
@@ -101,10 +104,82 @@ protected:
     const ModelConfig& Config() const override { return *cfg_; }
 
 private:
-    std::unique_ptr<ModelConfig> cfg_;
+    std::shared_ptr<const ModelConfig> cfg_;
     std::vector<TemplatePosition> tpl_;
 };
 
+// The whole template of one strand as populated by one model, shared by
+// the TemplateViews of all reads of that strand and model, so that its
+// positions are stored and mutated once rather than once per read
+class TemplateStore
+{
+public:
+    TemplateStore(const std::string& tpl, std::shared_ptr<const ModelConfig> cfg);
+
+    TemplateStore(const TemplateStore&) = delete;
+    TemplateStore& operator=(const TemplateStore&) = delete;
+
+    size_t Length() const { return tpl_.size(); }
+    const TemplatePosition& operator[](size_t i) const { return tpl_[i]; }
+    const std::shared_ptr<const ModelConfig>& Config() const { return cfg_; }
+
+    // Apply mutations to the whole template. The positions from before the
+    // last call stay valid until the next call, which lets the views of the
+    // store compare their old and new windows before they follow it.
+    void ApplyMutation(const Mutation& mut);
+    void ApplyMutations(std::vector<Mutation>* muts);
+
+private:
+    void KeepPrevious();
+
+    std::shared_ptr<const ModelConfig> cfg_;
+    std::vector<TemplatePosition> tpl_;
+    std::vector<TemplatePosition> previous_;
+    size_t generation_;
+
+    friend class TemplateView;
+};
+
+// A window of a TemplateStore with its own start/end mapping and pinning,
+// standing in for the Template of a single read. The store has to apply
+// any mutation before its views do, and the views follow it only through
+// ApplyMutation(s), which update the window. A view that missed a mutation
+// of its store throws instead of reading its stale window.
+class TemplateView : public AbstractTemplate
+{
+public:
+    TemplateView(std::shared_ptr<const TemplateStore> store, size_t start, size_t end,
+                 bool pinStart, bool pinEnd);
+
+    size_t Length() const override;
+    const TemplatePosition& operator[](size_t i) const override;
+
+    bool ApplyMutation(const Mutation& mut) override;
+    bool ApplyMutations(std::vector<Mutation>* muts) override;
+
+    std::unique_ptr<AbstractRecursor> CreateRecursor(const PacBio::Data::MappedRead& mr,
+                                                     double scoreDiff) const override;
+
+    double ExpectedLLForEmission(MoveType move, const AlleleRep& prev, const AlleleRep& curr,
+                                 MomentType moment) const override;
+
+protected:
+    const ModelConfig& Config() const override { return *store_->Config(); }
+
+private:
+    // point the window at the current positions of the store
+    void Follow();
+    // throw if the window no longer points at positions the store keeps
+    void CheckGeneration() const;
+
+    std::shared_ptr<const TemplateStore> store_;
+    const TemplatePosition* window_;
+    // the last base of the window ends the template, so unlike in the
+    // store it has no transitions
+    TemplatePosition last_;
+    size_t generation_;
+};
+
 // A View projected from some template, allowing for the analysis of a
 // hypothetical mutation without modifying the underlying Template,
 // which can now be kept const
@@ -153,12 +228,19 @@ public:
     virtual ~AbstractRecursor() {}
     virtual size_t FillAlphaBeta(const AbstractTemplate& tpl, M& alpha, M& beta,
                                  double tol) const = 0;
-    virtual void FillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha) const = 0;
-    virtual void FillBeta(const AbstractTemplate& tpl, const M& guide, M& beta) const = 0;
+    virtual void FillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                           size_t beginColumn = 0,
+                           size_t endColumn = std::numeric_limits<size_t>::max()) const = 0;
+    virtual void FillBeta(const AbstractTemplate& tpl, const M& guide, M& beta,
+                          size_t beginColumn = 0,
+                          size_t endColumn = std::numeric_limits<size_t>::max()) const = 0;
+    virtual bool RefillAlphaBeta(const AbstractTemplate& tpl, M& alpha, M& beta,
+                                 size_t keptAlphaColumns, size_t keptBetaColumns,
+                                 double tol) const = 0;
     virtual double LinkAlphaBeta(const AbstractTemplate& tpl, const M& alpha, size_t alphaColumn,
                                  const M& beta, size_t betaColumn, size_t absoluteColumn) const = 0;
     virtual void ExtendAlpha(const AbstractTemplate& tpl, const M& alpha, size_t beginColumn,
-                             M& ext, size_t numExtColumns = 2) const = 0;
+                             M& ext, size_t numExtColumns = 2, size_t firstExtColumn = 0) const = 0;
     virtual void ExtendBeta(const AbstractTemplate& tpl, const M& beta, size_t endColumn, M& ext,
                             int lengthDiff = 0) const = 0;
     virtual double UndoCounterWeights(size_t nEmissions) const = 0;
@@ -123,6 +123,8 @@ public:
         return NCBI4na{base, checkValid};
     }
 
+    static inline UNANIMITY_CONSTEXPR NCBI4na FromRaw(const uint8_t raw) { return NCBI4na{raw}; }
+
 public:
     ~NCBI4na() = default;
 
@@ -88,6 +88,11 @@ public:
     const PoaConsensus* FindConsensus(const PacBio::Align::AlignConfig& config,
                                       int minCoverage = -INT_MAX) const;
 
+    // The sequence of the intermediate consensus TryAddRead aligns against
+    // when given a range finder; cheaper than FindConsensus, as it does not
+    // copy the graph.
+    std::string ConsensusSequence(const PacBio::Align::AlignConfig& config) const;
+
 private:
     detail::PoaGraphImpl* impl;
 };
@@ -3,7 +3,6 @@
 #pragma once
 
 #include <cstddef>
-#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,7 +36,7 @@ class PoaGraphImpl;
 class SdpRangeFinder
 {
 private:
-    std::map<PoaGraph::Vertex, std::pair<int, int>> alignableReadIntervalByVertex_;
+    std::vector<std::pair<int, int>> alignableReadIntervalByVertex_;  // indexed by vertex
 
 public:
     virtual ~SdpRangeFinder();
@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <pacbio/denovo/RangeFinder.h>
@@ -26,9 +28,21 @@ using PoaGraph = PacBio::Poa::PoaGraph;
 
 class SdpRangeFinder : public PacBio::Poa::detail::SdpRangeFinder
 {
+public:
+    //
+    // Have FindAnchors hand out anchors already found between the current
+    // consensus and readSequence instead of aligning them again; held until
+    // ClearAnchors, which must be called before the consensus changes
+    //
+    void KeepAnchors(const std::string& readSequence, PacBio::Poa::detail::SdpAnchorVector anchors);
+    void ClearAnchors();
+
 protected:
     virtual PacBio::Poa::detail::SdpAnchorVector FindAnchors(
         const std::string& consensusSequence, const std::string& readSequence) const final;
+
+private:
+    std::vector<std::pair<std::string, PacBio::Poa::detail::SdpAnchorVector>> kept_;
 };
 
 //
@@ -52,6 +66,17 @@ struct PoaAlignmentSummary
     }
 };
 
+//
+// How OrientAndAddRead decided the strand of the reads it was given
+//
+struct PoaOrientationCounts
+{
+    size_t BySeeds;      // clear k-mer seed evidence, one strand aligned
+    size_t ByAlignment;  // ambiguous seed evidence, both strands aligned
+
+    PoaOrientationCounts() : BySeeds{0}, ByAlignment{0} {}
+};
+
 struct PoaAlignmentOptions
 {
     bool ClipBegin;
@@ -84,10 +109,19 @@ public:
     //
     // Find better orientation, (fwd or RC) and add as such
     //
+    // The strand is picked from the k-mer seeds of either orientation
+    // against the current consensus; only if those are ambiguous are both
+    // orientations aligned to the graph.
+    //
     ReadKey OrientAndAddRead(const std::string& readSequence,
                              const PoaAlignmentOptions& alnOptions = PoaAlignmentOptions(),
                              float minScoreToAdd = 0);
 
+    //
+    // Tally of the orientation decisions of OrientAndAddRead
+    //
+    const PoaOrientationCounts& OrientationCounts() const;
+
     //
     // Walk the POA and get the optimal consensus path
     //
@@ -115,6 +149,7 @@ public:
 
 private:
     void repCheck();
+    ReadKey commitRead(PoaAlignmentMatrix* mat, bool reverseComplemented, float minScoreToAdd);
 
 private:
     using Path = std::vector<PoaGraph::Vertex>;
@@ -123,6 +158,7 @@ private:
     std::vector<Path> readPaths_;
     std::vector<bool> reverseComplemented_;
     SdpRangeFinder* rangeFinder_;
+    PoaOrientationCounts orientationCounts_;
 };
 
 }  // namespace Poa
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -15,6 +16,8 @@ namespace PacBio {
 namespace GenomicConsensus {
 namespace experimental {
 
+class ReadCache;
+
 ///
 /// \brief The Input class
 ///
@@ -67,6 +70,7 @@ public:
 private:
     Settings settings_;
     PacBio::BAM::IndexedFastaReader fasta_;
+    std::shared_ptr<ReadCache> reads_;  // shared by all Inputs on a BAM file
 };
 
 }  // namespace experimental
@@ -2,9 +2,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/optional.hpp>
 
 #include <pacbio/genomicconsensus/experimental/Consensus.h>
 #include <pacbio/genomicconsensus/experimental/Settings.h>
@@ -19,16 +25,47 @@ namespace PacBio {
 namespace GenomicConsensus {
 namespace experimental {
 
+///
+/// \brief The Output class
+///
+/// Streams window results to the FASTA/FASTQ/GFF/VCF writers as soon as the
+/// windows before them are written, instead of holding a contig's results
+/// until all of it is processed. Each output window (a whole contig, or a
+/// window requested in Settings) becomes one FASTA/FASTQ record, written
+/// piece by piece from its results in reference order.
+///
+/// Results that arrive ahead of the next one expected are held in a reorder
+/// buffer. The work queue already hands results over in production order,
+/// so this buffer stays empty in gcpp runs; the queue itself holds at most
+/// MaxPendingResults results for the output thread. Like Consensus::Join,
+/// Output throws if the results of a record overlap or leave a gap: as soon
+/// as more than MaxPendingResults results wait for a missing one, or at
+/// Finish if a record is still incomplete.
+///
 class Output
 {
+public:
+    // Results that may wait for the output thread, in the work queue or in
+    // the reorder buffer
+    static constexpr const size_t MaxResultsPerThread = 4;
+    static size_t MaxPendingResults(const Settings& settings);
+
 public:
     explicit Output(const Settings& settings);
 
 public:
     void AddResult(WindowResult result);
 
+    // Throws unless every output window was written whole
+    void Finish();
+
 private:
-    void MaybeFlushContig(const std::string& refName);
+    void FlushReady();
+    bool OpenNextRecord();
+    void WriteResult(WindowResult result);
+    void CloseRecord();
+    const ReferenceWindow& RecordOf(const ReferenceWindow& window) const;
+    std::string RecordName(const ReferenceWindow& window) const;
 
 private:
     Settings settings_;
@@ -41,10 +78,20 @@ private:
 
     // per-reference data
     std::map<std::string, ReferenceWindow> refWindows_;
-    std::map<std::string, uint32_t> expectedBasesPerRef_;
-    std::map<std::string, uint32_t> processedBasesPerRef_;
-    std::map<std::string, std::vector<Consensus>> consensiPerRef_;
-    std::map<std::string, std::vector<Variant>> variantsPerRef_;
+    std::map<std::string, std::vector<ReferenceWindow>> outputWindows_;
+
+    // the record being written, and the reference position its next result
+    // must start at
+    boost::optional<ReferenceWindow> record_;
+    size_t recordPos_ = 0;
+
+    // reorder buffer: results not yet written, per reference & start
+    std::map<std::string, std::map<size_t, WindowResult>> pending_;
+    size_t nPending_ = 0;
+    size_t maxPending_;
+
+    // records written, by reference & start
+    std::set<std::pair<std::string, size_t>> written_;
 };
 
 }  // namespace experimental
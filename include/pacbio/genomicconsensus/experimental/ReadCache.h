@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <pbbam/BamFile.h>
+#include <pbbam/BamReader.h>
+#include <pbbam/BamRecord.h>
+#include <pbbam/PbiRawData.h>
+
+#include <pacbio/data/Interval.h>
+
+#include <pacbio/genomicconsensus/experimental/ReferenceWindow.h>
+
+namespace PacBio {
+namespace GenomicConsensus {
+namespace experimental {
+
+///
+/// \brief The ReadCache class
+///
+/// Shares one aligned BAM file between all windows of a run.  Its PBI is
+/// loaded once, and the mapped rows of each reference are kept sorted on
+/// tStart, so the reads overlapping a window are found by binary search
+/// instead of a PbiFilter pass over the whole index.
+///
+/// Records are decoded by a single reader that reads ahead of the requested
+/// row.  Since windows are enumerated in reference order over a sorted BAM,
+/// the records of the next window, and those spanning the boundary, are
+/// usually decoded already and no seek is needed.
+///
+/// All methods are thread-safe.
+///
+class ReadCache
+{
+public:
+    ///
+    /// \brief For
+    ///
+    /// The process-wide cache for \p bamFilename, created on first use.
+    ///
+    /// \param bamFilename
+    /// \return
+    ///
+    static std::shared_ptr<ReadCache> For(const std::string& bamFilename);
+
+    explicit ReadCache(const std::string& bamFilename);
+
+    ReadCache() = delete;
+    ReadCache(const ReadCache&) = delete;
+    ReadCache(ReadCache&&) = delete;
+    ReadCache& operator=(const ReadCache&) = delete;
+    ReadCache& operator=(ReadCache&&) = delete;
+    ~ReadCache() = default;
+
+public:
+    ///
+    /// \brief Index
+    /// \return the PBI of the BAM file
+    ///
+    const PacBio::BAM::PbiRawData& Index() const;
+
+    ///
+    /// \brief RowsInWindow
+    ///
+    /// Returns the PBI rows of reads overlapping \p window, with mapQV of at
+    /// least \p minMapQV, in file order. Equivalent to a PbiFilterQuery using
+    /// MakeWindowFilter(window, minMapQV).
+    ///
+    /// \param window
+    /// \param minMapQV
+    /// \return
+    ///
+    std::vector<size_t> RowsInWindow(const ReferenceWindow& window, const uint8_t minMapQV) const;
+
+    ///
+    /// \brief IntervalsInWindow
+    ///
+    /// Returns the sorted reference intervals of the reads in RowsInWindow.
+    /// Equivalent to FilteredWindowIntervals(Index(), window, minMapQV).
+    ///
+    /// \param window
+    /// \param minMapQV
+    /// \return
+    ///
+    std::vector<PacBio::Data::Interval> IntervalsInWindow(const ReferenceWindow& window,
+                                                          const uint8_t minMapQV) const;
+
+    ///
+    /// \brief Record
+    /// \param row  PBI row of the record
+    /// \return the decoded record
+    ///
+    PacBio::BAM::BamRecord Record(const size_t row);
+
+private:
+    void ReadAhead(size_t row);
+
+private:
+    // records decoded past the requested one, and records kept in total
+    static constexpr const size_t READ_AHEAD = 64;
+    static constexpr const size_t CAPACITY = 4096;
+
+    PacBio::BAM::BamFile bam_;
+    PacBio::BAM::PbiRawData index_;
+
+    // mapped rows of each reference id, sorted on tStart, and the longest
+    // reference span among them
+    std::vector<std::vector<size_t>> rowsByRef_;
+    std::vector<uint32_t> maxSpanByRef_;
+
+    // decoding state, guarded by mutex_
+    std::mutex mutex_;
+    PacBio::BAM::BamReader reader_;
+    size_t nextRow_;
+    std::unordered_map<size_t, PacBio::BAM::BamRecord> decoded_;
+    std::deque<size_t> decodedOrder_;
+};
+
+}  // namespace experimental
+}  // namespace GenomicConsensus
+}  // namespace PacBio
@@ -26,6 +26,7 @@ struct Settings
     {
         // parallelism
         static constexpr const size_t NumThreads = 1;
+        static constexpr const size_t PolishThreads = 1;
 
         // output filtering
         static constexpr const size_t MinConfidence = 40;
@@ -81,6 +82,7 @@ struct Settings
 
     // parallelism
     size_t numThreads = Defaults::NumThreads;
+    size_t polishThreads = Defaults::PolishThreads;
 
     // output settings
     size_t minConfidence = Defaults::MinConfidence;
@@ -187,7 +187,8 @@ struct Arrow
         return accuracy >= settings.minAccuracy;
     }
 
-    static std::vector<uint8_t> ConsensusConfidence(PacBio::Consensus::Integrator& integrator)
+    static std::vector<uint8_t> ConsensusConfidence(PacBio::Consensus::Integrator& integrator,
+                                                    const size_t nThreads)
     {
         //
         // Returns an array of QV values reflecting the consensus confidence
@@ -196,7 +197,7 @@ struct Arrow
         // consensus (str(ai)).
         //
 
-        const auto cssQVs = PacBio::Consensus::ConsensusQualities(integrator);
+        const auto cssQVs = PacBio::Consensus::ConsensusQualities(integrator, nThreads);
         std::vector<uint8_t> confidence;
         confidence.reserve(cssQVs.size());
         for (const auto c : cssQVs)
@@ -213,8 +214,9 @@ struct Arrow
         //
 
         using PolishConfig = PacBio::Consensus::PolishConfig;
-        const auto config = PolishConfig{settings.maxIterations, settings.mutationSeparation,
-                                         settings.mutationNeighborhood, polishDiploid};
+        const auto config =
+            PolishConfig{settings.maxIterations, settings.mutationSeparation,
+                         settings.mutationNeighborhood, polishDiploid, settings.polishThreads};
 
         if (settings.maskRadius != 0) {
             PacBio::Consensus::Polish(&integrator, config);
@@ -332,7 +334,7 @@ struct Arrow
         if (converged) {
             arrowCss = static_cast<std::string>(ai);
             if (settings.computeConfidence)
-                confidence = ConsensusConfidence(ai);
+                confidence = ConsensusConfidence(ai, settings.polishThreads);
             else
                 confidence = std::vector<uint8_t>(arrowCss.size(), 0);
         } else {
@@ -345,7 +347,7 @@ struct Arrow
             if (converged) {
                 arrowCss = static_cast<std::string>(ai);
                 if (settings.computeConfidence)
-                    confidence = ConsensusConfidence(ai);
+                    confidence = ConsensusConfidence(ai, settings.polishThreads);
                 else
                     confidence = std::vector<uint8_t>(arrowCss.size(), 0);
             } else {
@@ -19,12 +19,18 @@ public:
     FastaWriter(const Settings& settings);
     void Write(const std::string& header, const std::string& sequence);
 
+    // Writes a record piece by piece, wrapping lines across pieces
+    void BeginRecord(const std::string& header);
+    void Append(const std::string& sequence);
+    void EndRecord();
+
 private:
     void WriteLine(const std::string& line);
 
 private:
     FileProducer file_;
     std::ofstream out_;
+    size_t column_ = 0;  // bases on the current line of the open record
 };
 
 }  // namespace experimental
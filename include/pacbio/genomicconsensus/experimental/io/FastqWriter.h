@@ -21,12 +21,20 @@ public:
     void Write(const std::string& header, const std::string& sequence,
                const std::vector<uint8_t>& qualities);
 
+    // Writes a record piece by piece. The sequence goes straight to the file;
+    // the qualities, which follow all of it, are held as FASTQ characters
+    // until EndRecord.
+    void BeginRecord(const std::string& header);
+    void Append(const std::string& sequence, const std::vector<uint8_t>& qualities);
+    void EndRecord();
+
 private:
     void WriteLine(const std::string& line);
 
 private:
     FileProducer file_;
     std::ofstream out_;
+    std::string qualities_;  // of the open record
 };
 
 }  // namespace experimental
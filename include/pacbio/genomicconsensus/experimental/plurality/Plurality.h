@@ -10,6 +10,8 @@
 
 #include <algorithm>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <pbbam/BamRecord.h>
@@ -28,97 +30,6 @@ namespace experimental {
 
 struct Plurality
 {
-    static std::string AlignedReference(const PacBio::BAM::Cigar& cigar, const std::string& ref)
-    {
-        std::string alignedRef;
-        alignedRef.reserve(ref.size());
-
-        size_t posInInput = 0;
-        for (const auto& op : cigar) {
-            const auto len = op.Length();
-            if (op.Type() == PacBio::BAM::CigarOperationType::INSERTION)
-                alignedRef.append(len, '-');
-            else {
-                alignedRef.append(ref.substr(posInInput, len));
-                posInInput += len;
-            }
-        }
-
-        return alignedRef;
-    }
-
-    using BaseCallsMatrix = std::vector<std::vector<std::string>>;  // mat[read][pos] = bases
-
-    static std::vector<std::string> BaseCallsForAlignment(const std::string& alnRead,
-                                                          const std::string& alnRef,
-                                                          const size_t windowLength)
-    {
-        // Idea: scan through the ref, read; for each non-gap character
-        // in ref, record all non-gap characters seen in read since
-        // last ref gap.
-
-        std::vector<std::string> accum;
-        accum.reserve(windowLength);
-
-        std::string readBases;
-        for (size_t j = 0; j < alnRef.size(); ++j) {
-            const auto refBase = alnRef.at(j);
-            const auto readBase = alnRead.at(j);
-
-            if (readBase != '-') readBases.push_back(readBase);
-
-            if (refBase != '-') {
-                auto basesForRefPos = (readBases.empty() ? std::string(1, '-') : readBases);
-                accum.emplace_back(std::move(basesForRefPos));
-                readBases.clear();
-            }
-        }
-
-        return accum;
-    }
-
-    static BaseCallsMatrix TabulateBaseCalls(const Input& input, const ReferenceWindow& window)
-    {
-        // Go through the reads and build up the structured baseCallsMatrix
-        // table, which tabulates the read bases occurring at each reference
-        // coordinate in each read.  This code is somewhat tricky, read carefully.
-
-        using ClipType = PacBio::BAM::ClipType;
-        using Orientation = PacBio::BAM::Orientation;
-
-        const auto refStart = window.Start();
-        const auto refEnd = window.End();
-
-        auto reads = input.ReadsInWindow(window);
-        BaseCallsMatrix matrix{reads.size(), std::vector<std::string>(window.Length())};
-
-        for (size_t i = 0; i < reads.size(); ++i) {
-            auto& read = reads.at(i);
-            read.Clip(ClipType::CLIP_TO_REFERENCE, refStart, refEnd);
-
-            const auto alnRead = read.Sequence(Orientation::GENOMIC, true);
-            const auto alnRef = AlignedReference(read.CigarData(), input.ReferenceInWindow(window));
-            assert(alnRef.size() == alnRead.size());
-
-            // NOTE (DB): Can't find normalizeHomopolymerGaps() method. Come back later.
-            //
-            // if realignHomopolymers:
-            //     alnRef, alnRead =  normalizeHomopolymerGaps(alnRef, alnRead)
-
-            auto accum = BaseCallsForAlignment(alnRead, alnRef, window.Length());
-
-            const auto s = read.AlignedStart() - refStart;
-            const auto e = read.AlignedEnd() - refStart;
-            assert((e - s) == accum.size());
-
-            auto& alnBaseCalls = matrix.at(i);
-            for (size_t j = 0; j < accum.size(); ++j)
-                alnBaseCalls.at(j + s) = std::move(accum.at(j));
-        }
-
-        return matrix;
-    }
-
     struct Allele
     {
         std::string bases;
@@ -126,7 +37,7 @@ struct Plurality
 
         Allele() = default;
         Allele(std::string bases_, size_t frequency_)
-            : bases{std::move(bases)}, frequency{frequency_}
+            : bases{std::move(bases_)}, frequency{frequency_}
         {
         }
     };
@@ -145,63 +56,218 @@ struct Plurality
         }
     };
 
-    static std::vector<Top2> TopAllelesFromMatrix(const BaseCallsMatrix& matrix,
-                                                  const size_t windowLength)
+    //
+    // Streaming pileup of the alleles each read shows at each position of a
+    // window.  Following each read's CIGAR, the allele at a reference position
+    // is the read bases inserted since the previous reference position, plus
+    // the base aligned to this one, or "-" if it is deleted with nothing
+    // inserted before it.  Insertions after the last reference position of a
+    // read are dropped.
+    //
+    // Single-base alleles (and "-") are counted in one compact array of
+    // NUM_CODES counters per position; the few other alleles, mostly
+    // insertions, go to a side table of (position, allele) entries that is
+    // only sorted and counted when the top alleles are asked for.
+    //
+    class Pileup
     {
-        std::vector<Top2> result;
-        result.reserve(windowLength);
-
-        std::unordered_map<std::string, size_t> alleleCounts;
-        for (size_t pos = 0; pos < windowLength; ++pos) {
-            for (size_t row = 0; row < matrix.size(); ++row) {
-                assert(matrix.at(row).size() == windowLength);
-                auto s = matrix.at(row).at(pos);
-                if (!s.empty()) alleleCounts[s]++;
+    public:
+        explicit Pileup(const size_t windowLength)
+            : windowLength_{windowLength}, counts_(windowLength * NUM_CODES, 0)
+        {
+        }
+
+        // Adds a read whose alignment starts at windowStart within the window
+        // and stays within it, as after BamRecord::Clip(CLIP_TO_REFERENCE).
+        // cigar and seq are in genomic orientation; seq holds any soft-clipped
+        // bases.
+        void AddRead(const size_t windowStart, const PacBio::BAM::Cigar& cigar,
+                     const std::string& seq)
+        {
+            using CigarOperationType = PacBio::BAM::CigarOperationType;
+
+            size_t pos = windowStart;
+            size_t readPos = 0;
+            std::string inserted;
+
+            for (const auto& op : cigar) {
+                const size_t len = op.Length();
+                switch (op.Type()) {
+                    case CigarOperationType::ALIGNMENT_MATCH:
+                    case CigarOperationType::SEQUENCE_MATCH:
+                    case CigarOperationType::SEQUENCE_MISMATCH:
+                        for (size_t k = 0; k < len; ++k, ++pos, ++readPos) {
+                            if (inserted.empty())
+                                AddAllele(pos, seq[readPos]);
+                            else {
+                                inserted.push_back(seq[readPos]);
+                                AddAllele(pos, inserted);
+                                inserted.clear();
+                            }
+                        }
+                        break;
+
+                    case CigarOperationType::DELETION:
+                    case CigarOperationType::REFERENCE_SKIP:
+                        for (size_t k = 0; k < len; ++k, ++pos) {
+                            if (inserted.empty())
+                                AddAllele(pos, '-');
+                            else {
+                                AddAllele(pos, inserted);
+                                inserted.clear();
+                            }
+                        }
+                        break;
+
+                    case CigarOperationType::INSERTION:
+                        inserted.append(seq, readPos, len);
+                        readPos += len;
+                        break;
+
+                    case CigarOperationType::SOFT_CLIP:
+                        readPos += len;
+                        break;
+
+                    default:  // HARD_CLIP, PADDING
+                        break;
+                }
             }
+            assert(pos <= windowLength_);
+            assert(readPos <= seq.size());
+        }
 
-            // calculate totals & save top 2
-            Allele top1{};
-            Allele top2{};
-            size_t totalCoverage = 0;
-
-            if (!alleleCounts.empty()) {
-                if (alleleCounts.size() == 1) {
-                    const auto a = *alleleCounts.cbegin();
-                    top1 = Allele{a.first, a.second};
-                    totalCoverage = a.second;
-                } else {
-                    using MapPair = std::pair<std::string, size_t>;
-                    std::vector<MapPair> flattened;
-                    flattened.reserve(alleleCounts.size());
-                    for (auto& allelesAtPos : alleleCounts) {
-                        totalCoverage += allelesAtPos.second;
-                        flattened.emplace_back(std::move(allelesAtPos));
-                    }
-                    assert(flattened.size() > 1);
-
-                    // sort descending on allele count, top2 get placed at beginning
-                    std::nth_element(flattened.begin(), flattened.begin() + 1, flattened.end(),
-                                     [](const MapPair& lhs, const MapPair& rhs) {
-                                         return lhs.second > rhs.second;
-                                     });
-
-                    top1 = Allele{std::move(flattened.at(0).first), flattened.at(0).second};
-                    top2 = Allele{std::move(flattened.at(1).first), flattened.at(1).second};
+        std::vector<Top2> TopAlleles() const
+        {
+            // group the side table by position, then by allele
+            auto others = others_;
+            std::sort(others.begin(), others.end());
+
+            std::vector<Top2> result;
+            result.reserve(windowLength_);
+
+            auto other = others.cbegin();
+            for (size_t pos = 0; pos < windowLength_; ++pos) {
+                // (count, allele) of the two most frequent alleles; ties go to
+                // the lexicographically smaller allele, so results do not
+                // depend on hashing or insertion order
+                std::pair<size_t, std::string> top1{0, ""};
+                std::pair<size_t, std::string> top2{0, ""};
+                size_t totalCoverage = 0;
+
+                const auto consider = [&](const size_t count, const std::string& bases) {
+                    totalCoverage += count;
+                    if (IsBetter(count, bases, top1)) {
+                        top2 = std::move(top1);
+                        top1 = {count, bases};
+                    } else if (IsBetter(count, bases, top2))
+                        top2 = {count, bases};
+                };
+
+                const uint32_t* const counts = &counts_[pos * NUM_CODES];
+                for (size_t code = 0; code < NUM_CODES; ++code)
+                    if (counts[code] > 0) consider(counts[code], std::string(1, Base(code)));
+
+                while (other != others.cend() && other->first == pos) {
+                    const auto id = other->second;
+                    size_t count = 0;
+                    for (; other != others.cend() && other->first == pos && other->second == id;
+                         ++other)
+                        ++count;
+                    consider(count, alleles_[id]);
                 }
+
+                result.emplace_back(Allele{std::move(top1.second), top1.first},
+                                    Allele{std::move(top2.second), top2.first}, totalCoverage);
             }
 
-            result.emplace_back(top1, top2, totalCoverage);
-            alleleCounts.clear();
+            return result;
         }
 
-        return result;
-    }
+    private:
+        static constexpr const size_t NUM_CODES = 6;
+
+        static size_t Code(const char base)
+        {
+            switch (base) {
+                case 'A':
+                    return 0;
+                case 'C':
+                    return 1;
+                case 'G':
+                    return 2;
+                case 'T':
+                    return 3;
+                case 'N':
+                    return 4;
+                case '-':
+                    return 5;
+                default:
+                    return NUM_CODES;
+            }
+        }
+
+        static char Base(const size_t code) { return "ACGTN-"[code]; }
+
+        static bool IsBetter(const size_t count, const std::string& bases,
+                             const std::pair<size_t, std::string>& than)
+        {
+            return count > than.first || (count == than.first && count > 0 && bases < than.second);
+        }
+
+        void AddAllele(const size_t pos, const char base)
+        {
+            assert(pos < windowLength_);
+            const size_t code = Code(base);
+            if (code < NUM_CODES)
+                ++counts_[pos * NUM_CODES + code];
+            else
+                AddAllele(pos, std::string(1, base));
+        }
+
+        void AddAllele(const size_t pos, const std::string& bases)
+        {
+            assert(pos < windowLength_);
+            // a single base inserted before a deletion still counts as that base
+            if (bases.size() == 1 && Code(bases[0]) < NUM_CODES) {
+                ++counts_[pos * NUM_CODES + Code(bases[0])];
+                return;
+            }
+            auto it = alleleIds_.find(bases);
+            if (it == alleleIds_.end()) {
+                it = alleleIds_.emplace(bases, static_cast<uint32_t>(alleles_.size())).first;
+                alleles_.push_back(bases);
+            }
+            others_.emplace_back(static_cast<uint32_t>(pos), it->second);
+        }
+
+        size_t windowLength_;
+        std::vector<uint32_t> counts_;                       // counts_[pos * NUM_CODES + code]
+        std::vector<std::pair<uint32_t, uint32_t>> others_;  // (pos, allele id)
+        std::vector<std::string> alleles_;
+        std::unordered_map<std::string, uint32_t> alleleIds_;
+    };
 
     static std::vector<Top2> TopAllelesForWindow(const Input& input, const ReferenceWindow& window)
     {
-        const auto windowLength = window.Length();
-        const auto baseCallsMatrix = TabulateBaseCalls(input, window);
-        return TopAllelesFromMatrix(baseCallsMatrix, windowLength);
+        using ClipType = PacBio::BAM::ClipType;
+        using Orientation = PacBio::BAM::Orientation;
+
+        const auto refStart = window.Start();
+        const auto refEnd = window.End();
+
+        Pileup pileup{window.Length()};
+        for (auto& read : input.ReadsInWindow(window)) {
+            read.Clip(ClipType::CLIP_TO_REFERENCE, refStart, refEnd);
+
+            // NOTE (DB): Can't find normalizeHomopolymerGaps() method. Come back later.
+            //
+            // if realignHomopolymers:
+            //     alnRef, alnRead =  normalizeHomopolymerGaps(alnRef, alnRead)
+
+            pileup.AddRead(read.AlignedStart() - refStart, read.CigarData(),
+                           read.Sequence(Orientation::GENOMIC));
+        }
+        return pileup.TopAlleles();
     }
 
     static std::vector<Variant> VariantsFromRefAndRead(const std::string& refName,
@@ -42,11 +42,17 @@ struct Poa
         //
 
         using PacBio::Align::AlignAffineIupac;
+        using PacBio::Align::IupacAwareAffineAlignmentParams;
         using PairwiseAlignment = PacBio::Align::PairwiseAlignment;
 
+        // the consensus stays close to the reference diagonal; the band is
+        // widened if need be
+        auto alignParams = IupacAwareAffineAlignmentParams();
+        alignParams.BandWidth = 32;
+
         std::unique_ptr<PairwiseAlignment> ga = nullptr;
         // TODO: switch on CLI-requested aligner, for now just go with affine (default)
-        ga.reset(AlignAffineIupac(refSeq, poaCss));
+        ga.reset(AlignAffineIupac(refSeq, poaCss, alignParams));
         //        if (settings.aligner == "affine")
         //            ga.reset(AlignAffineIupac(refSeq, poaCss));
         //        else
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <time.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PacBio {
+namespace Parallel {
+
+/// Helper threads for the data-parallel loops within one task, such as
+/// scoring mutations over the reads of a ZMW.
+///
+/// Run calls a function on the calling thread and on up to nThreads - 1
+/// helpers at once and returns when all calls have. The helpers are started
+/// on the first Run that needs them and then wait for the next one, so a
+/// loop run once per polishing round does not start threads every round.
+/// Every thread has its own pool, so worker threads running separate tasks
+/// never wait on each other's helpers, and the helpers of a thread exit with
+/// it.
+class ForkJoinPool
+{
+public:
+    /// The pool of the calling thread.
+    static ForkJoinPool& ThreadLocal()
+    {
+        thread_local ForkJoinPool pool;
+        return pool;
+    }
+
+public:
+    ForkJoinPool()
+        : generation_{0}, nWanted_{0}, nRunning_{0}, helperCpu_{0}, running_{false}, stop_{false}
+    {
+    }
+
+    ForkJoinPool(const ForkJoinPool&) = delete;
+    ForkJoinPool& operator=(const ForkJoinPool&) = delete;
+
+    ~ForkJoinPool()
+    {
+        {
+            std::lock_guard<std::mutex> g(m_);
+            stop_ = true;
+        }
+        startCv_.notify_all();
+        for (auto& helper : helpers_)
+            helper.join();
+    }
+
+    /// Call f() on the calling thread and on nThreads - 1 helpers, and wait
+    /// for all of them. f must split the work between its calls itself, e.g.
+    /// through an atomic counter. The first exception thrown by any call is
+    /// rethrown once all have returned. A Run from within f only calls f on
+    /// the calling thread.
+    template <typename F>
+    void Run(const size_t nThreads, F&& f)
+    {
+        if (nThreads <= 1 || running_) {
+            f();
+            return;
+        }
+
+        const size_t nHelpers = nThreads - 1;
+        {
+            std::lock_guard<std::mutex> g(m_);
+            while (helpers_.size() < nHelpers) {
+                const size_t i = helpers_.size();
+                helpers_.emplace_back([this, i]() { Help(i); });
+            }
+            job_ = std::ref(f);
+            exc_ = nullptr;
+            nWanted_ = nHelpers;
+            nRunning_ = nHelpers;
+            ++generation_;
+        }
+        running_ = true;
+        startCv_.notify_all();
+
+        std::exception_ptr exc;
+        try {
+            f();
+        } catch (...) {
+            exc = std::current_exception();
+        }
+
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            doneCv_.wait(lk, [this]() { return nRunning_ == 0; });
+            job_ = nullptr;
+            if (!exc) exc = exc_;
+        }
+        running_ = false;
+        if (exc) std::rethrow_exception(exc);
+    }
+
+    /// The number of helper threads started so far.
+    size_t NumHelpers() const
+    {
+        std::lock_guard<std::mutex> g(m_);
+        return helpers_.size();
+    }
+
+    /// The CPU time the helpers spent in the calls of Run so far, in
+    /// nanoseconds.
+    int64_t HelperCpuNanoseconds() const
+    {
+        std::lock_guard<std::mutex> g(m_);
+        return helperCpu_;
+    }
+
+private:
+    void Help(const size_t i)
+    {
+        size_t seen = 0;
+        std::unique_lock<std::mutex> lk(m_);
+        while (true) {
+            startCv_.wait(lk, [this, seen]() { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+            // helpers beyond the ones asked for sit this run out
+            if (i >= nWanted_) continue;
+
+            lk.unlock();
+            const int64_t cpuStart = ThreadCpuNanoseconds();
+            std::exception_ptr exc;
+            try {
+                job_();
+            } catch (...) {
+                exc = std::current_exception();
+            }
+            const int64_t cpu = ThreadCpuNanoseconds() - cpuStart;
+            lk.lock();
+
+            helperCpu_ += cpu;
+            if (exc && !exc_) exc_ = exc;
+            if (--nRunning_ == 0) doneCv_.notify_one();
+        }
+    }
+
+    static int64_t ThreadCpuNanoseconds()
+    {
+        timespec ts;
+        if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+        return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+
+private:
+    mutable std::mutex m_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+    std::vector<std::thread> helpers_;
+    std::function<void()> job_;
+    std::exception_ptr exc_;
+    size_t generation_;
+    size_t nWanted_;
+    size_t nRunning_;
+    int64_t helperCpu_;  // nanoseconds
+    bool running_;       // only touched by the owning thread
+    bool stop_;
+};
+
+}  // namespace Parallel
+}  // namespace PacBio
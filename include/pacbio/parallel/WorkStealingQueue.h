@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/optional.hpp>
+
+namespace PacBio {
+namespace Parallel {
+
+/// Drop-in replacement for WorkQueue<T> built for many short tasks.
+///
+/// Every worker thread owns a deque of tasks; the producer deals tasks out
+/// round-robin, workers pop from their own deque and steal from the others'
+/// deques once theirs runs dry. Each deque has its own lock, so workers only
+/// contend when stealing. Like WorkQueue, the producer blocks while
+/// maxQueued tasks wait for a worker. Each task writes its result into its
+/// own slot, and the consumer takes the slots in production order, so a slow
+/// task only holds back the consumer, never the producer or the other
+/// workers. By default the slots are not bounded; given maxResults, the
+/// producer also blocks while that many results are produced but not yet
+/// consumed, bounding the memory held by finished results waiting behind a
+/// slow one. Locks shared by all threads are only taken
+/// to queue and hand over result slots, to put idle workers to sleep, to
+/// wake the consumer when the result it waits for arrives, and to block the
+/// producer.
+template <typename T>
+class WorkStealingQueue
+{
+private:
+    // Type-erased callable; unlike std::function it accepts move-only
+    // arguments such as the unique_ptr chunks ccs hands over.
+    struct Callable
+    {
+        virtual ~Callable() = default;
+        virtual T operator()() = 0;
+    };
+
+    template <typename B>
+    struct BoundCallable : public Callable
+    {
+        BoundCallable(B&& bound) : bound_(std::move(bound)) {}
+        T operator()() override { return bound_(); }
+        B bound_;
+    };
+
+    struct Slot
+    {
+        boost::optional<T> value;
+        std::exception_ptr exc;
+        std::atomic<bool> ready{false};
+    };
+
+    struct Task
+    {
+        size_t seq;
+        Slot* slot;
+        std::unique_ptr<Callable> fn;
+    };
+
+    struct Worker
+    {
+        std::mutex m;
+        std::deque<Task> tasks;
+    };
+
+public:
+    WorkStealingQueue(const size_t size, const size_t maxQueued = 0, const size_t maxResults = 0)
+        : nWorkers_{std::max<size_t>(1, size)}
+        , capacity_{maxQueued > 0 ? maxQueued : 4 * nWorkers_}
+        , maxResults_{maxResults}
+        , workers_(nWorkers_)
+        , exc_{nullptr}
+        , produced_{0}
+        , consumed_{0}
+        , pending_{0}
+        , sleeping_{0}
+        , finalized_{false}
+        , failed_{false}
+    {
+        for (auto& worker : workers_)
+            worker = std::make_unique<Worker>();
+        for (size_t i = 0; i < nWorkers_; ++i)
+            threads_.emplace_back(std::thread([this, i]() { Work(i); }));
+    }
+
+    ~WorkStealingQueue() noexcept(false)
+    {
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+
+        // wait to see if there's a final exception, throw if so..
+        {
+            std::lock_guard<std::mutex> g(seqM_);
+            if (exc_) std::rethrow_exception(exc_);
+        }
+    }
+
+    template <typename F, typename... Args>
+    void ProduceWith(F&& f, Args&&... args)
+    {
+        // wait until a worker has picked up one of the queued tasks, and
+        // the consumer one of the results if they are bounded
+        if (pending_.load() >= capacity_ || maxResults_ > 0) {
+            std::unique_lock<std::mutex> lk(seqM_);
+            spaceCv_.wait(lk, [this]() {
+                if (exc_) std::rethrow_exception(exc_);
+                return pending_.load() < capacity_ &&
+                       (maxResults_ == 0 || results_.size() < maxResults_);
+            });
+        }
+        if (failed_.load()) {
+            std::lock_guard<std::mutex> g(seqM_);
+            if (exc_) std::rethrow_exception(exc_);
+        }
+
+        // the slot is queued for the consumer before its task is published
+        const size_t seq = produced_.load(std::memory_order_relaxed);
+        auto slot = std::make_unique<Slot>();
+        Slot* const result = slot.get();
+        {
+            std::lock_guard<std::mutex> g(seqM_);
+            results_.emplace_back(std::move(slot));
+        }
+
+        // count the task before publishing it, so pending_ never underflows
+        ++pending_;
+        Worker& worker = *workers_[seq % nWorkers_];
+        {
+            std::lock_guard<std::mutex> g(worker.m);
+            worker.tasks.emplace_back(
+                Task{seq, result,
+                     MakeCallable(std::bind(std::forward<F>(f), std::forward<Args>(args)...))});
+        }
+        produced_.store(seq + 1);
+        WakeWorker();
+    }
+
+    template <typename F, typename... Args>
+    bool ConsumeWith(F&& cont, Args&&... args)
+    {
+        const size_t seq = consumed_.load(std::memory_order_relaxed);
+        std::unique_ptr<Slot> slot;
+        {
+            std::unique_lock<std::mutex> lk(seqM_);
+            resultCv_.wait(lk, [seq, this]() {
+                if (!results_.empty()) return results_.front()->ready.load();
+                return finalized_.load() && seq == produced_.load();
+            });
+            if (results_.empty()) return false;
+            slot = std::move(results_.front());
+            results_.pop_front();
+        }
+        if (maxResults_ > 0) spaceCv_.notify_one();
+
+        try {
+            consumed_.store(seq + 1);
+            if (slot->exc) std::rethrow_exception(slot->exc);
+            cont(std::forward<Args>(args)..., std::move(*slot->value));
+            return true;
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> g(seqM_);
+                exc_ = std::current_exception();
+                failed_.store(true);
+            }
+            spaceCv_.notify_all();
+        }
+        return false;
+    }
+
+    void Finalize()
+    {
+        finalized_.store(true);
+        {
+            std::lock_guard<std::mutex> g(idleM_);
+        }
+        idleCv_.notify_all();
+        {
+            std::lock_guard<std::mutex> g(seqM_);
+        }
+        resultCv_.notify_all();
+    }
+
+private:
+    void Work(const size_t self)
+    {
+        while (true) {
+            boost::optional<Task> task = Pop(self);
+            if (!task) {
+                // nothing to do, sleep until there is
+                std::unique_lock<std::mutex> lk(idleM_);
+                ++sleeping_;
+                idleCv_.wait(lk, [this]() { return pending_.load() > 0 || finalized_.load(); });
+                --sleeping_;
+                if (pending_.load() == 0 && finalized_.load()) return;
+                continue;
+            }
+
+            Slot& slot = *task->slot;
+            try {
+                slot.value = (*task->fn)();
+            } catch (...) {
+                slot.exc = std::current_exception();
+            }
+            slot.ready.store(true);
+
+            // only wake the consumer if it is waiting for this very result
+            if (consumed_.load() == task->seq) {
+                {
+                    std::lock_guard<std::mutex> g(seqM_);
+                }
+                resultCv_.notify_one();
+            }
+        }
+    }
+
+    // Pop from our own deque, or steal from another's once ours is empty.
+    // Both take the oldest task, which keeps the consumer from waiting on
+    // results that were produced long ago.
+    boost::optional<Task> Pop(const size_t self)
+    {
+        for (size_t k = 0; k < nWorkers_; ++k) {
+            Worker& worker = *workers_[(self + k) % nWorkers_];
+            boost::optional<Task> task;
+            {
+                std::lock_guard<std::mutex> g(worker.m);
+                if (worker.tasks.empty()) continue;
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+            }
+
+            // the producer may be waiting for room in the queue
+            if (pending_-- == capacity_) {
+                {
+                    std::lock_guard<std::mutex> g(seqM_);
+                }
+                spaceCv_.notify_one();
+            }
+            return task;
+        }
+        return boost::none;
+    }
+
+    template <typename B>
+    static std::unique_ptr<Callable> MakeCallable(B&& bound)
+    {
+        return std::make_unique<BoundCallable<B>>(std::move(bound));
+    }
+
+    void WakeWorker()
+    {
+        if (sleeping_.load() == 0) return;
+        {
+            std::lock_guard<std::mutex> g(idleM_);
+        }
+        idleCv_.notify_one();
+    }
+
+private:
+    const size_t nWorkers_;
+    const size_t capacity_;
+    const size_t maxResults_;  // 0 if unbounded
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::deque<std::unique_ptr<Slot>> results_;  // in production order
+    std::vector<std::thread> threads_;
+
+    std::mutex idleM_;
+    std::condition_variable idleCv_;
+    std::mutex seqM_;
+    std::condition_variable resultCv_;
+    std::condition_variable spaceCv_;
+    std::exception_ptr exc_;
+
+    std::atomic<size_t> produced_;
+    std::atomic<size_t> consumed_;
+    std::atomic<size_t> pending_;
+    std::atomic<size_t> sleeping_;
+    std::atomic<bool> finalized_;
+    std::atomic<bool> failed_;
+};
+
+}  // namespace Parallel
+}  // namespace PacBio
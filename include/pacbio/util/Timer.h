@@ -3,6 +3,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <string>
 
 namespace PacBio {
@@ -14,6 +15,7 @@ public:
     Timer();
 
     float ElapsedMilliseconds() const;
+    int64_t ElapsedNanoseconds() const;
     float ElapsedSeconds() const;
     std::string ElapsedTime() const;
     void Restart();
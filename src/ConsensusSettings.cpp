@@ -77,6 +77,13 @@ const PlainOption PolishRepeats{
     "Polish repeats of 2 to N bases of 3 or more elements.",
     CLI::Option::IntType(0)
 };
+const PlainOption PolishThreads{
+    "polish_threads",
+    { "polishThreads" },
+    "Threads per ZMW",
+    "Number of threads used to polish a single ZMW. Speeds up long inserts, results are unchanged.",
+    CLI::Option::IntType(1)
+};
 const PlainOption MinReadScore{
     "min_read_score",
     { "minReadScore" },
@@ -156,6 +163,33 @@ const PlainOption ModelSpec{
     "Name of chemistry or model to use, overriding default selection.",
     CLI::Option::StringType("")
 };
+const PlainOption SinglePrecision{
+    "single_precision",
+    { "singlePrecision" },
+    "Single-Precision Matrices",
+    "Store the cells of the polishing matrices in single precision, halving their memory. Subreads whose fills lose too much precision fall back to double.",
+    CLI::Option::BoolType(),
+    JSON::Json(nullptr),
+    CLI::OptionFlags::HIDE_FROM_HELP
+};
+const PlainOption SnrResolution{
+    "snr_resolution",
+    { "snrResolution" },
+    "SNR Resolution",
+    "Share the model of subreads whose SNRs round to the same multiple of this, 0 shares models between equal SNRs only.",
+    CLI::Option::FloatType(0.0),
+    JSON::Json(nullptr),
+    CLI::OptionFlags::HIDE_FROM_HELP
+};
+const PlainOption TimeStages{
+    "time_stages",
+    { "timeStages" },
+    "Measure Stage Timings",
+    "Write wall clock and CPU timings of each stage per thread, and matrix counters, as JSON next to the report, or to stderr if the report goes to stdout.",
+    CLI::Option::BoolType(),
+    JSON::Json(nullptr),
+    CLI::OptionFlags::HIDE_FROM_HELP
+};
 const PlainOption ZmwTimings{
     "zmw_timings",
     { "zmwTimings" },
@@ -187,8 +221,12 @@ ConsensusSettings::ConsensusSettings(const PacBio::CLI::Results& options)
     , ModelPath{options[OptionNames::ModelPath].get<decltype(ModelPath)>()}
     , ModelSpec{options[OptionNames::ModelSpec].get<decltype(ModelSpec)>()}
     , PolishRepeats{options[OptionNames::PolishRepeats]}
+    , PolishThreads{options[OptionNames::PolishThreads]}
     , ReportFile{options[OptionNames::ReportFile].get<decltype(ReportFile)>()}
     , RichQVs{options[OptionNames::RichQVs]}
+    , SinglePrecision{options[OptionNames::SinglePrecision]}
+    , SnrResolution{options[OptionNames::SnrResolution]}
+    , TimeStages{options[OptionNames::TimeStages]}
     , WlSpec{options[OptionNames::Zmws].get<decltype(WlSpec)>()}
     , ZmwTimings{options[OptionNames::ZmwTimings]}
 {
@@ -254,12 +292,16 @@ PacBio::CLI::Interface ConsensusSettings::CreateCLI(const std::string& descripti
         OptionNames::NoPolish,
         OptionNames::Polish,
         OptionNames::PolishRepeats,
+        OptionNames::PolishThreads,
         OptionNames::RichQVs,
         OptionNames::ReportFile,
         OptionNames::ModelPath,
         OptionNames::ModelSpec,
         OptionNames::NumThreads,
         OptionNames::LogFile,
+        OptionNames::SinglePrecision,
+        OptionNames::SnrResolution,
+        OptionNames::TimeStages,
         OptionNames::ZmwTimings
     });
 
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <pacbio/consensus/Evaluator.h>
 #include <pacbio/exception/InvalidEvaluatorException.h>
@@ -18,7 +19,7 @@ using namespace PacBio::Exception;
 namespace PacBio {
 namespace Consensus {
 
-Evaluator::Evaluator(const State state) : impl_{nullptr}, curState_{state}
+Evaluator::Evaluator(const State state) : impl_{nullptr}, curState_{state}, releasedEntries_{0}
 {
     if (curState_ == State::VALID)
         throw std::invalid_argument("cannot initialize a dummy Evaluator with VALID state");
@@ -26,7 +27,7 @@ Evaluator::Evaluator(const State state) : impl_{nullptr}, curState_{state}
 
 Evaluator::Evaluator(std::unique_ptr<AbstractTemplate>&& tpl, const MappedRead& mr,
                      const double minZScore, const double scoreDiff)
-    : impl_{nullptr}, curState_{State::VALID}
+    : impl_{nullptr}, curState_{State::VALID}, releasedEntries_{0}
 {
     try {
         impl_ = std::make_unique<EvaluatorImpl>(std::move(tpl), mr, scoreDiff);
@@ -36,13 +37,19 @@ Evaluator::Evaluator(std::unique_ptr<AbstractTemplate>&& tpl, const MappedRead&
     }
 }
 
-Evaluator::Evaluator(Evaluator&& eval) : impl_{std::move(eval.impl_)}, curState_{eval.curState_} {}
+Evaluator::Evaluator(Evaluator&& eval)
+    : impl_{std::move(eval.impl_)}
+    , curState_{eval.curState_}
+    , releasedEntries_{eval.releasedEntries_}
+{
+}
 
 Evaluator& Evaluator::operator=(Evaluator&& eval)
 {
     if (eval == *this) return *this;
     impl_ = std::move(eval.impl_);
     curState_ = eval.curState_;
+    releasedEntries_ = eval.releasedEntries_;
     return *this;
 }
 
@@ -74,19 +81,10 @@ double Evaluator::LL(const Mutation& mut)
         return NEG_DBL_INF;
     }
 
-    // for multi-base mutations, invoke the entire machinery
-    else if (mut.EditDistance() > 1) {
-        boost::optional<MutatedTemplate> mutTpl = impl_->tpl_->Mutate(mut);
-        if (!mutTpl) return NEG_DBL_INF;
-        auto newTpl = std::make_unique<MutatedTemplate>(std::move(*mutTpl));
-        EvaluatorImpl tmp(std::move(newTpl), impl_->recursor_->read_, impl_->recursor_->scoreDiff_);
-        ll = tmp.LL();
-    }
-
-    // single-base mutations employ the alpha-beta stitching
-    else {
-        ll = impl_->LL(mut);
-    }
+    // stitch the mutated columns between alpha and beta, however many bases
+    // the mutation spans
+    ll = impl_->LL(mut);
+    if (std::isinf(ll)) ll = FullFillLL(mut);
 
     // If the mutation of interest caused a corner-case failure,
     // release this Evaluator and report this issue via an exception.
@@ -99,6 +97,43 @@ double Evaluator::LL(const Mutation& mut)
     return ll;
 }
 
+std::vector<double> Evaluator::LL(const std::vector<Mutation>& muts)
+{
+    if (!IsValid()) return std::vector<double>(muts.size(), NEG_DBL_INF);
+
+    std::vector<double> lls = impl_->LL(muts);
+
+    bool failed = false;
+    for (size_t m = 0; m < muts.size(); ++m) {
+        if (std::isinf(lls[m])) lls[m] = FullFillLL(muts[m]);
+        failed = failed || std::isinf(lls[m]);
+    }
+
+    if (failed) {
+        const std::string name = ReadName();
+        Invalidate();
+        throw InvalidEvaluatorException("negative inf in mutation testing: '" + name + "'");
+    }
+
+    return lls;
+}
+
+double Evaluator::FullFillLL(const Mutation& mut) const
+{
+    // a multi-base mutation can wander outside the band the stitching relies
+    // on; retry those with a full fill over the mutated template
+    if (mut.EditDistance() <= 1) return NEG_DBL_INF;
+
+    boost::optional<MutatedTemplate> mutTpl = impl_->tpl_->Mutate(mut);
+    if (!mutTpl) return NEG_DBL_INF;
+
+    auto newTpl = std::make_unique<MutatedTemplate>(std::move(*mutTpl));
+    EvaluatorImpl tmp(std::move(newTpl), impl_->recursor_->read_, impl_->recursor_->scoreDiff_);
+    const double ll = tmp.LL();
+    impl_->scratchEntries_ += tmp.FilledEntries();
+    return ll;
+}
+
 double Evaluator::LL() const
 {
     if (IsValid()) return impl_->LL();
@@ -128,6 +163,11 @@ int Evaluator::NumFlipFlops() const
     return NEG_INT_INF;
 }
 
+size_t Evaluator::FilledEntries() const
+{
+    return releasedEntries_ + (impl_ ? impl_->FilledEntries() : 0);
+}
+
 bool Evaluator::ApplyMutation(const Mutation& mut)
 {
     bool mutApplied = false;
@@ -163,7 +203,10 @@ void Evaluator::Status(State nextState)
     else
         PBLOG_ERROR << "Log this behaviour and return";
 
-    if (curState_ != State::VALID) impl_.reset(nullptr);
+    if (curState_ != State::VALID && impl_) {
+        releasedEntries_ += impl_->FilledEntries();
+        impl_.reset(nullptr);
+    }
 }
 
 void Evaluator::Release() { Status(State::MANUALLY_RELEASED); }
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -9,6 +10,7 @@
 
 #include <pacbio/align/LinearAlignment.h>
 #include <pacbio/exception/InvalidEvaluatorException.h>
+#include <pacbio/exception/StateError.h>
 
 #include "Constants.h"
 #include "EvaluatorImpl.h"
@@ -69,15 +71,50 @@ EvaluatorImpl::EvaluatorImpl(std::unique_ptr<AbstractTemplate>&& tpl, const Mapp
     , alpha_(mr.Length() + 1, tpl_->Length() + 1, ScaledMatrix::FORWARD)
     , beta_(mr.Length() + 1, tpl_->Length() + 1, ScaledMatrix::REVERSE)
     , extendBuffer_(mr.Length() + 1, EXTEND_BUFFER_COLUMNS, ScaledMatrix::FORWARD)
+    , scratchEntries_{0}
 {
-    numFlipFlops_ =
-        recursor_->FillAlphaBeta(*tpl_, alpha_, beta_, EARLY_ALPHA_BETA_MISMATCH_TOLERANCE);
+    numFlipFlops_ = FillAlphaBeta(EARLY_ALPHA_BETA_MISMATCH_TOLERANCE);
 }
 
 std::string EvaluatorImpl::ReadName() const { return recursor_->read_.Name; }
 
 double EvaluatorImpl::LL(const Mutation& mut)
 {
+    bool extended;
+    return LL(mut, nullptr, &extended);
+}
+
+std::vector<double> EvaluatorImpl::LL(const std::vector<Mutation>& muts)
+{
+    // A substitution and an insertion of the same bases at the same site
+    // extend alpha through the same columns but the last, so score them
+    // back to back and extend those columns once.  This is the common case
+    // of QV computation, which tests both at every site.
+    std::vector<size_t> order(muts.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&muts](const size_t lhs, const size_t rhs) {
+        const Mutation& l = muts[lhs];
+        const Mutation& r = muts[rhs];
+        if (l.Start() != r.Start()) return l.Start() < r.Start();
+        if (l.IsDeletion() != r.IsDeletion()) return r.IsDeletion();
+        return l.Bases() < r.Bases();
+    });
+
+    std::vector<double> lls(muts.size());
+    const Mutation* extended = nullptr;
+    for (const size_t m : order) {
+        bool isExtended;
+        lls[m] = LL(muts[m], extended, &isExtended);
+        extended = isExtended ? &muts[m] : nullptr;
+    }
+    return lls;
+}
+
+double EvaluatorImpl::LL(const Mutation& mut, const Mutation* const extended,
+                         bool* const isExtended)
+{
+    *isExtended = false;
+
     // if we've masked out the mutation then just return the ll as-is
     if (mask_.Contains(mut)) return LL();
 
@@ -96,12 +133,31 @@ double EvaluatorImpl::LL(const Mutation& mut)
     bool atBegin = mutTpl->MutationStart() < 3;
     bool atEnd = (mutTpl->MutationEnd() + 3) > beta_.Columns();
 
+    // multi-base mutations extend over more columns than the buffer
+    // is sized for; grow it once and keep it for later mutations
+    const auto reserveExtendColumns = [this](const size_t columns) {
+        if (extendBuffer_.Columns() < columns)
+            extendBuffer_.Reset(recursor_->read_.Length() + 1, columns);
+    };
+
     if (!atBegin && !atEnd) {
-        const size_t extendLength = 2;
+        // one column per inserted or substituted base, plus one to link
         const size_t extendStartCol = mutTpl->MutationStart() - mut.IsDeletion();
-
-        extendBuffer_.SetDirection(ScaledMatrix::FORWARD);
-        recursor_->ExtendAlpha(*mutTpl, alpha_, extendStartCol, extendBuffer_, extendLength);
+        const size_t extendLength = absoluteLinkColumn - extendStartCol;
+
+        // all but the last column only depend on the template up to and
+        // including the inserted or substituted bases
+        const bool sharesColumns = extended && !mut.IsDeletion() && !extended->IsDeletion() &&
+                                   extended->Start() == mut.Start() &&
+                                   extended->Bases() == mut.Bases();
+        const size_t firstExtendCol = sharesColumns ? extendLength - 1 : 0;
+
+        reserveExtendColumns(extendLength);
+        // keeps the log scales of the shared columns otherwise
+        if (!sharesColumns) extendBuffer_.SetDirection(ScaledMatrix::FORWARD);
+        recursor_->ExtendAlpha(*mutTpl, alpha_, extendStartCol, extendBuffer_, extendLength,
+                               firstExtendCol);
+        *isExtended = true;
         score = recursor_->LinkAlphaBeta(*mutTpl, extendBuffer_, extendLength, beta_, betaLinkCol,
                                          absoluteLinkColumn) +
                 alpha_.GetLogProdScales(0, extendStartCol);
@@ -113,6 +169,7 @@ double EvaluatorImpl::LL(const Mutation& mut)
         assert(mutTpl->Length() + 1 > extendStartCol);
         size_t extendLength = mutTpl->Length() - extendStartCol + 1;
 
+        reserveExtendColumns(extendLength);
         extendBuffer_.SetDirection(ScaledMatrix::FORWARD);
         recursor_->ExtendAlpha(*mutTpl, alpha_, extendStartCol, extendBuffer_, extendLength);
         score = std::log(extendBuffer_(recursor_->read_.Length(), extendLength - 1)) +
@@ -124,6 +181,7 @@ double EvaluatorImpl::LL(const Mutation& mut)
         // We duplicate this math inside the function
         size_t extendLength = 1 + mutTpl->MutationEnd() + mutTpl->LengthDiff();
 
+        reserveExtendColumns(extendLength);
         extendBuffer_.SetDirection(ScaledMatrix::REVERSE);
         recursor_->ExtendBeta(*mutTpl, beta_, extendLastCol, extendBuffer_, mutTpl->LengthDiff());
         score = std::log(extendBuffer_(0, 0)) +
@@ -150,6 +208,7 @@ double EvaluatorImpl::LL(const Mutation& mut)
         recursor_->FillAlpha(*mutTpl, ScaledMatrix::Null(), alphaP);
         score = std::log(alphaP(recursor_->read_.Length(), mutTpl->Length())) +
                 alphaP.GetLogProdScales();
+        scratchEntries_ += alphaP.FilledEntries();
     }
 
     return score + recursor_->UndoCounterWeights(recursor_->read_.Length());
@@ -161,6 +220,12 @@ double EvaluatorImpl::LL() const
            recursor_->UndoCounterWeights(recursor_->read_.Length());
 }
 
+size_t EvaluatorImpl::FilledEntries() const
+{
+    return alpha_.FilledEntries() + beta_.FilledEntries() + extendBuffer_.FilledEntries() +
+           scratchEntries_;
+}
+
 std::pair<double, double> EvaluatorImpl::NormalParameters() const
 {
     return tpl_->NormalParameters();
@@ -173,6 +238,21 @@ double EvaluatorImpl::ZScore() const
     return (LL() - mean) / std::sqrt(var);
 }
 
+size_t EvaluatorImpl::FillAlphaBeta(const double tol)
+{
+    if (alpha_.Precision() == CellPrecision::FLOAT) {
+        try {
+            return recursor_->FillAlphaBeta(*tpl_, alpha_, beta_, tol);
+        } catch (const AlphaBetaMismatch&) {
+            // the rounding errors of float cells add up over long templates
+            alpha_.SetPrecision(CellPrecision::DOUBLE);
+            beta_.SetPrecision(CellPrecision::DOUBLE);
+            extendBuffer_.SetPrecision(CellPrecision::DOUBLE);
+        }
+    }
+    return recursor_->FillAlphaBeta(*tpl_, alpha_, beta_, tol);
+}
+
 inline void EvaluatorImpl::Recalculate()
 {
     size_t I = recursor_->read_.Length() + 1;
@@ -180,13 +260,64 @@ inline void EvaluatorImpl::Recalculate()
     alpha_.Reset(I, J);
     beta_.Reset(I, J);
     extendBuffer_.Reset(I, EXTEND_BUFFER_COLUMNS);
-    recursor_->FillAlphaBeta(*tpl_, alpha_, beta_, ALPHA_BETA_MISMATCH_TOLERANCE);
+    FillAlphaBeta(ALPHA_BETA_MISMATCH_TOLERANCE);
+}
+
+void EvaluatorImpl::Recalculate(const std::vector<TemplatePosition>& oldTpl)
+{
+    const auto samePosition = [](const TemplatePosition& a, const TemplatePosition& b) {
+        return a.Base == b.Base && a.Match == b.Match && a.Branch == b.Branch &&
+               a.Stick == b.Stick && a.Deletion == b.Deletion;
+    };
+
+    const size_t oldJ = oldTpl.size();
+    const size_t J = tpl_->Length();
+    const size_t minJ = std::min(oldJ, J);
+
+    // Polishing only changes a few sites, find the unchanged ends of the template
+    size_t prefix = 0, suffix = 0;
+    while (prefix < minJ && samePosition(oldTpl[prefix], (*tpl_)[prefix]))
+        ++prefix;
+    while (suffix < minJ && samePosition(oldTpl[oldJ - 1 - suffix], (*tpl_)[J - 1 - suffix]))
+        ++suffix;
+
+    // Alpha column j depends on template positions [0, j], so the columns
+    // [0, prefix) are still valid. Beta column j depends on template
+    // positions [j - 1, J), so the last suffix columns are still valid once
+    // shifted by the length difference. The remaining old columns of either
+    // matrix are kept aligned with the new template for RefillAlphaBeta.
+    const size_t keptAlpha = prefix;
+    const size_t keptBeta = suffix;
+    if (keptAlpha + keptBeta == 0) {
+        Recalculate();
+        return;
+    }
+
+    const size_t maxKept = minJ + 1;
+    alpha_.KeepColumns(J + 1, keptAlpha, std::min(keptBeta, maxKept - keptAlpha));
+    beta_.KeepColumns(J + 1, std::min(keptAlpha, maxKept - keptBeta), keptBeta);
+    extendBuffer_.Reset(recursor_->read_.Length() + 1, EXTEND_BUFFER_COLUMNS);
+
+    // the refill cannot reband, if alpha and beta disagree start over
+    if (!recursor_->RefillAlphaBeta(*tpl_, alpha_, beta_, keptAlpha, keptBeta,
+                                    ALPHA_BETA_MISMATCH_TOLERANCE))
+        Recalculate();
+}
+
+std::vector<TemplatePosition> EvaluatorImpl::TemplatePositions() const
+{
+    std::vector<TemplatePosition> result;
+    result.reserve(tpl_->Length());
+    for (size_t i = 0; i < tpl_->Length(); ++i)
+        result.emplace_back((*tpl_)[i]);
+    return result;
 }
 
 bool EvaluatorImpl::ApplyMutation(const Mutation& mut)
 {
+    const auto oldTpl = TemplatePositions();
     if (tpl_->ApplyMutation(mut)) {
-        Recalculate();
+        Recalculate(oldTpl);
         mask_.Mutate({mut});
         return true;
     }
@@ -195,8 +326,9 @@ bool EvaluatorImpl::ApplyMutation(const Mutation& mut)
 
 bool EvaluatorImpl::ApplyMutations(std::vector<Mutation>* muts)
 {
+    const auto oldTpl = TemplatePositions();
     if (tpl_->ApplyMutations(muts)) {
-        Recalculate();
+        Recalculate(oldTpl);
         mask_.Mutate(*muts);
         return true;
     }
@@ -29,6 +29,9 @@ public:
     double LL(const Mutation& mut);
     double LL() const;
 
+    // LL(mut) for each of muts, sharing alpha extensions between them
+    std::vector<double> LL(const std::vector<Mutation>& muts);
+
     // Interval masking methods
     void MaskIntervals(size_t radius, double maxErrRate);
 
@@ -42,6 +45,10 @@ public:
 
     int NumFlipFlops() const { return numFlipFlops_; }
 
+    // The number of cells filled in all matrices so far, see
+    // Evaluator::FilledEntries
+    size_t FilledEntries() const;
+
 public:
     const AbstractMatrix& Alpha() const;
     const AbstractMatrix& Beta() const;
@@ -51,7 +58,21 @@ public:
     const AbstractMatrix* BetaView(MatrixViewConvention c) const;
 
 private:
+    // LL(mut), where extendBuffer_ holds the alpha extension of the
+    // previously scored mutation extended, if not null. Sets isExtended if
+    // extendBuffer_ holds the alpha extension of mut afterwards.
+    double LL(const Mutation& mut, const Mutation* extended, bool* isExtended);
+
+    // Fill alpha and beta from scratch to within tol. If they disagree with
+    // single-precision cells, switch all matrices to double precision and
+    // try again before giving up.
+    size_t FillAlphaBeta(double tol);
+    // Refill alpha and beta from scratch
     void Recalculate();
+    // Refill only the columns of alpha and beta affected by the change from
+    // oldTpl to the current template, falling back to Recalculate()
+    void Recalculate(const std::vector<TemplatePosition>& oldTpl);
+    std::vector<TemplatePosition> TemplatePositions() const;
 
 private:
     std::unique_ptr<AbstractTemplate> tpl_;
@@ -62,6 +83,7 @@ private:
     ScaledMatrix extendBuffer_;
 
     int numFlipFlops_;
+    size_t scratchEntries_;  // filled in matrices dropped after a single LL
 
     friend class Evaluator;
 };
@@ -1,16 +1,20 @@
 // Author: Brett Bowman
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <exception>
 #include <limits>
 #include <numeric>
+#include <string>
 #include <utility>
 
 #include <pacbio/consensus/AbstractMatrix.h>
 #include <pacbio/consensus/Integrator.h>
 #include <pacbio/data/Sequence.h>
 #include <pacbio/exception/InvalidEvaluatorException.h>
+#include <pacbio/parallel/ForkJoinPool.h>
 
 #include "Constants.h"
 #include "ModelFactory.h"
@@ -84,6 +88,72 @@ double Integrator::LL(const Mutation& fwdMut)
     return ll;
 }
 
+std::vector<double> Integrator::LL(const std::vector<Mutation>& fwdMuts, const size_t nThreads)
+{
+    std::vector<Mutation> revMuts;
+    revMuts.reserve(fwdMuts.size());
+    for (const auto& mut : fwdMuts)
+        revMuts.emplace_back(ReverseComplement(mut));
+
+    // Each Evaluator scores all mutations in one batch, sharing alpha
+    // extensions between those at the same site.  Evaluators are stateful
+    // during mutation testing, so each one is owned by a single thread;
+    // ownership is handed out dynamically to balance load.
+    const size_t nEvals = evals_.size();
+    const size_t nMuts = fwdMuts.size();
+    const size_t nWorkers = std::max<size_t>(1, std::min(nThreads, nEvals));
+    std::vector<char> active(nEvals);
+    for (size_t e = 0; e < nEvals; ++e)
+        active[e] = evals_[e].IsValid();
+    std::vector<std::string> failures(nEvals);
+    std::vector<std::exception_ptr> errors(nEvals);
+    std::atomic_size_t nextEval{0};
+
+    // A single worker visits the Evaluators in order and sums right away;
+    // several keep every per-Evaluator LL for the reduction below.
+    std::vector<double> lls(nMuts, 0.0);
+    std::vector<double> evalLLs((nWorkers > 1) ? nEvals * nMuts : 0);
+
+    const auto worker = [&]() {
+        for (size_t e; (e = nextEval++) < nEvals;) {
+            if (!active[e]) continue;
+            const auto& muts = (evals_[e].Strand() == StrandType::FORWARD) ? fwdMuts : revMuts;
+            try {
+                const std::vector<double> evalLL = evals_[e].LL(muts);
+                if (nWorkers > 1)
+                    std::copy(evalLL.cbegin(), evalLL.cend(), evalLLs.begin() + e * nMuts);
+                else
+                    for (size_t m = 0; m < nMuts; ++m)
+                        lls[m] += evalLL[m];
+            } catch (const InvalidEvaluatorException& ex) {
+                failures[e] = ex.what();
+            } catch (...) {
+                errors[e] = std::current_exception();
+            }
+        }
+    };
+
+    // the helpers of this thread wait for the next call, polishing scores
+    // mutations every round
+    PacBio::Parallel::ForkJoinPool::ThreadLocal().Run(nWorkers, worker);
+
+    for (const auto& error : errors)
+        if (error) std::rethrow_exception(error);
+
+    std::string failure;
+    for (const auto& f : failures)
+        if (!f.empty()) failure += (failure.empty() ? "" : "\n") + f;
+    if (!failure.empty()) throw InvalidEvaluatorException(failure);
+
+    // reduce in Evaluator order, exactly as LL(mut) does
+    if (nWorkers > 1) {
+        for (size_t m = 0; m < nMuts; ++m)
+            for (size_t e = 0; e < nEvals; ++e)
+                if (active[e]) lls[m] += evalLLs[e * nMuts + m];
+    }
+    return lls;
+}
+
 double Integrator::LL() const
 {
     const auto functor = [](const Evaluator& eval) { return eval.IsValid() ? eval.LL() : 0; };
@@ -223,8 +293,18 @@ std::vector<StrandType> Integrator::StrandTypes() const
     return TransformEvaluators<StrandType>([](const Evaluator& eval) { return eval.Strand(); });
 }
 
+size_t Integrator::NumEvaluators() const { return evals_.size(); }
+
 const Evaluator& Integrator::GetEvaluator(size_t idx) const { return evals_[idx]; }
 
+size_t Integrator::FilledEntries() const
+{
+    size_t entries = 0;
+    for (const auto& eval : evals_)
+        entries += eval.FilledEntries();
+    return entries;
+}
+
 const AbstractMatrix& Integrator::Alpha(size_t idx) const { return evals_[idx].Alpha(); }
 
 const AbstractMatrix& Integrator::Beta(size_t idx) const { return evals_[idx].Beta(); }
@@ -265,6 +345,16 @@ void Integrator::ApplyMutation(const Mutation& fwdMut)
     fwdTpl_ = ::PacBio::Consensus::ApplyMutations(fwdTpl_, &fwdMuts);
     revTpl_ = ::PacBio::Consensus::ApplyMutations(revTpl_, &revMuts);
 
+    // apply the mutations to the shared templates before the Evaluators
+    //   move their windows over them
+    for (auto& shared : stores_) {
+        if (!shared.Store) continue;
+        if (shared.Strand == StrandType::FORWARD)
+            shared.Store->ApplyMutation(fwdMut);
+        else if (shared.Strand == StrandType::REVERSE)
+            shared.Store->ApplyMutation(revMut);
+    }
+
     for (auto& eval : evals_) {
         if (eval.Strand() == StrandType::FORWARD)
             eval.ApplyMutation(fwdMut);
@@ -286,6 +376,16 @@ void Integrator::ApplyMutations(std::vector<Mutation>* fwdMuts)
     fwdTpl_ = ::PacBio::Consensus::ApplyMutations(fwdTpl_, fwdMuts);
     revTpl_ = ::PacBio::Consensus::ApplyMutations(revTpl_, &revMuts);
 
+    // apply the mutations to the shared templates before the Evaluators
+    //   move their windows over them
+    for (auto& shared : stores_) {
+        if (!shared.Store) continue;
+        if (shared.Strand == StrandType::FORWARD)
+            shared.Store->ApplyMutations(fwdMuts);
+        else if (shared.Strand == StrandType::REVERSE)
+            shared.Store->ApplyMutations(&revMuts);
+    }
+
     for (auto& eval : evals_) {
         if (eval.Strand() == StrandType::FORWARD)
             eval.ApplyMutations(fwdMuts);
@@ -305,18 +405,45 @@ std::unique_ptr<AbstractTemplate> Integrator::GetTemplate(const PacBio::Data::Ma
         const size_t start = read.TemplateStart;
         const size_t end = read.TemplateEnd;
 
-        return std::make_unique<Template>(fwdTpl_.substr(start, len), ModelFactory::Create(read),
-                                          start, end, read.PinStart, read.PinEnd);
+        auto model = ModelFactory::CreateShared(read);
+        if (auto store = Store(read.Strand, model))
+            return std::make_unique<TemplateView>(std::move(store), start, end, read.PinStart,
+                                                  read.PinEnd);
+        return std::make_unique<Template>(fwdTpl_.substr(start, len), std::move(model), start, end,
+                                          read.PinStart, read.PinEnd);
     } else if (read.Strand == StrandType::REVERSE) {
         const size_t start = revTpl_.size() - read.TemplateEnd;
         const size_t end = revTpl_.size() - read.TemplateStart;
 
-        return std::make_unique<Template>(revTpl_.substr(start, len), ModelFactory::Create(read),
-                                          start, end, read.PinEnd, read.PinStart);
+        auto model = ModelFactory::CreateShared(read);
+        if (auto store = Store(read.Strand, model))
+            return std::make_unique<TemplateView>(std::move(store), start, end, read.PinEnd,
+                                                  read.PinStart);
+        return std::make_unique<Template>(revTpl_.substr(start, len), std::move(model), start, end,
+                                          read.PinEnd, read.PinStart);
     }
 
     throw std::invalid_argument("read is unmapped!");
 }
 
+std::shared_ptr<TemplateStore> Integrator::Store(const StrandType strand,
+                                                 const std::shared_ptr<const ModelConfig>& model)
+{
+    for (auto& shared : stores_) {
+        if (shared.Strand != strand || shared.Model != model) continue;
+
+        // the second read of a strand and model starts the store, the first
+        // keeps its own Template
+        if (!shared.Store) {
+            const std::string& tpl = (strand == StrandType::FORWARD) ? fwdTpl_ : revTpl_;
+            shared.Store = std::make_shared<TemplateStore>(tpl, model);
+        }
+        return shared.Store;
+    }
+
+    stores_.emplace_back(SharedTemplate{strand, model, nullptr});
+    return nullptr;
+}
+
 }  // namespace Consensus
 }  // namespace PacBio
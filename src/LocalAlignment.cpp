@@ -4,9 +4,12 @@
 // SIMD local (Smith-Waterman) alignment
 //
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <utility>
 
+#include <ssw.h>
 #include <ssw_cpp.h>
 
 #include <pacbio/align/LocalAlignment.h>
@@ -21,6 +24,39 @@ static inline LocalAlignment FromSSW(StripedSmithWaterman::Alignment&& sswAl)
         sswAl.mismatches, sswAl.sw_score, std::move(sswAl.cigar), std::move(sswAl.cigar_string)};
 }
 
+namespace {  // anonymous
+
+// the base encoding and scoring matrix of StripedSmithWaterman::Aligner
+int8_t TranslateBase(const char base)
+{
+    switch (base) {
+        case 'A':
+        case 'a':
+        case 'U':  // sic, as in ssw_cpp
+        case 'u':
+            return 0;
+        case 'C':
+        case 'c':
+            return 1;
+        case 'G':
+        case 'g':
+            return 2;
+        case 'T':
+        case 't':
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+constexpr int32_t scoreMatrixSize = 5;
+
+// ssw_align only reports the second best alignment, which we do not use, for
+// mask lengths >= 15, and complains on stderr for shorter ones
+constexpr int32_t minMaskLength = 15;
+
+}  // namespace anonymous
+
 LocalAlignConfig LocalAlignConfig::Default() { return LocalAlignConfig{2, 2, 3, 1}; }
 
 LocalAlignment::LocalAlignment(const int32_t targetBegin, const int32_t targetEnd,
@@ -69,5 +105,125 @@ std::vector<LocalAlignment> LocalAlign(const std::string& target,
     return results;
 }
 
+// The translated query and its striped profile. ssw_init keeps pointers to
+// the query and the scoring matrix, so neither may move while profile lives.
+struct LocalAligner::Profile
+{
+    Profile(const std::string& query, const LocalAlignConfig& config)
+        : gapOpen{config.GapOpenPenalty}, gapExtend{config.GapExtendPenalty}
+    {
+        if (query.empty()) throw std::invalid_argument("LocalAligner: empty query");
+
+        for (int32_t i = 0; i < scoreMatrixSize; ++i)
+            for (int32_t j = 0; j < scoreMatrixSize; ++j)
+                matrix[i * scoreMatrixSize + j] =
+                    (i == j && i < scoreMatrixSize - 1)
+                        ? static_cast<int8_t>(config.MatchScore)
+                        : -static_cast<int8_t>(config.MismatchPenalty);
+
+        read.resize(query.size());
+        std::transform(query.cbegin(), query.cend(), read.begin(), TranslateBase);
+        profile =
+            ssw_init(read.data(), static_cast<int32_t>(read.size()), matrix, scoreMatrixSize, 2);
+    }
+
+    ~Profile() { init_destroy(profile); }
+
+    Profile(const Profile&) = delete;
+    Profile& operator=(const Profile&) = delete;
+
+    // aligns the profile to target, translated into ref; never returns null
+    s_align* Run(const std::string& target, const uint8_t flag)
+    {
+        ref.resize(target.size());
+        std::transform(target.cbegin(), target.cend(), ref.begin(), TranslateBase);
+
+        const auto readLen = static_cast<int32_t>(read.size());
+        s_align* al = ssw_align(profile, ref.data(), static_cast<int32_t>(ref.size()), gapOpen,
+                                gapExtend, flag, 0, 32767, std::max(readLen, minMaskLength));
+        if (al == nullptr) throw std::runtime_error("LocalAligner: SSW alignment failed");
+        return al;
+    }
+
+    uint8_t gapOpen;
+    uint8_t gapExtend;
+    int8_t matrix[scoreMatrixSize * scoreMatrixSize];
+    std::vector<int8_t> read;
+    std::vector<int8_t> ref;  // the last target, reused between alignments
+    s_profile* profile;
+};
+
+LocalAligner::LocalAligner(const std::string& query, const LocalAlignConfig& config)
+    : profile_{new Profile(query, config)}
+{
+}
+
+LocalAligner::LocalAligner(LocalAligner&&) = default;
+
+LocalAligner& LocalAligner::operator=(LocalAligner&&) = default;
+
+LocalAligner::~LocalAligner(void) = default;
+
+LocalAlignment LocalAligner::Align(const std::string& target)
+{
+    if (target.empty()) return LocalAlignment{0, 0, 0, 0, 0, 0, {}, {}};
+
+    // begin positions and CIGAR, see SetFlag in ssw_cpp
+    std::unique_ptr<s_align, void (*)(s_align*)> al{profile_->Run(target, 0x0f), align_destroy};
+
+    const auto& read = profile_->read;
+    const auto readLen = static_cast<int32_t>(read.size());
+    int32_t mismatches = 0;
+    std::vector<uint32_t> cigar;
+    if (al->cigarLen > 0) {
+        // soft clips the query and splits M into = and X, as
+        // StripedSmithWaterman::Aligner does
+        mismatches =
+            mark_mismatch(al->ref_begin1, al->read_begin1, al->read_end1, profile_->ref.data(),
+                          read.data(), readLen, &al->cigar, &al->cigarLen);
+        cigar.assign(al->cigar, al->cigar + al->cigarLen);
+    } else {
+        if (al->read_begin1 > 0) cigar.push_back(to_cigar_int(al->read_begin1, 'S'));
+        const int32_t end = readLen - al->read_end1 - 1;
+        if (end > 0) cigar.push_back(to_cigar_int(end, 'S'));
+    }
+
+    std::string cigarString;
+    for (const auto op : cigar)
+        cigarString += std::to_string(cigar_int_to_len(op)) + cigar_int_to_op(op);
+
+    return LocalAlignment{al->ref_begin1, al->ref_end1, al->read_begin1,  al->read_end1,
+                          mismatches,     al->score1,   std::move(cigar), std::move(cigarString)};
+}
+
+std::vector<LocalAlignment> LocalAligner::Align(const std::vector<std::string>& targets)
+{
+    std::vector<LocalAlignment> results;
+    results.reserve(targets.size());
+    for (const auto& target : targets)
+        results.push_back(Align(target));
+    return results;
+}
+
+uint16_t LocalAligner::Score(const std::string& target)
+{
+    if (target.empty()) return 0;
+
+    // scores and end positions only
+    s_align* al = profile_->Run(target, 0);
+    const uint16_t score = al->score1;
+    align_destroy(al);
+    return score;
+}
+
+std::vector<uint16_t> LocalAligner::Score(const std::vector<std::string>& targets)
+{
+    std::vector<uint16_t> scores;
+    scores.reserve(targets.size());
+    for (const auto& target : targets)
+        scores.push_back(Score(target));
+    return scores;
+}
+
 }  // namespace Align
 }  // namespace PacBio
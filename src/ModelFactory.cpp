@@ -1,5 +1,6 @@
 // Author: Lance Hepler
 
+#include <cmath>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -52,22 +53,135 @@ void LoadBundleModels()
 }
 }
 
-std::unique_ptr<ModelConfig> ModelFactory::Create(const std::string& name, const SNR& snr)
+ModelConfigCache::ModelConfigCache(const size_t capacity, const double snrResolution)
+    : capacity_{capacity}, snrResolution_{snrResolution}
+{
+}
+
+void ModelConfigCache::Configure(const size_t capacity, const double snrResolution)
+{
+    if (snrResolution < 0.0) throw std::invalid_argument("SNR resolution must be >= 0");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    snrResolution_ = snrResolution;
+    entries_.clear();
+    index_.clear();
+    hits_ = misses_ = 0;
+}
+
+void ModelConfigCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    hits_ = misses_ = 0;
+}
+
+SNR ModelConfigCache::Quantize(const SNR& snr) const
+{
+    double resolution;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        resolution = snrResolution_;
+    }
+    if (resolution == 0.0) return snr;
+
+    SNR result(snr);
+    for (size_t i = 0; i < 4; ++i)
+        result[i] = std::round(snr[i] / resolution) * resolution;
+    return result;
+}
+
+std::shared_ptr<const ModelConfig> ModelConfigCache::Get(const std::string& name, const SNR& snr,
+                                                         const ModelCreator& creator)
+{
+    const SNR quantized = Quantize(snr);
+    const Key key{name, quantized.A, quantized.C, quantized.G, quantized.T};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = index_.find(key);
+        if (it != index_.end()) {
+            ++hits_;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+        ++misses_;
+    }
+
+    // create the model outside of the lock, as other threads may need
+    //   other models meanwhile; if two threads miss the same model, the
+    //   first one inserted is kept
+    std::shared_ptr<const ModelConfig> model = creator.Create(quantized);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) return model;
+    const auto it = index_.find(key);
+    if (it != index_.end()) return it->second->second;
+
+    entries_.emplace_front(key, model);
+    index_.emplace(key, entries_.begin());
+    if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    return model;
+}
+
+size_t ModelConfigCache::Capacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+double ModelConfigCache::SnrResolution() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return snrResolution_;
+}
+
+size_t ModelConfigCache::Size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t ModelConfigCache::Hits() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t ModelConfigCache::Misses() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+const ModelCreator& ModelFactory::FindCreator(const std::string& name, std::string* model)
 {
     // Load update bundle models before we create anything
     LoadBundleModels();
 
-    boost::optional<std::string> model(boost::none);
+    boost::optional<std::string> resolved(boost::none);
 
-    if (!(model = ModelOverride()))
-        if (!(model = Resolve(name))) throw ChemistryNotFound(name);
+    if (!(resolved = ModelOverride()))
+        if (!(resolved = Resolve(name))) throw ChemistryNotFound(name);
 
     const auto& tbl = CreatorTable();
-    const auto it = tbl.find(*model);
+    const auto it = tbl.find(*resolved);
 
     if (it == tbl.end()) throw ChemistryNotFound(name);
 
-    return it->second->Create(snr);
+    *model = *resolved;
+    return *it->second;
+}
+
+std::unique_ptr<ModelConfig> ModelFactory::Create(const std::string& name, const SNR& snr)
+{
+    std::string model;
+    return FindCreator(name, &model).Create(snr);
 }
 
 std::unique_ptr<ModelConfig> ModelFactory::Create(const PacBio::Data::Read& read)
@@ -75,6 +189,25 @@ std::unique_ptr<ModelConfig> ModelFactory::Create(const PacBio::Data::Read& read
     return Create(read.Model, read.SignalToNoise);
 }
 
+std::shared_ptr<const ModelConfig> ModelFactory::CreateShared(const std::string& name,
+                                                              const SNR& snr)
+{
+    std::string model;
+    const ModelCreator& creator = FindCreator(name, &model);
+    return Cache().Get(model, snr, creator);
+}
+
+std::shared_ptr<const ModelConfig> ModelFactory::CreateShared(const PacBio::Data::Read& read)
+{
+    return CreateShared(read.Model, read.SignalToNoise);
+}
+
+ModelConfigCache& ModelFactory::Cache()
+{
+    static ModelConfigCache cache;
+    return cache;
+}
+
 bool ModelFactory::Register(const ModelName& name, std::unique_ptr<ModelCreator>&& ctor)
 {
     return CreatorTable().emplace(name, std::move(ctor)).second;
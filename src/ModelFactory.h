@@ -4,10 +4,14 @@
 
 #include "UnanimityInternalConfig.h"
 
+#include <cstddef>
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <tuple>
 
 #include <boost/optional.hpp>
 
@@ -42,6 +46,49 @@ public:
     virtual std::unique_ptr<ModelConfig> Create(const SNR&) const = 0;
 };
 
+// A bounded, thread-safe cache of concrete models, keyed by the resolved
+//   model name and the SNR rounded to a multiple of the SNR resolution.
+//   Models are immutable once created, so the reads of a ZMW, which share
+//   their SNR, can share one model and its precomputed counter weight.
+//   The least recently used model is dropped once the cache is full.
+class ModelConfigCache
+{
+public:
+    ModelConfigCache(size_t capacity = 256, double snrResolution = 0.0);
+
+    // Sets the number of cached models and the SNR resolution, where a
+    //   resolution of 0 only shares models between identical SNRs.
+    //   Clears the cache and its counters.
+    void Configure(size_t capacity, double snrResolution);
+    void Clear();
+
+    // The SNR a model is created for: snr rounded to the resolution
+    SNR Quantize(const SNR& snr) const;
+
+    // The cached model of name at the quantized snr, created by creator
+    //   on a miss
+    std::shared_ptr<const ModelConfig> Get(const std::string& name, const SNR& snr,
+                                           const ModelCreator& creator);
+
+    size_t Capacity() const;
+    double SnrResolution() const;
+    size_t Size() const;
+    size_t Hits() const;
+    size_t Misses() const;
+
+private:
+    using Key = std::tuple<std::string, double, double, double, double>;
+    using Entry = std::pair<Key, std::shared_ptr<const ModelConfig>>;
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    double snrResolution_;
+    std::list<Entry> entries_;  // most recently used first
+    std::map<Key, std::list<Entry>::iterator> index_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
 // A static class containing the map of parameterized models that need
 //   only SNR to become concrete, with methods to create such models,
 //   register models, resolve models, and list available models
@@ -50,12 +97,18 @@ class ModelFactory
 public:
     static std::unique_ptr<ModelConfig> Create(const std::string& name, const SNR&);
     static std::unique_ptr<ModelConfig> Create(const PacBio::Data::Read& read);
+    // Like Create, but shares the models through Cache()
+    static std::shared_ptr<const ModelConfig> CreateShared(const std::string& name, const SNR&);
+    static std::shared_ptr<const ModelConfig> CreateShared(const PacBio::Data::Read& read);
+    static ModelConfigCache& Cache();
     static bool Register(const ModelName& name, std::unique_ptr<ModelCreator>&& ctor);
     static boost::optional<std::string> Resolve(const std::string& name);
     static std::set<std::string> SupportedModels();
 
 private:
     static std::map<ModelName, std::unique_ptr<ModelCreator>>& CreatorTable();
+    // The creator of the model name resolves to, storing the resolved name
+    static const ModelCreator& FindCreator(const std::string& name, std::string* model);
 };
 
 // The concrete form of ModelCreator, which registers a compiled-in
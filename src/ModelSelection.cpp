@@ -3,6 +3,7 @@
 #include <mutex>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <dirent.h>
@@ -46,6 +47,17 @@ bool UnOverrideModel()
     return true;
 }
 
+void ConfigureModelCache(const size_t capacity, const double snrResolution)
+{
+    ModelFactory::Cache().Configure(capacity, snrResolution);
+}
+
+std::pair<size_t, size_t> ModelCacheStatistics()
+{
+    const auto& cache = ModelFactory::Cache();
+    return {cache.Hits(), cache.Misses()};
+}
+
 bool LoadModelFromFile(const std::string& path, const ModelOrigin origin)
 {
     struct stat st;
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include "MutationSelector.h"
+
+namespace PacBio {
+namespace Consensus {
+
+MutationSelector::MutationSelector(const size_t separation) : separation_{separation}
+{
+    // TODO handle 0-separation correctly
+    if (separation_ == 0) throw std::invalid_argument("nonzero separation required");
+}
+
+bool MutationSelector::TryAdd(const Mutation& mut)
+{
+    // a selected mutation m is in the way if
+    //
+    //     m.Start() - separation <= mut.End() && mut.Start() < m.End() + separation
+    //
+    // the first holds for all selected mutations up to the one found here,
+    // the second one then holds for any of them iff it holds for this one
+    auto it = index_.upper_bound(mut.End() + separation_);
+    if (it != index_.begin() && mut.Start() < std::prev(it)->second + separation_) return false;
+
+    index_.emplace(mut.Start(), mut.End());
+    selected_.emplace_back(mut);
+    return true;
+}
+
+std::vector<Mutation> BestMutations(std::vector<ScoredMutation> scoredMuts, const size_t separation)
+{
+    MutationSelector selector(separation);
+
+    std::stable_sort(scoredMuts.begin(), scoredMuts.end(),
+                     [](const ScoredMutation& lhs, const ScoredMutation& rhs) {
+                         return ScoredMutation::ScoreComparer(rhs, lhs);
+                     });
+    for (const auto& mut : scoredMuts)
+        selector.TryAdd(mut);
+
+    return selector.Selected();
+}
+
+}  // namespace Consensus
+}  // namespace PacBio
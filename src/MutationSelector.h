@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+#include <pacbio/consensus/Mutation.h>
+
+namespace PacBio {
+namespace Consensus {
+
+///
+/// Collects mutations that are at least a separation apart.
+///
+/// A mutation is rejected if it starts before End() + separation of a
+/// selected one and ends at or after its Start() - separation. Selected
+/// mutations never nest, so when indexed on Start() their End() increases
+/// too, and the only selected mutation that can be in the way of a
+/// candidate is the last one starting at or before its End() + separation.
+/// This makes each TryAdd O(log n).
+///
+class MutationSelector
+{
+public:
+    explicit MutationSelector(size_t separation);
+
+    /// Selects mut, unless it is within the separation of a selected mutation.
+    /// Returns whether mut was selected.
+    bool TryAdd(const Mutation& mut);
+
+    /// The selected mutations, in the order they were added.
+    const std::vector<Mutation>& Selected() const { return selected_; }
+
+private:
+    size_t separation_;
+    std::vector<Mutation> selected_;
+    // Start() -> End() of the selected mutations
+    std::map<size_t, size_t> index_;
+};
+
+/// Greedily picks the best-scoring mutation and drops all mutations within
+/// separation of it, until none are left. Mutations with equal scores are
+/// picked in the order given. Returns the picked mutations, best first.
+///
+/// Runs in O(n log n) for n scored mutations.
+std::vector<Mutation> BestMutations(std::vector<ScoredMutation> scoredMuts, size_t separation);
+
+}  // namespace Consensus
+}  // namespace PacBio
@@ -1,14 +1,15 @@
 // Author: Lance Hepler
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <functional>
 #include <iterator>
 #include <limits>
-#include <list>
 #include <set>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <boost/math/distributions/chi_squared.hpp>
@@ -20,9 +21,9 @@
 #include <pacbio/consensus/Polish.h>
 #include <pacbio/exception/InvalidEvaluatorException.h>
 
+#include "MutationSelector.h"
 #include "MutationTracker.h"
 
-using std::list;
 using std::pair;
 using std::set;
 using std::string;
@@ -35,19 +36,21 @@ namespace PacBio {
 namespace Consensus {
 
 PolishConfig::PolishConfig(const size_t iterations, const size_t separation,
-                           const size_t neighborhood, const bool diploid)
+                           const size_t neighborhood, const bool diploid, const size_t threads)
     : MaximumIterations(iterations)
     , MutationSeparation(separation)
     , MutationNeighborhood(neighborhood)
     , Diploid(diploid)
+    , NumThreads(threads)
 {
 }
 
 RepeatConfig::RepeatConfig(const size_t repeatSize, const size_t elementCount,
-                           const size_t iterations)
+                           const size_t iterations, const size_t threads)
     : MaximumRepeatSize{repeatSize}
     , MinimumElementCount{elementCount}
     , MaximumIterations{iterations}
+    , NumThreads{threads}
 {
 }
 
@@ -162,29 +165,6 @@ vector<Mutation> RepeatMutations(const Integrator& ai, const RepeatConfig& cfg)
     return RepeatMutations(ai, cfg, 0, ai.TemplateLength());
 }
 
-vector<Mutation> BestMutations(list<ScoredMutation>* scoredMuts, const size_t separation)
-{
-    vector<Mutation> result;
-
-    // TODO handle 0-separation correctly
-    if (separation == 0) throw std::invalid_argument("nonzero separation required");
-
-    while (!scoredMuts->empty()) {
-        const auto& mut =
-            *max_element(scoredMuts->begin(), scoredMuts->end(), ScoredMutation::ScoreComparer);
-
-        result.emplace_back(mut);
-
-        const size_t start = (separation < mut.Start()) ? mut.Start() - separation : 0;
-        const size_t end = mut.End() + separation;
-
-        scoredMuts->remove_if(
-            [start, end](const ScoredMutation& m) { return start <= m.End() && m.Start() < end; });
-    }
-
-    return result;
-}
-
 vector<Mutation> NearbyMutations(vector<Mutation>* applied, vector<Mutation>* centers,
                                  const Integrator& ai, const size_t neighborhood,
                                  const bool diploid = false)
@@ -286,8 +266,8 @@ PolishResult Polish(Integrator* ai, const PolishConfig& cfg)
     for (size_t i = 0; i < cfg.MaximumIterations; ++i) {
         // find the best mutations given our parameters
         {
-            list<ScoredMutation> scoredMuts;
-            int mutationsTested = 0;
+            vector<ScoredMutation> scoredMuts;
+            size_t mutationsTested = 0;
             bool hasNewInvalidEvaluator;
 
             // Compute new sets of possible mutations until no Evaluators are
@@ -299,11 +279,12 @@ PolishResult Polish(Integrator* ai, const PolishConfig& cfg)
                 hasNewInvalidEvaluator = false;
                 try {
                     // Get set of possible mutations
-                    for (const auto& mut : muts) {
-                        ++mutationsTested;
-                        const double ll = ai->LL(mut);
-                        if (ll - LL > (mut.IsDeletion() ? 0 : minImprovementThreshold))
-                            scoredMuts.emplace_back(mut.WithScore(ll));
+                    const vector<double> lls = ai->LL(muts, cfg.NumThreads);
+                    mutationsTested += muts.size();
+                    for (size_t j = 0; j < muts.size(); ++j) {
+                        const auto& mut = muts[j];
+                        if (lls[j] - LL > (mut.IsDeletion() ? 0 : minImprovementThreshold))
+                            scoredMuts.emplace_back(mut.WithScore(lls[j]));
                     }
                 } catch (const Exception::InvalidEvaluatorException& e) {
                     // If an Evaluator exception occured,
@@ -318,7 +299,7 @@ PolishResult Polish(Integrator* ai, const PolishConfig& cfg)
             result.mutationsTested += mutationsTested;
 
             // take best mutations in separation window, apply them
-            muts = BestMutations(&scoredMuts, cfg.MutationSeparation);
+            muts = BestMutations(std::move(scoredMuts), cfg.MutationSeparation);
         }
 
         // convergence!!
@@ -401,9 +382,11 @@ PolishResult PolishRepeats(Integrator* const ai, const RepeatConfig& cfg)
             const double LL = ai->LL();
             hasNewInvalidEvaluator = false;
             try {
-                for (const auto& mut : muts) {
-                    const double ll = ai->LL(mut);
-                    if (ll > LL && (!bestMut || bestMut->Score < ll)) bestMut = mut.WithScore(ll);
+                const vector<double> lls = ai->LL(muts, cfg.NumThreads);
+                for (size_t j = 0; j < muts.size(); ++j) {
+                    const double ll = lls[j];
+                    if (ll > LL && (!bestMut || bestMut->Score < ll))
+                        bestMut = muts[j].WithScore(ll);
                 }
             } catch (const Exception::InvalidEvaluatorException& e) {
                 PBLOG_INFO << e.what();
@@ -446,86 +429,106 @@ inline int ScoreSumToQV(const double scoreSum)
     return ProbabilityToQV(1.0 - 1.0 / (1.0 + scoreSum));
 }
 
-}  // anonymous namespace
-
-vector<int> ConsensusQualities(Integrator& ai)
+// Sites whose candidate mutations are scored in one batch; bounds the
+// per-Evaluator LLs kept when scoring with several threads
+static constexpr const size_t QV_SITES_PER_BATCH = 256;
+
+// Scores the candidate mutations of every template site, and calls
+// visit(site, mut, score) with score = LL(mut) - LL for each.
+//
+// Each Evaluator scores a batch of sites at once, extending alpha once for
+// the substitution and the insertion of the same base at a site, and the
+// Evaluators are spread over nThreads threads.
+void ScoreSites(Integrator& ai, const size_t nThreads, const char* const caller,
+                const std::function<void(size_t, const Mutation&, double)>& visit)
 {
-    vector<int> quals;
-    quals.reserve(ai.TemplateLength());
-    const double LL = ai.LL();
-    for (size_t i = 0; i < ai.TemplateLength(); ++i) {
-        double scoreSum = 0.0;
-        for (const auto& m : Mutations(ai, i, i + 1)) {
+    const size_t len = ai.TemplateLength();
+    vector<Mutation> muts;
+    vector<size_t> sites;
+    vector<double> lls;
+
+    for (size_t begin = 0; begin < len; begin += QV_SITES_PER_BATCH) {
+        const size_t end = std::min(begin + QV_SITES_PER_BATCH, len);
+
+        muts.clear();
+        sites.clear();
+        for (size_t i = begin; i < end; ++i) {
+            const size_t first = muts.size();
+            Mutations(&muts, ai, i, i + 1);
             // skip mutations that start beyond the current site (e.g. trailing insertions)
-            if (m.Start() > i) continue;
-            // TODO (lhepler): this is dumb, but untestable mutations,
-            //   aka insertions at ends, cause all sorts of weird issues
-            // See also: Polish::ConsensusQVs(ai)
-            double score;
+            muts.erase(std::remove_if(muts.begin() + first, muts.end(),
+                                      [i](const Mutation& m) { return m.Start() > i; }),
+                       muts.end());
+            sites.resize(muts.size(), i);
+        }
+
+        // TODO (lhepler): this is dumb, but untestable mutations,
+        //   aka insertions at ends, cause all sorts of weird issues
+        double LL;
+        for (;;) {
+            LL = ai.LL();
             try {
-                score = ai.LL(m) - LL;
+                lls = ai.LL(muts, nThreads);
+                break;
             } catch (const Exception::InvalidEvaluatorException& e) {
-                // If an Evaluator exception occured, report and skip!
-                // We need to handle this!
-                std::string error = "In Polish::ConsensusQualities(ai): ";
-                error += e.what();
-                PBLOG_ERROR << error;
-                continue;
+                // If an Evaluator exception occured, report and
+                // retry without the problematic Evaluators
+                PBLOG_ERROR << "In Polish::" << caller << "(ai): " << e.what();
             }
-            assert(score <= 0.0);
-
-            if (score < 0) scoreSum += exp(score);
         }
-        quals.emplace_back(ScoreSumToQV(scoreSum));
+
+        for (size_t m = 0; m < muts.size(); ++m)
+            visit(sites[m], muts[m], lls[m] - LL);
     }
+}
+
+}  // anonymous namespace
+
+vector<int> ConsensusQualities(Integrator& ai, const size_t nThreads)
+{
+    vector<double> scoreSums(ai.TemplateLength(), 0.0);
+    ScoreSites(ai, nThreads, "ConsensusQualities",
+               [&scoreSums](const size_t i, const Mutation&, const double score) {
+                   assert(score <= 0.0);
+                   if (score < 0) scoreSums[i] += exp(score);
+               });
+
+    vector<int> quals;
+    quals.reserve(scoreSums.size());
+    for (const double scoreSum : scoreSums)
+        quals.emplace_back(ScoreSumToQV(scoreSum));
     return quals;
 }
 
-QualityValues ConsensusQVs(Integrator& ai)
+QualityValues ConsensusQVs(Integrator& ai, const size_t nThreads)
 {
     const size_t len = ai.TemplateLength();
+    vector<double> qualScoreSums(len, 0.0), delScoreSums(len, 0.0), insScoreSums(len, 0.0),
+        subScoreSums(len, 0.0);
+    ScoreSites(ai, nThreads, "ConsensusQVs",
+               [&](const size_t i, const Mutation& m, const double score) {
+                   // this really should never happen
+                   if (score >= 0.0) return;
+                   const double expScore = exp(score);
+                   qualScoreSums[i] += expScore;
+                   if (m.IsDeletion())
+                       delScoreSums[i] += expScore;
+                   else if (m.Start() == m.End())
+                       insScoreSums[i] += expScore;
+                   else
+                       subScoreSums[i] += expScore;
+               });
+
     vector<int> quals, delQVs, insQVs, subQVs;
     quals.reserve(len);
     delQVs.reserve(len);
     insQVs.reserve(len);
     subQVs.reserve(len);
-    const double LL = ai.LL();
     for (size_t i = 0; i < len; ++i) {
-        double qualScoreSum = 0.0, delScoreSum = 0.0, insScoreSum = 0.0, subScoreSum = 0.0;
-        for (const auto& m : Mutations(ai, i, i + 1)) {
-            // skip mutations that start beyond the current site (e.g. trailing insertions)
-            if (m.Start() > i) continue;
-
-            // TODO (lhepler): this is dumb, but untestable mutations,
-            //   aka insertions at ends, cause all sorts of weird issues
-            // See also: Polish::ConsensusQualities(ai)
-            double score;
-            try {
-                score = ai.LL(m) - LL;
-            } catch (const Exception::InvalidEvaluatorException& e) {
-                // If an Evaluator exception occured, report and skip!
-                // We need to handle this!
-                std::string error = "In Polish::ConsensusQVs(ai): ";
-                error += e.what();
-                PBLOG_ERROR << error;
-                continue;
-            }
-
-            // this really should never happen
-            if (score >= 0.0) continue;
-            const double expScore = exp(score);
-            qualScoreSum += expScore;
-            if (m.IsDeletion())
-                delScoreSum += expScore;
-            else if (m.Start() == m.End())
-                insScoreSum += expScore;
-            else
-                subScoreSum += expScore;
-        }
-        quals.emplace_back(ScoreSumToQV(qualScoreSum));
-        delQVs.emplace_back(ScoreSumToQV(delScoreSum));
-        insQVs.emplace_back(ScoreSumToQV(insScoreSum));
-        subQVs.emplace_back(ScoreSumToQV(subScoreSum));
+        quals.emplace_back(ScoreSumToQV(qualScoreSums[i]));
+        delQVs.emplace_back(ScoreSumToQV(delScoreSums[i]));
+        insQVs.emplace_back(ScoreSumToQV(insScoreSums[i]));
+        subQVs.emplace_back(ScoreSumToQV(subScoreSums[i]));
     }
     // TODO(lhepler): discuss InsQV being len + 1 to capture trailing insertion
     return QualityValues{std::move(quals), std::move(delQVs), std::move(insQVs), std::move(subQVs)};
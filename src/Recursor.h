@@ -3,9 +3,12 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <climits>
+#include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include <pacbio/UnanimityConfig.h>
 
@@ -13,6 +16,8 @@
 #include <pacbio/data/Read.h>
 #include <pacbio/exception/StateError.h>
 
+#include "RecursorKernels.h"
+#include "matrix/BufferPool.h"
 #include "matrix/ScaledMatrix.h"
 
 // "Wer mit Ungeheuern kämpft, mag zusehn, dass er nicht dabei zum Ungeheuer wird.
@@ -60,6 +65,28 @@ public:
     /// Returns the number of flip flop events (refilling events).
     size_t FillAlphaBeta(const AbstractTemplate& tpl, M& alpha, M& beta, double tol) const;
 
+    /// \brief Refill the alpha and beta matrices after a template change.
+    ///
+    /// The first keptAlphaColumns columns of alpha and the last
+    /// keptBetaColumns columns of beta must hold valid values for tpl, only
+    /// the remaining columns are refilled. The other columns of the matrices
+    /// outside those ranges may hold the values from before the template
+    /// change, that is the last keptBetaColumns columns of alpha and the first
+    /// keptAlphaColumns columns of beta. Once a refilled column is identical
+    /// to the old one it replaces, the remaining old columns follow from it
+    /// by the same recursion, so they are reused and only their scales are
+    /// adjusted. They keep the bands they were filled with, which were
+    /// guided by the matrices from before the change, so they match a full
+    /// refill within those bands, while a full refill may band them
+    /// differently. A change thus costs in proportion to how far its effect
+    /// on the matrices reaches rather than the template length.
+    ///
+    /// Unlike FillAlphaBeta no flip flops are attempted: returns false if the
+    /// scores of alpha and beta disagree, in which case the caller should
+    /// start over with FillAlphaBeta.
+    bool RefillAlphaBeta(const AbstractTemplate& tpl, M& alpha, M& beta, size_t keptAlphaColumns,
+                         size_t keptBetaColumns, double tol) const;
+
     /// \brief Fill in the alpha matrix.
     ///
     /// This matrix has the read run along the rows and the template run along
@@ -91,7 +118,10 @@ public:
     ///              "bands" for the banded algorithm used. This is typically
     ///              the beta matrix if we are "repopulating" the matrix.
     /// \param alpha The matrix to be filled.
-    void FillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha) const;
+    /// \param beginColumn, endColumn Only fill the columns [beginColumn,
+    ///              endColumn), the columns before beginColumn must be valid.
+    void FillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha, size_t beginColumn = 0,
+                   size_t endColumn = std::numeric_limits<size_t>::max()) const;
 
     /// \brief Fill the Beta matrix.
     /// That is the backwards half of the forward-backward algorithm.
@@ -111,7 +141,10 @@ public:
     /// \param M    the guide matrix for banding (this needs more documentation)
     /// \param beta The Beta matrix, stored as either a DenseMatrix or a
     ///             SparseMatrix.
-    void FillBeta(const AbstractTemplate& tpl, const M& guide, M& beta) const;
+    /// \param beginColumn, endColumn Only fill the columns [beginColumn,
+    ///              endColumn), the columns from endColumn on must be valid.
+    void FillBeta(const AbstractTemplate& tpl, const M& guide, M& beta, size_t beginColumn = 0,
+                  size_t endColumn = std::numeric_limits<size_t>::max()) const;
 
     /// \brief Calculate the recursion score by "linking" partial alpha and/or
     ///        beta matrices.
@@ -123,23 +156,80 @@ public:
     ///
     /// \param alpha         The alpha matrix
     /// \param beginColumn   The column where extension should start
-    /// \param ext           The matrix to be extended
+    /// \param ext           The matrix to be extended, with at least
+    ///                      numExtColumns columns
     /// \param numExtColumns The number of columns to be extended
+    /// \param firstExtColumn Columns [0, firstExtColumn) of ext already hold
+    ///                      this extension, e.g. for another mutation that
+    ///                      only differs from tpl in later columns
     void ExtendAlpha(const AbstractTemplate& tpl, const M& alpha, size_t beginColumn, M& ext,
-                     size_t numExtColumns = 2) const;
+                     size_t numExtColumns = 2, size_t firstExtColumn = 0) const;
 
     /// This method extends the Beta matrix into a temporary matrix given by ext.
     ///
     /// \param beta       The beta matrix
     /// \param endColumn  The right-hand side where extension should start
-    /// \param ext        The matrix to be extended
+    /// \param ext        The matrix to be extended, with at least
+    ///                   1 + endColumn + lengthDiff columns
     /// \param lengthDiff The length difference of the mutation
     void ExtendBeta(const AbstractTemplate& tpl, const M& beta, size_t endColumn, M& ext,
                     int lengthDiff = 0) const;
 
 private:
+    // The cells of the matrices are accessed through the typed views of
+    // BandedMatrix::WithCells, the public methods dispatch on the cell
+    // precision once and forward to these.
+
+    /// The reference implementations, filling cell by cell.
+    template <typename Cells>
+    void FillAlphaScalar(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                         const Cells& alphaCells, size_t beginColumn, size_t endColumn) const;
+    template <typename Cells>
+    void FillBetaScalar(const AbstractTemplate& tpl, const M& guide, M& beta,
+                        const Cells& betaCells, size_t beginColumn, size_t endColumn) const;
+
+    /// The vectorized implementations, see FillKernel::VECTORIZED.
+    template <typename Cells>
+    void FillAlphaVectorized(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                             const Cells& alphaCells, size_t beginColumn, size_t endColumn) const;
+    template <typename Cells>
+    void FillBetaVectorized(const AbstractTemplate& tpl, const M& guide, M& beta,
+                            const Cells& betaCells, size_t beginColumn, size_t endColumn) const;
+
+    template <typename AlphaCells, typename BetaCells>
+    double LinkAlphaBetaCells(const AbstractTemplate& tpl, const M& alpha,
+                              const AlphaCells& alphaCells, size_t alphaColumn, const M& beta,
+                              const BetaCells& betaCells, size_t betaColumn,
+                              size_t absoluteColumn) const;
+    template <typename AlphaCells, typename ExtCells>
+    void ExtendAlphaCells(const AbstractTemplate& tpl, const M& alpha, const AlphaCells& alphaCells,
+                          size_t beginColumn, M& ext, const ExtCells& extCells,
+                          size_t numExtColumns, size_t firstExtColumn) const;
+    template <typename BetaCells, typename ExtCells>
+    void ExtendBetaCells(const AbstractTemplate& tpl, const M& beta, const BetaCells& betaCells,
+                         size_t endColumn, M& ext, const ExtCells& extCells, int lengthDiff) const;
+
+    /// Returns EmissionPr(move, e, prev, curr) tabulated for every emission e of
+    /// this read. Pure contexts are served from pureEmissionTables_, ambiguous
+    /// contexts are tabulated into scratch.
+    const double* EmissionTable(MoveType move, const AlleleRep& prev, const AlleleRep& curr,
+                                double* scratch) const;
+
     std::pair<size_t, size_t> RowRange(size_t j, const M& matrix) const;
 
+    /// Refill alpha from beginColumn on, or beta up to endColumn, until a
+    /// column within the old columns is reached that is identical to its old
+    /// values.
+    void RefillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha, size_t beginColumn,
+                     size_t oldBegin) const;
+    void RefillBeta(const AbstractTemplate& tpl, const M& guide, M& beta, size_t endColumn,
+                    size_t oldEnd) const;
+
+    /// The band hints a fill leaves behind after filling column j, recovered
+    /// from the matrix to resume filling next to a kept column.
+    std::pair<size_t, size_t> AlphaHints(size_t j, const M& alpha) const;
+    std::pair<size_t, size_t> BetaHints(size_t j, const M& beta) const;
+
     /// \brief Reband alpha and beta matrices.
     /// This routine will reband alpha and beta to the convex hull
     /// of the maximum path through each and the inputs for column j.
@@ -148,6 +238,11 @@ private:
 
 private:
     std::vector<uint8_t> emissions_;
+    uint8_t nEmissions_;  // 1 + the largest encoded emission of the read
+
+    // [move][prev][curr][emission] for all pure dinucleotide contexts,
+    // populated on first use as Derived is not yet constructed in our ctor
+    mutable std::vector<double> pureEmissionTables_;
 };
 
 namespace {  // anonymous
@@ -158,6 +253,11 @@ using Interval = std::pair<size_t, size_t>;
 // TODO(anybody): Hmmm... not sure what the heck to do about these...
 static constexpr const int MAX_FLIP_FLOPS = 5;
 static constexpr const double REBANDING_THRESHOLD = 0.04;
+// RefillAlphaBeta refills this many columns at a time before testing whether
+// the refill converged onto the old columns
+static constexpr const size_t REFILL_COLUMNS = 16;
+// Encoded emissions (see EncodeBase) occupy at most 4 bits
+static constexpr const size_t MAX_EMISSIONS = 16;
 
 static UNANIMITY_CONSTEXPR const auto kDefaultBase =
     AlleleRep::FromASCII('A');  // corresponding to A, usually
@@ -176,10 +276,66 @@ inline Interval RangeUnion(const Interval& range1, const Interval& range2, const
 }
 
 inline double Combine(const double a, const double b) { return a + b; }
+
+// A column of a ScaledMatrix, saved before it is refilled
+struct SavedColumn
+{
+    Interval rows;
+    std::vector<double> values;
+    double logScale;
+};
+
+inline void SaveColumn(const ScaledMatrix& m, const size_t j, SavedColumn* column)
+{
+    column->rows = m.UsedRowRange(j);
+    column->values.resize(column->rows.second - column->rows.first);
+    m.CopyColumnRange(j, column->rows.first, column->rows.second, column->values.data());
+    column->logScale = m.GetLogScale(j);
+}
+
+// Columns are scaled to a maximum of 1, so compare them cell by cell. Only
+// an identical column makes the old columns after it valid, as they are
+// computed from it by the same recursion.
+inline bool SameColumn(const ScaledMatrix& m, const size_t j, const SavedColumn& column)
+{
+    if (m.UsedRowRange(j) != column.rows) return false;
+    return m.WithCells([&](const auto& cells) {
+        for (size_t i = column.rows.first; i < column.rows.second; ++i)
+            if (cells(i, j) != column.values[i - column.rows.first]) return false;
+        return true;
+    });
+}
 }  // namespace anonymous
 
 template <typename Derived>
-void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha) const
+void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                                  const size_t beginColumn, const size_t endColumn) const
+{
+    alpha.WithCells([&](const auto& alphaCells) {
+        if (GetFillKernel() == FillKernel::VECTORIZED)
+            this->FillAlphaVectorized(tpl, guide, alpha, alphaCells, beginColumn, endColumn);
+        else
+            this->FillAlphaScalar(tpl, guide, alpha, alphaCells, beginColumn, endColumn);
+    });
+}
+
+template <typename Derived>
+void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M& beta,
+                                 const size_t beginColumn, const size_t endColumn) const
+{
+    beta.WithCells([&](const auto& betaCells) {
+        if (GetFillKernel() == FillKernel::VECTORIZED)
+            this->FillBetaVectorized(tpl, guide, beta, betaCells, beginColumn, endColumn);
+        else
+            this->FillBetaScalar(tpl, guide, beta, betaCells, beginColumn, endColumn);
+    });
+}
+
+template <typename Derived>
+template <typename Cells>
+void Recursor<Derived>::FillAlphaScalar(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                                        const Cells& alphaCells, const size_t beginColumn,
+                                        const size_t endColumn) const
 {
     // We are pinning, so should never go all the way to the end of the
     // read/template
@@ -192,18 +348,29 @@ void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M
     assert(alpha.Rows() == I + 1 && alpha.Columns() == J + 1);
     assert(guide.IsNull() || (guide.Rows() == alpha.Rows() && guide.Columns() == alpha.Columns()));
 
+    assert(beginColumn < endColumn && beginColumn <= J);
+
     // Initial condition, we always start with a match
-    alpha.StartEditingColumn(0, 0, 1);
-    alpha.Set(0, 0, 1.0);
-    alpha.FinishEditingColumn<false>(0, 0, 1);
+    if (beginColumn == 0) {
+        alpha.StartEditingColumn(0, 0, 1);
+        alphaCells.Set(0, 0, 1.0);
+        alpha.FinishEditingColumn<false>(0, 0, 1);
+    }
     // End initial conditions
 
     size_t hintBeginRow = 1, hintEndRow = 1;
     auto prevTransProbs = kDefaultTplPos;
     auto prevTplBase = prevTransProbs.Idx;
 
-    for (size_t j = 1; j < J; ++j)  // Note due to offset with reads and otherwise, this is ugly-ish
-    {
+    // Resume right after the valid columns
+    if (beginColumn > 1) {
+        std::tie(hintBeginRow, hintEndRow) = AlphaHints(beginColumn - 1, alpha);
+        prevTransProbs = tpl[beginColumn - 2];
+        prevTplBase = prevTransProbs.Idx;
+    }
+
+    // Note due to offset with reads and otherwise, this is ugly-ish
+    for (size_t j = std::max<size_t>(beginColumn, 1); j < std::min(endColumn, J); ++j) {
         // Load up the transition parameters for this context
 
         auto currTransProbs = tpl[j - 1];
@@ -242,7 +409,7 @@ void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M
               ***********  EDGE_CONDITION ************
              */
             if (i > 0 && j > 0) {
-                thisMoveScore = alpha(i - 1, j - 1) * prevTransProbs.Match *
+                thisMoveScore = alphaCells(i - 1, j - 1) * prevTransProbs.Match *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::MATCH, curReadEm, prevTplBase, currTplBase);
                 score = Combine(score, thisMoveScore);
@@ -250,13 +417,13 @@ void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M
 
             if (i > 1) {
                 // Branch, due to pinning, can't "insert" first or last read base
-                thisMoveScore = alpha(i - 1, j) * currTransProbs.Branch *
+                thisMoveScore = alphaCells(i - 1, j) * currTransProbs.Branch *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::BRANCH, curReadEm, currTplBase, nextTplBase);
                 score = Combine(score, thisMoveScore);
 
                 // Stick
-                thisMoveScore = alpha(i - 1, j) * currTransProbs.Stick *
+                thisMoveScore = alphaCells(i - 1, j) * currTransProbs.Stick *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::STICK, curReadEm, currTplBase, nextTplBase);
                 score = Combine(score, thisMoveScore);
@@ -264,12 +431,12 @@ void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M
 
             // Deletion, due to pinning, can't "delete" first or last template bp
             if (j > 1) {
-                thisMoveScore = alpha(i, j - 1) * prevTransProbs.Deletion;
+                thisMoveScore = alphaCells(i, j - 1) * prevTransProbs.Deletion;
                 score = Combine(score, thisMoveScore);
             }
 
             //  Save score
-            alpha.Set(i, j, score);
+            alphaCells.Set(i, j, score);
 
             if (score > maxScore) {
                 maxScore = score;
@@ -282,7 +449,7 @@ void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M
         // Now, revise the hints to tell the caller where the mass of the
         // distribution really lived in this column.
         hintEndRow = endRow;
-        for (i = beginRow; i < endRow && alpha(i, j) < thresholdScore; ++i)
+        for (i = beginRow; i < endRow && alphaCells(i, j) < thresholdScore; ++i)
             ;
         hintBeginRow = i;
 
@@ -294,21 +461,24 @@ void Recursor<Derived>::FillAlpha(const AbstractTemplate& tpl, const M& guide, M
      * We require that we end in a match.
      * search for the term EDGE_CONDITION to find a comment with more
      * information */
-    {
+    if (endColumn > J) {
         auto currTplBase = tpl[J - 1].Idx;
         assert(J < 2 || prevTplBase.Overlap(tpl[J - 2].Idx));
         // end in the homopolymer state for now.
-        auto likelihood = alpha(I - 1, J - 1) *
+        auto likelihood = alphaCells(I - 1, J - 1) *
                           static_cast<const Derived*>(this)->EmissionPr(
                               MoveType::MATCH, emissions_[I - 1], prevTplBase, currTplBase);
         alpha.StartEditingColumn(J, I, I + 1);
-        alpha.Set(I, J, likelihood);
+        alphaCells.Set(I, J, likelihood);
         alpha.FinishEditingColumn<false>(J, I, I + 1);
     }
 }
 
 template <typename Derived>
-void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M& beta) const
+template <typename Cells>
+void Recursor<Derived>::FillBetaScalar(const AbstractTemplate& tpl, const M& guide, M& beta,
+                                       const Cells& betaCells, const size_t beginColumn,
+                                       const size_t endColumn) const
 {
     size_t I = read_.Length();
     size_t J = tpl.Length();
@@ -316,17 +486,25 @@ void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M&
     assert(beta.Rows() == I + 1 && beta.Columns() == J + 1);
     assert(guide.IsNull() || (guide.Rows() == beta.Rows() && guide.Columns() == beta.Columns()));
 
+    assert(beginColumn < endColumn && beginColumn <= J);
+
     // Setup initial condition, at the end we are one
-    beta.StartEditingColumn(J, I, I + 1);
-    beta.Set(I, J, 1.0);
-    beta.FinishEditingColumn<false>(J, I, I + 1);
+    if (endColumn > J) {
+        beta.StartEditingColumn(J, I, I + 1);
+        betaCells.Set(I, J, 1.0);
+        beta.FinishEditingColumn<false>(J, I, I + 1);
+    }
 
     // Totally arbitray decision here...
     size_t hintBeginRow = I, hintEndRow = I;
 
+    // Resume right before the valid columns
+    if (endColumn < J) std::tie(hintBeginRow, hintEndRow) = BetaHints(endColumn, beta);
+
     // Recursively calculate [Probability transition to next state] *
     // [Probability of emission at that state] * [Probability from that state]
-    for (size_t j = J - 1; j > 0; --j) {
+    const size_t firstColumn = std::max<size_t>(beginColumn, 1);
+    for (size_t j = std::min(endColumn, J) - 1; j >= firstColumn; --j) {
         const auto nextTplPos = tpl[j];
         const auto nextTplBase = nextTplPos.Idx;
         const auto currTransProbs = tpl[j - 1];
@@ -349,12 +527,12 @@ void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M&
 
             // Match
             if (i + 1 < I) {
-                thisMoveScore = beta(i + 1, j + 1) * currTransProbs.Match *
+                thisMoveScore = betaCells(i + 1, j + 1) * currTransProbs.Match *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::MATCH, nextReadEm, currTransProbs.Idx, nextTplBase);
                 score = Combine(score, thisMoveScore);
             } else if (i + 1 == I && j + 1 == J) {
-                thisMoveScore = beta(i + 1, j + 1) *
+                thisMoveScore = betaCells(i + 1, j + 1) *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::MATCH, nextReadEm, currTransProbs.Idx, nextTplBase);
                 score = Combine(score, thisMoveScore);
@@ -362,13 +540,13 @@ void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M&
 
             // Branch, can only transition to an insertion for the 2nd to last read base and before
             if (0 < i && i < I) {
-                thisMoveScore = beta(i + 1, j) * currTransProbs.Branch *
+                thisMoveScore = betaCells(i + 1, j) * currTransProbs.Branch *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::BRANCH, nextReadEm, currTransProbs.Idx, nextTplBase);
                 score = Combine(score, thisMoveScore);
 
                 // Stick, can only transition to an insertion for the 2nd to last read base
-                thisMoveScore = beta(i + 1, j) * currTransProbs.Stick *
+                thisMoveScore = betaCells(i + 1, j) * currTransProbs.Stick *
                                 static_cast<const Derived*>(this)->EmissionPr(
                                     MoveType::STICK, nextReadEm, currTransProbs.Idx, nextTplBase);
                 score = Combine(score, thisMoveScore);
@@ -376,12 +554,12 @@ void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M&
 
             // Deletion
             if (0 < j && j < J) {
-                thisMoveScore = beta(i, j + 1) * currTransProbs.Deletion;
+                thisMoveScore = betaCells(i, j + 1) * currTransProbs.Deletion;
                 score = Combine(score, thisMoveScore);
             }
 
             // Save score
-            beta.Set(i, j, score);
+            betaCells.Set(i, j, score);
 
             if (score > maxScore) {
                 maxScore = score;
@@ -395,7 +573,7 @@ void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M&
         // distribution really lived in this column.
 
         hintBeginRow = beginRow;
-        for (i = endRow; i > beginRow && beta(i - 1, j) < thresholdScore; --i)
+        for (i = endRow; i > beginRow && betaCells(i - 1, j) < thresholdScore; --i)
             ;
         hintEndRow = i;
 
@@ -406,11 +584,313 @@ void Recursor<Derived>::FillBeta(const AbstractTemplate& tpl, const M& guide, M&
     /* Now to fill the top row which must be a match
      * search for the term EDGE_CONDITION to find a comment with more
      * information */
-    {
+    if (beginColumn == 0) {
         beta.StartEditingColumn(0, 0, 1);
         auto match_emission_prob = static_cast<const Derived*>(this)->EmissionPr(
             MoveType::MATCH, emissions_[0], kDefaultBase, tpl[0].Idx);
-        beta.Set(0, 0, match_emission_prob * beta(1, 1));
+        betaCells.Set(0, 0, match_emission_prob * betaCells(1, 1));
+        beta.FinishEditingColumn<false>(0, 0, 1);
+    }
+}
+
+template <typename Derived>
+const double* Recursor<Derived>::EmissionTable(const MoveType move, const AlleleRep& prev,
+                                               const AlleleRep& curr, double* const scratch) const
+{
+    const auto tabulate = [this](const MoveType m, const AlleleRep& p, const AlleleRep& c,
+                                 double* const table) {
+        for (uint8_t em = 0; em < nEmissions_; ++em)
+            table[em] = static_cast<const Derived*>(this)->EmissionPr(m, em, p, c);
+    };
+
+    if (!prev.IsPure() || !curr.IsPure()) {
+        tabulate(move, prev, curr, scratch);
+        return scratch;
+    }
+
+    if (pureEmissionTables_.empty()) {
+        pureEmissionTables_.resize(3 * 16 * nEmissions_);
+        double* table = pureEmissionTables_.data();
+        for (const auto m : {MoveType::MATCH, MoveType::BRANCH, MoveType::STICK})
+            for (uint8_t p = 0; p < 4; ++p)
+                for (uint8_t c = 0; c < 4; ++c, table += nEmissions_)
+                    tabulate(m, NCBI2na::FromRaw(p).GetNCBI4na(), NCBI2na::FromRaw(c).GetNCBI4na(),
+                             table);
+    }
+
+    const size_t ctx = (prev.GetNCBI2na().Data() << 2) | curr.GetNCBI2na().Data();
+    return &pureEmissionTables_[(static_cast<uint8_t>(move) * 16 + ctx) * nEmissions_];
+}
+
+/// Same recursion as FillAlphaScalar, reorganized per column: the emission
+/// probabilities are tabulated once per template context, and the match and
+/// deletion moves, which only read column j - 1, are computed for the whole
+/// hinted band by the vectorized kernels. What remains serial is the
+/// insertion (branch/stick) recurrence down the column and the data-dependent
+/// extension of the band beyond the hint. The order of all floating point
+/// operations is preserved, and every cell is read as stored, rounded to
+/// float for CellPrecision::FLOAT, hence the result is identical to the
+/// scalar fill under either precision.
+template <typename Derived>
+template <typename Cells>
+void Recursor<Derived>::FillAlphaVectorized(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                                            const Cells& alphaCells, const size_t beginColumn,
+                                            const size_t endColumn) const
+{
+    size_t I = read_.Length();
+    size_t J = tpl.Length();
+
+    assert(alpha.Rows() == I + 1 && alpha.Columns() == J + 1);
+    assert(guide.IsNull() || (guide.Rows() == alpha.Rows() && guide.Columns() == alpha.Columns()));
+
+    assert(beginColumn < endColumn && beginColumn <= J);
+
+    // Initial condition, we always start with a match
+    if (beginColumn == 0) {
+        alpha.StartEditingColumn(0, 0, 1);
+        alphaCells.Set(0, 0, 1.0);
+        alpha.FinishEditingColumn<false>(0, 0, 1);
+    }
+    // End initial conditions
+
+    // column-wise scratch space: the band of the previous column and the
+    // match and deletion scores derived from it
+    ScopedBuffer scratch(3 * I + 1);
+    double* const prevColumn = scratch.data();
+    double* const matchScores = prevColumn + I + 1;
+    double* const deletionScores = matchScores + I;
+    std::array<double, MAX_EMISSIONS> matchScratch, branchScratch, stickScratch;
+
+    size_t hintBeginRow = 1, hintEndRow = 1;
+    auto prevTransProbs = kDefaultTplPos;
+    auto prevTplBase = prevTransProbs.Idx;
+
+    // Resume right after the valid columns
+    if (beginColumn > 1) {
+        std::tie(hintBeginRow, hintEndRow) = AlphaHints(beginColumn - 1, alpha);
+        prevTransProbs = tpl[beginColumn - 2];
+        prevTplBase = prevTransProbs.Idx;
+    }
+
+    for (size_t j = std::max<size_t>(beginColumn, 1); j < std::min(endColumn, J); ++j) {
+        auto currTransProbs = tpl[j - 1];
+        auto currTplBase = currTransProbs.Idx;
+        this->RangeGuide(j, guide, alpha, &hintBeginRow, &hintEndRow);
+
+        size_t i;
+        double thresholdScore = 0.0;
+        double maxScore = 0.0;
+        double score = 0.0;
+        alpha.StartEditingColumn(j, hintBeginRow, hintEndRow);
+
+        auto nextTplBase = tpl[j].Idx;
+
+        const double* const matchEm =
+            EmissionTable(MoveType::MATCH, prevTplBase, currTplBase, matchScratch.data());
+        const double* const branchEm =
+            EmissionTable(MoveType::BRANCH, currTplBase, nextTplBase, branchScratch.data());
+        const double* const stickEm =
+            EmissionTable(MoveType::STICK, currTplBase, nextTplBase, stickScratch.data());
+
+        size_t beginRow = hintBeginRow, endRow;
+        assert(beginRow > 0);
+
+        // Moves out of column j - 1, for the hinted band
+        const size_t nHinted = std::max(std::min(hintEndRow, I), beginRow) - beginRow;
+        alpha.CopyColumnRange(j - 1, beginRow - 1, beginRow + nHinted, prevColumn);
+        detail::ScaledEmissionProducts(prevColumn, prevTransProbs.Match, matchEm,
+                                       emissions_.data() + beginRow - 1, matchScores, nHinted);
+        detail::ScaledProducts(prevColumn + 1, prevTransProbs.Deletion, deletionScores, nHinted);
+
+        // alphaCells(i - 1, j), cells above the band are empty
+        double prevScore = 0.0;
+
+        for (i = beginRow; i < I && (score >= thresholdScore || i < hintEndRow); ++i) {
+            const size_t k = i - beginRow;
+            const uint8_t curReadEm = emissions_[i - 1];
+
+            // Match
+            if (k < nHinted)
+                score = matchScores[k];
+            else
+                score = alphaCells(i - 1, j - 1) * prevTransProbs.Match * matchEm[curReadEm];
+
+            // Branch and stick, due to pinning, can't "insert" first or last read base
+            if (i > 1) {
+                score = Combine(score, prevScore * currTransProbs.Branch * branchEm[curReadEm]);
+                score = Combine(score, prevScore * currTransProbs.Stick * stickEm[curReadEm]);
+            }
+
+            // Deletion, due to pinning, can't "delete" first or last template bp
+            if (j > 1) {
+                if (k < nHinted)
+                    score = Combine(score, deletionScores[k]);
+                else
+                    score = Combine(score, alphaCells(i, j - 1) * prevTransProbs.Deletion);
+            }
+
+            //  Save score, read back as stored for the next row
+            alphaCells.Set(i, j, score);
+            prevScore = alphaCells(i, j);
+
+            if (score > maxScore) {
+                maxScore = score;
+                thresholdScore = maxScore / scoreDiff_;
+            }
+        }
+        endRow = i;
+        prevTransProbs = currTransProbs;
+        prevTplBase = currTplBase;
+        // Now, revise the hints to tell the caller where the mass of the
+        // distribution really lived in this column.
+        hintEndRow = endRow;
+        for (i = beginRow; i < endRow && alphaCells(i, j) < thresholdScore; ++i)
+            ;
+        hintBeginRow = i;
+
+        // Don't rescale until we finish updating the hint.
+        alpha.FinishEditingColumn<true>(j, beginRow, endRow, maxScore);
+    }
+
+    // Last pinned position, see FillAlphaScalar
+    if (endColumn > J) {
+        auto currTplBase = tpl[J - 1].Idx;
+        assert(J < 2 || prevTplBase.Overlap(tpl[J - 2].Idx));
+        auto likelihood = alphaCells(I - 1, J - 1) *
+                          static_cast<const Derived*>(this)->EmissionPr(
+                              MoveType::MATCH, emissions_[I - 1], prevTplBase, currTplBase);
+        alpha.StartEditingColumn(J, I, I + 1);
+        alphaCells.Set(I, J, likelihood);
+        alpha.FinishEditingColumn<false>(J, I, I + 1);
+    }
+}
+
+/// Vectorized counterpart of FillBetaScalar, see FillAlphaVectorized.
+template <typename Derived>
+template <typename Cells>
+void Recursor<Derived>::FillBetaVectorized(const AbstractTemplate& tpl, const M& guide, M& beta,
+                                           const Cells& betaCells, const size_t beginColumn,
+                                           const size_t endColumn) const
+{
+    size_t I = read_.Length();
+    size_t J = tpl.Length();
+
+    assert(beta.Rows() == I + 1 && beta.Columns() == J + 1);
+    assert(guide.IsNull() || (guide.Rows() == beta.Rows() && guide.Columns() == beta.Columns()));
+
+    assert(beginColumn < endColumn && beginColumn <= J);
+
+    // Setup initial condition, at the end we are one
+    if (endColumn > J) {
+        beta.StartEditingColumn(J, I, I + 1);
+        betaCells.Set(I, J, 1.0);
+        beta.FinishEditingColumn<false>(J, I, I + 1);
+    }
+
+    ScopedBuffer scratch(3 * I + 1);
+    double* const nextColumn = scratch.data();
+    double* const matchScores = nextColumn + I + 1;
+    double* const deletionScores = matchScores + I;
+    std::array<double, MAX_EMISSIONS> matchScratch, branchScratch, stickScratch;
+
+    size_t hintBeginRow = I, hintEndRow = I;
+
+    // Resume right before the valid columns
+    if (endColumn < J) std::tie(hintBeginRow, hintEndRow) = BetaHints(endColumn, beta);
+
+    const size_t firstColumn = std::max<size_t>(beginColumn, 1);
+    for (size_t j = std::min(endColumn, J) - 1; j >= firstColumn; --j) {
+        const auto nextTplPos = tpl[j];
+        const auto nextTplBase = nextTplPos.Idx;
+        const auto currTransProbs = tpl[j - 1];
+
+        this->RangeGuide(j, guide, beta, &hintBeginRow, &hintEndRow);
+
+        beta.StartEditingColumn(j, hintBeginRow, hintEndRow);
+
+        const double* const matchEm =
+            EmissionTable(MoveType::MATCH, currTransProbs.Idx, nextTplBase, matchScratch.data());
+        const double* const branchEm =
+            EmissionTable(MoveType::BRANCH, currTransProbs.Idx, nextTplBase, branchScratch.data());
+        const double* const stickEm =
+            EmissionTable(MoveType::STICK, currTransProbs.Idx, nextTplBase, stickScratch.data());
+
+        size_t i;
+        double score = 0.0;
+        double thresholdScore = 0.0;
+        double maxScore = 0.0;
+
+        size_t endRow = hintEndRow;
+
+        // Moves into column j + 1, for the hinted band [bandBegin, bandEnd).
+        // The match move out of the last read base is special (pinning) and
+        // is left to the serial loop.
+        const size_t bandBegin = std::max<size_t>(hintBeginRow, 1);
+        const size_t bandEnd = std::max(std::min(endRow, I - 1), bandBegin);
+        const size_t nHinted = bandEnd - bandBegin;
+        beta.CopyColumnRange(j + 1, bandBegin, bandEnd + 1, nextColumn);
+        detail::ScaledEmissionProducts(nextColumn + 1, currTransProbs.Match, matchEm,
+                                       emissions_.data() + bandBegin, matchScores, nHinted);
+        detail::ScaledProducts(nextColumn, currTransProbs.Deletion, deletionScores, nHinted);
+
+        // betaCells(i + 1, j), cells below the band are empty
+        double nextScore = 0.0;
+
+        for (i = endRow > 0 ? endRow - 1 : 0;  // Since we stop if i <= 0, do not allow i to be neg
+             i > 0 && (score >= thresholdScore || i >= hintBeginRow); --i) {
+            const uint8_t nextReadEm = emissions_[i];
+            const bool isHinted = bandBegin <= i && i < bandEnd;
+            const size_t k = i - bandBegin;
+            score = 0.0;
+
+            // Match
+            if (isHinted)
+                score = matchScores[k];
+            else if (i + 1 < I)
+                score = betaCells(i + 1, j + 1) * currTransProbs.Match * matchEm[nextReadEm];
+            else if (i + 1 == I && j + 1 == J)
+                score = betaCells(i + 1, j + 1) * matchEm[nextReadEm];
+
+            // Branch and stick, can only transition to an insertion for the 2nd to last read base
+            if (0 < i && i < I) {
+                score = Combine(score, nextScore * currTransProbs.Branch * branchEm[nextReadEm]);
+                score = Combine(score, nextScore * currTransProbs.Stick * stickEm[nextReadEm]);
+            }
+
+            // Deletion
+            if (isHinted)
+                score = Combine(score, deletionScores[k]);
+            else
+                score = Combine(score, betaCells(i, j + 1) * currTransProbs.Deletion);
+
+            // Save score, read back as stored for the next row
+            betaCells.Set(i, j, score);
+            nextScore = betaCells(i, j);
+
+            if (score > maxScore) {
+                maxScore = score;
+                thresholdScore = maxScore / scoreDiff_;
+            }
+        }
+
+        size_t beginRow = i + 1;
+        // Now, revise the hints to tell the caller where the mass of the
+        // distribution really lived in this column.
+        hintBeginRow = beginRow;
+        for (i = endRow; i > beginRow && betaCells(i - 1, j) < thresholdScore; --i)
+            ;
+        hintEndRow = i;
+
+        // Don't rescale until we update the hints
+        beta.FinishEditingColumn<true>(j, beginRow, endRow, maxScore);
+    }
+
+    // Top row which must be a match, see FillBetaScalar
+    if (beginColumn == 0) {
+        beta.StartEditingColumn(0, 0, 1);
+        auto match_emission_prob = static_cast<const Derived*>(this)->EmissionPr(
+            MoveType::MATCH, emissions_[0], kDefaultBase, tpl[0].Idx);
+        betaCells.Set(0, 0, match_emission_prob * betaCells(1, 1));
         beta.FinishEditingColumn<false>(0, 0, 1);
     }
 }
@@ -427,6 +907,21 @@ template <typename Derived>
 double Recursor<Derived>::LinkAlphaBeta(const AbstractTemplate& tpl, const M& alpha,
                                         size_t alphaColumn, const M& beta, size_t betaColumn,
                                         size_t absoluteColumn) const
+{
+    return alpha.WithCells([&](const auto& alphaCells) {
+        return beta.WithCells([&](const auto& betaCells) {
+            return this->LinkAlphaBetaCells(tpl, alpha, alphaCells, alphaColumn, beta, betaCells,
+                                            betaColumn, absoluteColumn);
+        });
+    });
+}
+
+template <typename Derived>
+template <typename AlphaCells, typename BetaCells>
+double Recursor<Derived>::LinkAlphaBetaCells(const AbstractTemplate& tpl, const M& alpha,
+                                             const AlphaCells& alphaCells, size_t alphaColumn,
+                                             const M& beta, const BetaCells& betaCells,
+                                             size_t betaColumn, size_t absoluteColumn) const
 {
     const size_t I = read_.Length();
 
@@ -443,19 +938,22 @@ double Recursor<Derived>::LinkAlphaBeta(const AbstractTemplate& tpl, const M& al
     const auto currTplParams = tpl[absoluteColumn - 1];
     const auto prevTplParams = tpl[absoluteColumn - 2];
 
+    std::array<double, MAX_EMISSIONS> matchScratch;
+    const double* const matchEm =
+        EmissionTable(MoveType::MATCH, prevTplParams.Idx, currTplParams.Idx, matchScratch.data());
+
     for (size_t i = usedBegin; i < usedEnd; i++) {
         if (i < I) {
             const uint8_t readEm = emissions_[i];
             // Match
-            thisMoveScore = alpha(i, alphaColumn - 1) * prevTplParams.Match *
-                            static_cast<const Derived*>(this)->EmissionPr(
-                                MoveType::MATCH, readEm, prevTplParams.Idx, currTplParams.Idx) *
-                            beta(i + 1, betaColumn);
+            thisMoveScore = alphaCells(i, alphaColumn - 1) * prevTplParams.Match * matchEm[readEm] *
+                            betaCells(i + 1, betaColumn);
             v = Combine(v, thisMoveScore);
         }
 
         // Delete
-        thisMoveScore = alpha(i, alphaColumn - 1) * prevTplParams.Deletion * beta(i, betaColumn);
+        thisMoveScore =
+            alphaCells(i, alphaColumn - 1) * prevTplParams.Deletion * betaCells(i, betaColumn);
         v = Combine(v, thisMoveScore);
     }
 
@@ -472,9 +970,25 @@ double Recursor<Derived>::LinkAlphaBeta(const AbstractTemplate& tpl, const M& al
 /// each position.
 template <typename Derived>
 void Recursor<Derived>::ExtendAlpha(const AbstractTemplate& tpl, const M& alpha, size_t beginColumn,
-                                    M& ext, size_t numExtColumns) const
+                                    M& ext, size_t numExtColumns, size_t firstExtColumn) const
+{
+    alpha.WithCells([&](const auto& alphaCells) {
+        ext.WithCells([&](const auto& extCells) {
+            this->ExtendAlphaCells(tpl, alpha, alphaCells, beginColumn, ext, extCells,
+                                   numExtColumns, firstExtColumn);
+        });
+    });
+}
+
+template <typename Derived>
+template <typename AlphaCells, typename ExtCells>
+void Recursor<Derived>::ExtendAlphaCells(const AbstractTemplate& tpl, const M& alpha,
+                                         const AlphaCells& alphaCells, size_t beginColumn, M& ext,
+                                         const ExtCells& extCells, size_t numExtColumns,
+                                         size_t firstExtColumn) const
 {
     assert(numExtColumns >= 2);  // We have to fill at least one
+    assert(firstExtColumn < numExtColumns);
     assert(alpha.Rows() == read_.Length() + 1 &&
            ext.Rows() == read_.Length() + 1);  // The read never mutates
 
@@ -494,7 +1008,9 @@ void Recursor<Derived>::ExtendAlpha(const AbstractTemplate& tpl, const M& alpha,
     for (size_t j = 1; j + beginColumn < alpha.Columns() && j <= numExtColumns; ++j)
         endRow = std::max(alpha.UsedRowRange(j + beginColumn).second, endRow);
 
-    for (size_t extCol = 0; extCol < numExtColumns; extCol++) {
+    std::array<double, MAX_EMISSIONS> matchScratch, branchScratch, stickScratch;
+
+    for (size_t extCol = firstExtColumn; extCol < numExtColumns; extCol++) {
         size_t j = beginColumn + extCol;
 
         ext.StartEditingColumn(extCol, beginRow, endRow);
@@ -515,50 +1031,49 @@ void Recursor<Derived>::ExtendAlpha(const AbstractTemplate& tpl, const M& alpha,
             nextTplBase = tpl[j].Idx;
         }
 
+        // the emission probabilities of this column, by read emission
+        const double* const matchEm = EmissionTable(MoveType::MATCH, prevTplParams.Idx,
+                                                    currTplParams.Idx, matchScratch.data());
+        const double* const branchEm =
+            EmissionTable(MoveType::BRANCH, currTplBase, nextTplBase, branchScratch.data());
+        const double* const stickEm =
+            EmissionTable(MoveType::STICK, currTplBase, nextTplBase, stickScratch.data());
+
         for (i = beginRow; i < endRow; i++) {
             const uint8_t currReadEm = emissions_[i - 1];
             double thisMoveScore = 0.0;
 
             // Match
             if (i > 0 && j > 0) {
-                double prev = extCol == 0 ? alpha(i - 1, j - 1) : ext(i - 1, extCol - 1);
+                double prev = extCol == 0 ? alphaCells(i - 1, j - 1) : extCells(i - 1, extCol - 1);
                 if (i < maxDownMovePossible && j < maxLeftMovePossible) {
-                    thisMoveScore =
-                        prev * prevTplParams.Match *
-                        static_cast<const Derived*>(this)->EmissionPr(
-                            MoveType::MATCH, currReadEm, prevTplParams.Idx, currTplParams.Idx);
+                    thisMoveScore = prev * prevTplParams.Match * matchEm[currReadEm];
                 } else if (i == maxDownMovePossible && j == maxLeftMovePossible) {
-                    thisMoveScore =
-                        prev *
-                        static_cast<const Derived*>(this)->EmissionPr(
-                            MoveType::MATCH, currReadEm, prevTplParams.Idx, currTplParams.Idx);
+                    thisMoveScore = prev * matchEm[currReadEm];
                 }
                 score = thisMoveScore;
             }
 
             // Branch
             if (i > 1 && i < maxDownMovePossible && j != maxLeftMovePossible) {
-                thisMoveScore = ext(i - 1, extCol) * currTplParams.Branch *
-                                static_cast<const Derived*>(this)->EmissionPr(
-                                    MoveType::BRANCH, currReadEm, currTplBase, nextTplBase);
+                thisMoveScore =
+                    extCells(i - 1, extCol) * currTplParams.Branch * branchEm[currReadEm];
                 score = Combine(score, thisMoveScore);
             }
 
             // Stick
             if (i > 1 && i < maxDownMovePossible && j != maxLeftMovePossible) {
-                thisMoveScore = ext(i - 1, extCol) * currTplParams.Stick *
-                                static_cast<const Derived*>(this)->EmissionPr(
-                                    MoveType::STICK, currReadEm, currTplBase, nextTplBase);
+                thisMoveScore = extCells(i - 1, extCol) * currTplParams.Stick * stickEm[currReadEm];
                 score = Combine(score, thisMoveScore);
             }
 
             // Delete
             if (j > 1 && j < maxLeftMovePossible && i != maxDownMovePossible) {
-                double prev = extCol == 0 ? alpha(i, j - 1) : ext(i, extCol - 1);
+                double prev = extCol == 0 ? alphaCells(i, j - 1) : extCells(i, extCol - 1);
                 thisMoveScore = prev * prevTplParams.Deletion;
                 score = Combine(score, thisMoveScore);
             }
-            ext.Set(i, extCol, score);
+            extCells.Set(i, extCol, score);
             if (score > max_score) max_score = score;
         }
         assert(i == endRow);
@@ -586,6 +1101,19 @@ void Recursor<Derived>::ExtendAlpha(const AbstractTemplate& tpl, const M& alpha,
 template <typename Derived>
 void Recursor<Derived>::ExtendBeta(const AbstractTemplate& tpl, const M& beta, size_t lastColumn,
                                    M& ext, int lengthDiff) const
+{
+    beta.WithCells([&](const auto& betaCells) {
+        ext.WithCells([&](const auto& extCells) {
+            this->ExtendBetaCells(tpl, beta, betaCells, lastColumn, ext, extCells, lengthDiff);
+        });
+    });
+}
+
+template <typename Derived>
+template <typename BetaCells, typename ExtCells>
+void Recursor<Derived>::ExtendBetaCells(const AbstractTemplate& tpl, const M& beta,
+                                        const BetaCells& betaCells, size_t lastColumn, M& ext,
+                                        const ExtCells& extCells, int lengthDiff) const
 {
     size_t I = read_.Length();
     size_t J = tpl.Length();
@@ -598,13 +1126,13 @@ void Recursor<Derived>::ExtendBeta(const AbstractTemplate& tpl, const M& beta, s
 
     // The new template may not be the same length as the old template.
     // Just make sure that we have enough room to fill out the extend buffer
+    // lastColumn is the end of a mutation starting within the first three
+    // positions; a multi-base mutation moves it and the length difference
+    // along with its length, which the caller sizes ext for
     assert(lastColumn + 1 <= J);
-    assert(lastColumn < 4);  // Since we are only testing mutations of size 1,
-                             // and the check prior for a beginning mutation is
-                             // < 3, max = 2 + 1 = 3
+    assert(static_cast<int>(numExtColumns) > 0);
     assert(ext.Columns() >= numExtColumns);
     assert(beta.Rows() == I + 1 && ext.Rows() == I + 1);
-    assert(abs(lengthDiff) < 2);
 
     // completely fill the rectangle bounded by the min and max
     int beginRow, endRow;
@@ -615,6 +1143,8 @@ void Recursor<Derived>::ExtendBeta(const AbstractTemplate& tpl, const M& beta, s
     for (size_t j = 0; j <= lastColumn && j <= numExtColumns; ++j)
         beginRow = std::min(static_cast<int>(beta.UsedRowRange(lastColumn - j).first), beginRow);
 
+    std::array<double, MAX_EMISSIONS> matchScratch, branchScratch, stickScratch;
+
     for (int j = lastColumn; j + numExtColumns - lastColumn > 0; j--) {
         /* Convert from old template to new template coordinates.
            lengthDiff will be 0 for substitution, -1 for deletion and +1 for
@@ -634,6 +1164,14 @@ void Recursor<Derived>::ExtendBeta(const AbstractTemplate& tpl, const M& beta, s
         if (jp > 0) currTplParams = tpl[jp - 1];
         double max_score = 0.0;
 
+        // the emission probabilities of this column, by read emission
+        const double* const matchEm =
+            EmissionTable(MoveType::MATCH, currTplParams.Idx, nextTplBase, matchScratch.data());
+        const double* const branchEm =
+            EmissionTable(MoveType::BRANCH, currTplParams.Idx, nextTplBase, branchScratch.data());
+        const double* const stickEm =
+            EmissionTable(MoveType::STICK, currTplParams.Idx, nextTplBase, stickScratch.data());
+
         for (int i = endRow - 1; i >= beginRow; i--) {
             assert(i < static_cast<int>(I));
             assert(j < static_cast<int>(J));
@@ -644,35 +1182,29 @@ void Recursor<Derived>::ExtendBeta(const AbstractTemplate& tpl, const M& beta, s
                 bool extColIsLastExtColumn = static_cast<int>(extCol) == lastExtColumn;
                 // Match
                 const double matchNext =
-                    extColIsLastExtColumn ? beta(i + 1, j + 1) : ext(i + 1, extCol + 1);
+                    extColIsLastExtColumn ? betaCells(i + 1, j + 1) : extCells(i + 1, extCol + 1);
                 // First and last have to start with an emission
-                const double matchScore =
-                    matchNext * currTplParams.Match *
-                    static_cast<const Derived*>(this)->EmissionPr(MoveType::MATCH, nextReadEm,
-                                                                  currTplParams.Idx, nextTplBase);
+                const double matchScore = matchNext * currTplParams.Match * matchEm[nextReadEm];
                 score = Combine(score, matchScore);
 
                 // Branch
                 const double branchScore =
-                    ext(i + 1, extCol) * currTplParams.Branch *
-                    static_cast<const Derived*>(this)->EmissionPr(MoveType::BRANCH, nextReadEm,
-                                                                  currTplParams.Idx, nextTplBase);
+                    extCells(i + 1, extCol) * currTplParams.Branch * branchEm[nextReadEm];
                 score = Combine(score, branchScore);
 
                 // Stick
                 const double stickScore =
-                    ext(i + 1, extCol) * currTplParams.Stick *
-                    static_cast<const Derived*>(this)->EmissionPr(MoveType::STICK, nextReadEm,
-                                                                  currTplParams.Idx, nextTplBase);
+                    extCells(i + 1, extCol) * currTplParams.Stick * stickEm[nextReadEm];
                 score = Combine(score, stickScore);
 
                 // Deletion
-                double const delNext = extColIsLastExtColumn ? beta(i, j + 1) : ext(i, extCol + 1);
+                double const delNext =
+                    extColIsLastExtColumn ? betaCells(i, j + 1) : extCells(i, extCol + 1);
                 double const deletionScore = delNext * currTplParams.Deletion;
                 score = Combine(score, deletionScore);
             }
 
-            ext.Set(i, extCol, score);
+            extCells.Set(i, extCol, score);
             if (score > max_score) max_score = score;
         }
         ext.FinishEditingColumn<true>(extCol, beginRow, endRow, max_score);
@@ -681,18 +1213,22 @@ void Recursor<Derived>::ExtendBeta(const AbstractTemplate& tpl, const M& beta, s
     // fill out the (0, 0) entry of the matrix
     {
         ext.StartEditingColumn(0, 0, 1);
-        const double match_trans_prob = (lastExtColumn == 0) ? beta(1, lastColumn + 1) : ext(1, 1);
+        const double match_trans_prob =
+            (lastExtColumn == 0) ? betaCells(1, lastColumn + 1) : extCells(1, 1);
         const double match_emission_prob = static_cast<const Derived*>(this)->EmissionPr(
             MoveType::MATCH, emissions_[0], kDefaultBase, tpl[0].Idx);
-        ext.Set(0, 0, match_trans_prob * match_emission_prob);
+        extCells.Set(0, 0, match_trans_prob * match_emission_prob);
         ext.FinishEditingColumn<false>(0, 0, 1);
     }
 }
 
 template <typename Derived>
 Recursor<Derived>::Recursor(const PacBio::Data::MappedRead& mr, const double scoreDiff)
-    : AbstractRecursor(mr, scoreDiff), emissions_{Derived::EncodeRead(read_)}
+    : AbstractRecursor(mr, scoreDiff), emissions_{Derived::EncodeRead(read_)}, nEmissions_{0}
 {
+    for (const uint8_t em : emissions_)
+        nEmissions_ = std::max<uint8_t>(nEmissions_, em + 1);
+    assert(nEmissions_ <= MAX_EMISSIONS);
 }
 
 template <typename Derived>
@@ -742,34 +1278,122 @@ size_t Recursor<Derived>::FillAlphaBeta(const AbstractTemplate& tpl, M& a, M& b,
 }
 
 template <typename Derived>
-inline Interval Recursor<Derived>::RowRange(size_t j, const M& matrix) const
+bool Recursor<Derived>::RefillAlphaBeta(const AbstractTemplate& tpl, M& a, M& b,
+                                        const size_t keptAlphaColumns, const size_t keptBetaColumns,
+                                        const double tol) const
 {
-    int beginRow, endRow;
-    std::tie(beginRow, endRow) = matrix.UsedRowRange(j);
-    int maxRow = beginRow;
-    double maxScore = matrix(maxRow, j);
-    int i;
+    if (tpl.Length() == 0) throw std::runtime_error("template length is 0, invalid state!");
 
-    for (i = beginRow + 1; i < endRow; i++) {
-        double score = matrix(i, j);
+    size_t I = read_.Length();
+    size_t J = tpl.Length();
+    assert(keptAlphaColumns <= J && keptBetaColumns <= J);
+
+    // The kept columns of beta guide the refill of alpha, and the now
+    // complete alpha guides the refill of beta
+    RefillAlpha(tpl, b, a, keptAlphaColumns, J + 1 - keptBetaColumns);
+    RefillBeta(tpl, a, b, J + 1 - keptBetaColumns, keptAlphaColumns);
+
+    const double unweight = UndoCounterWeights(read_.Length());
+    const double alphaV = std::log(a(I, J)) + a.GetLogProdScales() + unweight;
+    const double betaV = std::log(b(0, 0)) + b.GetLogProdScales() + unweight;
+
+    return std::abs(1.0 - alphaV / betaV) <= tol && std::isfinite(betaV);
+}
 
-        if (score > maxScore) {
-            maxRow = i;
-            maxScore = score;
+template <typename Derived>
+void Recursor<Derived>::RefillAlpha(const AbstractTemplate& tpl, const M& guide, M& alpha,
+                                    const size_t beginColumn, const size_t oldBegin) const
+{
+    const size_t J = tpl.Length();
+    SavedColumn old;
+
+    for (size_t j = beginColumn; j <= J;) {
+        const size_t endColumn = std::min(j + REFILL_COLUMNS, J + 1);
+        const size_t last = endColumn - 1;
+        const bool isOld = last >= oldBegin && !alpha.IsColumnEmpty(last);
+        if (isOld) SaveColumn(alpha, last, &old);
+
+        FillAlpha(tpl, guide, alpha, j, endColumn);
+
+        // the old columns after last follow from the old column last by the
+        // same recursion as the new ones do, they only differ in scale
+        if (isOld && SameColumn(alpha, last, old)) {
+            alpha.ShiftLogScales(endColumn, J + 1, alpha.GetLogScale(last) - old.logScale);
+            return;
         }
+        j = endColumn;
     }
+}
+
+template <typename Derived>
+void Recursor<Derived>::RefillBeta(const AbstractTemplate& tpl, const M& guide, M& beta,
+                                   const size_t endColumn, const size_t oldEnd) const
+{
+    SavedColumn old;
+
+    for (size_t j = endColumn; j > 0;) {
+        const size_t beginColumn = (j > REFILL_COLUMNS) ? j - REFILL_COLUMNS : 0;
+        const bool isOld = beginColumn < oldEnd && !beta.IsColumnEmpty(beginColumn);
+        if (isOld) SaveColumn(beta, beginColumn, &old);
 
-    double thresholdScore = maxScore / scoreDiff_;
+        FillBeta(tpl, guide, beta, beginColumn, j);
+
+        // see RefillAlpha
+        if (isOld && SameColumn(beta, beginColumn, old)) {
+            beta.ShiftLogScales(0, beginColumn, beta.GetLogScale(beginColumn) - old.logScale);
+            return;
+        }
+        j = beginColumn;
+    }
+}
 
-    for (i = beginRow; i < maxRow && matrix(i, j) < thresholdScore; i++)
-        ;
-    beginRow = i;
+template <typename Derived>
+inline Interval Recursor<Derived>::RowRange(size_t j, const M& matrix) const
+{
+    return matrix.WithCells([&](const auto& cells) {
+        int beginRow, endRow;
+        std::tie(beginRow, endRow) = matrix.UsedRowRange(j);
+        int maxRow = beginRow;
+        double maxScore = cells(maxRow, j);
+        int i;
 
-    for (i = endRow - 1; i >= maxRow && matrix(i, j) < thresholdScore; i--)
-        ;
-    endRow = i + 1;
+        for (i = beginRow + 1; i < endRow; i++) {
+            double score = cells(i, j);
 
-    return Interval(beginRow, endRow);
+            if (score > maxScore) {
+                maxRow = i;
+                maxScore = score;
+            }
+        }
+
+        double thresholdScore = maxScore / scoreDiff_;
+
+        for (i = beginRow; i < maxRow && cells(i, j) < thresholdScore; i++)
+            ;
+        beginRow = i;
+
+        for (i = endRow - 1; i >= maxRow && cells(i, j) < thresholdScore; i--)
+            ;
+        endRow = i + 1;
+
+        return Interval(beginRow, endRow);
+    });
+}
+
+// FillAlpha hints the rows of column j + 1 from the first row of column j
+// above the threshold down to the end of the filled rows of column j.
+template <typename Derived>
+inline Interval Recursor<Derived>::AlphaHints(size_t j, const M& alpha) const
+{
+    return Interval(RowRange(j, alpha).first, alpha.UsedRowRange(j).second);
+}
+
+// FillBeta hints the rows of column j - 1 from the beginning of the filled
+// rows of column j down to its last row above the threshold.
+template <typename Derived>
+inline Interval Recursor<Derived>::BetaHints(size_t j, const M& beta) const
+{
+    return Interval(beta.UsedRowRange(j).first, RowRange(j, beta).second);
 }
 
 // The RangeGuide function determines the minimum score by dividing out scoreDiff_.
@@ -0,0 +1,52 @@
+#include "UnanimityInternalConfig.h"
+
+#include <atomic>
+
+#include "RecursorKernels.h"
+
+namespace PacBio {
+namespace Consensus {
+namespace {  // anonymous
+
+std::atomic<FillKernel> fillKernel_{FillKernel::VECTORIZED};
+
+}  // namespace anonymous
+
+void SetFillKernel(const FillKernel kernel) { fillKernel_.store(kernel); }
+
+FillKernel GetFillKernel() { return fillKernel_.load(std::memory_order_relaxed); }
+
+std::string FillKernelInstructionSet()
+{
+#if UNANIMITY_HAS_TARGET_CLONES
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return "AVX-512";
+    if (__builtin_cpu_supports("avx2")) return "AVX2";
+    if (__builtin_cpu_supports("sse4.2")) return "SSE4.2";
+#endif
+    return "default";
+}
+
+namespace detail {
+
+UNANIMITY_TARGET_CLONES
+void ScaledEmissionProducts(const double* __restrict__ prev, const double trans,
+                            const double* __restrict__ emissionTable,
+                            const uint8_t* __restrict__ emissions, double* __restrict__ out,
+                            const size_t n)
+{
+    for (size_t k = 0; k < n; ++k)
+        out[k] = (prev[k] * trans) * emissionTable[emissions[k]];
+}
+
+UNANIMITY_TARGET_CLONES
+void ScaledProducts(const double* __restrict__ prev, const double trans, double* __restrict__ out,
+                    const size_t n)
+{
+    for (size_t k = 0; k < n; ++k)
+        out[k] = prev[k] * trans;
+}
+
+}  // namespace detail
+}  // namespace Consensus
+}  // namespace PacBio
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PacBio {
+namespace Consensus {
+
+/// The column kernels used by Recursor::FillAlpha/FillBeta.
+///
+/// SCALAR is the original cell-by-cell recursion and serves as the reference
+/// implementation. VECTORIZED tabulates the emission probabilities once per
+/// column and computes all contributions that only depend on the neighboring
+/// column in runtime-dispatched SIMD loops; only the within-column insertion
+/// recurrence stays serial. Both kernels produce bit-identical matrices.
+enum class FillKernel : uint8_t
+{
+    SCALAR,
+    VECTORIZED
+};
+
+/// Select the kernel used by all subsequent fills (process-wide).
+void SetFillKernel(FillKernel kernel);
+
+/// Returns the currently selected fill kernel.
+FillKernel GetFillKernel();
+
+/// Returns the instruction set the VECTORIZED kernel dispatches to on this host.
+std::string FillKernelInstructionSet();
+
+namespace detail {
+
+/// out[k] = (prev[k] * trans) * emissionTable[emissions[k]], for k in [0, n)
+void ScaledEmissionProducts(const double* prev, double trans, const double* emissionTable,
+                            const uint8_t* emissions, double* out, size_t n);
+
+/// out[k] = prev[k] * trans, for k in [0, n)
+void ScaledProducts(const double* prev, double trans, double* out, size_t n);
+
+}  // namespace detail
+}  // namespace Consensus
+}  // namespace PacBio
@@ -28,10 +28,48 @@ namespace Poa {
 
 using Vertex = PoaGraph::Vertex;
 
+namespace {  // anonymous
+
+constexpr size_t SDP_QGRAM_SIZE = 6;
+
+// OrientAndAddRead picks a strand from the seeds alone if its SDP chain
+// against the consensus has at least MIN_ORIENTATION_ANCHORS anchors, and
+// ORIENTATION_ANCHOR_RATIO times as many as the chain of the other strand.
+// Chains of spurious hits between unrelated sequences stay far below that.
+constexpr size_t MIN_ORIENTATION_ANCHORS = 10;
+constexpr size_t ORIENTATION_ANCHOR_RATIO = 3;
+
+enum struct Strand
+{
+    FORWARD,
+    REVERSE,
+    AMBIGUOUS
+};
+
+Strand ClassifyStrand(const size_t nFwd, const size_t nRev)
+{
+    if (nFwd >= MIN_ORIENTATION_ANCHORS && nFwd >= ORIENTATION_ANCHOR_RATIO * nRev)
+        return Strand::FORWARD;
+    if (nRev >= MIN_ORIENTATION_ANCHORS && nRev >= ORIENTATION_ANCHOR_RATIO * nFwd)
+        return Strand::REVERSE;
+    return Strand::AMBIGUOUS;
+}
+
+}  // namespace anonymous
+
+void SdpRangeFinder::KeepAnchors(const std::string& readSequence, SdpAnchorVector anchors)
+{
+    kept_.emplace_back(readSequence, std::move(anchors));
+}
+
+void SdpRangeFinder::ClearAnchors() { kept_.clear(); }
+
 SdpAnchorVector SdpRangeFinder::FindAnchors(const std::string& consensusSequence,
                                             const std::string& readSequence) const
 {
-    return CCS::SparseAlign(6, consensusSequence, readSequence);
+    for (const auto& kept : kept_)
+        if (kept.first == readSequence) return kept.second;
+    return CCS::SparseAlign(SDP_QGRAM_SIZE, consensusSequence, readSequence);
 }
 
 SparsePoa::SparsePoa()
@@ -39,6 +77,7 @@ SparsePoa::SparsePoa()
     , readPaths_()
     , reverseComplemented_()
     , rangeFinder_(new SdpRangeFinder())
+    , orientationCounts_()
 {
 }
 
@@ -63,14 +102,7 @@ SparsePoa::ReadKey SparsePoa::AddRead(const std::string& readSequence,
         key = graph_->NumReads() - 1;
     } else {
         auto c = graph_->TryAddRead(readSequence, config, rangeFinder_);
-
-        if (c->Score() >= minScoreToAdd) {
-            graph_->CommitAdd(c, &outputPath);
-            readPaths_.push_back(outputPath);
-            reverseComplemented_.push_back(false);
-            key = graph_->NumReads() - 1;
-        }
-
+        key = commitRead(c, false, minScoreToAdd);
         delete c;
     }
 
@@ -91,29 +123,58 @@ SparsePoa::ReadKey SparsePoa::OrientAndAddRead(const std::string& readSequence,
         reverseComplemented_.push_back(false);
         key = graph_->NumReads() - 1;
     } else {
-        auto c1 = graph_->TryAddRead(readSequence, config, rangeFinder_);
-        auto c2 = graph_->TryAddRead(ReverseComplement(readSequence), config, rangeFinder_);
-
-        if (c1->Score() >= c2->Score() && c1->Score() >= minScoreToAdd) {
-            graph_->CommitAdd(c1, &outputPath);
-            readPaths_.push_back(outputPath);
-            reverseComplemented_.push_back(false);
-            key = graph_->NumReads() - 1;
-        } else if (c2->Score() >= c1->Score() && c2->Score() >= minScoreToAdd) {
-            graph_->CommitAdd(c2, &outputPath);
-            readPaths_.push_back(outputPath);
-            reverseComplemented_.push_back(true);
-            key = graph_->NumReads() - 1;
+        const std::string revSequence = ReverseComplement(readSequence);
+        const std::string consensusSequence = graph_->ConsensusSequence(config);
+        SdpAnchorVector fwdAnchors =
+            CCS::SparseAlign(SDP_QGRAM_SIZE, consensusSequence, readSequence);
+        SdpAnchorVector revAnchors =
+            CCS::SparseAlign(SDP_QGRAM_SIZE, consensusSequence, revSequence);
+        const Strand strand = ClassifyStrand(fwdAnchors.size(), revAnchors.size());
+
+        // the range finder reuses the anchors of the strands aligned below
+        if (strand != Strand::AMBIGUOUS) {
+            ++orientationCounts_.BySeeds;
+            const bool isRev = strand == Strand::REVERSE;
+            const std::string& sequence = isRev ? revSequence : readSequence;
+            rangeFinder_->KeepAnchors(sequence, std::move(isRev ? revAnchors : fwdAnchors));
+            auto c = graph_->TryAddRead(sequence, config, rangeFinder_);
+            rangeFinder_->ClearAnchors();
+            key = commitRead(c, isRev, minScoreToAdd);
+            delete c;
         } else {
-            key = -1;
+            ++orientationCounts_.ByAlignment;
+            rangeFinder_->KeepAnchors(readSequence, std::move(fwdAnchors));
+            rangeFinder_->KeepAnchors(revSequence, std::move(revAnchors));
+            auto c1 = graph_->TryAddRead(readSequence, config, rangeFinder_);
+            auto c2 = graph_->TryAddRead(revSequence, config, rangeFinder_);
+            rangeFinder_->ClearAnchors();
+
+            if (c1->Score() >= c2->Score())
+                key = commitRead(c1, false, minScoreToAdd);
+            else
+                key = commitRead(c2, true, minScoreToAdd);
+
+            delete c1;
+            delete c2;
         }
-
-        delete c1;
-        delete c2;
     }
     return key;
 }
 
+SparsePoa::ReadKey SparsePoa::commitRead(PoaAlignmentMatrix* mat, const bool reverseComplemented,
+                                         const float minScoreToAdd)
+{
+    if (mat->Score() < minScoreToAdd) return -1;
+
+    Path outputPath;
+    graph_->CommitAdd(mat, &outputPath);
+    readPaths_.push_back(outputPath);
+    reverseComplemented_.push_back(reverseComplemented);
+    return graph_->NumReads() - 1;
+}
+
+const PoaOrientationCounts& SparsePoa::OrientationCounts() const { return orientationCounts_; }
+
 std::shared_ptr<const PoaConsensus> SparsePoa::FindConsensus(
     int minCoverage, std::vector<PoaAlignmentSummary>* summaries) const
 {
@@ -0,0 +1,150 @@
+#include <pacbio/ccs/StageTimings.h>
+
+#include <time.h>
+
+#include <atomic>
+#include <iomanip>
+#include <thread>
+
+#include <pacbio/parallel/ForkJoinPool.h>
+
+#include "matrix/BufferPool.h"
+
+namespace PacBio {
+namespace CCS {
+namespace {  // anonymous
+
+// CPU time of the calling thread and of the helpers working for it
+int64_t ThreadCpuNanoseconds()
+{
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec +
+           Parallel::ForkJoinPool::ThreadLocal().HelperCpuNanoseconds();
+}
+
+void WriteTimings(std::ostream& os, const StageTimings& timings, const char* indent)
+{
+    os << indent << "\"zmws\": " << timings.Zmws << ",\n";
+    os << indent << "\"matrix_cells\": " << timings.MatrixCells << ",\n";
+    os << indent << "\"flip_flops\": " << timings.FlipFlops << ",\n";
+    os << indent << "\"poa_oriented_by_seeds\": " << timings.PoaOrientedBySeeds << ",\n";
+    os << indent << "\"poa_oriented_by_alignment\": " << timings.PoaOrientedByAlignment << ",\n";
+    os << indent << "\"buffer_allocations\": " << timings.BufferAllocations << ",\n";
+    os << indent << "\"stages\": {";
+    for (size_t i = 0; i < timings.Stages.size(); ++i) {
+        const StageTime& time = timings.Stages[i];
+        os << (i == 0 ? "\n" : ",\n") << indent << "    \"" << StageName(static_cast<Stage>(i))
+           << "\": {\"calls\": " << time.Calls << ", \"wall_ms\": " << time.WallMilliseconds
+           << ", \"cpu_ms\": " << time.CpuMilliseconds << '}';
+    }
+    os << '\n' << indent << '}';
+}
+
+}  // namespace anonymous
+
+const char* StageName(const Stage stage)
+{
+    switch (stage) {
+        case Stage::FILTER:
+            return "filter";
+        case Stage::POA:
+            return "poa";
+        case Stage::MAP_READS:
+            return "map_reads";
+        case Stage::ADD_READS:
+            return "add_reads";
+        case Stage::POLISH:
+            return "polish";
+        case Stage::QVS:
+            return "qvs";
+        case Stage::WRITE:
+            return "write";
+        default:
+            return "unknown";
+    }
+}
+
+StageTimings& StageTimings::operator+=(const StageTimings& other)
+{
+    for (size_t i = 0; i < Stages.size(); ++i) {
+        Stages[i].Calls += other.Stages[i].Calls;
+        Stages[i].WallMilliseconds += other.Stages[i].WallMilliseconds;
+        Stages[i].CpuMilliseconds += other.Stages[i].CpuMilliseconds;
+    }
+    Zmws += other.Zmws;
+    MatrixCells += other.MatrixCells;
+    FlipFlops += other.FlipFlops;
+    PoaOrientedBySeeds += other.PoaOrientedBySeeds;
+    PoaOrientedByAlignment += other.PoaOrientedByAlignment;
+    BufferAllocations += other.BufferAllocations;
+    return *this;
+}
+
+ThreadTimings& operator+=(ThreadTimings& timings, const ThreadTimings& other)
+{
+    for (const auto& thread : other)
+        timings[thread.first] += thread.second;
+    return timings;
+}
+
+size_t ThreadIndex()
+{
+    static std::atomic<size_t> nThreads{0};
+    thread_local const size_t index = nThreads++;
+    return index;
+}
+
+int64_t ThreadBufferAllocations()
+{
+    std::atomic<int64_t> allocations{
+        static_cast<int64_t>(Consensus::BufferPool::ThreadLocal().Allocations())};
+
+    // the helpers allocate from pools of their own, read them on each helper
+    Parallel::ForkJoinPool& helpers = Parallel::ForkJoinPool::ThreadLocal();
+    const size_t nHelpers = helpers.NumHelpers();
+    if (nHelpers > 0) {
+        const std::thread::id caller = std::this_thread::get_id();
+        helpers.Run(nHelpers + 1, [&allocations, caller]() {
+            if (std::this_thread::get_id() != caller)
+                allocations += Consensus::BufferPool::ThreadLocal().Allocations();
+        });
+    }
+    return allocations.load();
+}
+
+void WriteStageTimings(std::ostream& os, const ThreadTimings& timings)
+{
+    StageTimings total;
+    for (const auto& thread : timings)
+        total += thread.second;
+
+    os << std::fixed << std::setprecision(3);
+    os << "{\n    \"threads\": [";
+    bool first = true;
+    for (const auto& thread : timings) {
+        os << (first ? "\n" : ",\n") << "        {\n";
+        os << "            \"thread\": " << thread.first << ",\n";
+        WriteTimings(os, thread.second, "            ");
+        os << "\n        }";
+        first = false;
+    }
+    os << "\n    ],\n    \"total\": {\n";
+    WriteTimings(os, total, "        ");
+    os << "\n    }\n}\n";
+}
+
+ScopedStageTimer::ScopedStageTimer(const Stage stage, StageTimings* const timings)
+    : time_{&(*timings)[stage]}, cpuStart_{ThreadCpuNanoseconds()}
+{
+}
+
+ScopedStageTimer::~ScopedStageTimer()
+{
+    time_->Calls += 1;
+    time_->WallMilliseconds += wall_.ElapsedNanoseconds() / 1e6;
+    time_->CpuMilliseconds += (ThreadCpuNanoseconds() - cpuStart_) / 1e6;
+}
+
+}  // namespace CCS
+}  // namespace PacBio
@@ -1,5 +1,6 @@
 // Author: Lance Hepler
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <sstream>
@@ -13,6 +14,59 @@ namespace Consensus {
 
 using TemplateTooSmall = PacBio::Exception::TemplateTooSmall;
 
+namespace {  // anonymous
+
+// Apply mut to the positions of the template from offset on, re-populating
+// the positions whose context it changes
+void MutatePositions(const ModelConfig& cfg, std::vector<TemplatePosition>* const positions,
+                     const size_t offset, const Mutation& mut)
+{
+    auto& tpl = *positions;
+    const size_t b = mut.Start() - offset;
+
+    if (mut.IsDeletion()) {
+        const size_t e = mut.End() - offset;
+        tpl.erase(tpl.begin() + b, tpl.begin() + e);
+
+        if (b > 0) {
+            if (b < tpl.size())
+                tpl[b - 1] = cfg.Populate({tpl[b - 1].Base, tpl[b].Base})[0];
+            else
+                tpl[b - 1] = TemplatePosition{tpl[b - 1].Base, 1.0, 0.0, 0.0, 0.0};
+        }
+    } else if (mut.IsInsertion()) {
+        const auto elems = cfg.Populate(mut.Bases());
+        const size_t e = b + elems.size();
+
+        tpl.insert(tpl.begin() + b, elems.begin(), elems.end());
+
+        if (b > 0) tpl[b - 1] = cfg.Populate({tpl[b - 1].Base, tpl[b].Base})[0];
+        if (0 < e && e < tpl.size()) tpl[e - 1] = cfg.Populate({tpl[e - 1].Base, tpl[e].Base})[0];
+    } else if (mut.IsSubstitution()) {
+        const auto elems = cfg.Populate(mut.Bases());
+        const size_t e = mut.End() - offset;
+
+        for (size_t i = b; i < e; ++i)
+            tpl[i] = elems[i - b];
+
+        if (b > 0) tpl[b - 1] = cfg.Populate({tpl[b - 1].Base, tpl[b].Base})[0];
+        if (0 < e && e < tpl.size()) tpl[e - 1] = cfg.Populate({tpl[e - 1].Base, tpl[e].Base})[0];
+    } else
+        throw std::invalid_argument(
+            "invalid mutation type! must be DELETION, INSERTION, or "
+            "SUBSTITUTION");
+}
+
+// The position of the last base of a window ending at end of store
+TemplatePosition LastPosition(const TemplateStore& store, const size_t end)
+{
+    if (end == 0 || end > store.Length())
+        throw std::invalid_argument("template window exceeds the template!");
+    return TemplatePosition{store[end - 1].Base, 1.0, 0.0, 0.0, 0.0};
+}
+
+}  // namespace anonymous
+
 //
 // AbstractTemplate Function Definitions
 //
@@ -209,13 +263,13 @@ std::ostream& operator<<(std::ostream& os, const AbstractTemplate& tpl)
 //
 // (Concrete) Template Function Definitions
 //
-Template::Template(const std::string& tpl, std::unique_ptr<ModelConfig>&& cfg)
+Template::Template(const std::string& tpl, std::shared_ptr<const ModelConfig> cfg)
     : Template(tpl, std::move(cfg), 0, tpl.length(), true, true)
 {
 }
 
-Template::Template(const std::string& tpl, std::unique_ptr<ModelConfig>&& cfg, const size_t start,
-                   const size_t end, const bool pinStart, const bool pinEnd)
+Template::Template(const std::string& tpl, std::shared_ptr<const ModelConfig> cfg,
+                   const size_t start, const size_t end, const bool pinStart, const bool pinEnd)
     : AbstractTemplate(start, end, pinStart, pinEnd)
     , cfg_(std::move(cfg))
     , tpl_{cfg_->Populate(tpl)}
@@ -233,45 +287,8 @@ bool Template::ApplyMutation(const Mutation& mut)
     if (Length() == 0 && mut.LengthDiff() < 1) goto finish;
     if (!InRange(mut.Start(), mut.End())) goto finish;
 
-    {
-        const size_t b = mut.Start() - start_;
-
-        if (mut.IsDeletion()) {
-            const size_t e = mut.End() - start_;
-            tpl_.erase(tpl_.begin() + b, tpl_.begin() + e);
-
-            if (b > 0) {
-                if (b < tpl_.size())
-                    tpl_[b - 1] = cfg_->Populate({tpl_[b - 1].Base, tpl_[b].Base})[0];
-                else
-                    tpl_[b - 1] = TemplatePosition{tpl_[b - 1].Base, 1.0, 0.0, 0.0, 0.0};
-            }
-        } else if (mut.IsInsertion()) {
-            const auto elems = cfg_->Populate(mut.Bases());
-            const size_t e = b + elems.size();
-
-            tpl_.insert(tpl_.begin() + b, elems.begin(), elems.end());
-
-            if (b > 0) tpl_[b - 1] = cfg_->Populate({tpl_[b - 1].Base, tpl_[b].Base})[0];
-            if (0 < e && e < tpl_.size())
-                tpl_[e - 1] = cfg_->Populate({tpl_[e - 1].Base, tpl_[e].Base})[0];
-        } else if (mut.IsSubstitution()) {
-            const auto elems = cfg_->Populate(mut.Bases());
-            const size_t e = mut.End() - start_;
-
-            for (size_t i = b; i < e; ++i)
-                tpl_[i] = elems[i - b];
-
-            if (b > 0) tpl_[b - 1] = cfg_->Populate({tpl_[b - 1].Base, tpl_[b].Base})[0];
-            if (0 < e && e < tpl_.size())
-                tpl_[e - 1] = cfg_->Populate({tpl_[e - 1].Base, tpl_[e].Base})[0];
-        } else
-            throw std::invalid_argument(
-                "invalid mutation type! must be DELETION, INSERTION, or "
-                "SUBSTITUTION");
-
-        mutApplied = true;
-    }
+    MutatePositions(*cfg_, &tpl_, start_, mut);
+    mutApplied = true;
 
 finish:
     // update the start_ and end_ mappings
@@ -304,6 +321,118 @@ double Template::ExpectedLLForEmission(MoveType move, const AlleleRep& prev, con
     return cfg_->ExpectedLLForEmission(move, prev, curr, moment);
 }
 
+//
+// TemplateStore Function Definitions
+//
+TemplateStore::TemplateStore(const std::string& tpl, std::shared_ptr<const ModelConfig> cfg)
+    : cfg_(std::move(cfg)), tpl_{cfg_->Populate(tpl)}, generation_{0}
+{
+}
+
+void TemplateStore::KeepPrevious()
+{
+    // swapping keeps the previous positions at their addresses, where the
+    // views that have yet to follow the store point to
+    previous_.swap(tpl_);
+    tpl_ = previous_;
+    ++generation_;
+}
+
+void TemplateStore::ApplyMutation(const Mutation& mut)
+{
+    KeepPrevious();
+    MutatePositions(*cfg_, &tpl_, 0, mut);
+}
+
+void TemplateStore::ApplyMutations(std::vector<Mutation>* const muts)
+{
+    KeepPrevious();
+
+    // make sure the mutations are sorted by site: End() then Start()
+    std::sort(muts->begin(), muts->end(), Mutation::SiteComparer);
+
+    for (auto it = muts->crbegin(); it != muts->crend(); ++it)
+        MutatePositions(*cfg_, &tpl_, 0, *it);
+}
+
+//
+// TemplateView Function Definitions
+//
+TemplateView::TemplateView(std::shared_ptr<const TemplateStore> store, const size_t start,
+                           const size_t end, const bool pinStart, const bool pinEnd)
+    : AbstractTemplate(start, end, pinStart, pinEnd)
+    , store_(std::move(store))
+    , window_{store_->tpl_.data() + start_}
+    , last_{LastPosition(*store_, end_)}
+    , generation_{store_->generation_}
+{
+    assert(!pinStart_ || start_ == 0);
+}
+
+void TemplateView::Follow()
+{
+    if (generation_ + 1 != store_->generation_)
+        throw std::runtime_error("template view must follow each mutation of its store!");
+    assert(!pinStart_ || start_ == 0);
+
+    window_ = store_->tpl_.data() + start_;
+    generation_ = store_->generation_;
+
+    if (Length() < 2) throw TemplateTooSmall();
+
+    last_ = LastPosition(*store_, end_);
+}
+
+bool TemplateView::ApplyMutation(const Mutation& mut)
+{
+    // the store has already changed the positions, only move the window
+    const bool mutApplied = AbstractTemplate::ApplyMutation(mut);
+    Follow();
+    return mutApplied;
+}
+
+bool TemplateView::ApplyMutations(std::vector<Mutation>* const muts)
+{
+    bool mutsApplied = false;
+
+    // make sure the mutations are sorted by site: End() then Start()
+    std::sort(muts->begin(), muts->end(), Mutation::SiteComparer);
+
+    for (auto it = muts->crbegin(); it != muts->crend(); ++it)
+        mutsApplied |= AbstractTemplate::ApplyMutation(*it);
+
+    Follow();
+    return mutsApplied;
+}
+
+size_t TemplateView::Length() const { return end_ - start_; }
+
+const TemplatePosition& TemplateView::operator[](const size_t i) const
+{
+    CheckGeneration();
+    return (i + 1 < Length()) ? window_[i] : last_;
+}
+
+void TemplateView::CheckGeneration() const
+{
+    // Between a mutation of the store and Follow, the window still points at
+    // the previous positions of the store, which stay until its next mutation
+    if (generation_ + 1 < store_->generation_)
+        throw std::runtime_error("template view missed a mutation of its store!");
+}
+
+std::unique_ptr<AbstractRecursor> TemplateView::CreateRecursor(const PacBio::Data::MappedRead& mr,
+                                                               double scoreDiff) const
+{
+    return store_->Config()->CreateRecursor(mr, scoreDiff);
+}
+
+double TemplateView::ExpectedLLForEmission(MoveType move, const AlleleRep& prev,
+                                           const AlleleRep& curr, MomentType moment) const
+{
+    return store_->Config()->ExpectedLLForEmission(move, prev, curr, moment);
+}
+
 //
 // MutatedTemplate Function Definitions
 //
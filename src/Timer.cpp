@@ -19,6 +19,12 @@ float Timer::ElapsedMilliseconds() const
     return std::chrono::duration_cast<milliseconds>(tock - tick).count();
 }
 
+int64_t Timer::ElapsedNanoseconds() const
+{
+    auto tock = steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tock - tick).count();
+}
+
 float Timer::ElapsedSeconds() const { return ElapsedMilliseconds() / 1000; }
 
 std::string Timer::ElapsedTime() const
@@ -7,3 +7,16 @@
 #endif
 
 #include <pacbio/UnanimityConfig.h>
+
+// Function multiversioning for the hot DP kernels: GCC emits one clone per
+// listed instruction set and an ifunc resolver picks the best one at load
+// time. Other toolchains get the portable (compiler-vectorized) build.
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 6) && defined(__x86_64__) && \
+    defined(__linux__)
+#define UNANIMITY_TARGET_CLONES \
+    __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+#define UNANIMITY_HAS_TARGET_CLONES 1
+#else
+#define UNANIMITY_TARGET_CLONES
+#define UNANIMITY_HAS_TARGET_CLONES 0
+#endif
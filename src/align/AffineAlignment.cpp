@@ -3,32 +3,29 @@
 #include <algorithm>
 #include <cassert>
 #include <cfloat>
+#include <cstdint>
 #include <string>
+#include <type_traits>
 #include <vector>
 
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/matrix_proxy.hpp>
-
 #include <pacbio/align/AffineAlignment.h>
 #include <pacbio/align/PairwiseAlignment.h>
 #include <pacbio/data/Sequence.h>
+
+#include "BandedTraceback.h"
 // #include <pacbio/consensus/Utils.h>
 
 namespace PacBio {
 namespace Align {
 
 using namespace PacBio::Data;
+using PacBio::Align::internal::BandedTraceback;
 
 namespace {
 
 class IupacAware;
 class Standard;
 
-static float MAX4(float a, float b, float c, float d)
-{
-    return std::max(std::max(a, b), std::max(c, d));
-}
-
 inline bool IsIupacPartialMatch(char iupacCode, char b)
 {
     assert(iupacCode != b);
@@ -75,99 +72,167 @@ inline float MatchScore<IupacAware>(char t, char q, float matchScore, float mism
     }  // NOLINT
 }
 
+// Traceback of the affine aligner, 4 bits per cell: bit 0 is set if the
+// match state at (i, j) was reached from the gap state, bits 1-2 hold the
+// argmax over (M left, GAP left, M up, GAP up) of the gap state at (i, j)
+enum : uint8_t
+{
+    FROM_GAP = 0x1,
+    GAP_SHIFT = 1
+};
+
+// An upper bound on the score of the global alignments leaving the band of tb:
+// those make at least one gap, and at most MaxDiagonalMovesOutside() moves
+// along the diagonal; the bound is linear in the number of the latter.
+template <class C>
+float OutsideBandBound(const BandedTraceback<4>& tb, const int I, const int J,
+                       const AffineAlignmentParams& params)
+{
+    float maxMatch = std::max(params.MatchScore, params.MismatchScore);
+    if (std::is_same<C, IupacAware>::value) maxMatch = std::max(maxMatch, params.PartialMatchScore);
+    const auto bound = [&](const int nDiag) {
+        const int nGaps = I + J - 2 * nDiag;
+        const float gaps = (params.GapOpen <= params.GapExtend)
+                               ? params.GapOpen + (nGaps - 1) * params.GapExtend
+                               : nGaps * params.GapOpen;
+        return nDiag * maxMatch + gaps;
+    };
+    return std::max(bound(0), bound(tb.MaxDiagonalMovesOutside()));
+}
+
 template <class C>
 PairwiseAlignment* AlignAffineGeneric(const std::string& target, const std::string& query,
                                       AffineAlignmentParams params)
 {
     // Implementation follows the textbook "two-state" affine gap model
     // description from Durbin et. al
-    using boost::numeric::ublas::matrix;
-
-    int I = query.length();
-    int J = target.length();
-    matrix<float> M(I + 1, J + 1);
-    matrix<float> GAP(I + 1, J + 1);
-
-    // Initialization
-    M(0, 0) = 0;
-    GAP(0, 0) = -FLT_MAX;
-    for (int i = 1; i <= I; ++i) {
-        M(i, 0) = -FLT_MAX;
-        GAP(i, 0) = params.GapOpen + (i - 1) * params.GapExtend;
-    }
-    for (int j = 1; j <= J; ++j) {
-        M(0, j) = -FLT_MAX;
-        GAP(0, j) = params.GapOpen + (j - 1) * params.GapExtend;
-    }
+    //
+    // Only two rows of M and GAP are kept, along with the packed traceback
+    // of the cells in the band.  As in Align, each row is filled with the
+    // moves from the previous row first, which vectorize, and then with
+    // the moves along the row.
+    const int I = query.length();
+    const int J = target.length();
+    int bandWidth = params.BandWidth;
+
+    while (true) {
+        BandedTraceback<4> tb(I, J, bandWidth);
+        std::vector<float> prevM(J + 1, -FLT_MAX), prevGap(J + 1, -FLT_MAX);
+        std::vector<float> M(J + 1, -FLT_MAX), GAP(J + 1, -FLT_MAX);
+        std::vector<uint8_t> codes(J + 1);
 
-    // Main part of the recursion
-    for (int i = 1; i <= I; ++i) {
-        for (int j = 1; j <= J; ++j) {
-            float matchScore = MatchScore<C>(target[j - 1], query[i - 1], params.MatchScore,
-                                             params.MismatchScore, params.PartialMatchScore);
-            M(i, j) = std::max(M(i - 1, j - 1), GAP(i - 1, j - 1)) + matchScore;
-            GAP(i, j) = MAX4(M(i, j - 1) + params.GapOpen, GAP(i, j - 1) + params.GapExtend,
-                             M(i - 1, j) + params.GapOpen, GAP(i - 1, j) + params.GapExtend);
+        // Initialization
+        M[0] = 0;
+        GAP[0] = -FLT_MAX;
+        for (int j = 1; j < tb.End(0); ++j) {
+            M[j] = -FLT_MAX;
+            GAP[j] = params.GapOpen + (j - 1) * params.GapExtend;
+            tb.Set(0, j, (j == 1 ? 0 : 1) << GAP_SHIFT);
         }
-    }
+        if (tb.End(0) <= J) M[tb.End(0)] = GAP[tb.End(0)] = -FLT_MAX;
 
-    // Perform the traceback
-    const int MATCH_MATRIX = 1;
-    const int GAP_MATRIX = 2;
-
-    std::string raQuery, raTarget;
-    int i = I, j = J;
-    int mat = (M(I, J) >= GAP(I, J) ? MATCH_MATRIX : GAP_MATRIX);
-    int iPrev, jPrev, matPrev;
-    while (i > 0 || j > 0) {
-        if (mat == MATCH_MATRIX) {
-            matPrev = (M(i - 1, j - 1) >= GAP(i - 1, j - 1) ? MATCH_MATRIX : GAP_MATRIX);
-            iPrev = i - 1;
-            jPrev = j - 1;
-            raQuery.push_back(query[iPrev]);
-            raTarget.push_back(target[jPrev]);
-        } else {
-            assert(mat == GAP_MATRIX);
-            float s[4];
-            s[0] = (j > 0 ? M(i, j - 1) + params.GapOpen : -FLT_MAX);
-            s[1] = (j > 0 ? GAP(i, j - 1) + params.GapExtend : -FLT_MAX);
-            s[2] = (i > 0 ? M(i - 1, j) + params.GapOpen : -FLT_MAX);
-            s[3] = (i > 0 ? GAP(i - 1, j) + params.GapExtend : -FLT_MAX);
-            int argMax = std::max_element(s, s + 4) - s;
-
-            matPrev = ((argMax == 0 || argMax == 2) ? MATCH_MATRIX : GAP_MATRIX);
-            if (argMax == 0 || argMax == 1) {
-                iPrev = i;
-                jPrev = j - 1;
-                raQuery.push_back('-');
-                raTarget.push_back(target[jPrev]);
+        // Main part of the recursion
+        for (int i = 1; i <= I; ++i) {
+            std::swap(prevM, M);
+            std::swap(prevGap, GAP);
+            int jBegin = tb.Begin(i);
+            const int jEnd = tb.End(i);
+            const char q = query[i - 1];
+
+            if (jBegin == 0) {
+                M[0] = -FLT_MAX;
+                GAP[0] = params.GapOpen + (i - 1) * params.GapExtend;
+                tb.Set(i, 0, (i == 1 ? 2 : 3) << GAP_SHIFT);
+                jBegin = 1;
             } else {
-                iPrev = i - 1;
-                jPrev = j;
-                raQuery.push_back(query[iPrev]);
-                raTarget.push_back('-');
+                M[jBegin - 1] = GAP[jBegin - 1] = -FLT_MAX;
+            }
+
+            float* const m = M.data();
+            float* const g = GAP.data();
+            const float* const pm = prevM.data();
+            const float* const pg = prevGap.data();
+            uint8_t* const x = codes.data();
+            for (int j = jBegin; j < jEnd; ++j) {
+                const float matchScore =
+                    MatchScore<C>(target[j - 1], q, params.MatchScore, params.MismatchScore,
+                                  params.PartialMatchScore);
+                const bool fromGap = !(pm[j - 1] >= pg[j - 1]);
+                m[j] = std::max(pm[j - 1], pg[j - 1]) + matchScore;
+                const float mUp = pm[j] + params.GapOpen;
+                const float gapUp = pg[j] + params.GapExtend;
+                g[j] = std::max(mUp, gapUp);
+                x[j] = (fromGap ? FROM_GAP : 0) | ((mUp >= gapUp ? 2 : 3) << GAP_SHIFT);
+            }
+            for (int j = jBegin; j < jEnd; ++j) {
+                const float mLeft = m[j - 1] + params.GapOpen;
+                const float gapLeft = g[j - 1] + params.GapExtend;
+                const float left = std::max(mLeft, gapLeft);
+                if (left >= g[j]) {
+                    g[j] = left;
+                    x[j] = (x[j] & FROM_GAP) | ((mLeft >= gapLeft ? 0 : 1) << GAP_SHIFT);
+                }
             }
+            if (jEnd <= J) M[jEnd] = GAP[jEnd] = -FLT_MAX;
+
+            for (int j = jBegin; j < jEnd; ++j)
+                tb.Set(i, j, x[j]);
         }
 
-        // Go to previous square
-        i = iPrev;
-        j = jPrev;
-        mat = matPrev;
-    }
+        // An alignment leaving the band may beat the one found, widen it
+        if (!tb.IsFull() && std::max(M[J], GAP[J]) < OutsideBandBound<C>(tb, I, J, params)) {
+            bandWidth *= 2;
+            continue;
+        }
 
-    assert(raQuery.length() == raTarget.length());
-    return new PairwiseAlignment(Reverse(raTarget), Reverse(raQuery));
+        // Perform the traceback
+        const int MATCH_MATRIX = 1;
+        const int GAP_MATRIX = 2;
+
+        std::string raQuery, raTarget;
+        int i = I, j = J;
+        int mat = (M[J] >= GAP[J] ? MATCH_MATRIX : GAP_MATRIX);
+        while (i > 0 || j > 0) {
+            const uint8_t code = tb.Get(i, j);
+            if (mat == MATCH_MATRIX) {
+                mat = ((code & FROM_GAP) ? GAP_MATRIX : MATCH_MATRIX);
+                --i;
+                --j;
+                raQuery.push_back(query[i]);
+                raTarget.push_back(target[j]);
+            } else {
+                assert(mat == GAP_MATRIX);
+                const int argMax = code >> GAP_SHIFT;
+
+                mat = ((argMax == 0 || argMax == 2) ? MATCH_MATRIX : GAP_MATRIX);
+                if (argMax == 0 || argMax == 1) {
+                    --j;
+                    raQuery.push_back('-');
+                    raTarget.push_back(target[j]);
+                } else {
+                    --i;
+                    raQuery.push_back(query[i]);
+                    raTarget.push_back('-');
+                }
+            }
+        }
+
+        assert(raQuery.length() == raTarget.length());
+        return new PairwiseAlignment(Reverse(raTarget), Reverse(raQuery));
+    }
 }
 
 }  // anonymous namespace
 
 AffineAlignmentParams::AffineAlignmentParams(float matchScore, float mismatchScore, float gapOpen,
-                                             float gapExtend, float partialMatchScore)
+                                             float gapExtend, float partialMatchScore,
+                                             int bandWidth)
     : MatchScore(matchScore)
     , MismatchScore(mismatchScore)
     , GapOpen(gapOpen)
     , GapExtend(gapExtend)
     , PartialMatchScore(partialMatchScore)
+    , BandWidth(bandWidth)
 {
 }
 
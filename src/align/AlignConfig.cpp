@@ -12,7 +12,10 @@ AlignParams::AlignParams(int match, int mismatch, int insert, int delete_)
 
 AlignParams AlignParams::Default() { return {0, -1, -1, -1}; }
 
-AlignConfig::AlignConfig(AlignParams params, AlignMode mode) : Params(params), Mode(mode) {}
+AlignConfig::AlignConfig(AlignParams params, AlignMode mode, int bandWidth)
+    : Params(params), Mode(mode), BandWidth(bandWidth)
+{
+}
 
 AlignConfig AlignConfig::Default() { return {AlignParams::Default(), AlignMode::GLOBAL}; }
 
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PacBio {
+namespace Align {
+namespace internal {
+
+//
+// The traceback of a pairwise alignment restricted to a diagonal band,
+// i.e. to the cells (i, j) of the (I+1) x (J+1) matrix with
+//
+//     lo <= j - i <= hi
+//
+// The aligners start from a narrow band and double it until their score
+// beats that of any global alignment leaving the band, so the result stays
+// optimal.
+//
+// Only the moves are kept, BITS bits per cell, packed 8 / BITS to a byte;
+// the aligners fill the scores row by row into two rolling rows.  This
+// takes a 20 kb x 20 kb global alignment from 1.6 GB of int scores to
+// 100 MB of 2-bit moves unbanded, and to a few MB for a band of 100.
+//
+template <size_t BITS>
+class BandedTraceback
+{
+    static_assert(BITS == 1 || BITS == 2 || BITS == 4 || BITS == 8, "BITS must divide 8");
+
+public:
+    // A band of bandWidth diagonals on either side of the ones between the
+    // corners (0, 0) and (I, J); bandWidth <= 0 spans the whole matrix
+    BandedTraceback(const int I, const int J, const int bandWidth) : I_{I}, J_{J}
+    {
+        if (bandWidth <= 0) {
+            lo_ = -I;
+            hi_ = J;
+        } else {
+            lo_ = std::max(-I, std::min(0, J - I) - bandWidth);
+            hi_ = std::min(J, std::max(0, J - I) + bandWidth);
+        }
+
+        offsets_.resize(I + 2);
+        offsets_[0] = 0;
+        for (int i = 0; i <= I; ++i)
+            offsets_[i + 1] = offsets_[i] + (End(i) - Begin(i));
+        codes_.assign((offsets_[I + 1] * BITS + 7) / 8, 0);
+    }
+
+    // The band of row i is the half-open range of columns [Begin(i), End(i))
+    int Begin(const int i) const { return std::max(0, i + lo_); }
+    int End(const int i) const { return std::min(J_, i + hi_) + 1; }
+
+    bool IsFull() const { return lo_ <= -I_ && hi_ >= J_; }
+
+    // The most diagonal moves a global alignment leaving the band can make,
+    // or -1 if the band spans the whole matrix.  Leaving the band above
+    // takes at least hi + 1 deletions, leaving it below at least 1 - lo
+    // insertions; this bounds the score of such alignments from above.
+    int MaxDiagonalMovesOutside() const
+    {
+        int n = -1;
+        if (hi_ < J_) n = std::max(n, J_ - hi_ - 1);
+        if (lo_ > -I_) n = std::max(n, I_ + lo_ - 1);
+        return n;
+    }
+
+    void Set(const int i, const int j, const uint8_t code)
+    {
+        const size_t k = index(i, j);
+        const size_t shift = (k % PER_BYTE) * BITS;
+        codes_[k / PER_BYTE] |= (code & MASK) << shift;
+    }
+
+    uint8_t Get(const int i, const int j) const
+    {
+        const size_t k = index(i, j);
+        const size_t shift = (k % PER_BYTE) * BITS;
+        return (codes_[k / PER_BYTE] >> shift) & MASK;
+    }
+
+    size_t AllocatedBytes() const { return codes_.size(); }
+
+private:
+    static constexpr size_t PER_BYTE = 8 / BITS;
+    static constexpr uint8_t MASK = (1 << BITS) - 1;
+
+    size_t index(const int i, const int j) const
+    {
+        assert(i >= 0 && i <= I_ && j >= Begin(i) && j < End(i));
+        return offsets_[i] + (j - Begin(i));
+    }
+
+    int I_;
+    int J_;
+    int lo_;
+    int hi_;
+    std::vector<size_t> offsets_;
+    std::vector<uint8_t> codes_;
+};
+
+}  // namespace internal
+}  // namespace Align
+}  // namespace PacBio
@@ -1,14 +1,16 @@
 // Author: David Alexander
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include <boost/numeric/ublas/matrix.hpp>
-
 #include <pacbio/align/PairwiseAlignment.h>
 #include <pacbio/data/Sequence.h>
+
+#include "BandedTraceback.h"
 // #include <pacbio/consensus/Utils.hpp>
 
 namespace PacBio {
@@ -130,6 +132,7 @@ bool Rewrite3R(std::string* target, std::string* query, std::string* transcript,
 }  // PacBio::Align::internal
 
 using namespace PacBio::Data;
+using PacBio::Align::internal::BandedTraceback;
 
 std::string PairwiseAlignment::Target() const { return target_; }
 
@@ -272,94 +275,167 @@ PairwiseAlignment PairwiseAlignment::ClippedTo(const size_t refStart, const size
     return PairwiseAlignment(clippedTarget, clippedQuery, clipRefStart, clipRefEnd);
 }
 
-PairwiseAlignment* Align(const std::string& target, const std::string& query, int* score,
-                         AlignConfig config)
+namespace {  // anonymous
+
+// Moves of the linear gap aligner, 2 bits each
+enum : uint8_t
 {
-    using boost::numeric::ublas::matrix;
+    MATCH = 0,
+    INSERT = 1,
+    DELETE = 2
+};
+
+constexpr int NEG_INF = std::numeric_limits<int>::min() / 2;
 
+// Fill the band of tb with the moves of the optimal alignments, keeping only
+// two rows of scores, and return the last row of scores.
+//
+// Each row is filled in two passes: first the diagonal and vertical moves,
+// which only depend on the previous row and so vectorize, then the
+// horizontal moves, a running max along the row.  The moves agree with
+// ArgMax3 over (match, insert, delete), ties included.
+std::vector<int> FillBand(const std::string& target, const std::string& query,
+                          const AlignConfig& config, BandedTraceback<2>* tb)
+{
     const AlignParams& params = config.Params;
-    if (config.Mode != AlignMode::GLOBAL && config.Mode != AlignMode::SEMIGLOBAL) {
-        throw std::invalid_argument("Only GLOBAL and SEMIGLOBAL alignments supported at present");
-    }
+    const int I = query.length();
+    const int J = target.length();
 
-    int I = query.length();
-    int J = target.length();
-    matrix<int> Score(I + 1, J + 1);
+    std::vector<int> prev(J + 1, NEG_INF), cur(J + 1, NEG_INF);
+    std::vector<uint8_t> moves(J + 1);
 
-    Score(0, 0) = 0;
-    for (int i = 1; i <= I; i++) {
-        Score(i, 0) = i * params.Insert;
-    }
-    if (config.Mode == AlignMode::GLOBAL) {
-        for (int j = 1; j <= J; j++) {
-            Score(0, j) = j * params.Delete;
+    for (int j = 0; j < tb->End(0); ++j)
+        cur[j] = (config.Mode == AlignMode::GLOBAL) ? j * params.Delete : 0;
+    if (tb->End(0) <= J) cur[tb->End(0)] = NEG_INF;
+
+    for (int i = 1; i <= I; ++i) {
+        std::swap(prev, cur);
+        int jBegin = tb->Begin(i);
+        const int jEnd = tb->End(i);
+        const char q = query[i - 1];
+
+        if (jBegin == 0) {
+            cur[0] = i * params.Insert;
+            jBegin = 1;
+        } else {
+            cur[jBegin - 1] = NEG_INF;
         }
-    } else {
-        for (int j = 1; j <= J; j++) {
-            Score(0, j) = 0;
+
+        int* const c = cur.data();
+        const int* const p = prev.data();
+        uint8_t* const m = moves.data();
+        for (int j = jBegin; j < jEnd; ++j) {
+            const int diag = p[j - 1] + ((q == target[j - 1]) ? params.Match : params.Mismatch);
+            const int up = p[j] + params.Insert;
+            c[j] = std::max(diag, up);
+            m[j] = (diag >= up) ? MATCH : INSERT;
         }
-    }
-    for (int i = 1; i <= I; i++) {
-        for (int j = 1; j <= J; j++) {
-            bool isMatch = (query[i - 1] == target[j - 1]);
-            Score(i, j) = Max3(Score(i - 1, j - 1) + (isMatch ? params.Match : params.Mismatch),
-                               Score(i - 1, j) + params.Insert, Score(i, j - 1) + params.Delete);
+        for (int j = jBegin; j < jEnd; ++j) {
+            const int left = c[j - 1] + params.Delete;
+            if (left > c[j]) {
+                c[j] = left;
+                m[j] = DELETE;
+            }
         }
-    }
-    if (score != nullptr) {
-        *score = Score(I, J);
+        if (jEnd <= J) cur[jEnd] = NEG_INF;
+
+        for (int j = jBegin; j < jEnd; ++j)
+            tb->Set(i, j, m[j]);
     }
 
-    // Find the alignment end coordinate in the reference
-    //  This is J if Global and the maximum scoring position if not
-    int maxJ = J;
-    if (config.Mode == AlignMode::SEMIGLOBAL) {
-        int maxScore = std::numeric_limits<int>::min();
-        for (int j = 1; j <= J; ++j) {
-            if (Score(I, j) >= maxScore) {
-                maxScore = Score(I, j);
-                maxJ = j;
-            }
-        }
+    return cur;
+}
+
+// An upper bound on the score of the global alignments leaving the band of tb,
+// linear in the number of their diagonal moves
+int OutsideBandBound(const BandedTraceback<2>& tb, const int I, const int J,
+                     const AlignParams& params)
+{
+    const auto bound = [&](const int nDiag) {
+        return nDiag * std::max(params.Match, params.Mismatch) + (I - nDiag) * params.Insert +
+               (J - nDiag) * params.Delete;
+    };
+    return std::max(bound(0), bound(tb.MaxDiagonalMovesOutside()));
+}
+
+}  // anonymous namespace
+
+PairwiseAlignment* Align(const std::string& target, const std::string& query, int* score,
+                         AlignConfig config)
+{
+    if (config.Mode != AlignMode::GLOBAL && config.Mode != AlignMode::SEMIGLOBAL) {
+        throw std::invalid_argument("Only GLOBAL and SEMIGLOBAL alignments supported at present");
     }
 
-    // Traceback, build up reversed aligned query, aligned target
-    int i = I;
-    int j = maxJ;
-    std::string raQuery, raTarget;
-    while (i > 0 || (config.Mode == AlignMode::GLOBAL && j > 0)) {
-        int move;
-        if (i == 0) {
-            move = 2;  // only deletion is possible
-        } else if (j == 0) {
-            move = 1;  // only insertion is possible
-        } else {
-            bool isMatch = (query[i - 1] == target[j - 1]);
-            move = ArgMax3(Score(i - 1, j - 1) + (isMatch ? params.Match : params.Mismatch),
-                           Score(i - 1, j) + params.Insert, Score(i, j - 1) + params.Delete);
+    const int I = query.length();
+    const int J = target.length();
+
+    // A band only makes sense if both ends of the alignment are fixed
+    int bandWidth = (config.Mode == AlignMode::GLOBAL) ? config.BandWidth : 0;
+
+    while (true) {
+        BandedTraceback<2> tb(I, J, bandWidth);
+        const std::vector<int> lastRow = FillBand(target, query, config, &tb);
+
+        // An alignment leaving the band may beat the one found, widen it
+        if (!tb.IsFull() && lastRow[J] < OutsideBandBound(tb, I, J, config.Params)) {
+            bandWidth *= 2;
+            continue;
         }
-        // Incorporate:
-        if (move == 0) {
-            i--;
-            j--;
-            raQuery.push_back(query[i]);
-            raTarget.push_back(target[j]);
+
+        // Find the alignment end coordinate in the reference
+        //  This is J if Global and the maximum scoring position if not
+        int maxJ = J;
+        if (config.Mode == AlignMode::SEMIGLOBAL) {
+            int maxScore = std::numeric_limits<int>::min();
+            for (int j = 1; j <= J; ++j) {
+                if (lastRow[j] >= maxScore) {
+                    maxScore = lastRow[j];
+                    maxJ = j;
+                }
+            }
         }
-        // Insert:
-        else if (move == 1) {
-            i--;
-            raQuery.push_back(query[i]);
-            raTarget.push_back('-');
+
+        // Traceback, build up reversed aligned query, aligned target
+        int i = I;
+        int j = maxJ;
+        std::string raQuery, raTarget;
+        while (i > 0 || (config.Mode == AlignMode::GLOBAL && j > 0)) {
+            int move;
+            if (i == 0) {
+                move = DELETE;  // only deletion is possible
+            } else if (j == 0) {
+                move = INSERT;  // only insertion is possible
+            } else {
+                move = tb.Get(i, j);
+            }
+            // Incorporate:
+            if (move == MATCH) {
+                i--;
+                j--;
+                raQuery.push_back(query[i]);
+                raTarget.push_back(target[j]);
+            }
+            // Insert:
+            else if (move == INSERT) {
+                i--;
+                raQuery.push_back(query[i]);
+                raTarget.push_back('-');
+            }
+            // Delete:
+            else if (move == DELETE) {
+                j--;
+                raQuery.push_back('-');
+                raTarget.push_back(target[j]);
+            }
         }
-        // Delete:
-        else if (move == 2) {
-            j--;
-            raQuery.push_back('-');
-            raTarget.push_back(target[j]);
+
+        if (score != nullptr) {
+            *score = lastRow[J];
         }
+        return new PairwiseAlignment(Reverse(raTarget), Reverse(raQuery), std::max(0, j - 1),
+                                     maxJ - 1);
     }
-
-    return new PairwiseAlignment(Reverse(raTarget), Reverse(raQuery), std::max(0, j - 1), maxJ - 1);
 }
 
 PairwiseAlignment* Align(const std::string& target, const std::string& query, AlignConfig config)
@@ -7,6 +7,7 @@
 #include <pacbio/genomicconsensus/experimental/Filters.h>
 #include <pacbio/genomicconsensus/experimental/Input.h>
 #include <pacbio/genomicconsensus/experimental/Intervals.h>
+#include <pacbio/genomicconsensus/experimental/ReadCache.h>
 #include <pacbio/genomicconsensus/experimental/WorkChunk.h>
 
 namespace PacBio {
@@ -89,9 +90,10 @@ WindowResult IPoaModel::ResultForWindow(const ReferenceWindow& refWindow, const
     // determine intervals for window
     std::vector<PacBio::Data::Interval> allIntervals;
     if (settings.usingFancyChunking) {
-        const PacBio::BAM::BamFile bam{settings.inputFilename};
-        const PacBio::BAM::PbiRawData index{bam.PacBioIndexFilename()};
-        allIntervals = FancyIntervals(index, refWindow, settings);
+        const auto reads = ReadCache::For(settings.inputFilename);
+        allIntervals = FancyIntervals(refWindow.interval,
+                                      reads->IntervalsInWindow(refWindow, settings.minMapQV),
+                                      settings.minCoverage);
     } else {
         allIntervals.emplace_back(winStart, winEnd);
     }
@@ -148,8 +150,10 @@ WindowResult IPoaModel::ResultForWindow(const ReferenceWindow& refWindow, const
 Consensus IPoaModel::RestrictedConsensus(const Consensus& enlargedCss, const std::string& refSeq,
                                          const ReferenceWindow& originalWindow) const
 {
+    const PacBio::Align::AlignConfig alignConfig(PacBio::Align::AlignParams::Default(),
+                                                 PacBio::Align::AlignMode::GLOBAL, 32);
     const std::unique_ptr<PacBio::Align::PairwiseAlignment> ga{
-        PacBio::Align::Align(refSeq, enlargedCss.sequence)};
+        PacBio::Align::Align(refSeq, enlargedCss.sequence, alignConfig)};
 
     const auto targetPositions = PacBio::Align::TargetToQueryPositions(*ga);
     const auto cssStart = targetPositions.at(originalWindow.Start() - enlargedCss.window.Start());
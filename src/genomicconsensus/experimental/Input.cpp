@@ -2,18 +2,26 @@
 
 #include <pacbio/genomicconsensus/experimental/Input.h>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include <pbbam/FastaSequenceQuery.h>
 #include <pbbam/PbiFilterQuery.h>
 
 #include <pacbio/genomicconsensus/experimental/Filters.h>
 #include <pacbio/genomicconsensus/experimental/Intervals.h>
+#include <pacbio/genomicconsensus/experimental/ReadCache.h>
 #include <pacbio/genomicconsensus/experimental/Sorting.h>
 
 namespace PacBio {
 namespace GenomicConsensus {
 namespace experimental {
 
-Input::Input(const Settings& settings) : settings_{settings}, fasta_{settings.referenceFilename} {}
+Input::Input(const Settings& settings) : settings_{settings}, fasta_{settings.referenceFilename}
+{
+    // datasets still go through PbiFilterQuery
+    if (boost::algorithm::iends_with(settings_.inputFilename, ".bam"))
+        reads_ = ReadCache::For(settings_.inputFilename);
+}
 
 std::vector<PacBio::BAM::BamRecord> Input::ReadsInWindow(const ReferenceWindow& window) const
 {
@@ -24,26 +32,24 @@ std::vector<PacBio::BAM::BamRecord> Input::ReadsInWindow(const ReferenceWindow&
     result.reserve(settings_.maxCoverage);
     partialHits.reserve(settings_.maxCoverage * 2);
 
-    const auto filter = MakeWindowFilter(window, settings_);
-    PbiFilterQuery query{filter, settings_.inputFilename};
-    for (const auto& record : query) {
-
-        // TODO (DB): combine with similar lambda used in FilterAlignments (Filters.cpp),
-        //            if possible?
-        const auto IsPoaCompatible = [&](const BamRecord& record) {
-            const auto readLength = record.AlignedEnd() - record.AlignedStart();
-            const auto refLength = record.ReferenceEnd() - record.ReferenceStart();
-            const auto snr = record.SignalToNoise();
-            return (readLength >= refLength * settings_.readStumpinessThreshold) &&
-                   (*std::min_element(snr.begin(), snr.end()) >= settings_.minHqRegionSnr) &&
-                   (record.ReadAccuracy() >= settings_.minReadScore);
-        };
-
+    // TODO (DB): combine with similar lambda used in FilterAlignments (Filters.cpp),
+    //            if possible?
+    const auto IsPoaCompatible = [&](const BamRecord& record) {
+        const auto readLength = record.AlignedEnd() - record.AlignedStart();
+        const auto refLength = record.ReferenceEnd() - record.ReferenceStart();
+        const auto snr = record.SignalToNoise();
+        return (readLength >= refLength * settings_.readStumpinessThreshold) &&
+               (*std::min_element(snr.begin(), snr.end()) >= settings_.minHqRegionSnr) &&
+               (record.ReadAccuracy() >= settings_.minReadScore);
+    };
+
+    // returns false once max coverage is met
+    const auto AddRecord = [&](BamRecord record) {
         // quit if max coverage met
-        if (result.size() == settings_.maxCoverage) break;
+        if (result.size() == settings_.maxCoverage) return false;
 
         // skip read if fails additional (non-PBI-backed) filters
-        if (!IsPoaCompatible(record)) continue;
+        if (!IsPoaCompatible(record)) return true;
 
         // record spans window or exact hit
         const auto refStart = static_cast<uint32_t>(record.ReferenceStart());
@@ -54,6 +60,17 @@ std::vector<PacBio::BAM::BamRecord> Input::ReadsInWindow(const ReferenceWindow&
         // read starts/ends within window
         else
             partialHits.emplace_back(std::move(record));
+        return true;
+    };
+
+    if (reads_) {
+        for (const auto row : reads_->RowsInWindow(window, settings_.minMapQV))
+            if (!AddRecord(reads_->Record(row))) break;
+    } else {
+        const auto filter = MakeWindowFilter(window, settings_);
+        PbiFilterQuery query{filter, settings_.inputFilename};
+        for (const auto& record : query)
+            if (!AddRecord(record)) break;
     }
 
     if (result.size() <= settings_.maxCoverage) {
@@ -2,7 +2,10 @@
 
 #include <pacbio/genomicconsensus/experimental/Output.h>
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 #include <pbcopper/logging/Logging.h>
 
@@ -13,17 +16,20 @@ namespace PacBio {
 namespace GenomicConsensus {
 namespace experimental {
 
-Output::Output(const Settings& settings) : settings_{settings}
+size_t Output::MaxPendingResults(const Settings& settings)
+{
+    return std::max<size_t>(1, settings.numThreads) * MaxResultsPerThread;
+}
+
+Output::Output(const Settings& settings)
+    : settings_{settings}, maxPending_{MaxPendingResults(settings)}
 {
     const Input input{settings_};
     const auto refWindows = input.ReferenceWindows(false);
 
     for (const auto& window : refWindows) {
         refWindows_[window.name] = window;
-        processedBasesPerRef_[window.name] = 0;
-        expectedBasesPerRef_[window.name] = window.Length();
-        consensiPerRef_[window.name] = {};
-        variantsPerRef_[window.name] = {};
+        outputWindows_[window.name] = Workflow::EnumerateWindows(window.name, settings_);
     }
 
     // init writers from settings
@@ -38,74 +44,145 @@ void Output::AddResult(WindowResult result)
     PBLOG_INFO << "Adding result for " << result.css.window;
 
     const auto window = result.css.window;
-    consensiPerRef_[window.name].emplace_back(std::move(result.css));
-    variantsPerRef_[window.name];  // append list
-    processedBasesPerRef_[window.name] += window.Length();
-    MaybeFlushContig(window.name);
+    const auto& record = RecordOf(window);
+    if (written_.count(std::make_pair(record.name, record.Start())) > 0 ||
+        (record_ && record == *record_ && window.Start() < recordPos_))
+        throw std::runtime_error("Consensus chunks must be contiguous");
+    if (!pending_[window.name].emplace(window.Start(), std::move(result)).second)
+        throw std::runtime_error("Consensus chunks must be contiguous");
+    ++nPending_;
+
+    FlushReady();
+
+    // results arrive in production order, so a result waiting behind this
+    // many others means the one they wait for is missing
+    if (nPending_ > maxPending_) throw std::runtime_error("Consensus chunks must be contiguous");
 }
 
-void Output::MaybeFlushContig(const std::string& refName)
+void Output::Finish()
 {
-    const auto basesProcessed = processedBasesPerRef_[refName];
-    const auto expectedBases = expectedBasesPerRef_[refName];
-    if (basesProcessed == expectedBases) {
-        // This contig is done, so we can dump to file & delete data
-        if (gff_ || vcf_) {
-            // sort & write variants
-            auto& variants = variantsPerRef_[refName];
-            std::sort(variants.begin(), variants.end());
-            if (gff_) gff_->WriteVariants(variants);
-            if (vcf_) vcf_->WriteVariants(variants);
-        }
+    // every record must have been written from end to end
+    size_t nRecords = 0;
+    for (const auto& windows : outputWindows_)
+        nRecords += windows.second.size();
+    if (record_ || nPending_ > 0 || written_.size() != nRecords)
+        throw std::runtime_error("Consensus chunks must be contiguous");
+}
 
-        // TODO: this doesn't actually free up memory
-        variantsPerRef_[refName].clear();
-
-        //
-        // If the user asked to analyze a window or a set of
-        // windows, we output a FAST[AQ] contig per analyzed
-        // window.  Otherwise we output a fasta contig per
-        // reference contig.
-        //
-        // We try to be intelligent about naming the output
-        // contigs, to include window information where applicable.
-        //
-        for (const auto& window : Workflow::EnumerateWindows(refName, settings_)) {
-            std::string recordName = window.name;
-            if (window != refWindows_[window.name]) {
-                recordName +=
-                    '_' + std::to_string(window.Start()) + '_' + std::to_string(window.End());
-            }
+void Output::FlushReady()
+{
+    // write results for as long as the next one of the open record is here
+    while (record_ || OpenNextRecord()) {
+        auto& pending = pending_[record_->name];
+        auto it = pending.lower_bound(record_->Start());
+        if (it == pending.end() || it->first > recordPos_) return;
+        if (it->first < recordPos_) throw std::runtime_error("Consensus chunks must be contiguous");
+
+        WriteResult(std::move(it->second));
+        pending.erase(it);
+        --nPending_;
+        if (recordPos_ >= record_->End()) CloseRecord();
+    }
+}
 
-            std::string algoName;
-            switch (settings_.mode) {
-                case ConsensusMode::ARROW:
-                    algoName = "arrow";
-                    break;
-                case ConsensusMode::PLURALITY:
-                    algoName = "plurality";
-                    break;
-                case ConsensusMode::POA:
-                    algoName = "poa";
-                    break;
-                default:
-                    throw std::runtime_error("unknown consensus mode");
+bool Output::OpenNextRecord()
+{
+    //
+    // If the user asked to analyze a window or a set of
+    // windows, we output a FAST[AQ] contig per analyzed
+    // window.  Otherwise we output a fasta contig per
+    // reference contig.
+    //
+    // Any record whose first result has arrived can be opened; with results
+    // arriving in order, that is the next one.
+    //
+    for (const auto& refPending : pending_) {
+        if (refPending.second.empty()) continue;
+        const auto start = refPending.second.cbegin()->first;
+        for (const auto& window : outputWindows_[refPending.first]) {
+            if (window.Start() == start) {
+                record_ = window;
+                recordPos_ = start;
+
+                const auto recordName = RecordName(window);
+                if (fasta_) fasta_->BeginRecord(recordName);
+                if (fastq_) fastq_->BeginRecord(recordName);
+                return true;
             }
-            std::string cssName = recordName + '|' + algoName;
+        }
+    }
+    return false;
+}
 
-            std::vector<Consensus> consensiInThisWindow;
-            for (const auto& consensus : consensiPerRef_[refName]) {
-                if (Overlap(consensus.window, window)) consensiInThisWindow.push_back(consensus);
-            }
-            auto css = Consensus::Join(consensiInThisWindow);
+void Output::WriteResult(WindowResult result)
+{
+    const auto& css = result.css;
+    if (fasta_) fasta_->Append(css.sequence);
+    if (fastq_) fastq_->Append(css.sequence, css.confidence);
+
+    // a window's variants all sort after those of the windows before it
+    if (gff_ || vcf_) {
+        auto& variants = result.variants;
+        std::sort(variants.begin(), variants.end());
+        if (gff_) gff_->WriteVariants(variants);
+        if (vcf_) vcf_->WriteVariants(variants);
+    }
+
+    recordPos_ = css.window.End();
+}
+
+void Output::CloseRecord()
+{
+    // the record's results must tile it exactly, as Consensus::Join requires
+    if (recordPos_ != record_->End())
+        throw std::runtime_error("Consensus chunks must be contiguous");
+
+    if (fasta_) fasta_->EndRecord();
+    if (fastq_) fastq_->EndRecord();
+
+    written_.emplace(record_->name, record_->Start());
+    const auto pending = pending_.find(record_->name);
+    if (pending != pending_.end() && pending->second.empty()) pending_.erase(pending);
+    record_ = boost::none;
+}
 
-            if (fasta_) fasta_->Write(cssName, css.sequence);
-            if (fastq_) fastq_->Write(cssName, css.sequence, css.confidence);
+const ReferenceWindow& Output::RecordOf(const ReferenceWindow& window) const
+{
+    const auto windows = outputWindows_.find(window.name);
+    if (windows != outputWindows_.cend()) {
+        for (const auto& record : windows->second) {
+            if (record.Start() <= window.Start() && window.End() <= record.End()) return record;
         }
+    }
+    throw std::runtime_error("Consensus chunk is outside of all output windows");
+}
+
+std::string Output::RecordName(const ReferenceWindow& window) const
+{
+    //
+    // We try to be intelligent about naming the output
+    // contigs, to include window information where applicable.
+    //
+    std::string recordName = window.name;
+    if (window != refWindows_.at(window.name)) {
+        recordName += '_' + std::to_string(window.Start()) + '_' + std::to_string(window.End());
+    }
 
-        // TODO: this doesn't actually free up memory
-        consensiPerRef_[refName].clear();
+    std::string algoName;
+    switch (settings_.mode) {
+        case ConsensusMode::ARROW:
+            algoName = "arrow";
+            break;
+        case ConsensusMode::PLURALITY:
+            algoName = "plurality";
+            break;
+        case ConsensusMode::POA:
+            algoName = "poa";
+            break;
+        default:
+            throw std::runtime_error("unknown consensus mode");
     }
+    return recordName + '|' + algoName;
 }
 
 }  // namespace experimental
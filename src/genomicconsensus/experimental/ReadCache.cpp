@@ -0,0 +1,143 @@
+#include <pacbio/genomicconsensus/experimental/ReadCache.h>
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+namespace PacBio {
+namespace GenomicConsensus {
+namespace experimental {
+
+std::shared_ptr<ReadCache> ReadCache::For(const std::string& bamFilename)
+{
+    static std::mutex m;
+    static std::map<std::string, std::shared_ptr<ReadCache>> caches;
+
+    std::lock_guard<std::mutex> lock(m);
+    auto& cache = caches[bamFilename];
+    if (!cache) cache = std::make_shared<ReadCache>(bamFilename);
+    return cache;
+}
+
+ReadCache::ReadCache(const std::string& bamFilename)
+    : bam_{bamFilename}
+    , index_{bam_.PacBioIndexFilename()}
+    , reader_{bamFilename}
+    , nextRow_{index_.NumReads()}
+{
+    if (!index_.HasMappedData()) return;
+
+    const auto& mappedData = index_.MappedData();
+    const auto& tId = mappedData.tId_;
+    const auto& tStart = mappedData.tStart_;
+    const auto& tEnd = mappedData.tEnd_;
+
+    const auto numRefs = bam_.Header().Sequences().size();
+    rowsByRef_.resize(numRefs);
+    maxSpanByRef_.assign(numRefs, 0);
+
+    for (size_t row = 0; row < index_.NumReads(); ++row) {
+        const auto ref = tId.at(row);
+        if (ref < 0 || static_cast<size_t>(ref) >= numRefs) continue;  // unmapped
+        rowsByRef_[ref].push_back(row);
+        maxSpanByRef_[ref] = std::max(maxSpanByRef_[ref], tEnd.at(row) - tStart.at(row));
+    }
+
+    // a sorted BAM is already in tStart order, so this is usually a no-op
+    for (auto& rows : rowsByRef_)
+        std::stable_sort(rows.begin(), rows.end(), [&tStart](const size_t lhs, const size_t rhs) {
+            return tStart[lhs] < tStart[rhs];
+        });
+}
+
+const PacBio::BAM::PbiRawData& ReadCache::Index() const { return index_; }
+
+std::vector<size_t> ReadCache::RowsInWindow(const ReferenceWindow& window,
+                                            const uint8_t minMapQV) const
+{
+    std::vector<size_t> result;
+
+    const auto& header = bam_.Header();
+    if (rowsByRef_.empty() || !header.HasSequence(window.name)) return result;
+    const auto ref = static_cast<size_t>(header.SequenceId(window.name));
+    if (ref >= rowsByRef_.size()) return result;
+
+    const auto& mappedData = index_.MappedData();
+    const auto& tStart = mappedData.tStart_;
+    const auto& tEnd = mappedData.tEnd_;
+    const auto& mapQV = mappedData.mapQV_;
+
+    const auto winStart = static_cast<uint32_t>(window.Start());
+    const auto winEnd = static_cast<uint32_t>(window.End());
+
+    // no read starting before winStart - maxSpan can reach into the window
+    const auto maxSpan = maxSpanByRef_[ref];
+    const uint32_t minStart = (winStart > maxSpan) ? winStart - maxSpan : 0;
+
+    const auto& rows = rowsByRef_[ref];
+    const auto startsBefore = [&tStart](const size_t row, const uint32_t pos) {
+        return tStart[row] < pos;
+    };
+    const auto first = std::lower_bound(rows.cbegin(), rows.cend(), minStart, startsBefore);
+    const auto last = std::lower_bound(first, rows.cend(), winEnd, startsBefore);
+
+    for (auto it = first; it != last; ++it) {
+        const auto row = *it;
+        if (tEnd[row] > winStart && mapQV[row] >= minMapQV) result.push_back(row);
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::vector<PacBio::Data::Interval> ReadCache::IntervalsInWindow(const ReferenceWindow& window,
+                                                                 const uint8_t minMapQV) const
+{
+    const auto& mappedData = index_.MappedData();
+
+    std::vector<PacBio::Data::Interval> result;
+    for (const auto row : RowsInWindow(window, minMapQV))
+        result.emplace_back(mappedData.tStart_[row], mappedData.tEnd_[row]);
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+PacBio::BAM::BamRecord ReadCache::Record(const size_t row)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = decoded_.find(row);
+    if (it == decoded_.end()) {
+        ReadAhead(row);
+        it = decoded_.find(row);
+        if (it == decoded_.end())
+            throw std::runtime_error("could not read record " + std::to_string(row) + " of " +
+                                     bam_.Filename());
+    }
+    return it->second;
+}
+
+void ReadCache::ReadAhead(size_t row)
+{
+    // only seek if the reader is not already sitting on this record
+    if (row != nextRow_) reader_.VirtualSeek(index_.BasicData().fileOffset_.at(row));
+
+    PacBio::BAM::BamRecord record;
+    const auto end = std::min(row + 1 + READ_AHEAD, static_cast<size_t>(index_.NumReads()));
+    for (; row < end && reader_.GetNext(record); ++row) {
+        if (decoded_.find(row) != decoded_.end()) continue;
+        decoded_.emplace(row, record);
+        decodedOrder_.push_back(row);
+    }
+    nextRow_ = row;
+
+    // evict the oldest records; CAPACITY > READ_AHEAD keeps the requested one
+    while (decodedOrder_.size() > CAPACITY) {
+        decoded_.erase(decodedOrder_.front());
+        decodedOrder_.pop_front();
+    }
+}
+
+}  // namespace experimental
+}  // namespace GenomicConsensus
+}  // namespace PacBio
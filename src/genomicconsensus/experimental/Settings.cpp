@@ -197,6 +197,7 @@ void ParseSortStrategy(const PacBio::CLI::Results& args, Settings* const setting
 
 Settings::Settings(const PacBio::CLI::Results& args)
     : numThreads{args[Options::NumThreads]}
+    , polishThreads{args[Options::PolishThreads]}
     , minConfidence{args[Options::MinConfidence]}
     , minCoverage{args[Options::MinCoverage]}
     , maxCoverage{args[Options::MaxCoverage]}
@@ -41,6 +41,16 @@ const PacBio::Data::PlainOption NumThreads
     PacBio::CLI::Option::UIntType(Settings::Defaults::NumThreads)
 };
 
+const PacBio::Data::PlainOption PolishThreads
+{
+    "polish_threads",
+    {"polishThreads"},
+    "Threads per Window",
+    "The number of threads used to polish a single reference window (arrow-only)."
+    " Results are unchanged.",
+    PacBio::CLI::Option::UIntType(Settings::Defaults::PolishThreads)
+};
+
 const PacBio::Data::PlainOption MinConfidence
 {
     "min_confidence",
@@ -443,7 +453,8 @@ inline std::vector<PacBio::CLI::Option> ParallelismOptions()
 {
     return
     {
-        Options::NumThreads
+        Options::NumThreads,
+        Options::PolishThreads
     };
 }
 
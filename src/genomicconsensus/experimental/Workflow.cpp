@@ -20,11 +20,12 @@
 #include <pacbio/genomicconsensus/experimental/Filters.h>
 #include <pacbio/genomicconsensus/experimental/Intervals.h>
 #include <pacbio/genomicconsensus/experimental/Output.h>
+#include <pacbio/genomicconsensus/experimental/ReadCache.h>
 #include <pacbio/genomicconsensus/experimental/ReferenceWindow.h>
 #include <pacbio/genomicconsensus/experimental/Settings.h>
 #include <pacbio/genomicconsensus/experimental/WindowResult.h>
 #include <pacbio/genomicconsensus/experimental/WorkChunk.h>
-#include <pacbio/parallel/WorkQueue.h>
+#include <pacbio/parallel/WorkStealingQueue.h>
 
 #include "SettingsOptions.h"
 
@@ -34,13 +35,15 @@ namespace experimental {
 
 namespace {
 
-static void Consumer(PacBio::Parallel::WorkQueue<WindowResult>& queue, const Settings& settings)
+static void Consumer(PacBio::Parallel::WorkStealingQueue<WindowResult>& queue,
+                     const Settings& settings)
 {
     auto output = std::make_unique<Output>(settings);
 
     auto ResultOutput = [&](WindowResult&& result) { output->AddResult(std::move(result)); };
     while (queue.ConsumeWith(ResultOutput))
         ;
+    output->Finish();
 }
 
 static WindowResult Producer(const WorkChunk& chunk, const Settings& settings)
@@ -93,12 +96,11 @@ std::vector<WorkChunk> Workflow::FancyChunks(const std::string& name, const Sett
 {
     std::vector<WorkChunk> result;
 
-    const PacBio::BAM::BamFile bam{settings.inputFilename};
-    const PacBio::BAM::PbiRawData index{bam.PacBioIndexFilename()};
+    const auto reads = ReadCache::For(settings.inputFilename);
 
     const auto windows = EnumerateWindows(name, settings);
     for (const auto& win : windows) {
-        const auto readIntervals = FilteredWindowIntervals(index, win, settings.minMapQV);
+        const auto readIntervals = reads->IntervalsInWindow(win, settings.minMapQV);
         const auto coverageIntervals = CoverageIntervals(win.interval, readIntervals);
         for (const auto& ci : coverageIntervals) {
             const bool hasCoverage = ci.coverage >= settings.minCoverage;
@@ -161,7 +163,14 @@ int Workflow::Runner(const CLI::Results& args)
 
     // setup work queue & output thread
     const Settings settings{args};
-    PacBio::Parallel::WorkQueue<WindowResult> workQueue{settings.numThreads};
+    //
+    // The queue hands results to the output thread in production order, so
+    // Output can stream each window's result out as it arrives. Production
+    // blocks while MaxPendingResults of them are not yet written, so results
+    // finished behind a slow window do not pile up.
+    //
+    PacBio::Parallel::WorkStealingQueue<WindowResult> workQueue{
+        settings.numThreads, 0, Output::MaxPendingResults(settings)};
     std::future<void> writer =
         std::async(std::launch::async, Consumer, std::ref(workQueue), std::ref(settings));
 
@@ -2,8 +2,8 @@
 
 #include <pacbio/genomicconsensus/experimental/io/FastaWriter.h>
 
+#include <algorithm>
 #include <stdexcept>
-#include <vector>
 
 using namespace std::literals::string_literals;
 
@@ -13,16 +13,7 @@ namespace experimental {
 
 namespace {
 
-std::vector<std::string> WrapToColumns(const std::string& seq, const size_t width = 70)
-{
-    std::vector<std::string> result;
-    size_t pos = 0;
-    while (pos < seq.size()) {
-        result.push_back(seq.substr(pos, width));
-        pos += width;
-    }
-    return result;
-}
+static constexpr const size_t LineWidth = 70;
 
 }  // namespace anonymous
 
@@ -36,10 +27,37 @@ FastaWriter::FastaWriter(const Settings& settings)
 }
 
 void FastaWriter::Write(const std::string& header, const std::string& sequence)
+{
+    BeginRecord(header);
+    Append(sequence);
+    EndRecord();
+}
+
+void FastaWriter::BeginRecord(const std::string& header)
 {
     WriteLine('>' + header);
-    for (const auto& line : WrapToColumns(sequence))
-        WriteLine(line);
+    column_ = 0;
+}
+
+void FastaWriter::Append(const std::string& sequence)
+{
+    size_t pos = 0;
+    while (pos < sequence.size()) {
+        if (column_ == LineWidth) {
+            out_ << '\n';
+            column_ = 0;
+        }
+        const auto n = std::min(LineWidth - column_, sequence.size() - pos);
+        out_.write(sequence.data() + pos, n);
+        column_ += n;
+        pos += n;
+    }
+}
+
+void FastaWriter::EndRecord()
+{
+    if (column_ > 0) out_ << '\n';
+    column_ = 0;
 }
 
 void FastaWriter::WriteLine(const std::string& line) { out_ << line << '\n'; }
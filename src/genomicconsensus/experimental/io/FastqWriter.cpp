@@ -23,11 +23,30 @@ FastqWriter::FastqWriter(const Settings& settings)
 
 void FastqWriter::Write(const std::string& header, const std::string& sequence,
                         const std::vector<uint8_t>& qualities)
+{
+    BeginRecord(header);
+    Append(sequence, qualities);
+    EndRecord();
+}
+
+void FastqWriter::BeginRecord(const std::string& header)
 {
     WriteLine('@' + header);
-    WriteLine(sequence);
+    qualities_.clear();
+}
+
+void FastqWriter::Append(const std::string& sequence, const std::vector<uint8_t>& qualities)
+{
+    out_ << sequence;
+    qualities_ += PacBio::BAM::QualityValues(qualities).Fastq();
+}
+
+void FastqWriter::EndRecord()
+{
+    out_ << '\n';
     WriteLine("+");
-    WriteLine(PacBio::BAM::QualityValues(qualities).Fastq());
+    WriteLine(qualities_);
+    std::string{}.swap(qualities_);
 }
 
 void FastqWriter::WriteLine(const std::string& line) { out_ << line << '\n'; }
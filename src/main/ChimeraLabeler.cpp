@@ -1,7 +1,17 @@
 // Author: Brett Bowman
 
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
 #include <seqan/seq_io.h>
 
+#include <pbcopper/cli/CLI.h>
+
+#include <pacbio/UnanimityVersion.h>
+#include <pacbio/data/PlainOption.h>
 #include "pacbio/chimera/ChimeraLabeler.h"
 #include "pacbio/chimera/ChimeraResultWriter.h"
 #include "pbbam/FastaReader.h"
@@ -11,14 +21,61 @@ using PacBio::BAM::FastqReader;
 using PacBio::BAM::FastaReader;
 using namespace PacBio::Chimera;
 
-int main(int argc, char const** argv)
+namespace OptionNames {
+using PlainOption = PacBio::Data::PlainOption;
+// clang-format off
+const PlainOption MaxCandidates{
+    "max_candidates",
+    { "maxCandidates" },
+    "Maximum Candidate Parents",
+    "Align each chunk only to the possible parents sharing the most k-mers with it, at most this many. 0 aligns every chunk to all parents.",
+    PacBio::CLI::Option::IntType(0)
+};
+const PlainOption NumThreads{
+    "num_threads",
+    { "numThreads" },
+    "Number of Threads",
+    "Number of threads aligning the chunks of a sequence to its possible parents.",
+    PacBio::CLI::Option::IntType(1)
+};
+// clang-format on
+}  // namespace OptionNames
+
+static PacBio::CLI::Interface CreateCLI()
+{
+    PacBio::CLI::Interface i{"ChimeraLabeler", "Label chimeric sequences in a FASTQ file.",
+                             PacBio::UnanimityVersion()};
+
+    i.AddHelpOption();
+    i.AddVersionOption();
+
+    // clang-format off
+    i.AddPositionalArguments({
+        {"input", "Input FASTQ file.", "INPUT"}
+    });
+
+    i.AddOptions(
+    {
+        OptionNames::MaxCandidates,
+        OptionNames::NumThreads
+    });
+    // clang-format on
+
+    return i;
+}
+
+static int Runner(const PacBio::CLI::Results& args)
 {
     using namespace seqan;
 
-    if (argc != 2) return 1;  // Invalid number of arguments.
+    const std::vector<std::string> files = args.PositionalArguments();
+    if (files.size() != 1) {
+        std::cerr << "ERROR: Please provide the INPUT file. See --help for more info.\n";
+        return EXIT_FAILURE;
+    }
 
     // Get the input file
-    std::string inputFile(argv[1]);
+    const std::string inputFile = files.front();
 
     // Parse the records
     std::vector<std::string> ids;
@@ -29,12 +86,17 @@ int main(int argc, char const** argv)
     }
 
     // Label the Records
-    ChimeraLabeler chimeraLabeler(1.0f, 100, true);
+    const int maxCandidates = args[OptionNames::MaxCandidates];
+    const int numThreads = args[OptionNames::NumThreads];
+    ChimeraLabeler chimeraLabeler(1.0f, 100, true, std::max(0, maxCandidates),
+                                  std::max(1, numThreads));
     auto labels = chimeraLabeler.LabelChimeras(ids, seqs);
 
     // Display the results
     ChimeraResultWriter csvWriter("temp.csv");
     csvWriter.WriteResults(labels);
 
-    return 0;
+    return EXIT_SUCCESS;
 }
+
+int main(int argc, char* argv[]) { return PacBio::CLI::Run(argc, argv, CreateCLI(), &Runner); }
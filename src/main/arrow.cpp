@@ -45,8 +45,10 @@ int main(int argc, char* argv[])
         //
         // Restrict the consensus and variants to the reference window.
         //
+        const PacBio::Align::AlignConfig alignConfig(PacBio::Align::AlignParams::Default(),
+                                                     PacBio::Align::AlignMode::GLOBAL, 32);
         const std::unique_ptr<PairwiseAlignment> ga{
-            PacBio::Align::Align(refSeq, cssAndVariants.css.sequence)};
+            PacBio::Align::Align(refSeq, cssAndVariants.css.sequence, alignConfig)};
 
         const auto targetPositions = PacBio::Align::TargetToQueryPositions(*ga);
         const auto cssStart = targetPositions.at(window.Start() - enlargedWindow.Start());
@@ -28,13 +28,15 @@
 #include <pbcopper/logging/Logging.h>
 #include <pbcopper/utility/FileUtils.h>
 
+#include <pacbio/ccs/ChunkSizer.h>
 #include <pacbio/ccs/Consensus.h>
 #include <pacbio/ccs/Whitelist.h>
+#include <pacbio/consensus/AbstractMatrix.h>
 #include <pacbio/consensus/ModelSelection.h>
 #include <pacbio/data/Interval.h>
 #include <pacbio/data/ReadId.h>
 #include <pacbio/io/Utility.h>
-#include <pacbio/parallel/WorkQueue.h>
+#include <pacbio/parallel/WorkStealingQueue.h>
 
 #include <pacbio/UnanimityVersion.h>
 
@@ -106,6 +108,7 @@ inline string QVsToASCII(const vector<int>& qvs)
 void WriteBamRecords(BamWriter& ccsBam, unique_ptr<PbiBuilder>& ccsPbi, Results& counts,
                      const ConsensusSettings& settings, Results&& results)
 {
+    ScopedStageTimer timer(Stage::WRITE, &counts.Timings[ThreadIndex()]);
     counts += results;
 
     for (const auto& ccs : results) {
@@ -184,7 +187,7 @@ void WriteBamRecords(BamWriter& ccsBam, unique_ptr<PbiBuilder>& ccsPbi, Results&
     ccsBam.TryFlush();
 }
 
-Results BamWriterThread(WorkQueue<Results>& queue, unique_ptr<BamWriter>&& ccsBam,
+Results BamWriterThread(WorkStealingQueue<Results>& queue, unique_ptr<BamWriter>&& ccsBam,
                         unique_ptr<PbiBuilder>&& ccsPbi, const ConsensusSettings& settings)
 {
     Results counts;
@@ -195,6 +198,7 @@ Results BamWriterThread(WorkQueue<Results>& queue, unique_ptr<BamWriter>&& ccsBa
 
 void WriteFastqRecords(ofstream& ccsFastq, Results& counts, Results&& results)
 {
+    ScopedStageTimer timer(Stage::WRITE, &counts.Timings[ThreadIndex()]);
     counts += results;
     for (const auto& ccs : results) {
         ccsFastq << '@' << *(ccs.Id.MovieName) << '/' << ccs.Id.HoleNumber << "/ccs";
@@ -219,7 +223,7 @@ void WriteFastqRecords(ofstream& ccsFastq, Results& counts, Results&& results)
     ccsFastq.flush();
 }
 
-Results FastqWriterThread(WorkQueue<Results>& queue, const string& fname)
+Results FastqWriterThread(WorkStealingQueue<Results>& queue, const string& fname)
 {
     ofstream ccsFastq(fname);
     Results counts;
@@ -309,6 +313,16 @@ void WriteResultsReport(ostream& report, const Results& counts)
     counts.SubreadCounter.WriteResultsReport(report);
 }
 
+// The stage timings go next to the report, e.g. ccs_report.txt -> ccs_report.timings.json
+string StageTimingsFile(const string& reportFile)
+{
+    const size_t dot = reportFile.find_last_of('.');
+    const size_t slash = reportFile.find_last_of('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return reportFile + ".timings.json";
+    return reportFile.substr(0, dot) + ".timings.json";
+}
+
 static std::vector<ExternalResource> BarcodeSets(const ExternalResources& ext)
 {
     std::vector<ExternalResource> output;
@@ -400,6 +414,17 @@ static int Runner(const PacBio::CLI::Results& args)
         }
     }
 
+    // share models between subreads of similar SNR
+    //
+    //
+    if (settings.SnrResolution < 0.0) {
+        PBLOG_FATAL << "option --snrResolution: must be >= 0";
+        exit(EXIT_FAILURE);
+    }
+    ConfigureModelCache(settings.ModelCacheSize, settings.SnrResolution);
+
+    if (settings.SinglePrecision) SetCellPrecision(CellPrecision::FLOAT);
+
     // start processing chunks!
     //
     //
@@ -453,7 +478,7 @@ static int Runner(const PacBio::CLI::Results& args)
     else
         query = std::make_unique<PbiFilterQuery>(filter, ds);
 
-    WorkQueue<Results> workQueue(settings.NThreads);
+    WorkStealingQueue<Results> workQueue(settings.NThreads);
     future<Results> writer;
 
     // Check if output type is a dataset
@@ -502,6 +527,7 @@ static int Runner(const PacBio::CLI::Results& args)
     }
 
     auto chunk = std::make_unique<vector<Chunk>>();
+    ChunkSizer chunkSizer(settings.ChunkBases, settings.MaxChunkSize);
     map<string, shared_ptr<string>> movieNames;
     auto holeNumber = boost::make_optional(false, int32_t{});
     bool skipZmw = false;
@@ -515,9 +541,10 @@ static int Runner(const PacBio::CLI::Results& args)
 
         // check if we've started a new ZMW
         if ((!holeNumber) || (holeNumber.value() != read.HoleNumber())) {
-            if (chunk && chunk->size() >= settings.ChunkSize) {
+            if (chunk && chunkSizer.IsFull()) {
                 workQueue.ProduceWith(CircularConsensus, move(chunk), settings);
                 chunk = std::make_unique<vector<Chunk>>();
+                chunkSizer.Reset();
             }
             holeNumber = read.HoleNumber();
 
@@ -537,6 +564,7 @@ static int Runner(const PacBio::CLI::Results& args)
                 skipZmw = false;
                 chunk->emplace_back(
                     Chunk{ReadId(movieNames[movieName], *holeNumber), vector<Subread>(), barcodes});
+                chunkSizer.AddZmw();
             }
         }
 
@@ -563,6 +591,8 @@ static int Runner(const PacBio::CLI::Results& args)
         else
             pw = vector<uint8_t>(read.Sequence().length(), 0);
 
+        chunkSizer.AddBases(read.Sequence().length());
+
         string chem(modelSpec.empty() ? read.ReadGroup().SequencingChemistry() : modelSpec);
         chunk->back().Reads.emplace_back(
             Subread{ReadId(movieNames[movieName], *holeNumber,
@@ -589,6 +619,20 @@ static int Runner(const PacBio::CLI::Results& args)
         WriteResultsReport(stream, counts);
     }
 
+    const auto modelCache = ModelCacheStatistics();
+    PBLOG_DEBUG << "Shared models: " << modelCache.first << " hits, " << modelCache.second
+                << " misses";
+
+    if (settings.TimeStages) {
+        // keep stdout to the report
+        if (reportFile == "-")
+            WriteStageTimings(cerr, counts.Timings);
+        else {
+            ofstream stream(StageTimingsFile(reportFile));
+            WriteStageTimings(stream, counts.Timings);
+        }
+    }
+
     return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,282 @@
+#include "BandedMatrix.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+
+#include "BufferPool.h"
+
+namespace PacBio {
+namespace Consensus {
+
+namespace {  // anonymous
+
+std::atomic<CellPrecision> cellPrecision_{CellPrecision::DOUBLE};
+
+}  // namespace anonymous
+
+void SetCellPrecision(const CellPrecision precision) { cellPrecision_.store(precision); }
+
+CellPrecision GetCellPrecision() { return cellPrecision_.load(std::memory_order_relaxed); }
+
+constexpr const size_t BandedMatrix::PADDING;
+
+BandedMatrix::BandedMatrix(const size_t rows, const size_t cols, const CellPrecision precision)
+    : precision_(precision)
+    , pool_(BufferPool::Current())
+    , arenaTaken_(false)
+    , floatArenaTaken_(false)
+    , slots_(cols)
+    , abandoned_(0)
+    , nCols_(cols)
+    , nRows_(rows)
+    , columnBeingEdited_(std::numeric_limits<size_t>::max())
+    , usedRanges_(cols, std::make_pair(0, 0))
+    , filled_(0)
+{
+}
+
+BandedMatrix::BandedMatrix(const BandedMatrix& other)
+    : precision_(other.precision_)
+    , arena_(other.arena_)
+    , floatArena_(other.floatArena_)
+    , pool_(BufferPool::Current())
+    , arenaTaken_(false)
+    , floatArenaTaken_(false)
+    , slots_(other.slots_)
+    , abandoned_(other.abandoned_)
+    , nCols_(other.nCols_)
+    , nRows_(other.nRows_)
+    , columnBeingEdited_(other.columnBeingEdited_)
+    , usedRanges_(other.usedRanges_)
+    , filled_(other.filled_)
+{
+}
+
+BandedMatrix::~BandedMatrix()
+{
+    ReleaseArena();
+    ReleaseFloatArena();
+}
+
+void BandedMatrix::Reset(const size_t rows, const size_t cols)
+{
+    // keep the arena's capacity around for the next fill
+    arena_.clear();
+    floatArena_.clear();
+    slots_.assign(cols, ColumnSlot());
+    abandoned_ = 0;
+    nCols_ = cols;
+    nRows_ = rows;
+    usedRanges_.assign(cols, std::make_pair(0, 0));
+    columnBeingEdited_ = std::numeric_limits<size_t>::max();
+}
+
+void BandedMatrix::KeepColumns(const size_t cols, const size_t nLeading, const size_t nTrailing)
+{
+    assert(nLeading + nTrailing <= std::min(cols, nCols_));
+    assert(columnBeingEdited_ == std::numeric_limits<size_t>::max());
+
+    std::vector<ColumnSlot> slots(cols);
+    std::vector<std::pair<size_t, size_t>> usedRanges(cols, std::make_pair(0, 0));
+    std::vector<bool> kept(nCols_, false);
+    for (size_t j = 0; j < nLeading; ++j) {
+        slots[j] = slots_[j];
+        usedRanges[j] = usedRanges_[j];
+        kept[j] = true;
+    }
+    for (size_t k = 1; k <= nTrailing; ++k) {
+        slots[cols - k] = slots_[nCols_ - k];
+        usedRanges[cols - k] = usedRanges_[nCols_ - k];
+        kept[nCols_ - k] = true;
+    }
+
+    // hand the slots of dropped columns to the cleared ones, so refilling
+    // them does not grow the arena
+    size_t k = nLeading;
+    for (size_t j = 0; j < nCols_; ++j) {
+        if (kept[j] || slots_[j].capacity == 0) continue;
+        if (k < cols - nTrailing) {
+            slots[k].offset = slots_[j].offset;
+            slots[k].capacity = slots_[j].capacity;
+            ++k;
+        } else
+            abandoned_ += slots_[j].capacity;
+    }
+
+    slots_.swap(slots);
+    usedRanges_.swap(usedRanges);
+    nCols_ = cols;
+}
+
+void BandedMatrix::SetPrecision(const CellPrecision precision)
+{
+    if (precision == precision_) return;
+    // hand the arena of the old precision to the next matrix using it
+    if (precision_ == CellPrecision::FLOAT)
+        ReleaseFloatArena();
+    else
+        ReleaseArena();
+    precision_ = precision;
+    Reset(nRows_, nCols_);
+}
+
+size_t BandedMatrix::UsedEntries() const
+{
+    // use column ranges
+    size_t filledEntries = 0;
+    for (size_t col = 0; col < Columns(); ++col) {
+        size_t start, end;
+        std::tie(start, end) = UsedRowRange(col);
+        filledEntries += (end - start);
+    }
+    return filledEntries;
+}
+
+float BandedMatrix::UsedEntriesRatio() const
+{
+    const auto filled = static_cast<float>(UsedEntries());
+    const auto size = static_cast<float>(Rows() * Columns());
+    return filled / size;
+}
+
+size_t BandedMatrix::AllocatedEntries() const
+{
+    // We want the real memory usage, including abandoned slots and the
+    // arena's spare capacity.
+    return arena_.capacity() + floatArena_.capacity();
+}
+
+void BandedMatrix::ToHostMatrix(double** mat, int* rows, int* cols) const
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    *mat = new double[Rows() * Columns()];
+    *rows = static_cast<int>(Rows());
+    *cols = static_cast<int>(Columns());
+    for (size_t i = 0; i < Rows(); i++) {
+        for (size_t j = 0; j < Columns(); j++) {
+            (*mat)[i * Columns() + j] = IsAllocated(i, j) ? Get(i, j) : nan;
+        }
+    }
+}
+
+void BandedMatrix::AllocateSlot(const size_t j, const size_t nRows)
+{
+    // adopt a buffer of the pool of the thread that built the matrix, sized
+    // for a typical band (reserved right away, so that the pool sees the
+    // buffer back even if every column stays empty); other threads must not
+    // touch that pool
+    const size_t typical = std::max<size_t>(1, nCols_ * 4 * PADDING);
+    const bool fromPool = pool_ != nullptr && BufferPool::Current() == pool_;
+    if (precision_ == CellPrecision::FLOAT) {
+        if (floatArena_.capacity() == 0) {
+            if (fromPool) floatArena_ = BufferPool::TakeFloat(typical);
+            floatArenaTaken_ = fromPool;
+            BufferPool::Reserve(&floatArena_, typical);
+        }
+    } else if (arena_.capacity() == 0) {
+        if (fromPool) arena_ = BufferPool::Take(typical);
+        arenaTaken_ = fromPool;
+        BufferPool::Reserve(&arena_, typical);
+    }
+
+    abandoned_ += slots_[j].capacity;
+    slots_[j] = ColumnSlot();
+    if (abandoned_ > ArenaSize() / 2) Compact();
+
+    WithArena([&](auto& arena) {
+        slots_[j].offset = arena.size();
+        slots_[j].capacity = nRows;
+        BufferPool::Resize(&arena, arena.size() + nRows);
+    });
+}
+
+void BandedMatrix::ReleaseArena()
+{
+    if (arenaTaken_ && BufferPool::Current() == pool_) BufferPool::Give(std::move(arena_));
+    std::vector<double>().swap(arena_);
+    arenaTaken_ = false;
+}
+
+void BandedMatrix::ReleaseFloatArena()
+{
+    if (floatArenaTaken_ && BufferPool::Current() == pool_)
+        BufferPool::Give(std::move(floatArena_));
+    std::vector<float>().swap(floatArena_);
+    floatArenaTaken_ = false;
+}
+
+void BandedMatrix::Compact()
+{
+    std::vector<size_t> order;
+    order.reserve(nCols_);
+    for (size_t j = 0; j < nCols_; ++j)
+        if (slots_[j].capacity > 0) order.emplace_back(j);
+    std::sort(order.begin(), order.end(),
+              [this](size_t a, size_t b) { return slots_[a].offset < slots_[b].offset; });
+
+    // slots only ever move towards the front, so memmove is safe
+    WithArena([this, &order](auto& arena) {
+        size_t end = 0;
+        for (const size_t j : order) {
+            ColumnSlot& slot = slots_[j];
+            if (slot.offset != end)
+                memmove(&arena[end], &arena[slot.offset], slot.capacity * sizeof(arena[0]));
+            slot.offset = end;
+            end += slot.capacity;
+        }
+        arena.resize(end);
+    });
+    abandoned_ = 0;
+}
+
+void BandedMatrix::ExpandColumn(const size_t j, const size_t i)
+{
+    const ColumnSlot old = slots_[j];
+    const size_t beginRow = std::min((i > PADDING) ? i - PADDING : 0, old.beginRow);
+    const size_t endRow = std::min(std::max(i + PADDING, old.endRow), nRows_);
+    const size_t nOld = old.endRow - old.beginRow;
+
+    WithArena([&](auto& arena) {
+        if (endRow - beginRow > old.capacity) {
+            // relocate to the end of the arena, growing geometrically so
+            // columns expanding row by row relocate rarely; compaction is left
+            // to the next AllocateSlot as it would move the contents we need
+            // to keep
+            const size_t capacity = std::max(endRow - beginRow, std::min(2 * old.capacity, nRows_));
+            const size_t offset = arena.size();
+            BufferPool::Resize(&arena, offset + capacity);
+            std::copy_n(arena.begin() + old.offset, nOld,
+                        arena.begin() + offset + (old.beginRow - beginRow));
+            abandoned_ += old.capacity;
+            slots_[j].offset = offset;
+            slots_[j].capacity = capacity;
+        } else {
+            memmove(&arena[old.offset + (old.beginRow - beginRow)], &arena[old.offset],
+                    nOld * sizeof(arena[0]));
+        }
+
+        const ColumnSlot& slot = slots_[j];
+        std::fill_n(arena.begin() + slot.offset, old.beginRow - beginRow, 0);
+        std::fill(arena.begin() + slot.offset + (old.endRow - beginRow),
+                  arena.begin() + slot.offset + (endRow - beginRow), 0);
+    });
+
+    ColumnSlot& slot = slots_[j];
+    slot.beginRow = beginRow;
+    slot.endRow = endRow;
+}
+
+void BandedMatrix::CheckInvariants(size_t column) const
+{
+#ifndef NDEBUG
+    const ColumnSlot& slot = slots_[column];
+    assert(slot.beginRow <= slot.endRow && slot.endRow <= nRows_);
+    assert(slot.endRow - slot.beginRow <= slot.capacity);
+    assert(slot.offset + slot.capacity <= ArenaSize());
+#endif
+}
+
+}  // namespace Consensus
+}  // namespace PacBio
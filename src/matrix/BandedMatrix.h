@@ -0,0 +1,406 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <pacbio/consensus/AbstractMatrix.h>
+
+namespace PacBio {
+namespace Consensus {
+
+class BufferPool;
+
+/// The BandedMatrix offers the same interface as the SparseMatrix, but stores
+/// the allocated band of every column in a single contiguous arena. A
+/// per-column table records where in the arena the column lives and which
+/// rows it covers, so a cell access is one table lookup followed by one arena
+/// read. Columns that outgrow their slot are relocated to the end of the
+/// arena; abandoned slots are reclaimed by compacting the arena once they make
+/// up the majority of it. Reset() keeps the arena's capacity, so refilling a
+/// matrix of similar size does not allocate, and the arena is taken from and
+/// returned to the BufferPool of the thread that built the matrix, so neither
+/// does a new matrix. A matrix first filled on another thread, such as a
+/// helper scoring mutations, or copied from another matrix, allocates its
+/// own arena instead, as the pools are not shared between threads. A matrix
+/// must be destroyed on the thread that built it.
+class BandedMatrix : public AbstractMatrix
+{
+public:  // Constructor, destructor
+    /// Constructor with explicit dimensions.
+    BandedMatrix(size_t rows, size_t cols, CellPrecision precision = GetCellPrecision());
+    /// Copy constructor.
+    BandedMatrix(const BandedMatrix& other);
+    /// Destructor.
+    virtual ~BandedMatrix();
+
+public:
+    /// Clears and resizes the internal data structures.
+    virtual void Reset(size_t rows, size_t cols);
+    /// Resizes to cols columns, keeping the first nLeading columns in place
+    /// and moving the last nTrailing columns to the new end, and clears all
+    /// other columns. The arena slots of cleared columns are recycled.
+    virtual void KeepColumns(size_t cols, size_t nLeading, size_t nTrailing);
+
+public:  // Cell precision
+    CellPrecision Precision() const;
+    /// Switch the storage type of the cells, this clears the matrix like Reset.
+    void SetPrecision(CellPrecision precision);
+
+public:  // Nullability
+    /// Returns a BandedMatrix representing null.
+    static const BandedMatrix& Null();
+    /// Returns if the both dimensions are zero.
+    bool IsNull() const;
+
+public:  // Size information
+    size_t Rows() const;
+    size_t Columns() const;
+
+public:  // Information about entries filled by column
+    /// Prepare the arena slot of column j for rows hintBegin to hintEnd.
+    void StartEditingColumn(size_t j, size_t hintBegin, size_t hintEnd);
+    /// Finish editing column j and store the used rows in usedRanges_.
+    void FinishEditingColumn(size_t j, size_t usedBegin, size_t usedEnd);
+    /// Retreive the row range for column j.
+    std::pair<size_t, size_t> UsedRowRange(size_t j) const;
+    // Checks if no rows are set for column j.
+    bool IsColumnEmpty(size_t j) const;
+    /// Computes the number of filled cells.
+    size_t UsedEntries() const override;
+    /// Computes the ratio of filled cells.
+    float UsedEntriesRatio() const override;
+    /// Computes the number of allocated cells.
+    /// An entry may be allocated but not used.
+    size_t AllocatedEntries() const override;
+    /// The number of cells filled since construction, counting every refill
+    /// of a column.
+    size_t FilledEntries() const;
+
+public:  // Accessors
+    /// Typed access to the cells, see WithCells.
+    template <typename T>
+    class ConstCells;
+    template <typename T>
+    class Cells;
+
+    /// Call f with a Cells<double> or Cells<float> (ConstCells on a const
+    /// matrix) for the storage type in use. Loops over many cells should go
+    /// through the view, so that the precision is dispatched on once per
+    /// matrix rather than for every cell.
+    template <typename F>
+    decltype(auto) WithCells(F&& f);
+    template <typename F>
+    decltype(auto) WithCells(F&& f) const;
+
+    /// Access cell at row i and column j.
+    /// If not allocated, return 0.
+    double operator()(size_t i, size_t j) const;
+    /// Checks if cell is allocated.
+    bool IsAllocated(size_t i, size_t j) const;
+    double Get(size_t i, size_t j) const;
+    void Set(size_t i, size_t j, double v);
+    /// Copy rows [beginRow, endRow) of column j into dst.
+    /// Unallocated cells are copied as 0.
+    void CopyColumnRange(size_t j, size_t beginRow, size_t endRow, double* dst) const;
+    /// Clear content of column j and reset respective row range.
+    void ClearColumn(size_t j);
+
+public:
+    /// Convert sparse to full matrix.
+    void ToHostMatrix(double** mat, int* rows, int* cols) const override;
+
+private:
+    // Where column j lives in the arena: rows [beginRow, endRow) are stored
+    // at [offset, offset + endRow - beginRow) of the arena, and the slot has room
+    // for capacity rows.
+    struct ColumnSlot
+    {
+        size_t offset = 0;
+        size_t capacity = 0;
+        size_t beginRow = 0;
+        size_t endRow = 0;
+    };
+
+    static constexpr const size_t PADDING = 8;
+
+private:
+    // Point column j at a fresh slot of at least nRows at the end of the
+    // arena, abandoning its previous slot. Does not preserve contents.
+    void AllocateSlot(size_t j, size_t nRows);
+    // Move all live slots to the front of the arena, in column order.
+    void Compact();
+    // Grow the allocated rows of column j to cover row i, preserving contents.
+    void ExpandColumn(size_t j, size_t i);
+    void CheckInvariants(size_t column) const;
+    size_t ArenaSize() const;
+    // Call f with the arena in use
+    template <typename F>
+    void WithArena(F&& f);
+    template <typename F>
+    void WithArena(F&& f) const;
+    // Give the arenas taken from pool_ back, free the others
+    void ReleaseArena();
+    void ReleaseFloatArena();
+
+private:
+    // only the arena matching precision_ is used
+    CellPrecision precision_;
+    std::vector<double> arena_;
+    std::vector<float> floatArena_;
+    BufferPool* pool_;  // the pool of the thread that built the matrix
+    bool arenaTaken_;   // whether the arenas came from pool_
+    bool floatArenaTaken_;
+    std::vector<ColumnSlot> slots_;
+    size_t abandoned_;  // number of arena entries in abandoned slots
+    size_t nCols_;
+    size_t nRows_;
+    size_t columnBeingEdited_;
+    std::vector<std::pair<size_t, size_t>> usedRanges_;
+    size_t filled_;
+};
+
+//
+// Nullability
+//
+inline const BandedMatrix& BandedMatrix::Null()
+{
+    static auto nullObj = std::make_unique<BandedMatrix>(0, 0);
+    return *nullObj;
+}
+
+inline bool BandedMatrix::IsNull() const { return (Rows() == 0 && Columns() == 0); }
+
+//
+// Size information
+//
+inline size_t BandedMatrix::Rows() const { return nRows_; }
+inline size_t BandedMatrix::Columns() const { return nCols_; }
+
+inline size_t BandedMatrix::FilledEntries() const { return filled_; }
+
+//
+// Cell precision
+//
+inline CellPrecision BandedMatrix::Precision() const { return precision_; }
+
+inline size_t BandedMatrix::ArenaSize() const
+{
+    return (precision_ == CellPrecision::FLOAT) ? floatArena_.size() : arena_.size();
+}
+
+template <typename F>
+inline void BandedMatrix::WithArena(F&& f)
+{
+    if (precision_ == CellPrecision::FLOAT)
+        f(floatArena_);
+    else
+        f(arena_);
+}
+
+template <typename F>
+inline void BandedMatrix::WithArena(F&& f) const
+{
+    if (precision_ == CellPrecision::FLOAT)
+        f(floatArena_);
+    else
+        f(arena_);
+}
+
+//
+// Typed cell access
+//
+template <typename T>
+class BandedMatrix::ConstCells
+{
+public:
+    /// Access cell at row i and column j.
+    /// If not allocated, return 0.
+    const T& operator()(size_t i, size_t j) const;
+
+protected:
+    friend class BandedMatrix;
+    ConstCells(const BandedMatrix& matrix, const std::vector<T>& arena);
+
+    const BandedMatrix& matrix_;
+    // a reference to the vector, the arena may move while a column is edited
+    const std::vector<T>& arena_;
+};
+
+template <typename T>
+class BandedMatrix::Cells : public BandedMatrix::ConstCells<T>
+{
+public:
+    /// Set cell at row i of column j, which is being edited.
+    void Set(size_t i, size_t j, double v) const;
+
+private:
+    friend class BandedMatrix;
+    Cells(BandedMatrix& matrix, std::vector<T>& arena);
+
+    BandedMatrix& matrix_;
+    std::vector<T>& arena_;
+};
+
+template <typename T>
+inline BandedMatrix::ConstCells<T>::ConstCells(const BandedMatrix& matrix,
+                                               const std::vector<T>& arena)
+    : matrix_(matrix), arena_(arena)
+{
+}
+
+template <typename T>
+inline const T& BandedMatrix::ConstCells<T>::operator()(const size_t i, const size_t j) const
+{
+    const ColumnSlot& slot = matrix_.slots_[j];
+    // unsigned wrap-around folds both bounds checks into one comparison
+    if (i - slot.beginRow < slot.endRow - slot.beginRow)
+        return arena_[slot.offset + (i - slot.beginRow)];
+    static const T emptyCell = 0;
+    return emptyCell;
+}
+
+template <typename T>
+inline BandedMatrix::Cells<T>::Cells(BandedMatrix& matrix, std::vector<T>& arena)
+    : ConstCells<T>(matrix, arena), matrix_(matrix), arena_(arena)
+{
+}
+
+template <typename T>
+inline void BandedMatrix::Cells<T>::Set(const size_t i, const size_t j, const double v) const
+{
+    assert(matrix_.columnBeingEdited_ == j);
+    assert(i < matrix_.nRows_);
+    if (!matrix_.IsAllocated(i, j)) matrix_.ExpandColumn(j, i);
+    const ColumnSlot& slot = matrix_.slots_[j];
+    arena_[slot.offset + (i - slot.beginRow)] = static_cast<T>(v);
+}
+
+template <typename F>
+inline decltype(auto) BandedMatrix::WithCells(F&& f)
+{
+    if (precision_ == CellPrecision::FLOAT) return f(Cells<float>(*this, floatArena_));
+    return f(Cells<double>(*this, arena_));
+}
+
+template <typename F>
+inline decltype(auto) BandedMatrix::WithCells(F&& f) const
+{
+    if (precision_ == CellPrecision::FLOAT) return f(ConstCells<float>(*this, floatArena_));
+    return f(ConstCells<double>(*this, arena_));
+}
+
+//
+// Entry range queries per column
+//
+inline void BandedMatrix::StartEditingColumn(const size_t j, const size_t hintBegin,
+                                             const size_t hintEnd)
+{
+    assert(columnBeingEdited_ == std::numeric_limits<size_t>::max());
+    assert(hintBegin <= hintEnd && hintEnd <= nRows_);
+    columnBeingEdited_ = j;
+
+    const size_t beginRow = (hintBegin > PADDING) ? hintBegin - PADDING : 0;
+    const size_t endRow = std::min(hintEnd + PADDING, nRows_);
+    if (endRow - beginRow > slots_[j].capacity) AllocateSlot(j, endRow - beginRow);
+
+    ColumnSlot& slot = slots_[j];
+    slot.beginRow = beginRow;
+    slot.endRow = endRow;
+    WithArena([&slot](auto& arena) {
+        std::fill_n(arena.begin() + slot.offset, slot.endRow - slot.beginRow, 0);
+    });
+}
+
+inline void BandedMatrix::FinishEditingColumn(const size_t j, const size_t usedRowsBegin,
+                                              const size_t usedRowsEnd)
+{
+    assert(columnBeingEdited_ == j);
+    usedRanges_[j] = std::make_pair(usedRowsBegin, usedRowsEnd);
+    filled_ += usedRowsEnd - usedRowsBegin;
+    CheckInvariants(columnBeingEdited_);
+    columnBeingEdited_ = std::numeric_limits<size_t>::max();
+}
+
+inline std::pair<size_t, size_t> BandedMatrix::UsedRowRange(const size_t j) const
+{
+    assert(j < usedRanges_.size());
+    return usedRanges_[j];
+}
+
+inline bool BandedMatrix::IsColumnEmpty(const size_t j) const
+{
+    assert(j < usedRanges_.size());
+    size_t begin, end;
+    std::tie(begin, end) = usedRanges_[j];
+    return begin >= end;
+}
+
+//
+// Accessors
+//
+inline double BandedMatrix::operator()(const size_t i, const size_t j) const
+{
+    const ColumnSlot& slot = slots_[j];
+    // unsigned wrap-around folds both bounds checks into one comparison
+    if (i - slot.beginRow >= slot.endRow - slot.beginRow) return 0.0;
+    const size_t k = slot.offset + (i - slot.beginRow);
+    return (precision_ == CellPrecision::FLOAT) ? floatArena_[k] : arena_[k];
+}
+
+inline bool BandedMatrix::IsAllocated(const size_t i, const size_t j) const
+{
+    return i >= slots_[j].beginRow && i < slots_[j].endRow;
+}
+
+inline double BandedMatrix::Get(const size_t i, const size_t j) const { return (*this)(i, j); }
+
+inline void BandedMatrix::Set(const size_t i, const size_t j, const double v)
+{
+    assert(columnBeingEdited_ == j);
+    assert(i < nRows_);
+    if (!IsAllocated(i, j)) ExpandColumn(j, i);
+    const size_t k = slots_[j].offset + (i - slots_[j].beginRow);
+    if (precision_ == CellPrecision::FLOAT)
+        floatArena_[k] = static_cast<float>(v);
+    else
+        arena_[k] = v;
+}
+
+inline void BandedMatrix::CopyColumnRange(const size_t j, const size_t beginRow,
+                                          const size_t endRow, double* dst) const
+{
+    assert(beginRow <= endRow && endRow <= nRows_);
+    const ColumnSlot& slot = slots_[j];
+    const size_t copyBegin = std::max(beginRow, slot.beginRow);
+    const size_t copyEnd = std::min(endRow, slot.endRow);
+    if (copyBegin >= copyEnd) {
+        std::fill_n(dst, endRow - beginRow, 0.0);
+        return;
+    }
+    dst = std::fill_n(dst, copyBegin - beginRow, 0.0);
+    WithArena([&](const auto& arena) {
+        const auto column = arena.begin() + slot.offset;
+        dst = std::copy(column + (copyBegin - slot.beginRow), column + (copyEnd - slot.beginRow),
+                        dst);
+    });
+    std::fill_n(dst, endRow - copyEnd, 0.0);
+}
+
+inline void BandedMatrix::ClearColumn(const size_t j)
+{
+    usedRanges_[j] = std::make_pair(0, 0);
+    const ColumnSlot& slot = slots_[j];
+    WithArena([&slot](auto& arena) {
+        std::fill_n(arena.begin() + slot.offset, slot.endRow - slot.beginRow, 0);
+    });
+    CheckInvariants(j);
+}
+
+}  // namespace Consensus
+}  // namespace PacBio
@@ -0,0 +1,182 @@
+#include "BufferPool.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace PacBio {
+namespace Consensus {
+
+constexpr const size_t BufferPool::MAX_RETAINED_BYTES;
+
+namespace {  // anonymous
+
+// Buffers may be returned while threads (or the program) shut down, after
+// the pool of the thread has already been destroyed; those are just freed.
+enum struct PoolState : unsigned char
+{
+    NONE,
+    ALIVE,
+    DESTROYED
+};
+
+thread_local PoolState poolState = PoolState::NONE;
+
+}  // namespace anonymous
+
+BufferPool::BufferPool() : retained_{0}, allocations_{0}, taken_{0}, job_{0}
+{
+    poolState = PoolState::ALIVE;
+}
+
+BufferPool::~BufferPool() { poolState = PoolState::DESTROYED; }
+
+BufferPool& BufferPool::ThreadLocal()
+{
+    thread_local BufferPool pool;
+    return pool;
+}
+
+BufferPool* BufferPool::Current()
+{
+    if (poolState == PoolState::DESTROYED) return nullptr;
+    return &ThreadLocal();
+}
+
+std::vector<double> BufferPool::Take(const size_t minCapacity)
+{
+    if (poolState == PoolState::DESTROYED) return std::vector<double>();
+    BufferPool& pool = ThreadLocal();
+    return pool.TakeBuffer(&pool.buffers_, minCapacity);
+}
+
+void BufferPool::Give(std::vector<double>&& buffer)
+{
+    if (buffer.capacity() == 0 || poolState == PoolState::DESTROYED) return;
+    BufferPool& pool = ThreadLocal();
+    pool.GiveBuffer(&pool.buffers_, std::move(buffer));
+    pool.Returned();
+}
+
+std::vector<float> BufferPool::TakeFloat(const size_t minCapacity)
+{
+    if (poolState == PoolState::DESTROYED) return std::vector<float>();
+    BufferPool& pool = ThreadLocal();
+    return pool.TakeBuffer(&pool.floatBuffers_, minCapacity);
+}
+
+void BufferPool::Give(std::vector<float>&& buffer)
+{
+    if (buffer.capacity() == 0 || poolState == PoolState::DESTROYED) return;
+    BufferPool& pool = ThreadLocal();
+    pool.GiveBuffer(&pool.floatBuffers_, std::move(buffer));
+    pool.Returned();
+}
+
+template <typename T>
+void BufferPool::Reserve(std::vector<T>* const buffer, const size_t capacity)
+{
+    if (capacity <= buffer->capacity()) return;
+    Allocated();
+    buffer->reserve(capacity);
+}
+
+template <typename T>
+void BufferPool::Resize(std::vector<T>* const buffer, const size_t size)
+{
+    if (size > buffer->capacity()) Allocated();
+    buffer->resize(size);
+}
+
+template void BufferPool::Reserve(std::vector<double>*, size_t);
+template void BufferPool::Reserve(std::vector<float>*, size_t);
+template void BufferPool::Resize(std::vector<double>*, size_t);
+template void BufferPool::Resize(std::vector<float>*, size_t);
+
+size_t BufferPool::NumBuffers() const { return buffers_.size() + floatBuffers_.size(); }
+
+size_t BufferPool::RetainedBytes() const { return retained_; }
+
+size_t BufferPool::Allocations() const { return allocations_; }
+
+size_t BufferPool::NumTaken() const { return taken_; }
+
+void BufferPool::Clear()
+{
+    buffers_.clear();
+    floatBuffers_.clear();
+    retained_ = 0;
+    taken_ = 0;
+}
+
+template <typename T>
+std::vector<T> BufferPool::TakeBuffer(std::vector<Retained<T>>* const buffers,
+                                      const size_t minCapacity)
+{
+    ++taken_;
+    if (buffers->empty()) return std::vector<T>();
+
+    // buffers are sorted by capacity
+    auto it = std::lower_bound(
+        buffers->begin(), buffers->end(), minCapacity,
+        [](const Retained<T>& retained, size_t n) { return retained.Buffer.capacity() < n; });
+    if (it == buffers->end()) --it;
+
+    std::vector<T> result(std::move(it->Buffer));
+    buffers->erase(it);
+    retained_ -= result.capacity() * sizeof(T);
+    return result;
+}
+
+template <typename T>
+void BufferPool::GiveBuffer(std::vector<Retained<T>>* const buffers, std::vector<T>&& buffer)
+{
+    const size_t bytes = buffer.capacity() * sizeof(T);
+    if (retained_ + bytes > MAX_RETAINED_BYTES) return;
+
+    buffer.clear();
+    retained_ += bytes;
+    auto it = std::upper_bound(
+        buffers->begin(), buffers->end(), buffer.capacity(),
+        [](size_t n, const Retained<T>& other) { return n < other.Buffer.capacity(); });
+    buffers->emplace(it, Retained<T>{std::move(buffer), job_});
+}
+
+template <typename T>
+void BufferPool::ReleaseIdle(std::vector<Retained<T>>* const buffers)
+{
+    auto idle =
+        std::remove_if(buffers->begin(), buffers->end(), [this](const Retained<T>& retained) {
+            if (retained.Job == job_) return false;
+            retained_ -= retained.Buffer.capacity() * sizeof(T);
+            return true;
+        });
+    buffers->erase(idle, buffers->end());
+}
+
+void BufferPool::Returned()
+{
+    // buffers that were never taken from the pool do not end a job
+    if (taken_ == 0 || --taken_ > 0) return;
+
+    // the job is done, drop what it did not need
+    ReleaseIdle(&buffers_);
+    ReleaseIdle(&floatBuffers_);
+    ++job_;
+}
+
+void BufferPool::Allocated()
+{
+    if (poolState != PoolState::DESTROYED) ++ThreadLocal().allocations_;
+}
+
+ScopedBuffer::ScopedBuffer(const size_t size) : buffer_(BufferPool::Take(size))
+{
+    // never empty, so that the pool sees it back
+    BufferPool::Reserve(&buffer_, std::max<size_t>(1, size));
+    buffer_.resize(size);
+}
+
+ScopedBuffer::~ScopedBuffer() { BufferPool::Give(std::move(buffer_)); }
+
+}  // namespace Consensus
+}  // namespace PacBio
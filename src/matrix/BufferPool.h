@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace PacBio {
+namespace Consensus {
+
+/// A per-thread pool of buffers backing the DP matrices and the scratch space
+/// of the recursors.
+///
+/// Every ZMW builds an Integrator with an alpha, beta and extension matrix per
+/// read and tears them all down once its consensus is done. Drawing their
+/// storage from the pool of the worker thread hands the memory of one ZMW to
+/// the next one processed by the same thread, so in steady state the worker
+/// threads neither contend on the global heap nor fragment it over long runs.
+///
+/// The pool only keeps what the last job needed. A job ends whenever every
+/// buffer taken from the pool has been given back, which for a worker thread
+/// is the end of each ZMW. Buffers that sat in the pool for the whole job are
+/// then freed, so a thread that went through one very long ZMW does not hold
+/// on to its memory once it is back to shorter ones, and an idle thread holds
+/// no more than its last job used. Buffers returned while the pool already
+/// holds MAX_RETAINED_BYTES are freed as well. Matrices storing
+/// single-precision cells draw from a separate set of float buffers, counted
+/// against the same limits.
+class BufferPool
+{
+public:
+    static constexpr const size_t MAX_RETAINED_BYTES = 64 << 20;
+
+public:
+    /// The pool of the calling thread.
+    static BufferPool& ThreadLocal();
+    /// The same, or nullptr once the thread is shutting down and its pool
+    /// has been destroyed.
+    static BufferPool* Current();
+
+    /// Take an empty buffer from the pool of the calling thread: the
+    /// smallest one with room for minCapacity elements, else the largest
+    /// one, else a new one.
+    static std::vector<double> Take(size_t minCapacity);
+    /// Return a buffer to the pool of the calling thread, which must be
+    /// the one it was taken from.
+    static void Give(std::vector<double>&& buffer);
+    /// The same for float buffers.
+    static std::vector<float> TakeFloat(size_t minCapacity);
+    static void Give(std::vector<float>&& buffer);
+
+    /// Reserve or resize a buffer taken from the pool, counting the heap
+    /// allocation if it has to grow past its capacity. Taken buffers must
+    /// grow through these for Allocations to be exact.
+    template <typename T>
+    static void Reserve(std::vector<T>* buffer, size_t capacity);
+    template <typename T>
+    static void Resize(std::vector<T>* buffer, size_t size);
+
+public:
+    ~BufferPool();
+
+    /// The number of buffers and bytes held by the pool.
+    size_t NumBuffers() const;
+    size_t RetainedBytes() const;
+    /// The number of times a taken buffer was allocated on the heap, be it
+    /// new or grown past its capacity.
+    size_t Allocations() const;
+    /// The number of buffers taken and not yet given back.
+    size_t NumTaken() const;
+    /// Free all held buffers and forget the ones taken, as if the thread
+    /// had just started.
+    void Clear();
+
+private:
+    template <typename T>
+    struct Retained
+    {
+        std::vector<T> Buffer;
+        size_t Job;  // the job that last gave the buffer back
+    };
+
+private:
+    BufferPool();
+
+    template <typename T>
+    std::vector<T> TakeBuffer(std::vector<Retained<T>>* buffers, size_t minCapacity);
+    template <typename T>
+    void GiveBuffer(std::vector<Retained<T>>* buffers, std::vector<T>&& buffer);
+    template <typename T>
+    void ReleaseIdle(std::vector<Retained<T>>* buffers);
+    void Returned();
+    static void Allocated();
+
+private:
+    std::vector<Retained<double>> buffers_;
+    std::vector<Retained<float>> floatBuffers_;
+    size_t retained_;  // bytes
+    size_t allocations_;
+    size_t taken_;
+    size_t job_;
+};
+
+/// A buffer of at least size elements taken from the pool of the calling
+/// thread for the lifetime of the object.
+class ScopedBuffer
+{
+public:
+    explicit ScopedBuffer(size_t size);
+    ~ScopedBuffer();
+
+    ScopedBuffer(const ScopedBuffer&) = delete;
+    ScopedBuffer& operator=(const ScopedBuffer&) = delete;
+
+    double* data() { return buffer_.data(); }
+
+private:
+    std::vector<double> buffer_;
+};
+
+}  // namespace Consensus
+}  // namespace PacBio
@@ -10,19 +10,28 @@ namespace PacBio {
 namespace Consensus {
 
 ScaledMatrix::ScaledMatrix(size_t rows, size_t cols, Direction dir)
-    : SparseMatrix(rows, cols), logScalars_(cols, 0.0), dir_{dir}
+    : BandedMatrix(rows, cols), logScalars_(cols, 0.0), dir_{dir}
 {
 }
 
 ScaledMatrix::ScaledMatrix(const ScaledMatrix& other)
-    : SparseMatrix(other), logScalars_(other.logScalars_)
+    : BandedMatrix(other), logScalars_(other.logScalars_)
 {
 }
 
 void ScaledMatrix::Reset(size_t rows, size_t cols)
 {
     std::vector<double>(cols, 0.0).swap(logScalars_);
-    SparseMatrix::Reset(rows, cols);
+    BandedMatrix::Reset(rows, cols);
+}
+
+void ScaledMatrix::KeepColumns(const size_t cols, const size_t nLeading, const size_t nTrailing)
+{
+    std::vector<double> logScalars(cols, 0.0);
+    std::copy_n(logScalars_.begin(), nLeading, logScalars.begin());
+    std::copy_n(logScalars_.end() - nTrailing, nTrailing, logScalars.end() - nTrailing);
+    logScalars_.swap(logScalars);
+    BandedMatrix::KeepColumns(cols, nLeading, nTrailing);
 }
 
 ScaledMatrix::Direction ScaledMatrix::SetDirection(const Direction dir)
@@ -8,14 +8,14 @@
 #include <numeric>
 #include <vector>
 
-#include "SparseMatrix.h"
+#include "BandedMatrix.h"
 
 namespace PacBio {
 namespace Consensus {
 
-/// This class inherits from SparseMatrix and extends it by having a
+/// This class inherits from BandedMatrix and extends it by having a
 /// column-wise scaling factor.
-class ScaledMatrix : public SparseMatrix
+class ScaledMatrix : public BandedMatrix
 {
 public:
     enum Direction
@@ -35,6 +35,9 @@ public:  // constructor/destructor
 public:
     /// Clears and resizes the internal data structures.
     void Reset(size_t rows, size_t cols) override;
+    /// Resizes to cols columns like BandedMatrix::KeepColumns, keeping the
+    /// log scales of the kept columns as they are.
+    void KeepColumns(size_t cols, size_t nLeading, size_t nTrailing) override;
     /// Set direction and reset column-wise log scalars.
     Direction SetDirection(Direction dir);
 
@@ -55,6 +58,8 @@ public:  // Scaling and normalization
     double GetLogProdScales(size_t s, size_t e) const;
     /// Get the log scale
     double GetLogProdScales() const;
+    /// Add delta to the log scales of columns s to e
+    void ShiftLogScales(size_t s, size_t e, double delta);
 
 public:  // Convenient matrix access for SWIG
     /// Convert sparse to full matrix.
@@ -80,9 +85,11 @@ inline void ScaledMatrix::FinishEditingColumn(const size_t j, const size_t usedB
     // get the constant to scale by
     if (!maxProvided) {
         max_val = 0.0;
-        for (size_t i = usedBegin; i < usedEnd; ++i) {
-            max_val = std::max(max_val, SparseMatrix::Get(i, j));
-        }
+        WithCells([&](const auto& cells) {
+            for (size_t i = usedBegin; i < usedEnd; ++i) {
+                max_val = std::max<double>(max_val, cells(i, j));
+            }
+        });
     }
 
     // cumsum stuff
@@ -94,15 +101,17 @@ inline void ScaledMatrix::FinishEditingColumn(const size_t j, const size_t usedB
 
     // set it
     if (max_val != 0.0 && max_val != 1.0) {
-        for (size_t i = usedBegin; i < usedEnd; ++i) {
-            SparseMatrix::Set(i, j, SparseMatrix::Get(i, j) / max_val);
-        }
+        WithCells([&](const auto& cells) {
+            for (size_t i = usedBegin; i < usedEnd; ++i) {
+                cells.Set(i, j, cells(i, j) / max_val);
+            }
+        });
         logScalars_[j] = last + std::log(max_val);
     } else {
         logScalars_[j] = last;
     }
 
-    SparseMatrix::FinishEditingColumn(j, usedBegin, usedEnd);
+    BandedMatrix::FinishEditingColumn(j, usedBegin, usedEnd);
 }
 
 inline double ScaledMatrix::GetLogScale(size_t j) const { return logScalars_[j]; }
@@ -126,5 +135,11 @@ inline double ScaledMatrix::GetLogProdScales() const
     return logScalars_.front();
 }
 
+inline void ScaledMatrix::ShiftLogScales(size_t beginColumn, size_t endColumn, double delta)
+{
+    for (size_t j = beginColumn; j < endColumn; ++j)
+        logScalars_[j] += delta;
+}
+
 }  // namespace Consensus
 }  // namespace PacBio
@@ -65,6 +65,9 @@ public:  // Accessors
     bool IsAllocated(size_t i, size_t j) const;
     double Get(size_t i, size_t j) const;
     void Set(size_t i, size_t j, double v);
+    /// Copy rows [beginRow, endRow) of column j into dst.
+    /// Unallocated cells are copied as 0.
+    void CopyColumnRange(size_t j, size_t beginRow, size_t endRow, double* dst) const;
     /// Clear content of column j and reset respective row range.
     void ClearColumn(size_t j);
 
@@ -165,6 +168,15 @@ inline void SparseMatrix::Set(size_t i, size_t j, double v)
     columns_[j]->Set(i, v);
 }
 
+inline void SparseMatrix::CopyColumnRange(size_t j, size_t beginRow, size_t endRow,
+                                          double* dst) const
+{
+    if (columns_[j] == NULL)
+        std::fill_n(dst, endRow - beginRow, 0.0);
+    else
+        columns_[j]->CopyRange(beginRow, endRow, dst);
+}
+
 inline void SparseMatrix::ClearColumn(size_t j)
 {
     usedRanges_[j] = std::make_pair(0, 0);
@@ -29,6 +29,8 @@ public:
     double Get(size_t i) const;
     void Set(size_t i, double v);
     void Clear();
+    /// Copy entries [beginRow, endRow) into dst, unallocated entries read as 0.
+    void CopyRange(size_t beginRow, size_t endRow, double* dst) const;
 
 public:
     size_t AllocatedEntries() const;
@@ -173,6 +175,21 @@ inline void SparseVector::Set(size_t i, double v)
 
 inline void SparseVector::Clear() { std::fill(storage_.begin(), storage_.end(), 0.0); }
 
+inline void SparseVector::CopyRange(const size_t beginRow, const size_t endRow, double* dst) const
+{
+    assert(beginRow <= endRow && endRow <= logicalLength_);
+    const size_t copyBegin = std::max(beginRow, allocatedBeginRow_);
+    const size_t copyEnd = std::min(endRow, allocatedEndRow_);
+    if (copyBegin >= copyEnd) {
+        std::fill_n(dst, endRow - beginRow, 0.0);
+        return;
+    }
+    dst = std::fill_n(dst, copyBegin - beginRow, 0.0);
+    dst = std::copy(storage_.begin() + (copyBegin - allocatedBeginRow_),
+                    storage_.begin() + (copyEnd - allocatedBeginRow_), dst);
+    std::fill_n(dst, endRow - copyEnd, 0.0);
+}
+
 inline size_t SparseVector::AllocatedEntries() const
 {
     // We want the real memory usage.  std::vector is holding some memory back
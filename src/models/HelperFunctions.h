@@ -4,6 +4,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -249,6 +251,108 @@ inline UNANIMITY_CONSTEXPR double AbstractExpectedLLForEmission(const MoveType m
     }
 }
 
+// Precomputed NCBI4na context tables
+// AbstractEmissionPr and AbstractExpectedLLForEmission have to average over
+// all contained haploid contexts whenever prev or curr is ambiguous. The
+// tables below hold their results for all 16x16 (prev, curr) pairs of NCBI4na
+// bases, indexed by NCBI4na::Data(), such that diploid contexts cost the same
+// single lookup as haploid ones. Rows of gaps (0) are never valid and stay 0.
+static constexpr const size_t NCBI4NA_CONTEXT_NUMBER = 16;
+
+// The number of distinct emissions of an emission table. The simple tables
+// only distinguish a match from a mismatch, but are indexed by the emitted
+// NCBI2na base.
+inline constexpr size_t EmissionNumber(const size_t emissionOutcomeNumber)
+{
+    return emissionOutcomeNumber == 2 ? 4 : emissionOutcomeNumber;
+}
+
+template <size_t EmissionNumber>
+struct AlleleEmissionTable
+{
+    double Pr[3][NCBI4NA_CONTEXT_NUMBER][NCBI4NA_CONTEXT_NUMBER][EmissionNumber];
+
+    inline UNANIMITY_CONSTEXPR double operator()(const MoveType move, const uint8_t emission,
+                                                 const AlleleRep& prev, const AlleleRep& curr) const
+    {
+        assert(move != MoveType::DELETION);
+        assert(emission < EmissionNumber);
+        assert(prev.IsValid());
+        assert(curr.IsValid());
+
+        return Pr[static_cast<uint8_t>(move)][prev.Data()][curr.Data()][emission];
+    }
+};
+
+template <size_t EmissionContextNumber, size_t EmissionOutcomeNumber>
+inline UNANIMITY_CONSTEXPR AlleleEmissionTable<EmissionNumber(EmissionOutcomeNumber)>
+MakeAlleleEmissionTable(
+    const double (&emissionTable)[3][EmissionContextNumber][EmissionOutcomeNumber])
+{
+    AlleleEmissionTable<EmissionNumber(EmissionOutcomeNumber)> result{};
+
+    for (uint8_t m = 0; m < 3; ++m) {
+        const auto move = static_cast<MoveType>(m);
+
+        for (uint8_t p = 1; p < NCBI4NA_CONTEXT_NUMBER; ++p) {
+            const auto prev = AlleleRep::FromRaw(p);
+
+            for (uint8_t c = 1; c < NCBI4NA_CONTEXT_NUMBER; ++c) {
+                const auto curr = AlleleRep::FromRaw(c);
+
+                for (uint8_t e = 0; e < EmissionNumber(EmissionOutcomeNumber); ++e) {
+                    result.Pr[m][p][c][e] = AbstractEmissionPr(emissionTable, move, e, prev, curr);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+struct AlleleExpectationTable
+{
+    double LL[3][NCBI4NA_CONTEXT_NUMBER][NCBI4NA_CONTEXT_NUMBER][2];
+
+    inline double operator()(const MoveType move, const AlleleRep& prev, const AlleleRep& curr,
+                             const MomentType moment) const
+    {
+        assert(move != MoveType::DELETION);
+        assert(prev.IsValid());
+        assert(curr.IsValid());
+
+        return LL[static_cast<uint8_t>(move)][prev.Data()][curr.Data()]
+                 [static_cast<uint8_t>(moment)];
+    }
+};
+
+// cacheExpectationFetcher is the haploid expectation, as passed to
+// AbstractExpectedLLForEmission
+template <typename Callable>
+inline AlleleExpectationTable MakeAlleleExpectationTable(Callable cacheExpectationFetcher)
+{
+    AlleleExpectationTable result{};
+
+    for (uint8_t m = 0; m < 3; ++m) {
+        const auto move = static_cast<MoveType>(m);
+
+        for (uint8_t p = 1; p < NCBI4NA_CONTEXT_NUMBER; ++p) {
+            const auto prev = AlleleRep::FromRaw(p);
+
+            for (uint8_t c = 1; c < NCBI4NA_CONTEXT_NUMBER; ++c) {
+                const auto curr = AlleleRep::FromRaw(c);
+
+                for (uint8_t moment = 0; moment < 2; ++moment) {
+                    result.LL[m][p][c][moment] = AbstractExpectedLLForEmission(
+                        move, prev, curr, static_cast<MomentType>(moment), cacheExpectationFetcher);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 // Generic population interface
 // rowFetcher is a generic function that takes the previous and current base as
 // arguments in NCBI2na encoding. The return value *ret* has to be an array-like
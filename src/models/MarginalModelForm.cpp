@@ -55,6 +55,7 @@ public:
 
 private:
     const MarginalModelCreator* params_;
+    double counterWeight_;
 };
 
 class MarginalRecursor : public Recursor<MarginalRecursor>
@@ -91,16 +92,14 @@ public:
 private:
     double emissionPmf_[3][CONTEXT_NUMBER][OUTCOME_NUMBER];
     double transitionPmf_[CONTEXT_NUMBER][4];
+    // emissions and expectations of all NCBI4na contexts
+    AlleleEmissionTable<EmissionNumber(OUTCOME_NUMBER)> alleleEmissionPmf_;
+    AlleleExpectationTable alleleExpectations_;
 };
 
 MarginalModel::MarginalModel(const MarginalModelCreator* params, const SNR& snr) : params_{params}
 {
-}
-
-std::unique_ptr<AbstractRecursor> MarginalModel::CreateRecursor(const MappedRead& mr,
-                                                                double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) {
             return params_->transitionPmf_[ctx][static_cast<uint8_t>(m)];
         },
@@ -113,8 +112,12 @@ std::unique_ptr<AbstractRecursor> MarginalModel::CreateRecursor(const MappedRead
             return r;
         },
         CONTEXT_NUMBER);
+}
 
-    return std::make_unique<MarginalRecursor>(mr, scoreDiff, counterWeight, params_);
+std::unique_ptr<AbstractRecursor> MarginalModel::CreateRecursor(const MappedRead& mr,
+                                                                double scoreDiff) const
+{
+    return std::make_unique<MarginalRecursor>(mr, scoreDiff, counterWeight_, params_);
 }
 
 std::vector<TemplatePosition> MarginalModel::Populate(const std::string& tpl) const
@@ -131,22 +134,7 @@ std::vector<TemplatePosition> MarginalModel::Populate(const std::string& tpl) co
 double MarginalModel::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
                                             const AlleleRep& curr, const MomentType moment) const
 {
-    auto cachedEmissionVisitor = [this](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                        const MomentType moment) -> double {
-        const auto ctx = EncodeContext8(prev, curr);
-        double expectedLL = 0;
-        for (size_t i = 0; i < OUTCOME_NUMBER; i++) {
-            double curProb = params_->emissionPmf_[static_cast<uint8_t>(move)][ctx][i];
-            double lgCurProb = std::log(curProb);
-            if (!std::isfinite(lgCurProb)) continue;
-            if (moment == MomentType::FIRST)
-                expectedLL += curProb * lgCurProb;
-            else if (moment == MomentType::SECOND)
-                expectedLL += curProb * (lgCurProb * lgCurProb);
-        }
-        return expectedLL;
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    return params_->alleleExpectations_(move, prev, curr, moment);
 }
 
 MarginalRecursor::MarginalRecursor(const MappedRead& mr, double scoreDiff, double counterWeight,
@@ -173,7 +161,7 @@ std::vector<uint8_t> MarginalRecursor::EncodeRead(const MappedRead& read)
 double MarginalRecursor::EmissionPr(const MoveType move, const uint8_t emission,
                                     const AlleleRep& prev, const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(params_->emissionPmf_, move, emission, prev, curr) * counterWeight_;
+    return params_->alleleEmissionPmf_(move, emission, prev, curr) * counterWeight_;
 }
 
 double MarginalRecursor::UndoCounterWeights(const size_t nEmissions) const
@@ -192,6 +180,24 @@ MarginalModelCreator::MarginalModelCreator(const boost::property_tree::ptree& pt
     } catch (boost::property_tree::ptree_error&) {
         throw MalformedModelFile();
     }
+
+    alleleEmissionPmf_ = MakeAlleleEmissionTable(emissionPmf_);
+    alleleExpectations_ =
+        MakeAlleleExpectationTable([this](const MoveType move, const NCBI2na prev,
+                                          const NCBI2na curr, const MomentType moment) -> double {
+            const auto ctx = EncodeContext8(prev, curr);
+            double expectedLL = 0;
+            for (size_t i = 0; i < OUTCOME_NUMBER; i++) {
+                double curProb = emissionPmf_[static_cast<uint8_t>(move)][ctx][i];
+                double lgCurProb = std::log(curProb);
+                if (!std::isfinite(lgCurProb)) continue;
+                if (moment == MomentType::FIRST)
+                    expectedLL += curProb * lgCurProb;
+                else if (moment == MomentType::SECOND)
+                    expectedLL += curProb * (lgCurProb * lgCurProb);
+            }
+            return expectedLL;
+        });
 }
 
 class MarginalModelInitializeModel
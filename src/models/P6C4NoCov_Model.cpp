@@ -49,6 +49,7 @@ public:
 private:
     SNR snr_;
     double ctxTrans_[4][2][4];
+    double counterWeight_;
 };
 
 // TODO(lhepler) comments regarding the CRTP
@@ -144,23 +145,8 @@ P6C4NoCov_Model::P6C4NoCov_Model(const SNR& snr)
                 ctxTrans_[bp][hp][j] /= sum;
         }
     }
-}
 
-std::vector<TemplatePosition> P6C4NoCov_Model::Populate(const std::string& tpl) const
-{
-    auto rowFetcher = [this](const NCBI2na prev, const NCBI2na curr) -> const double(&)[4]
-    {
-        const bool hp = (prev.Data() == curr.Data());  // NA -> 0, AA -> 1
-        const double(&params)[4] = ctxTrans_[curr.Data()][hp];
-        return params;
-    };
-    return AbstractPopulater(tpl, rowFetcher);
-}
-
-std::unique_ptr<AbstractRecursor> P6C4NoCov_Model::CreateRecursor(const MappedRead& mr,
-                                                                  double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) {
             return ctxTrans_[ctx >> 1][ctx & 1][static_cast<uint8_t>(m)];
         },
@@ -176,15 +162,31 @@ std::unique_ptr<AbstractRecursor> P6C4NoCov_Model::CreateRecursor(const MappedRe
             return 0.0;
         },
         8);
+}
 
-    return std::make_unique<P6C4NoCovRecursor>(mr, scoreDiff, counterWeight);
+std::vector<TemplatePosition> P6C4NoCov_Model::Populate(const std::string& tpl) const
+{
+    auto rowFetcher = [this](const NCBI2na prev, const NCBI2na curr) -> const double(&)[4]
+    {
+        const bool hp = (prev.Data() == curr.Data());  // NA -> 0, AA -> 1
+        const double(&params)[4] = ctxTrans_[curr.Data()][hp];
+        return params;
+    };
+    return AbstractPopulater(tpl, rowFetcher);
 }
 
-double P6C4NoCov_Model::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
-                                              const AlleleRep& curr, const MomentType moment) const
+std::unique_ptr<AbstractRecursor> P6C4NoCov_Model::CreateRecursor(const MappedRead& mr,
+                                                                  double scoreDiff) const
 {
-    auto cachedEmissionVisitor = [](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                    const MomentType moment) -> double {
+    return std::make_unique<P6C4NoCovRecursor>(mr, scoreDiff, counterWeight_);
+}
+
+// emissions and expectations of all NCBI4na contexts
+static UNANIMITY_CONSTEXPR const auto alleleEmissionPmf = MakeAlleleEmissionTable(emissionPmf);
+
+static const AlleleExpectationTable alleleExpectations =
+    MakeAlleleExpectationTable([](const MoveType move, const NCBI2na prev, const NCBI2na curr,
+                                  const MomentType moment) -> double {
         const double lgThird = -std::log(3.0);
         if (move == MoveType::MATCH) {
             static constexpr const double probMatch = kInvEps;
@@ -204,8 +206,12 @@ double P6C4NoCov_Model::ExpectedLLForEmission(const MoveType move, const AlleleR
                 return lgThird * lgThird;
         }
         throw std::invalid_argument("invalid move!");
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    });
+
+double P6C4NoCov_Model::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
+                                              const AlleleRep& curr, const MomentType moment) const
+{
+    return alleleExpectations(move, prev, curr, moment);
 }
 
 P6C4NoCovRecursor::P6C4NoCovRecursor(const MappedRead& mr, double scoreDiff, double counterWeight)
@@ -230,7 +236,7 @@ std::vector<uint8_t> P6C4NoCovRecursor::EncodeRead(const MappedRead& read)
 double P6C4NoCovRecursor::EmissionPr(const MoveType move, const uint8_t emission,
                                      const AlleleRep& prev, const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(emissionPmf, move, emission, prev, curr) * counterWeight_;
+    return alleleEmissionPmf(move, emission, prev, curr) * counterWeight_;
 }
 
 double P6C4NoCovRecursor::UndoCounterWeights(const size_t nEmissions) const
@@ -51,13 +51,10 @@ public:
     friend class PwSnrAInitializeModel;
 
 private:
-    double CalculateExpectedLLForEmission(const size_t move, const uint8_t row,
-                                          const size_t moment) const;
-
     const PwSnrAModelCreator* params_;
     SNR snr_;
     double ctxTrans_[CONTEXT_NUMBER][4];
-    double cachedEmissionExpectations_[CONTEXT_NUMBER][3][2];
+    double counterWeight_;
 };
 
 class PwSnrARecursor : public Recursor<PwSnrARecursor>
@@ -93,17 +90,24 @@ public:
     };
 
 private:
+    double CalculateExpectedLLForEmission(const size_t move, const uint8_t row,
+                                          const size_t moment) const;
+
     double snrRanges_[2];
     double emissionPmf_[3][CONTEXT_NUMBER][OUTCOME_NUMBER];
     double transitionParams_[CONTEXT_NUMBER][3][4];
+    // emissions and expectations of all NCBI4na contexts
+    AlleleEmissionTable<EmissionNumber(OUTCOME_NUMBER)> alleleEmissionPmf_;
+    AlleleExpectationTable alleleExpectations_;
 };
 
-inline double PwSnrAModel::CalculateExpectedLLForEmission(const size_t move, const uint8_t row,
-                                                          const size_t moment) const
+inline double PwSnrAModelCreator::CalculateExpectedLLForEmission(const size_t move,
+                                                                 const uint8_t row,
+                                                                 const size_t moment) const
 {
     double expectedLL = 0;
     for (size_t i = 0; i < OUTCOME_NUMBER; i++) {
-        double curProb = params_->emissionPmf_[move][row][i];
+        double curProb = emissionPmf_[move][row][i];
         double lgCurProb = std::log(curProb);
         if (!std::isfinite(lgCurProb)) continue;
         if (moment == static_cast<uint8_t>(MomentType::FIRST))
@@ -134,19 +138,9 @@ PwSnrAModel::PwSnrAModel(const PwSnrAModelCreator* params, const SNR& snr)
         }
         for (size_t j = 0; j < 4; ++j)
             ctxTrans_[ctx][j] /= sum;
-
-        // cached expectations
-        for (size_t move = 0; move < 3; ++move)
-            for (size_t moment = 0; moment < 2; ++moment)
-                cachedEmissionExpectations_[ctx][move][moment] =
-                    CalculateExpectedLLForEmission(move, ctx, moment);
     }
-}
 
-std::unique_ptr<AbstractRecursor> PwSnrAModel::CreateRecursor(const MappedRead& mr,
-                                                              double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) { return ctxTrans_[ctx][static_cast<uint8_t>(m)]; },
         [this](size_t ctx, MoveType m) {
             double r = 0.0;
@@ -157,8 +151,12 @@ std::unique_ptr<AbstractRecursor> PwSnrAModel::CreateRecursor(const MappedRead&
             return r;
         },
         CONTEXT_NUMBER);
+}
 
-    return std::make_unique<PwSnrARecursor>(mr, scoreDiff, counterWeight, params_);
+std::unique_ptr<AbstractRecursor> PwSnrAModel::CreateRecursor(const MappedRead& mr,
+                                                              double scoreDiff) const
+{
+    return std::make_unique<PwSnrARecursor>(mr, scoreDiff, counterWeight_, params_);
 }
 
 std::vector<TemplatePosition> PwSnrAModel::Populate(const std::string& tpl) const
@@ -175,13 +173,7 @@ std::vector<TemplatePosition> PwSnrAModel::Populate(const std::string& tpl) cons
 double PwSnrAModel::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
                                           const AlleleRep& curr, const MomentType moment) const
 {
-    auto cachedEmissionVisitor = [this](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                        const MomentType moment) -> double {
-        const auto row = EncodeContext16(prev, curr);
-        return cachedEmissionExpectations_[row][static_cast<uint8_t>(move)]
-                                          [static_cast<uint8_t>(moment)];
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    return params_->alleleExpectations_(move, prev, curr, moment);
 }
 
 PwSnrARecursor::PwSnrARecursor(const MappedRead& mr, double scoreDiff, double counterWeight,
@@ -208,7 +200,7 @@ std::vector<uint8_t> PwSnrARecursor::EncodeRead(const MappedRead& read)
 double PwSnrARecursor::EmissionPr(const MoveType move, const uint8_t emission,
                                   const AlleleRep& prev, const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(params_->emissionPmf_, move, emission, prev, curr) * counterWeight_;
+    return params_->alleleEmissionPmf_(move, emission, prev, curr) * counterWeight_;
 }
 
 double PwSnrARecursor::UndoCounterWeights(const size_t nEmissions) const
@@ -228,6 +220,13 @@ PwSnrAModelCreator::PwSnrAModelCreator(const boost::property_tree::ptree& pt)
     } catch (boost::property_tree::ptree_error&) {
         throw MalformedModelFile();
     }
+
+    alleleEmissionPmf_ = MakeAlleleEmissionTable(emissionPmf_);
+    alleleExpectations_ = MakeAlleleExpectationTable([this](
+        const MoveType move, const NCBI2na prev, const NCBI2na curr, const MomentType moment) {
+        return CalculateExpectedLLForEmission(
+            static_cast<uint8_t>(move), EncodeContext16(prev, curr), static_cast<uint8_t>(moment));
+    });
 }
 
 class PwSnrAInitializeModel
@@ -51,13 +51,10 @@ public:
     friend class PwSnrInitializeModel;
 
 private:
-    double CalculateExpectedLLForEmission(const size_t move, const uint8_t row,
-                                          const size_t moment) const;
-
     const PwSnrModelCreator* params_;
     SNR snr_;
     double ctxTrans_[CONTEXT_NUMBER][4];
-    double cachedEmissionExpectations_[CONTEXT_NUMBER][3][2];
+    double counterWeight_;
 };
 
 class PwSnrRecursor : public Recursor<PwSnrRecursor>
@@ -93,17 +90,24 @@ public:
     };
 
 private:
+    double CalculateExpectedLLForEmission(const size_t move, const uint8_t row,
+                                          const size_t moment) const;
+
     double snrRanges_[4][2];
     double emissionPmf_[3][CONTEXT_NUMBER][OUTCOME_NUMBER];
     double transitionParams_[CONTEXT_NUMBER][3][4];
+    // emissions and expectations of all NCBI4na contexts
+    AlleleEmissionTable<EmissionNumber(OUTCOME_NUMBER)> alleleEmissionPmf_;
+    AlleleExpectationTable alleleExpectations_;
 };
 
-inline double PwSnrModel::CalculateExpectedLLForEmission(const size_t move, const uint8_t row,
-                                                         const size_t moment) const
+inline double PwSnrModelCreator::CalculateExpectedLLForEmission(const size_t move,
+                                                                const uint8_t row,
+                                                                const size_t moment) const
 {
     double expectedLL = 0;
     for (size_t i = 0; i < OUTCOME_NUMBER; i++) {
-        double curProb = params_->emissionPmf_[move][row][i];
+        double curProb = emissionPmf_[move][row][i];
         double lgCurProb = std::log(curProb);
         if (!std::isfinite(lgCurProb)) continue;
         if (moment == static_cast<uint8_t>(MomentType::FIRST))
@@ -135,19 +139,9 @@ PwSnrModel::PwSnrModel(const PwSnrModelCreator* params, const SNR& snr) : params
         }
         for (size_t j = 0; j < 4; ++j)
             ctxTrans_[ctx][j] /= sum;
-
-        // cached expectations
-        for (size_t move = 0; move < 3; ++move)
-            for (size_t moment = 0; moment < 2; ++moment)
-                cachedEmissionExpectations_[ctx][move][moment] =
-                    CalculateExpectedLLForEmission(move, ctx, moment);
     }
-}
 
-std::unique_ptr<AbstractRecursor> PwSnrModel::CreateRecursor(const MappedRead& mr,
-                                                             double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) { return ctxTrans_[ctx][static_cast<uint8_t>(m)]; },
         [this](size_t ctx, MoveType m) {
             double r = 0.0;
@@ -158,8 +152,12 @@ std::unique_ptr<AbstractRecursor> PwSnrModel::CreateRecursor(const MappedRead& m
             return r;
         },
         CONTEXT_NUMBER);
+}
 
-    return std::make_unique<PwSnrRecursor>(mr, scoreDiff, counterWeight, params_);
+std::unique_ptr<AbstractRecursor> PwSnrModel::CreateRecursor(const MappedRead& mr,
+                                                             double scoreDiff) const
+{
+    return std::make_unique<PwSnrRecursor>(mr, scoreDiff, counterWeight_, params_);
 }
 
 std::vector<TemplatePosition> PwSnrModel::Populate(const std::string& tpl) const
@@ -176,13 +174,7 @@ std::vector<TemplatePosition> PwSnrModel::Populate(const std::string& tpl) const
 double PwSnrModel::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
                                          const AlleleRep& curr, const MomentType moment) const
 {
-    auto cachedEmissionVisitor = [this](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                        const MomentType moment) -> double {
-        const auto row = EncodeContext16(prev, curr);
-        return cachedEmissionExpectations_[row][static_cast<uint8_t>(move)]
-                                          [static_cast<uint8_t>(moment)];
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    return params_->alleleExpectations_(move, prev, curr, moment);
 }
 
 PwSnrRecursor::PwSnrRecursor(const MappedRead& mr, double scoreDiff, double counterWeight,
@@ -209,7 +201,7 @@ std::vector<uint8_t> PwSnrRecursor::EncodeRead(const MappedRead& read)
 double PwSnrRecursor::EmissionPr(const MoveType move, const uint8_t emission, const AlleleRep& prev,
                                  const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(params_->emissionPmf_, move, emission, prev, curr) * counterWeight_;
+    return params_->alleleEmissionPmf_(move, emission, prev, curr) * counterWeight_;
 }
 
 double PwSnrRecursor::UndoCounterWeights(const size_t nEmissions) const
@@ -229,6 +221,13 @@ PwSnrModelCreator::PwSnrModelCreator(const boost::property_tree::ptree& pt)
     } catch (boost::property_tree::ptree_error&) {
         throw MalformedModelFile();
     }
+
+    alleleEmissionPmf_ = MakeAlleleEmissionTable(emissionPmf_);
+    alleleExpectations_ = MakeAlleleExpectationTable([this](
+        const MoveType move, const NCBI2na prev, const NCBI2na curr, const MomentType moment) {
+        return CalculateExpectedLLForEmission(
+            static_cast<uint8_t>(move), EncodeContext16(prev, curr), static_cast<uint8_t>(moment));
+    });
 }
 
 class PwSnrInitializeModel
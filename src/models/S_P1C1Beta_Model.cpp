@@ -44,6 +44,7 @@ public:
 
 private:
     SNR snr_;
+    double counterWeight_;
 };
 
 class S_P1C1Beta_Recursor : public Recursor<S_P1C1Beta_Recursor>
@@ -115,6 +116,17 @@ static constexpr const double transProbs[8][4] = {
 S_P1C1Beta_Model::S_P1C1Beta_Model(const SNR& snr)
     : snr_(ClampSNR(snr, SNR{snrRanges[0]}, SNR{snrRanges[1]}))
 {
+    counterWeight_ = CounterWeight(
+        [](size_t ctx, MoveType m) { return transProbs[ctx][static_cast<uint8_t>(m)]; },
+        [](size_t ctx, MoveType m) {
+            double r = 0.0;
+            for (size_t o = 0; o < 4; ++o) {
+                const double p = emissionPmf[static_cast<uint8_t>(m)][ctx][o];
+                if (p > 0.0) r += p * std::log(p);
+            }
+            return r;
+        },
+        8);
 }
 
 std::vector<TemplatePosition> S_P1C1Beta_Model::Populate(const std::string& tpl) const
@@ -131,26 +143,15 @@ std::vector<TemplatePosition> S_P1C1Beta_Model::Populate(const std::string& tpl)
 std::unique_ptr<AbstractRecursor> S_P1C1Beta_Model::CreateRecursor(const MappedRead& mr,
                                                                    double scoreDiff) const
 {
-    const double counterWeight = CounterWeight(
-        [](size_t ctx, MoveType m) { return transProbs[ctx][static_cast<uint8_t>(m)]; },
-        [](size_t ctx, MoveType m) {
-            double r = 0.0;
-            for (size_t o = 0; o < 4; ++o) {
-                const double p = emissionPmf[static_cast<uint8_t>(m)][ctx][o];
-                if (p > 0.0) r += p * std::log(p);
-            }
-            return r;
-        },
-        8);
-
-    return std::make_unique<S_P1C1Beta_Recursor>(mr, scoreDiff, counterWeight);
+    return std::make_unique<S_P1C1Beta_Recursor>(mr, scoreDiff, counterWeight_);
 }
 
-double S_P1C1Beta_Model::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
-                                               const AlleleRep& curr, const MomentType moment) const
-{
-    auto cachedEmissionVisitor = [](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                    const MomentType moment) -> double {
+// emissions and expectations of all NCBI4na contexts
+static UNANIMITY_CONSTEXPR const auto alleleEmissionPmf = MakeAlleleEmissionTable(emissionPmf);
+
+static const AlleleExpectationTable alleleExpectations =
+    MakeAlleleExpectationTable([](const MoveType move, const NCBI2na prev, const NCBI2na curr,
+                                  const MomentType moment) -> double {
         const auto row = EncodeContext8(prev, curr);
         double expectedLL = 0;
         for (size_t i = 0; i < 4; i++) {
@@ -162,8 +163,12 @@ double S_P1C1Beta_Model::ExpectedLLForEmission(const MoveType move, const Allele
                 expectedLL += curProb * (lgCurProb * lgCurProb);
         }
         return expectedLL;
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    });
+
+double S_P1C1Beta_Model::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
+                                               const AlleleRep& curr, const MomentType moment) const
+{
+    return alleleExpectations(move, prev, curr, moment);
 }
 
 S_P1C1Beta_Recursor::S_P1C1Beta_Recursor(const MappedRead& mr, double scoreDiff,
@@ -189,7 +194,7 @@ std::vector<uint8_t> S_P1C1Beta_Recursor::EncodeRead(const MappedRead& read)
 double S_P1C1Beta_Recursor::EmissionPr(const MoveType move, const uint8_t emission,
                                        const AlleleRep& prev, const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(emissionPmf, move, emission, prev, curr) * counterWeight_;
+    return alleleEmissionPmf(move, emission, prev, curr) * counterWeight_;
 }
 
 double S_P1C1Beta_Recursor::UndoCounterWeights(const size_t nEmissions) const
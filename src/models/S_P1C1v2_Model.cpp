@@ -45,7 +45,7 @@ public:
 private:
     SNR snr_;
     double ctxTrans_[CONTEXT_NUMBER][4];
-    double cachedEmissionExpectations_[CONTEXT_NUMBER][3][2];
+    double counterWeight_;
 };
 
 // TODO(lhepler) comments regarding the CRTP
@@ -250,6 +250,15 @@ inline double CalculateExpectedLLForEmission(const size_t move, const uint8_t ro
     return expectedLL;
 }
 
+// emissions and expectations of all NCBI4na contexts
+static UNANIMITY_CONSTEXPR const auto alleleEmissionPmf = MakeAlleleEmissionTable(emissionPmf);
+
+static const AlleleExpectationTable alleleExpectations = MakeAlleleExpectationTable(
+    [](const MoveType move, const NCBI2na prev, const NCBI2na curr, const MomentType moment) {
+        return CalculateExpectedLLForEmission(
+            static_cast<uint8_t>(move), EncodeContext16(prev, curr), static_cast<uint8_t>(moment));
+    });
+
 S_P1C1v2_Model::S_P1C1v2_Model(const SNR& snr)
     : snr_(ClampSNR(snr, SNR{snrRanges[0]}, SNR{snrRanges[1]}))
 {
@@ -269,19 +278,9 @@ S_P1C1v2_Model::S_P1C1v2_Model(const SNR& snr)
         }
         for (size_t j = 0; j < 4; ++j)
             ctxTrans_[ctx][j] /= sum;
-
-        // cached expectations
-        for (size_t move = 0; move < 3; ++move)
-            for (size_t moment = 0; moment < 2; ++moment)
-                cachedEmissionExpectations_[ctx][move][moment] =
-                    CalculateExpectedLLForEmission(move, ctx, moment);
     }
-}
 
-std::unique_ptr<AbstractRecursor> S_P1C1v2_Model::CreateRecursor(const MappedRead& mr,
-                                                                 double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) { return ctxTrans_[ctx][static_cast<uint8_t>(m)]; },
         [](size_t ctx, MoveType m) {
             double r = 0.0;
@@ -292,8 +291,12 @@ std::unique_ptr<AbstractRecursor> S_P1C1v2_Model::CreateRecursor(const MappedRea
             return r;
         },
         CONTEXT_NUMBER);
+}
 
-    return std::make_unique<S_P1C1v2_Recursor>(mr, scoreDiff, counterWeight);
+std::unique_ptr<AbstractRecursor> S_P1C1v2_Model::CreateRecursor(const MappedRead& mr,
+                                                                 double scoreDiff) const
+{
+    return std::make_unique<S_P1C1v2_Recursor>(mr, scoreDiff, counterWeight_);
 }
 
 std::vector<TemplatePosition> S_P1C1v2_Model::Populate(const std::string& tpl) const
@@ -310,13 +313,7 @@ std::vector<TemplatePosition> S_P1C1v2_Model::Populate(const std::string& tpl) c
 double S_P1C1v2_Model::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
                                              const AlleleRep& curr, const MomentType moment) const
 {
-    auto cachedEmissionVisitor = [this](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                        const MomentType moment) -> double {
-        const auto row = EncodeContext16(prev, curr);
-        return cachedEmissionExpectations_[row][static_cast<uint8_t>(move)]
-                                          [static_cast<uint8_t>(moment)];
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    return alleleExpectations(move, prev, curr, moment);
 }
 
 S_P1C1v2_Recursor::S_P1C1v2_Recursor(const MappedRead& mr, double scoreDiff, double counterWeight)
@@ -341,7 +338,7 @@ std::vector<uint8_t> S_P1C1v2_Recursor::EncodeRead(const MappedRead& read)
 double S_P1C1v2_Recursor::EmissionPr(const MoveType move, const uint8_t emission,
                                      const AlleleRep& prev, const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(emissionPmf, move, emission, prev, curr) * counterWeight_;
+    return alleleEmissionPmf(move, emission, prev, curr) * counterWeight_;
 }
 
 double S_P1C1v2_Recursor::UndoCounterWeights(const size_t nEmissions) const
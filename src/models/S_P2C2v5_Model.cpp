@@ -47,7 +47,7 @@ public:
 private:
     SNR snr_;
     double ctxTrans_[CONTEXT_NUMBER][4];
-    double cachedEmissionExpectations_[CONTEXT_NUMBER][3][2];
+    double counterWeight_;
 };
 
 // TODO(lhepler) comments regarding the CRTP
@@ -237,6 +237,15 @@ inline double CalculateExpectedLLForEmission(const size_t move, const uint8_t ro
     return expectedLL;
 }
 
+// emissions and expectations of all NCBI4na contexts
+static UNANIMITY_CONSTEXPR const auto alleleEmissionPmf = MakeAlleleEmissionTable(emissionPmf);
+
+static const AlleleExpectationTable alleleExpectations = MakeAlleleExpectationTable(
+    [](const MoveType move, const NCBI2na prev, const NCBI2na curr, const MomentType moment) {
+        return CalculateExpectedLLForEmission(
+            static_cast<uint8_t>(move), EncodeContext16(prev, curr), static_cast<uint8_t>(moment));
+    });
+
 S_P2C2v5_Model::S_P2C2v5_Model(const SNR& snr)
     : snr_(ClampSNR(snr, SNR{snrRanges[0]}, SNR{snrRanges[1]}))
 {
@@ -256,19 +265,9 @@ S_P2C2v5_Model::S_P2C2v5_Model(const SNR& snr)
         }
         for (size_t j = 0; j < 4; ++j)
             ctxTrans_[ctx][j] /= sum;
-
-        // cached expectations
-        for (size_t move = 0; move < 3; ++move)
-            for (size_t moment = 0; moment < 2; ++moment)
-                cachedEmissionExpectations_[ctx][move][moment] =
-                    CalculateExpectedLLForEmission(move, ctx, moment);
     }
-}
 
-std::unique_ptr<AbstractRecursor> S_P2C2v5_Model::CreateRecursor(const MappedRead& mr,
-                                                                 double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) { return ctxTrans_[ctx][static_cast<uint8_t>(m)]; },
         [](size_t ctx, MoveType m) {
             double r = 0.0;
@@ -279,8 +278,12 @@ std::unique_ptr<AbstractRecursor> S_P2C2v5_Model::CreateRecursor(const MappedRea
             return r;
         },
         CONTEXT_NUMBER);
+}
 
-    return std::make_unique<S_P2C2v5_Recursor>(mr, scoreDiff, counterWeight);
+std::unique_ptr<AbstractRecursor> S_P2C2v5_Model::CreateRecursor(const MappedRead& mr,
+                                                                 double scoreDiff) const
+{
+    return std::make_unique<S_P2C2v5_Recursor>(mr, scoreDiff, counterWeight_);
 }
 
 std::vector<TemplatePosition> S_P2C2v5_Model::Populate(const std::string& tpl) const
@@ -297,13 +300,7 @@ std::vector<TemplatePosition> S_P2C2v5_Model::Populate(const std::string& tpl) c
 double S_P2C2v5_Model::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
                                              const AlleleRep& curr, const MomentType moment) const
 {
-    auto cachedEmissionVisitor = [this](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                        const MomentType moment) -> double {
-        const auto row = EncodeContext16(prev, curr);
-        return cachedEmissionExpectations_[row][static_cast<uint8_t>(move)]
-                                          [static_cast<uint8_t>(moment)];
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    return alleleExpectations(move, prev, curr, moment);
 }
 
 S_P2C2v5_Recursor::S_P2C2v5_Recursor(const MappedRead& mr, double scoreDiff, double counterWeight)
@@ -328,7 +325,7 @@ std::vector<uint8_t> S_P2C2v5_Recursor::EncodeRead(const MappedRead& read)
 double S_P2C2v5_Recursor::EmissionPr(const MoveType move, const uint8_t emission,
                                      const AlleleRep& prev, const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(emissionPmf, move, emission, prev, curr) * counterWeight_;
+    return alleleEmissionPmf(move, emission, prev, curr) * counterWeight_;
 }
 
 double S_P2C2v5_Recursor::UndoCounterWeights(const size_t nEmissions) const
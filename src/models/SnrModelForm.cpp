@@ -52,6 +52,7 @@ private:
     const SnrModelCreator* params_;
     SNR snr_;
     double ctxTrans_[CONTEXT_NUMBER][4];
+    double counterWeight_;
 };
 
 class SnrRecursor : public Recursor<SnrRecursor>
@@ -91,6 +92,9 @@ private:
     double emissionPmf_[3][1][2];
     double transitionParams_[CONTEXT_NUMBER][3][4];
     double substitutionRate_;
+    // emissions and expectations of all NCBI4na contexts
+    AlleleEmissionTable<EmissionNumber(2)> alleleEmissionPmf_;
+    AlleleExpectationTable alleleExpectations_;
 };
 
 SnrModel::SnrModel(const SnrModelCreator* params, const SNR& snr) : params_{params}, snr_(snr)
@@ -115,12 +119,8 @@ SnrModel::SnrModel(const SnrModelCreator* params, const SNR& snr) : params_{para
         for (size_t j = 0; j < 4; ++j)
             ctxTrans_[ctx][j] /= sum;
     }
-}
 
-std::unique_ptr<AbstractRecursor> SnrModel::CreateRecursor(const MappedRead& mr,
-                                                           double scoreDiff) const
-{
-    const double counterWeight = CounterWeight(
+    counterWeight_ = CounterWeight(
         [this](size_t ctx, MoveType m) { return ctxTrans_[ctx][static_cast<uint8_t>(m)]; },
         [this](size_t ctx, MoveType m) {
             const double kEps = params_->substitutionRate_;
@@ -136,8 +136,12 @@ std::unique_ptr<AbstractRecursor> SnrModel::CreateRecursor(const MappedRead& mr,
             return 0.0;
         },
         CONTEXT_NUMBER);
+}
 
-    return std::make_unique<SnrRecursor>(mr, scoreDiff, counterWeight, params_);
+std::unique_ptr<AbstractRecursor> SnrModel::CreateRecursor(const MappedRead& mr,
+                                                           double scoreDiff) const
+{
+    return std::make_unique<SnrRecursor>(mr, scoreDiff, counterWeight_, params_);
 }
 
 std::vector<TemplatePosition> SnrModel::Populate(const std::string& tpl) const
@@ -154,30 +158,7 @@ std::vector<TemplatePosition> SnrModel::Populate(const std::string& tpl) const
 double SnrModel::ExpectedLLForEmission(const MoveType move, const AlleleRep& prev,
                                        const AlleleRep& curr, const MomentType moment) const
 {
-    auto cachedEmissionVisitor = [this](const MoveType move, const NCBI2na prev, const NCBI2na curr,
-                                        const MomentType moment) -> double {
-        const double lgThird = -std::log(3.0);
-        if (move == MoveType::MATCH) {
-            const double probMismatch = params_->substitutionRate_;
-            const double probMatch = 1.0 - probMismatch;
-            const double lgMatch = std::log(probMatch);
-            const double lgMismatch = lgThird + std::log(probMismatch);
-            if (!std::isfinite(lgMatch) || !std::isfinite(lgMismatch)) return 0.0;
-            if (moment == MomentType::FIRST)
-                return probMatch * lgMatch + probMismatch * lgMismatch;
-            else if (moment == MomentType::SECOND)
-                return probMatch * (lgMatch * lgMatch) + probMismatch * (lgMismatch * lgMismatch);
-        } else if (move == MoveType::BRANCH)
-            return 0.0;
-        else if (move == MoveType::STICK) {
-            if (moment == MomentType::FIRST)
-                return lgThird;
-            else if (moment == MomentType::SECOND)
-                return lgThird * lgThird;
-        }
-        throw std::invalid_argument("invalid move!");
-    };
-    return AbstractExpectedLLForEmission(move, prev, curr, moment, cachedEmissionVisitor);
+    return params_->alleleExpectations_(move, prev, curr, moment);
 }
 
 SnrRecursor::SnrRecursor(const MappedRead& mr, double scoreDiff, double counterWeight,
@@ -204,7 +185,7 @@ std::vector<uint8_t> SnrRecursor::EncodeRead(const MappedRead& read)
 double SnrRecursor::EmissionPr(const MoveType move, const uint8_t emission, const AlleleRep& prev,
                                const AlleleRep& curr) const
 {
-    return AbstractEmissionPr(params_->emissionPmf_, move, emission, prev, curr) * counterWeight_;
+    return params_->alleleEmissionPmf_(move, emission, prev, curr) * counterWeight_;
 }
 
 double SnrRecursor::UndoCounterWeights(const size_t nEmissions) const
@@ -226,6 +207,32 @@ SnrModelCreator::SnrModelCreator(const boost::property_tree::ptree& pt)
     } catch (boost::property_tree::ptree_error&) {
         throw MalformedModelFile();
     }
+
+    alleleEmissionPmf_ = MakeAlleleEmissionTable(emissionPmf_);
+    alleleExpectations_ = MakeAlleleExpectationTable([this](const MoveType move, const NCBI2na prev,
+                                                            const NCBI2na curr,
+                                                            const MomentType moment) -> double {
+        const double lgThird = -std::log(3.0);
+        if (move == MoveType::MATCH) {
+            const double probMismatch = substitutionRate_;
+            const double probMatch = 1.0 - probMismatch;
+            const double lgMatch = std::log(probMatch);
+            const double lgMismatch = lgThird + std::log(probMismatch);
+            if (!std::isfinite(lgMatch) || !std::isfinite(lgMismatch)) return 0.0;
+            if (moment == MomentType::FIRST)
+                return probMatch * lgMatch + probMismatch * lgMismatch;
+            else if (moment == MomentType::SECOND)
+                return probMatch * (lgMatch * lgMatch) + probMismatch * (lgMismatch * lgMismatch);
+        } else if (move == MoveType::BRANCH)
+            return 0.0;
+        else if (move == MoveType::STICK) {
+            if (moment == MomentType::FIRST)
+                return lgThird;
+            else if (moment == MomentType::SECOND)
+                return lgThird * lgThird;
+        }
+        throw std::invalid_argument("invalid move!");
+    });
 }
 
 class SnrInitializeModel
@@ -0,0 +1,144 @@
+#include "FlatGraph.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace PacBio {
+namespace Poa {
+namespace detail {
+
+namespace {  // anonymous
+
+void InsertSorted(std::vector<VD>* vs, const VD v)
+{
+    vs->insert(std::lower_bound(vs->begin(), vs->end(), v), v);
+}
+
+void EraseSorted(std::vector<VD>* vs, const VD v)
+{
+    const auto it = std::lower_bound(vs->begin(), vs->end(), v);
+    if (it != vs->end() && *it == v) vs->erase(it);
+}
+
+// Lay out the edge lists of the live vertices as one CSR array.
+void BuildRows(const std::vector<std::vector<VD>>& lists, std::vector<size_t>* offsets,
+               std::vector<VD>* flat)
+{
+    offsets->resize(lists.size() + 1);
+    flat->clear();
+    for (size_t v = 0; v < lists.size(); ++v) {
+        (*offsets)[v] = flat->size();
+        flat->insert(flat->end(), lists[v].begin(), lists[v].end());
+    }
+    offsets->back() = flat->size();
+}
+
+}  // namespace anonymous
+
+FlatGraph::FlatGraph() : numLive_{0}, dirty_{false}, predOffsets_(1, 0), succOffsets_(1, 0) {}
+
+VD FlatGraph::AddVertex()
+{
+    const VD v = live_.size();
+    live_.push_back(true);
+    in_.emplace_back();
+    out_.emplace_back();
+    ++numLive_;
+    dirty_ = true;
+    return v;
+}
+
+void FlatGraph::AddEdge(const VD u, const VD v)
+{
+    assert(HasVertex(u) && HasVertex(v));
+    auto& succs = out_[u];
+    if (std::binary_search(succs.begin(), succs.end(), v)) return;
+    InsertSorted(&succs, v);
+    InsertSorted(&in_[v], u);
+    edges_.emplace_back(u, v);
+    dirty_ = true;
+}
+
+void FlatGraph::RemoveVertex(const VD v)
+{
+    assert(HasVertex(v));
+    for (const VD u : in_[v])
+        EraseSorted(&out_[u], v);
+    for (const VD w : out_[v])
+        EraseSorted(&in_[w], v);
+    std::vector<VD>().swap(in_[v]);
+    std::vector<VD>().swap(out_[v]);
+    live_[v] = false;
+    --numLive_;
+    dirty_ = true;
+}
+
+void FlatGraph::Update()
+{
+    if (!dirty_) return;
+
+    const size_t n = live_.size();
+    edges_.erase(std::remove_if(edges_.begin(), edges_.end(),
+                                [this](const std::pair<VD, VD>& e) {
+                                    return !live_[e.first] || !live_[e.second];
+                                }),
+                 edges_.end());
+
+    vertices_.clear();
+    for (VD v = 0; v < n; ++v)
+        if (live_[v]) vertices_.push_back(v);
+
+    BuildRows(in_, &predOffsets_, &preds_);
+    BuildRows(out_, &succOffsets_, &succs_);
+
+    // Kahn's algorithm, seeded and expanded in vertex order, so the order
+    // only depends on the graph and not on the history of edits
+    std::vector<size_t> inDegree(n, 0);
+    order_.clear();
+    order_.reserve(numLive_);
+    for (const VD v : vertices_) {
+        inDegree[v] = in_[v].size();
+        if (inDegree[v] == 0) order_.push_back(v);
+    }
+    for (size_t k = 0; k < order_.size(); ++k) {
+        for (const VD w : out_[order_[k]])
+            if (--inDegree[w] == 0) order_.push_back(w);
+    }
+    assert(order_.size() == numLive_);
+
+    dirty_ = false;
+}
+
+const std::vector<VD>& FlatGraph::Vertices() const
+{
+    assert(!dirty_);
+    return vertices_;
+}
+
+const std::vector<VD>& FlatGraph::TopologicalOrder() const
+{
+    assert(!dirty_);
+    return order_;
+}
+
+const std::vector<std::pair<VD, VD>>& FlatGraph::Edges() const
+{
+    assert(!dirty_);
+    return edges_;
+}
+
+VertexRange FlatGraph::Predecessors(const VD v) const
+{
+    assert(!dirty_ && v < live_.size());
+    return VertexRange(preds_.begin() + predOffsets_[v], preds_.begin() + predOffsets_[v + 1]);
+}
+
+VertexRange FlatGraph::Successors(const VD v) const
+{
+    assert(!dirty_ && v < live_.size());
+    return VertexRange(succs_.begin() + succOffsets_[v], succs_.begin() + succOffsets_[v + 1]);
+}
+
+}  // namespace detail
+}  // namespace Poa
+}  // namespace PacBio
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+namespace PacBio {
+namespace Poa {
+namespace detail {
+
+// Vertex descriptors are dense indices into the vertex arrays of the graph.
+// They are never reused, so removing vertices leaves holes.
+using VD = size_t;
+static const VD null_vertex = static_cast<VD>(-1);
+
+using VertexRange = boost::iterator_range<std::vector<VD>::const_iterator>;
+
+//
+// A flat, index-based DAG underlying the POA graph.
+//
+// Edits go to per-vertex sorted edge lists and a list of all edges in the
+// order they were added.  The traversals (the alignment DP, the consensus
+// and range finder recursions) instead read a snapshot: the live vertices in
+// topological order and their predecessors and successors as CSR arrays,
+// sorted by vertex, so walking the graph streams through a few contiguous
+// arrays.  Update() rebuilds the snapshot after a batch of edits, i.e. once
+// for every read threaded onto the graph, rather than sorting the graph anew
+// for every traversal.
+//
+class FlatGraph
+{
+public:
+    FlatGraph();
+
+    //
+    // Editing; invalidates the snapshot until the next Update()
+    //
+    VD AddVertex();
+    /// Add the edge u -> v, unless it exists already.
+    void AddEdge(VD u, VD v);
+    /// Remove v and all of its edges.
+    void RemoveVertex(VD v);
+    /// Rebuild the snapshot.
+    void Update();
+
+    //
+    // Snapshot queries
+    //
+    /// Upper bound of the descriptors handed out so far.
+    size_t NumIds() const { return live_.size(); }
+    size_t NumVertices() const { return numLive_; }
+    bool HasVertex(VD v) const { return v < live_.size() && live_[v]; }
+
+    /// Live vertices, in the order they were added.
+    const std::vector<VD>& Vertices() const;
+    /// Live vertices, in topological order.
+    const std::vector<VD>& TopologicalOrder() const;
+    /// Edges, in the order they were added.
+    const std::vector<std::pair<VD, VD>>& Edges() const;
+
+    VertexRange Predecessors(VD v) const;
+    VertexRange Successors(VD v) const;
+
+private:
+    // editable representation
+    std::vector<bool> live_;
+    std::vector<std::vector<VD>> in_;
+    std::vector<std::vector<VD>> out_;
+    std::vector<std::pair<VD, VD>> edges_;
+    size_t numLive_;
+
+    // snapshot
+    bool dirty_;
+    std::vector<VD> vertices_;
+    std::vector<VD> order_;
+    std::vector<size_t> predOffsets_;
+    std::vector<VD> preds_;
+    std::vector<size_t> succOffsets_;
+    std::vector<VD> succs_;
+};
+
+}  // namespace detail
+}  // namespace Poa
+}  // namespace PacBio
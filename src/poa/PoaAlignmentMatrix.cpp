@@ -1,7 +1,10 @@
 // Author: David Alexander
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -14,6 +17,52 @@ namespace PacBio {
 namespace Poa {
 namespace detail {
 
+constexpr size_t AlignmentColumnMap::NO_COLUMN;
+constexpr size_t AlignmentColumnPool::MAX_RETAINED;
+
+AlignmentColumnMap::AlignmentColumnMap() : numCells_{0}, maxCells_{0} {}
+
+void AlignmentColumnMap::Reserve(const size_t numIds, const size_t numColumns,
+                                 const size_t numCells)
+{
+    rank_.assign(numIds, NO_COLUMN);
+    columns_.clear();
+    columns_.reserve(numColumns);
+    numCells_ = 0;
+    if (numCells > maxCells_) {
+        // the graph, and so the alignment, grows with every read added
+        maxCells_ = std::max(numCells, maxCells_ + maxCells_ / 2);
+        scores_.reset(new float[maxCells_]);
+        reachingMoves_.reset(new MoveType[maxCells_]);
+        previousVertices_.reset(new VD[maxCells_]);
+    }
+}
+
+AlignmentColumn* AlignmentColumnMap::Add(const VD v, const int beginRow, const int endRow)
+{
+    const size_t offset = numCells_;
+    numCells_ += endRow - beginRow;
+    assert(numCells_ <= maxCells_ && columns_.size() < columns_.capacity());
+
+    rank_[v] = columns_.size();
+    columns_.emplace_back(v, beginRow, endRow, scores_.get() + offset,
+                          reachingMoves_.get() + offset, previousVertices_.get() + offset);
+    return &columns_.back();
+}
+
+std::unique_ptr<AlignmentColumnMap> AlignmentColumnPool::Take()
+{
+    if (free_.empty()) return std::make_unique<AlignmentColumnMap>();
+    std::unique_ptr<AlignmentColumnMap> columns = std::move(free_.back());
+    free_.pop_back();
+    return columns;
+}
+
+void AlignmentColumnPool::Give(std::unique_ptr<AlignmentColumnMap>&& columns)
+{
+    if (free_.size() < MAX_RETAINED) free_.emplace_back(std::move(columns));
+}
+
 void PoaAlignmentMatrixImpl::Print() const
 {
     const int COL_WIDTH = 6;
@@ -61,7 +110,7 @@ void PoaAlignmentMatrixImpl::Print() const
     }
 
     for (const auto& v : graph_->sortedVertices()) {
-        const AlignmentColumn* col = columns_.at(v);
+        const AlignmentColumn* col = columns_->at(v);
         const PoaNode& node = graph_->getPoaNode(v);
 
         header0 << std::setw(COL_WIDTH) << std::right << node.Id;
@@ -8,15 +8,16 @@
 
 #include <pacbio/denovo/PoaGraph.h>
 
-#include <boost/unordered_map.hpp>
 #include <boost/utility.hpp>
+#include <cassert>
 #include <cfloat>
+#include <memory>
+#include <vector>
 
-#include "BoostGraph.h"
+#include "FlatGraph.h"
 #include "VectorL.h"
 
 using boost::noncopyable;
-using boost::unordered_map;
 
 namespace PacBio {
 namespace Poa {
@@ -34,49 +35,106 @@ enum MoveType
     ExtraMove
 };
 
-struct AlignmentColumn : noncopyable
+// A view of the cells of one column, which live in the buffers of the
+// AlignmentColumnMap.
+struct AlignmentColumn
 {
     VD CurrentVertex;
     VectorL<float> Score;
     VectorL<MoveType> ReachingMove;
     VectorL<VD> PreviousVertex;
 
-    AlignmentColumn(VD vertex, int beginRow, int endRow)
+    AlignmentColumn(VD vertex, int beginRow, int endRow, float* score, MoveType* reachingMove,
+                    VD* previousVertex)
         : CurrentVertex(vertex)
-        , Score(beginRow, endRow, -FLT_MAX)
-        , ReachingMove(beginRow, endRow, InvalidMove)
-        , PreviousVertex(beginRow, endRow, null_vertex)
+        , Score(score, beginRow, endRow, -FLT_MAX)
+        , ReachingMove(reachingMove, beginRow, endRow, InvalidMove)
+        , PreviousVertex(previousVertex, beginRow, endRow, null_vertex)
     {
     }
 
-    ~AlignmentColumn() {}
     size_t BeginRow() const { return Score.BeginRow(); }
     size_t EndRow() const { return Score.EndRow(); }
     bool HasRow(size_t i) const { return (BeginRow() <= i) && (i < EndRow()); }
 };
 
-using AlignmentColumnMap = unordered_map<VD, const AlignmentColumn*>;
+//
+// The alignment columns of a read against the vertices of a graph.  The
+// columns are kept in the (topological) order they are added in, and their
+// cells back to back in one buffer per field, so the recursion walks
+// contiguous memory and one alignment costs a handful of allocations rather
+// than four per vertex.  Reserve() sizes the buffers up front: the views
+// handed out by Add() stay valid until the next Reserve().
+//
+class AlignmentColumnMap : noncopyable
+{
+public:
+    AlignmentColumnMap();
+
+    void Reserve(size_t numIds, size_t numColumns, size_t numCells);
+    AlignmentColumn* Add(VD v, int beginRow, int endRow);
+
+    const AlignmentColumn* at(VD v) const
+    {
+        assert(v < rank_.size() && rank_[v] != NO_COLUMN);
+        return &columns_[rank_[v]];
+    }
+    size_t size() const { return columns_.size(); }
+
+private:
+    static constexpr size_t NO_COLUMN = static_cast<size_t>(-1);
+
+    std::vector<size_t> rank_;  // indexed by VD
+    std::vector<AlignmentColumn> columns_;
+    // the cells are initialized by the columns, so don't bother with vectors
+    std::unique_ptr<float[]> scores_;
+    std::unique_ptr<MoveType[]> reachingMoves_;
+    std::unique_ptr<VD[]> previousVertices_;
+    size_t numCells_;
+    size_t maxCells_;
+};
+
+//
+// Recycles the AlignmentColumnMaps of the alignments against one graph, so
+// aligning the next read reuses the buffers of the previous ones.  Like the
+// graph, a pool must not be used by multiple threads at once.
+//
+class AlignmentColumnPool : noncopyable
+{
+public:
+    // SparsePoa keeps two alignments around, one per strand
+    static constexpr size_t MAX_RETAINED = 2;
+
+public:
+    std::unique_ptr<AlignmentColumnMap> Take();
+    void Give(std::unique_ptr<AlignmentColumnMap>&& columns);
+
+private:
+    std::vector<std::unique_ptr<AlignmentColumnMap>> free_;
+};
 
 class PoaAlignmentMatrixImpl : public PoaAlignmentMatrix
 {
 public:
-    virtual ~PoaAlignmentMatrixImpl()
+    PoaAlignmentMatrixImpl(std::shared_ptr<AlignmentColumnPool> pool)
+        : pool_(std::move(pool)), columns_(pool_->Take())
     {
-        for (auto& kv : columns_) {
-            delete kv.second;
-        }
     }
 
+    virtual ~PoaAlignmentMatrixImpl() { pool_->Give(std::move(columns_)); }
+
     virtual float Score() const { return score_; }
     size_t NumRows() const { return readSequence_.length() + 1; }
-    size_t NumCols() const { return columns_.size(); }
+    size_t NumCols() const { return columns_->size(); }
     void Print() const;
 
+private:
+    std::shared_ptr<AlignmentColumnPool> pool_;
+
 public:
-    // TODO: why did I leave these public?  why is there no
-    // constructor?
+    // TODO: why did I leave these public?
     const PoaGraphImpl* graph_;
-    AlignmentColumnMap columns_;
+    std::unique_ptr<AlignmentColumnMap> columns_;
     std::string readSequence_;
     PacBio::Align::AlignMode mode_;
     float score_;
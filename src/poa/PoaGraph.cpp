@@ -48,6 +48,11 @@ const PoaConsensus* PoaGraph::FindConsensus(const AlignConfig& config, int minCo
     return impl->FindConsensus(config, minCoverage);
 }
 
+string PoaGraph::ConsensusSequence(const AlignConfig& config) const
+{
+    return impl->ConsensusSequence(config);
+}
+
 string PoaGraph::ToGraphViz(int flags, const PoaConsensus* pc) const
 {
     return impl->ToGraphViz(flags, pc);
@@ -1,11 +1,10 @@
 // Author: Lance Hepler
 
+#include <fstream>
 #include <set>
+#include <sstream>
 
-#include <boost/foreach.hpp>
-#include <boost/graph/copy.hpp>
-#include <boost/graph/graphviz.hpp>
-#include <boost/graph/topological_sort.hpp>
+#include <boost/format.hpp>
 
 #include <pacbio/align/AlignConfig.h>
 #include <pacbio/denovo/PoaConsensus.h>
@@ -16,88 +15,71 @@
 
 using namespace PacBio::Align;
 
-namespace boost {
+namespace PacBio {
+namespace Poa {
+namespace detail {
 
-using namespace PacBio::Poa::detail;
-using namespace PacBio::Poa;
 using boost::format;
 
-class my_label_writer
+// GraphViz output, in the format of boost::write_graphviz
+class GraphVizWriter
 {
 public:
-    my_label_writer(VertexInfoMap map, bool color, bool verbose, const PoaConsensus* pc = nullptr)
-        : map_(map), cssVtxs_(), color_(color), verbose_(verbose)
+    GraphVizWriter(const std::vector<PoaNode>& vertexInfo, bool color, bool verbose,
+                   const PoaConsensus* pc = nullptr)
+        : vertexInfo_(vertexInfo), cssVtxs_(), color_(color), verbose_(verbose)
     {
         if (pc != nullptr) {
             cssVtxs_.insert(pc->Path.begin(), pc->Path.end());
         }
     }
 
-    template <class descriptor>
-    void operator()(std::ostream& out, const descriptor& v) const
+    void WriteVertexLabel(std::ostream& out, VD v) const
     {
-        PoaGraph::Vertex vertexId = map_[v].Id;
+        const PoaNode& node = vertexInfo_[v];
 
         std::string nodeColoringAttribute =
-            (color_ && isInConsensus(vertexId) ? R"( style="filled", fillcolor="lightblue" ,)"
-                                               : "");
+            (color_ && isInConsensus(node.Id) ? R"( style="filled", fillcolor="lightblue" ,)" : "");
 
         if (!verbose_) {
             out << format("[shape=Mrecord,%s label=\"{ %c | %d }\"]") % nodeColoringAttribute %
-                       map_[v].Base % map_[v].Reads;
+                       node.Base % node.Reads;
         } else {
             out << format(
                        "[shape=Mrecord,%s label=\"{ "
                        "{ %d | %c } | "
                        "{ %d | %d } | "
                        "{ %0.2f | %0.2f } }\"]") %
-                       nodeColoringAttribute % vertexId % map_[v].Base % map_[v].Reads %
-                       map_[v].SpanningReads % map_[v].Score % map_[v].ReachingScore;
+                       nodeColoringAttribute % node.Id % node.Base % node.Reads %
+                       node.SpanningReads % node.Score % node.ReachingScore;
         }
     }
 
 private:
     bool isInConsensus(PoaGraph::Vertex v) const { return cssVtxs_.find(v) != cssVtxs_.end(); }
-    VertexInfoMap map_;
+    const std::vector<PoaNode>& vertexInfo_;
     std::set<PoaGraph::Vertex> cssVtxs_;
     bool color_;
     bool verbose_;
 };
 
-class my_graph_writer
-{
-public:
-    my_graph_writer(bool leftToRight = false) : leftToRight_(leftToRight) {}
-    void operator()(std::ostream& out) const
-    {
-        if (leftToRight_) out << "rankdir=\"LR\";" << std::endl;
-    }
-
-private:
-    bool leftToRight_;
-};
-
-}  // namespace boost
-
-namespace PacBio {
-namespace Poa {
-namespace detail {
-
 // ----------------- PoaGraphImpl ---------------------
 
 PoaGraphImpl::PoaGraphImpl()
-    : g_(), vertexInfoMap_(get(vertex_info, g_)), numReads_(0), totalVertices_(0), liveVertices_(0)
+    : g_(), vertexInfo_(), numReads_(0), columnPool_(std::make_shared<AlignmentColumnPool>())
 {
     enterVertex_ = addVertex('^', 0);
     exitVertex_ = addVertex('$', 0);
+    g_.Update();
 }
 
 PoaGraphImpl::PoaGraphImpl(const PoaGraphImpl& other)
     : g_(other.g_)
-    , vertexInfoMap_(get(vertex_info, g_))
+    , vertexInfo_(other.vertexInfo_)
     , enterVertex_(other.enterVertex_)
     , exitVertex_(other.exitVertex_)
     , numReads_(other.numReads_)
+    , columnPool_(std::make_shared<AlignmentColumnPool>())
 {
 }
 
@@ -106,54 +88,69 @@ void PoaGraphImpl::repCheck() const
 {
 #ifndef NDEBUG
     // assert the representation invariant for the object
-    BOOST_FOREACH (const VD v, vertices(g_)) {
+    for (const VD v : g_.Vertices()) {
         if (v == enterVertex_) {
-            assert(in_degree(v, g_) == 0);
-            assert(out_degree(v, g_) > 0 || NumReads() == 0);
+            assert(g_.Predecessors(v).empty());
+            assert(!g_.Successors(v).empty() || NumReads() == 0);
         } else if (v == exitVertex_) {
-            assert(in_degree(v, g_) > 0 || NumReads() == 0);
-            assert(out_degree(v, g_) == 0);
+            assert(!g_.Predecessors(v).empty() || NumReads() == 0);
+            assert(g_.Successors(v).empty());
         } else {
-            assert(in_degree(v, g_) > 0);
-            assert(out_degree(v, g_) > 0);
+            assert(!g_.Predecessors(v).empty());
+            assert(!g_.Successors(v).empty());
         }
     }
 #endif
 }
 
-static inline vector<const AlignmentColumn*> getPredecessorColumns(const BoostGraph& g, VD v,
-                                                                   const AlignmentColumnMap& colMap)
+static inline void getPredecessorColumns(const FlatGraph& g, VD v, const AlignmentColumnMap& colMap,
+                                         vector<const AlignmentColumn*>* predecessorColumns)
 {
-    vector<const AlignmentColumn*> predecessorColumns;
+    predecessorColumns->clear();
     const AlignmentColumn* predCol;
-    for (auto e : inEdges(v, g)) {
-        VD u = source(e, g);
+    for (const VD u : g.Predecessors(v)) {
         predCol = colMap.at(u);
         assert(predCol != nullptr);
-        predecessorColumns.push_back(predCol);
+        predecessorColumns->push_back(predCol);
     }
-    return predecessorColumns;
 }
 
 PoaConsensus* PoaGraphImpl::FindConsensus(const AlignConfig& config, int minCoverage)
 {
     std::vector<VD> bestPath = consensusPath(config.Mode, minCoverage);
-    std::string consensusSequence = sequenceAlongPath(g_, vertexInfoMap_, bestPath);
+    std::string consensusSequence = sequenceAlongPath(vertexInfo_, bestPath);
     PoaConsensus* pc = new PoaConsensus(consensusSequence, *this, externalizePath(bestPath));
     return pc;
 }
 
-const AlignmentColumn* PoaGraphImpl::makeAlignmentColumnForExit(VD v,
-                                                                const AlignmentColumnMap& colMap,
-                                                                const std::string& sequence,
-                                                                const AlignConfig& config) const
+std::string PoaGraphImpl::ConsensusSequence(const AlignConfig& config) const
+{
+    return intermediateConsensus(config.Mode).Sequence;
+}
+
+const PoaGraphImpl::IntermediateConsensus& PoaGraphImpl::intermediateConsensus(
+    const AlignMode mode) const
+{
+    IntermediateConsensus& css = intermediateConsensus_;
+    if (!css.Valid || css.Mode != mode) {
+        css.Path = consensusPath(mode);
+        css.Sequence = sequenceAlongPath(vertexInfo_, css.Path);
+        css.Mode = mode;
+        css.Valid = true;
+    }
+    return css;
+}
+
+const AlignmentColumn* PoaGraphImpl::makeAlignmentColumnForExit(
+    VD v, AlignmentColumnMap* colMap, const std::string& sequence, const AlignConfig& config,
+    vector<const AlignmentColumn*>* predecessorColumns) const
 {
-    assert(out_degree(v, g_) == 0);
+    assert(g_.Successors(v).empty());
 
     // this is kind of unnecessary as we are only actually using one entry in
     // this column
     int I = sequence.length();
-    auto* curCol = new AlignmentColumn(v, 0, I + 1);
+    AlignmentColumn* curCol = colMap->Add(v, 0, I + 1);
 
     float bestScore = -FLT_MAX;
     VD prevVertex = null_vertex;
@@ -164,9 +161,9 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumnForExit(VD v,
     // the graph.  In local alignment, it may have been from any
     // row, not necessarily I.
     if (config.Mode == AlignMode::SEMIGLOBAL || config.Mode == AlignMode::LOCAL) {
-        BOOST_FOREACH (const VD u, vertices(g_)) {
+        for (const VD u : g_.Vertices()) {
             if (u != exitVertex_) {
-                const AlignmentColumn* predCol = colMap.at(u);
+                const AlignmentColumn* predCol = colMap->at(u);
                 int prevRow = (config.Mode == AlignMode::LOCAL ? ArgMax(predCol->Score) : I);
                 if (predCol->HasRow(prevRow) && predCol->Score[prevRow] > bestScore) {
                     bestScore = predCol->Score[prevRow];
@@ -176,8 +173,8 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumnForExit(VD v,
         }
     } else {
         // regular predecessors
-        vector<const AlignmentColumn*> predecessorColumns = getPredecessorColumns(g_, v, colMap);
-        for (const AlignmentColumn* predCol : predecessorColumns) {
+        getPredecessorColumns(g_, v, *colMap, predecessorColumns);
+        for (const AlignmentColumn* predCol : *predecessorColumns) {
             if (predCol->HasRow(I) && predCol->Score[I] > bestScore) {
                 bestScore = predCol->Score[I];
                 prevVertex = predCol->CurrentVertex;
@@ -191,10 +188,9 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumnForExit(VD v,
     return curCol;
 }
 
-const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(VD v, const AlignmentColumnMap& colMap,
-                                                         const std::string& sequence,
-                                                         const AlignConfig& config, int beginRow,
-                                                         int endRow) const
+const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(
+    VD v, AlignmentColumnMap* colMap, const std::string& sequence, const AlignConfig& config,
+    int beginRow, int endRow, vector<const AlignmentColumn*>* predecessorColumns) const
 {
     AlignmentColumn* curCol;
     if (beginRow > endRow) {
@@ -204,7 +200,7 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(VD v, const AlignmentCo
 
         // This is only going to work in LOCAL aln, assert on that
 
-        curCol = new AlignmentColumn(v, 0, 1);
+        curCol = colMap->Add(v, 0, 1);
         curCol->ReachingMove[0] = StartMove;
         curCol->PreviousVertex[0] = enterVertex_;
         curCol->Score[0] = 0;  // > -FLT_MAX
@@ -213,9 +209,9 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(VD v, const AlignmentCo
 
     assert(beginRow < endRow || beginRow == 0 || beginRow == static_cast<int>(sequence.length()));
 
-    curCol = new AlignmentColumn(v, beginRow, endRow);
-    const PoaNode& vertexInfo = vertexInfoMap_[v];
-    vector<const AlignmentColumn*> predecessorColumns = getPredecessorColumns(g_, v, colMap);
+    curCol = colMap->Add(v, beginRow, endRow);
+    const PoaNode& vertexInfo = vertexInfo_[v];
+    getPredecessorColumns(g_, v, *colMap, predecessorColumns);
 
     // i represents position in array
     // readPos=i-1 represents position in read
@@ -239,7 +235,7 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(VD v, const AlignmentCo
         // Special-case the first row, this could probably be factored
         // more cleanly
         if (i == 0) {
-            if (predecessorColumns.size() == 0) {
+            if (predecessorColumns->empty()) {
                 // if this vertex doesn't have any in-edges it is ^; has
                 // no reaching move
                 assert(v == enterVertex_);
@@ -253,7 +249,7 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(VD v, const AlignmentCo
                 curCol->PreviousVertex[0] = enterVertex_;
             } else {
                 // otherwise it's a deletion
-                for (const AlignmentColumn* prevCol : predecessorColumns) {
+                for (const AlignmentColumn* prevCol : *predecessorColumns) {
                     candidateScore = prevCol->Score[0] + config.Params.Delete;
                     if (candidateScore > bestScore) {
                         bestScore = candidateScore;
@@ -267,7 +263,7 @@ const AlignmentColumn* PoaGraphImpl::makeAlignmentColumn(VD v, const AlignmentCo
                 curCol->PreviousVertex[0] = prevVertex;
             }
         } else {
-            for (const AlignmentColumn* prevCol : predecessorColumns) {
+            for (const AlignmentColumn* prevCol : *predecessorColumns) {
                 // Incorporate (Match or Mismatch)
                 if (prevCol->HasRow(i - 1)) {
                     bool isMatch = sequence[i - 1] == vertexInfo.Base;
@@ -328,6 +324,7 @@ void PoaGraphImpl::AddFirstRead(const std::string& readSeq, std::vector<Vertex>*
 
     threadFirstRead(readSeq, readPathOutput);
     numReads_++;
+    intermediateConsensus_.Valid = false;
     repCheck();
 }
 
@@ -343,41 +340,53 @@ PoaAlignmentMatrix* PoaGraphImpl::TryAddRead(const std::string& readSeq, const A
         // NB: no minCoverage applicable here; this
         // "intermediate" consensus may include extra sequence
         // at either end
-        std::vector<VD> cssPath = consensusPath(config.Mode);
-        std::string cssSeq = sequenceAlongPath(g_, vertexInfoMap_, cssPath);
-        rangeFinder->InitRangeFinder(*this, externalizePath(cssPath), cssSeq, readSeq);
+        const IntermediateConsensus& css = intermediateConsensus(config.Mode);
+        rangeFinder->InitRangeFinder(*this, externalizePath(css.Path), css.Sequence, readSeq);
     }
 
     // Calculate alignment columns of sequence vs. graph, using sparsity if
     // we have a range finder.
-    auto* mat = new PoaAlignmentMatrixImpl();
+    auto* mat = new PoaAlignmentMatrixImpl(columnPool_);
     mat->readSequence_ = readSeq;
     mat->mode_ = config.Mode;
     mat->graph_ = this;
 
-    vector<VD> sortedVerticesLocal(num_vertices(g_));
-    topological_sort(g_, sortedVerticesLocal.rbegin());
-    const AlignmentColumn* curCol;
-    for (const auto& v : sortedVerticesLocal) {
-        if (v != exitVertex_) {
-            size_t startRow = 0, endRow = readSeq.size() + 1;
-            if (rangeFinder) {
-                // FindAlignableRange returns an alignable sequence range, which is not the same as
-                // the alignable rows (the end is off-by-one, for a normal interval).
-                int startRange, endRange;
-                std::tie(startRange, endRange) = rangeFinder->FindAlignableRange(externalize(v));
-                startRow = startRange;
-                endRow = (endRange == -INT_MAX / 2 ? endRange : endRange + 1);
-            }
-            Vertex vExt = externalize(v);  // DEBUGGING
-            curCol = makeAlignmentColumn(v, mat->columns_, readSeq, config, startRow, endRow);
-        } else {
-            curCol = makeAlignmentColumnForExit(v, mat->columns_, readSeq, config);
+    // Find the rows of every column first, so that all columns can be laid
+    // out in one buffer.  $ goes last: outside of global alignment, any
+    // vertex may precede it.
+    const std::vector<VD>& sortedVerticesLocal = g_.TopologicalOrder();
+    std::vector<std::pair<int, int>> rows;
+    rows.reserve(sortedVerticesLocal.size());
+    size_t numCells = readSeq.size() + 1;
+    for (const VD v : sortedVerticesLocal) {
+        if (v == exitVertex_) continue;
+        int startRow = 0, endRow = readSeq.size() + 1;
+        if (rangeFinder) {
+            // FindAlignableRange returns an alignable sequence range, which is not the same as
+            // the alignable rows (the end is off-by-one, for a normal interval).
+            int startRange, endRange;
+            std::tie(startRange, endRange) = rangeFinder->FindAlignableRange(externalize(v));
+            startRow = startRange;
+            endRow = (endRange == -INT_MAX / 2 ? endRange : endRange + 1);
         }
-        mat->columns_[v] = curCol;
+        rows.emplace_back(startRow, endRow);
+        // an empty range yields a single-row column, see makeAlignmentColumn
+        numCells += (startRow > endRow) ? 1 : endRow - startRow;
     }
+    mat->columns_->Reserve(g_.NumIds(), sortedVerticesLocal.size(), numCells);
 
-    mat->score_ = mat->columns_[exitVertex_]->Score[readSeq.size()];
+    std::vector<const AlignmentColumn*> predecessorColumns;
+    auto row = rows.cbegin();
+    for (const VD v : sortedVerticesLocal) {
+        if (v == exitVertex_) continue;
+        makeAlignmentColumn(v, mat->columns_.get(), readSeq, config, row->first, row->second,
+                            &predecessorColumns);
+        ++row;
+    }
+    const AlignmentColumn* exitCol = makeAlignmentColumnForExit(
+        exitVertex_, mat->columns_.get(), readSeq, config, &predecessorColumns);
+
+    mat->score_ = exitCol->Score[readSeq.size()];
     repCheck();
 
     return mat;
@@ -388,69 +397,48 @@ void PoaGraphImpl::CommitAdd(PoaAlignmentMatrix* mat_, std::vector<Vertex>* read
     repCheck();
 
     auto* mat = static_cast<PoaAlignmentMatrixImpl*>(mat_);
-    tracebackAndThread(mat->readSequence_, mat->columns_, mat->mode_, readPathOutput);
+    tracebackAndThread(mat->readSequence_, *mat->columns_, mat->mode_, readPathOutput);
     numReads_++;
+    intermediateConsensus_.Valid = false;
 
     repCheck();
 }
 
-struct VertexComparator
-{
-    VertexComparator(const BoostGraph& g) : g_(g) {}
-    // Use exsiting indices to provide a stable memory-agnostic ordering
-    bool operator()(VD v1, VD v2) const
-    {
-        const int vi1 = get(vertex_index, g_, v1);
-        const int vi2 = get(vertex_index, g_, v2);
-        return (vi1 < vi2);
-    }
-
-private:
-    const BoostGraph& g_;
-};
-
 void PoaGraphImpl::PruneGraph(const int minCoverage)
 {
-    // We have to use an iterator since we're modifying the graph as we go
-    graph_traits<BoostGraph>::vertex_iterator vi, vi_end, next;
-    tie(vi, vi_end) = vertices(g_);
-    for (next = vi; vi != vi_end; vi = next) {
-        ++next;
-        if (vertexInfoMap_[*vi].Reads < minCoverage) {
-            clear_vertex(*vi, g_);
-            remove_vertex(*vi, g_);
+    for (const VD v : std::vector<VD>(g_.Vertices())) {
+        if (vertexInfo_[v].Reads < minCoverage) {
+            g_.RemoveVertex(v);
         }
     }
-
-    // This is a workaround for the non-deterministic order of iteration
-    // from BGL's vertices, which like edges also appear to be ordered
-    // by memory address (see: http://stackoverflow.com/questions/30968690/)
-
-    // We can't use topological sort here, since having a vertex index greater
-    // than num_vertices(g_) causes a crash. Instead we sort the vertices by
-    // their existing index.  This should still be very fast, as the underlying
-    // collection should be mostly sorted already.
-    vector<VD> sortedVerticesLocal;
-    BGL_FORALL_VERTICES(v, g_, BoostGraph) sortedVerticesLocal.push_back(v);
-    std::sort(sortedVerticesLocal.begin(), sortedVerticesLocal.end(), VertexComparator(g_));
-
-    // Finally, re-index all vertices to the range [0, num_vertices(g_)]
-    graph_traits<BoostGraph>::vertices_size_type current_index = 0;
-    index_map_t index_map = get(vertex_index, g_);
-    for (const VD& v : sortedVerticesLocal) {
-        index_map[v] = current_index++;
-    }
+    g_.Update();
+    intermediateConsensus_.Valid = false;
 }
 
 size_t PoaGraphImpl::NumReads() const { return numReads_; }
 
 string PoaGraphImpl::ToGraphViz(int flags, const PoaConsensus* pc) const
 {
+    const GraphVizWriter writer(vertexInfo_, flags & PoaGraph::COLOR_NODES,
+                                flags & PoaGraph::VERBOSE_NODES, pc);
+
+    // GraphViz IDs number the remaining vertices consecutively
+    std::vector<size_t> index(g_.NumIds());
+    for (size_t i = 0; i < g_.Vertices().size(); ++i)
+        index[g_.Vertices()[i]] = i;
+
     std::ostringstream ss;
-    write_graphviz(ss, g_, my_label_writer(vertexInfoMap_, flags & PoaGraph::COLOR_NODES,
-                                           flags & PoaGraph::VERBOSE_NODES, pc),
-                   default_writer(),  // edge writer
-                   my_graph_writer(true));
+    ss << "digraph G {" << std::endl;
+    ss << "rankdir=\"LR\";" << std::endl;
+    for (const VD v : g_.Vertices()) {
+        ss << index[v];
+        writer.WriteVertexLabel(ss, v);
+        ss << ";" << std::endl;
+    }
+    for (const auto& e : g_.Edges()) {
+        ss << index[e.first] << "->" << index[e.second] << " ;" << std::endl;
+    }
+    ss << "}" << std::endl;
 
     return ss.str();
 }
@@ -467,12 +455,9 @@ void PoaGraphImpl::WriteGraphCsvFile(const string& filename) const
 {
     std::ofstream outfile(filename.c_str());
 
-    std::list<VD> sortedVerticesLocal(num_vertices(g_));
-    topological_sort(g_, sortedVerticesLocal.rbegin());
-
     outfile << "Id,Base,Reads,SpanningReads,Score,ReachingScore" << std::endl;
-    for (const VD v : sortedVerticesLocal) {
-        PoaNode& vi = vertexInfoMap_[v];
+    for (const VD v : g_.TopologicalOrder()) {
+        const PoaNode& vi = vertexInfo_[v];
         outfile << vi.Id << "," << vi.Base << "," << vi.Reads << "," << vi.SpanningReads << ","
                 << vi.Score << "," << vi.ReachingScore << std::endl;
     }
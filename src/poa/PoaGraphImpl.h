@@ -4,28 +4,19 @@
 
 #include <cfloat>
 #include <climits>
+#include <memory>
 #include <vector>
 
-#include <boost/config.hpp>
-#include <boost/format.hpp>
-#include <boost/static_assert.hpp>
-#include <boost/type_traits.hpp>
-
 #include <pacbio/align/AlignConfig.h>
 #include <pacbio/consensus/Mutation.h>
 #include <pacbio/denovo/PoaGraph.h>
 
-#include "BoostGraph.h"
+#include "FlatGraph.h"
 #include "PoaAlignmentMatrix.h"
 
 using std::string;
 using std::vector;
 
-///
-///  Boost graph library typedefs, properties, and graphviz output.
-///
-using namespace boost;  // NOLINT
-
 namespace PacBio {
 namespace Poa {
 namespace detail {
@@ -62,79 +53,55 @@ struct PoaNode
 // External-facing vertex id type
 using Vertex = size_t;
 
-struct EdgeComparator
-{
-    EdgeComparator(const BoostGraph& g) : g_(g) {}
-    // want lex. comparison... just using pair to get it..
-    bool operator()(ED e1, ED e2) const
-    {
-        std::pair<int, int> vt1, vt2;
-        vt1 = std::make_pair(get(vertex_index, g_, source(e1, g_)),
-                             get(vertex_index, g_, target(e1, g_)));
-        vt2 = std::make_pair(get(vertex_index, g_, source(e2, g_)),
-                             get(vertex_index, g_, target(e2, g_)));
-        return (vt1 < vt2);
-    }
-
-private:
-    const BoostGraph& g_;
-};
-
-inline std::vector<ED> inEdges(VD v, const BoostGraph& g)
-{
-    // This is a sad workaround the nondeterministic order of iteration
-    // from BGL's in_edges. (see: http://stackoverflow.com/questions/30968690/)
-
-    // Unfortunately, we can't just use the boost::sort range adapter
-    // because it requires an underlying random access iterator, which
-    // we can't get from the std::set container.
-    graph_traits<BoostGraph>::in_edge_iterator begin, end;
-    tie(begin, end) = in_edges(v, g);
-    std::vector<ED> tmp(begin, end);
-    std::sort(tmp.begin(), tmp.end(), EdgeComparator(g));
-    return tmp;
-}
-
 class PoaGraphImpl
 {
     friend class SdpRangeFinder;
 
-    BoostGraph g_;
-    VertexInfoMap vertexInfoMap_;  // NB: this is a reference type and refers to
-                                   // an "internal" property map
-    index_map_t indexMap_;
+    FlatGraph g_;
+    mutable std::vector<PoaNode> vertexInfo_;  // indexed by VD; consensusPath()
+                                               // records the node scores here
     VD enterVertex_;
     VD exitVertex_;
     size_t numReads_;
-    size_t totalVertices_;               // includes "ex"-vertices which have since been removed
-    size_t liveVertices_;                // vertices that are in the graph.  this is needed
-                                         // for algorithms.
-    std::map<Vertex, VD> vertexLookup_;  // external ID -> internal ID
+    // column storage for TryAddRead, shared with the matrices it returns
+    std::shared_ptr<AlignmentColumnPool> columnPool_;
+
+    // The intermediate consensus TryAddRead aligns against, kept until the
+    // graph changes: orienting a read traces it once for ConsensusSequence
+    // and the TryAddRead of either strand.
+    struct IntermediateConsensus
+    {
+        bool Valid = false;
+        PacBio::Align::AlignMode Mode;
+        std::vector<VD> Path;
+        std::string Sequence;
+    };
+    mutable IntermediateConsensus intermediateConsensus_;
+
+    const IntermediateConsensus& intermediateConsensus(PacBio::Align::AlignMode mode) const;
 
     void repCheck() const;
 
     VD addVertex(char base, int nReads = 1, int spanningReads = 0)
     {
-        VD vd = add_vertex(g_);
-        Vertex vExt = totalVertices_++;
-        vertexInfoMap_[vd] = PoaNode(vExt, base, nReads, spanningReads);
-        vertexLookup_[vExt] = vd;
-        indexMap_[vd] = liveVertices_++;
+        VD vd = g_.AddVertex();
+        vertexInfo_.emplace_back(vd, base, nReads, spanningReads);
         return vd;
     }
 
     //
     // utility routines
     //
-    const AlignmentColumn* makeAlignmentColumn(VD v,
-                                               const AlignmentColumnMap& alignmentColumnForVertex,
-                                               const std::string& sequence,
-                                               const PacBio::Align::AlignConfig& config,
-                                               int beginRow, int endRow) const;
+    // predecessorColumns is scratch space, to save an allocation per column
+    const AlignmentColumn* makeAlignmentColumn(
+        VD v, AlignmentColumnMap* alignmentColumnForVertex, const std::string& sequence,
+        const PacBio::Align::AlignConfig& config, int beginRow, int endRow,
+        std::vector<const AlignmentColumn*>* predecessorColumns) const;
 
     const AlignmentColumn* makeAlignmentColumnForExit(
-        VD v, const AlignmentColumnMap& alignmentColumnForVertex, const std::string& sequence,
-        const PacBio::Align::AlignConfig& config) const;
+        VD v, AlignmentColumnMap* alignmentColumnForVertex, const std::string& sequence,
+        const PacBio::Align::AlignConfig& config,
+        std::vector<const AlignmentColumn*>* predecessorColumns) const;
 
 public:
     //
@@ -146,7 +113,7 @@ public:
         if (vd == null_vertex) {
             return PoaGraph::NullVertex;
         } else {
-            return vertexInfoMap_[vd].Id;
+            return vertexInfo_[vd].Id;
         }
     }
 
@@ -155,7 +122,8 @@ public:
         if (vertex == PoaGraph::NullVertex) {
             return null_vertex;
         }
-        return vertexLookup_.at(vertex);
+        // external IDs are the vertex descriptors themselves
+        return vertexInfo_.at(vertex).Id;
     }
 
     std::vector<Vertex> externalizePath(const std::vector<VD>& vds) const
@@ -180,7 +148,7 @@ public:
     //
     // POA node lookup
     //
-    const PoaNode& getPoaNode(VD v) const { return vertexInfoMap_[v]; }
+    const PoaNode& getPoaNode(VD v) const { return vertexInfo_[v]; }
 public:
     //
     // Graph traversal functions, defined in PoaGraphTraversals
@@ -220,6 +188,7 @@ public:
 
     PoaConsensus* FindConsensus(const PacBio::Align::AlignConfig& config,
                                 int minCoverage = -INT_MAX);
+    std::string ConsensusSequence(const PacBio::Align::AlignConfig& config) const;
     void PruneGraph(const int minCoverage);
 
     size_t NumReads() const;
@@ -229,8 +198,7 @@ public:
 };
 
 // free functions, we should put these all in traversals
-std::string sequenceAlongPath(const BoostGraph& g, const VertexInfoMap& vertexInfoMap,
-                              const std::vector<VD>& path);
+std::string sequenceAlongPath(const std::vector<PoaNode>& vertexInfo, const std::vector<VD>& path);
 
 }  // namespace detail
 }  // namespace Poa
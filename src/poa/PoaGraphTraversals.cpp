@@ -1,8 +1,7 @@
 // Author: David Alexander
 
-#include <boost/foreach.hpp>
-#include <boost/graph/topological_sort.hpp>
-#include <boost/unordered_set.hpp>
+#include <list>
+#include <sstream>
 
 #include <pacbio/denovo/PoaGraph.h>
 
@@ -16,21 +15,27 @@ namespace detail {
 using namespace PacBio::Align;
 using namespace PacBio::Consensus;
 
-std::string sequenceAlongPath(const BoostGraph& g, const VertexInfoMap& vertexInfoMap,
-                              const std::vector<VD>& path)
+std::string sequenceAlongPath(const std::vector<PoaNode>& vertexInfo, const std::vector<VD>& path)
 {
-    std::ostringstream ss;
+    std::string seq;
+    seq.reserve(path.size());
     for (const VD v : path) {
-        ss << vertexInfoMap[v].Base;
+        seq.push_back(vertexInfo[v].Base);
     }
-    return ss.str();
+    return seq;
 }
 
-boost::unordered_set<VD> SpanningDFS(const VD start, const VD end, const BoostGraph& g)
+std::vector<VD> SpanningDFS(const VD start, const VD end, const FlatGraph& g)
 {
+    enum : unsigned char
+    {
+        UNSEEN,
+        FWD,
+        REV
+    };
+    std::vector<unsigned char> mark(g.NumIds(), UNSEEN);
     std::vector<VD> stack;
-    boost::unordered_set<VD> fwd;
-    boost::unordered_set<VD> rev;
+    std::vector<VD> rev;
     // find all vertices reachable from start
     stack.push_back(start);
     do {
@@ -38,10 +43,10 @@ boost::unordered_set<VD> SpanningDFS(const VD start, const VD end, const BoostGr
         stack.pop_back();
         // mark those we've already visited,
         //   if so, skip
-        if (fwd.find(v) != fwd.end()) continue;
-        fwd.insert(v);
-        BOOST_FOREACH (const ED& e, out_edges(v, g)) {
-            stack.push_back(target(e, g));
+        if (mark[v] != UNSEEN) continue;
+        mark[v] = FWD;
+        for (const VD w : g.Successors(v)) {
+            stack.push_back(w);
         }
     } while (!stack.empty());
     // find all vertices that can reach end
@@ -52,27 +57,22 @@ boost::unordered_set<VD> SpanningDFS(const VD start, const VD end, const BoostGr
         stack.pop_back();
         // if it's not been visited in the forward pass,
         //   or we've already visited it here, skip
-        if (fwd.find(v) == fwd.end() || rev.find(v) != rev.end()) continue;
-        rev.insert(v);
-        BOOST_FOREACH (const ED& e, in_edges(v, g)) {
-            stack.push_back(source(e, g));
+        if (mark[v] != FWD) continue;
+        mark[v] = REV;
+        rev.push_back(v);
+        for (const VD u : g.Predecessors(v)) {
+            stack.push_back(u);
         }
     } while (!stack.empty());
     return rev;
 }
 
-std::vector<VD> PoaGraphImpl::sortedVertices() const
-{
-    vector<VD> sv(num_vertices(g_));
-    topological_sort(g_, sv.rbegin());
-    return sv;
-}
+std::vector<VD> PoaGraphImpl::sortedVertices() const { return g_.TopologicalOrder(); }
 
 void PoaGraphImpl::tagSpan(VD start, VD end)
 {
-    boost::unordered_set<VD> vertices = SpanningDFS(start, end, g_);
-    for (const VD v : vertices) {
-        vertexInfoMap_[v].SpanningReads++;
+    for (const VD v : SpanningDFS(start, end, g_)) {
+        vertexInfo_[v].SpanningReads++;
     }
 }
 
@@ -95,20 +95,17 @@ std::vector<VD> PoaGraphImpl::consensusPath(AlignMode mode, int minCoverage) con
     int totalReads = NumReads();
 
     std::list<VD> path;
-    std::list<VD> sortedVerticesLocal(num_vertices(g_));
-    topological_sort(g_, sortedVerticesLocal.rbegin());
-    unordered_map<VD, VD> bestPrevVertex;
+    std::vector<VD> bestPrevVertex(g_.NumIds(), null_vertex);
 
-    // ignore ^ and $
-    // TODO(dalexander): find a cleaner way to do this
-    vertexInfoMap_[sortedVerticesLocal.front()].ReachingScore = 0;
-    sortedVerticesLocal.pop_back();
-    sortedVerticesLocal.pop_front();
+    vertexInfo_[enterVertex_].ReachingScore = 0;
 
     VD bestVertex = null_vertex;
     float bestReachingScore = -FLT_MAX;
-    for (const VD v : sortedVerticesLocal) {
-        PoaNode& vInfo = vertexInfoMap_[v];
+    for (const VD v : g_.TopologicalOrder()) {
+        // ignore ^ and $
+        if (v == enterVertex_ || v == exitVertex_) continue;
+
+        PoaNode& vInfo = vertexInfo_[v];
         int containingReads = vInfo.Reads;
         int spanningReads = vInfo.SpanningReads;
         float score =
@@ -117,10 +114,8 @@ std::vector<VD> PoaGraphImpl::consensusPath(AlignMode mode, int minCoverage) con
                 : (2 * containingReads - 1 * totalReads - 0.0001f);
         vInfo.Score = score;
         vInfo.ReachingScore = score;
-        bestPrevVertex[v] = null_vertex;
-        for (const ED& e : inEdges(v, g_)) {
-            VD sourceVertex = source(e, g_);
-            float rsc = score + vertexInfoMap_[sourceVertex].ReachingScore;
+        for (const VD sourceVertex : g_.Predecessors(v)) {
+            float rsc = score + vertexInfo_[sourceVertex].ReachingScore;
             if (rsc > vInfo.ReachingScore) {
                 vInfo.ReachingScore = rsc;
                 bestPrevVertex[v] = sourceVertex;
@@ -129,11 +124,10 @@ std::vector<VD> PoaGraphImpl::consensusPath(AlignMode mode, int minCoverage) con
                 bestVertex = v;
                 bestReachingScore = rsc;
             }
-            // if the score is the same, the order we've encountered vertices
-            //   might not be deterministic. Fix this by comparing on
-            //   vertex_index
+            // if the score is the same, prefer the vertex added first, so
+            //   the result doesn't depend on the topological order
             else if (rsc == bestReachingScore) {
-                if (get(vertex_index, g_, v) < get(vertex_index, g_, bestVertex)) bestVertex = v;
+                if (v < bestVertex) bestVertex = v;
             }
         }
     }
@@ -165,10 +159,10 @@ void PoaGraphImpl::threadFirstRead(std::string sequence, std::vector<Vertex>* ou
             outputPath->push_back(externalize(v));
         }
         if (readPos == 0) {
-            add_edge(enterVertex_, v, g_);
+            g_.AddEdge(enterVertex_, v);
             startSpanVertex = v;
         } else {
-            add_edge(u, v, g_);
+            g_.AddEdge(u, v);
         }
         u = v;
         readPos++;
@@ -176,7 +170,8 @@ void PoaGraphImpl::threadFirstRead(std::string sequence, std::vector<Vertex>* ou
     assert(startSpanVertex != null_vertex);
     assert(u != null_vertex);
     endSpanVertex = u;
-    add_edge(u, exitVertex_, g_);  // terminus -> $
+    g_.AddEdge(u, exitVertex_);  // terminus -> $
+    g_.Update();
     tagSpan(startSpanVertex, endSpanVertex);
 }
 
@@ -218,7 +213,6 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
 
         curCol = alignmentColumnForVertex.at(u);
         assert(curCol != nullptr);
-        PoaNode& curNodeInfo = vertexInfoMap_[u];
         VD prevVertex = curCol->PreviousVertex[i];
         MoveType reachingMove = curCol->ReachingMove[i];
 
@@ -232,7 +226,7 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
             while (i > 0) {
                 assert(alignMode == AlignMode::LOCAL);
                 VD newForkVertex = addVertex(sequence[READPOS], 1, span);
-                add_edge(newForkVertex, forkVertex, g_);
+                g_.AddEdge(newForkVertex, forkVertex);
                 VERTEX_ON_PATH(READPOS, newForkVertex);
                 forkVertex = newForkVertex;
                 i--;
@@ -251,7 +245,7 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
 
                 while (i > static_cast<int>(prevRow)) {
                     VD newForkVertex = addVertex(sequence[READPOS], 1, span);
-                    add_edge(newForkVertex, forkVertex, g_);
+                    g_.AddEdge(newForkVertex, forkVertex);
                     VERTEX_ON_PATH(READPOS, newForkVertex);
                     forkVertex = newForkVertex;
                     i--;
@@ -261,11 +255,11 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
             VERTEX_ON_PATH(READPOS, u);
             // if there is an extant forkVertex, join it
             if (forkVertex != null_vertex) {
-                add_edge(u, forkVertex, g_);
+                g_.AddEdge(u, forkVertex);
                 forkVertex = null_vertex;
             }
             // add to existing node
-            curNodeInfo.Reads++;
+            vertexInfo_[u].Reads++;
             i--;
         } else if (reachingMove == DeleteMove) {
             if (forkVertex == null_vertex) {
@@ -277,7 +271,7 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
             if (forkVertex == null_vertex) {
                 forkVertex = v;
             }
-            add_edge(newForkVertex, forkVertex, g_);
+            g_.AddEdge(newForkVertex, forkVertex);
             VERTEX_ON_PATH(READPOS, newForkVertex);
             forkVertex = newForkVertex;
             i--;
@@ -287,16 +281,17 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
 
         v = u;
         u = prevVertex;
-        span = curNodeInfo.SpanningReads;
+        span = vertexInfo_[v].SpanningReads;
     }
     startSpanVertex = v;
 
     // if there is an extant forkVertex, join it to enterVertex
     if (forkVertex != null_vertex) {
-        add_edge(enterVertex_, forkVertex, g_);
+        g_.AddEdge(enterVertex_, forkVertex);
         startSpanVertex = forkVertex;
         forkVertex = null_vertex;
     }
+    g_.Update();
 
     if (startSpanVertex != exitVertex_) {
         tagSpan(startSpanVertex, endSpanVertex);
@@ -310,22 +305,9 @@ void PoaGraphImpl::tracebackAndThread(std::string sequence,
 #undef VERTEX_ON_PATH
 }
 
-static boost::unordered_set<VD> childVertices(VD v, const BoostGraph& g)
+static bool hasVertex(const VertexRange& vertices, VD v)
 {
-    boost::unordered_set<VD> result;
-    BOOST_FOREACH (const ED& e, out_edges(v, g)) {
-        result.insert(target(e, g));
-    }
-    return result;
-}
-
-static boost::unordered_set<VD> parentVertices(VD v, const BoostGraph& g)
-{
-    boost::unordered_set<VD> result;
-    BOOST_FOREACH (const ED& e, in_edges(v, g)) {
-        result.insert(source(e, g));
-    }
-    return result;
+    return std::binary_search(vertices.begin(), vertices.end(), v);
 }
 
 vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
@@ -339,13 +321,13 @@ vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
     for (int i = 2; i < (int)bestPath_.size() - 2; i++)  // NOLINT
     {
         VD v = bestPath_[i];
-        boost::unordered_set<VD> children = childVertices(v, g_);
+        const VertexRange children = g_.Successors(v);
 
         // Look for a direct edge from the current node to the node
         // two spaces down---suggesting a deletion with respect to
         // the consensus sequence.
-        if (children.find(bestPath_[i + 2]) != children.end()) {
-            float score = -vertexInfoMap_[bestPath_[i + 1]].Score;
+        if (hasVertex(children, bestPath_[i + 2])) {
+            float score = -vertexInfo_[bestPath_[i + 1]].Score;
             variants->push_back(Mutation::Deletion(i + 1, 1).WithScore(score));
         }
 
@@ -353,7 +335,7 @@ vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
         // This indicates we should try inserting the base at i + 1.
 
         // Parents of (i + 1)
-        boost::unordered_set<VD> lookBack = parentVertices(bestPath_[i + 1], g_);
+        VertexRange lookBack = g_.Predecessors(bestPath_[i + 1]);
 
         // (We could do this in STL using std::set sorted on score, which would
         // then
@@ -364,21 +346,19 @@ vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
         VD bestInsertVertex = null_vertex;
 
         for (const VD v : children) {
-            boost::unordered_set<VD>::iterator found = lookBack.find(v);
-            if (found != lookBack.end()) {
-                float score = vertexInfoMap_[*found].Score;
+            if (hasVertex(lookBack, v)) {
+                float score = vertexInfo_[v].Score;
                 if (score > bestInsertScore) {
                     bestInsertScore = score;
-                    bestInsertVertex = *found;
+                    bestInsertVertex = v;
                 } else if (score == bestInsertScore) {
-                    if (get(vertex_index, g_, *found) < get(vertex_index, g_, bestInsertVertex))
-                        bestInsertVertex = *found;
+                    if (v < bestInsertVertex) bestInsertVertex = v;
                 }
             }
         }
 
         if (bestInsertVertex != null_vertex) {
-            char base = vertexInfoMap_[bestInsertVertex].Base;
+            char base = vertexInfo_[bestInsertVertex].Base;
             variants->push_back(Mutation::Insertion(i + 1, base).WithScore(bestInsertScore));
         }
 
@@ -386,7 +366,7 @@ vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
         // to i + 2.  This indicates we should try mismatching the base i + 1.
 
         // Parents of (i + 2)
-        lookBack = parentVertices(bestPath_[i + 2], g_);
+        lookBack = g_.Predecessors(bestPath_[i + 2]);
 
         float bestMismatchScore = -FLT_MAX;
         VD bestMismatchVertex = null_vertex;
@@ -394,15 +374,13 @@ vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
         for (const VD v : children) {
             if (v == bestPath_[i + 1]) continue;
 
-            boost::unordered_set<VD>::iterator found = lookBack.find(v);
-            if (found != lookBack.end()) {
-                float score = vertexInfoMap_[*found].Score;
+            if (hasVertex(lookBack, v)) {
+                float score = vertexInfo_[v].Score;
                 if (score > bestMismatchScore) {
                     bestMismatchScore = score;
-                    bestMismatchVertex = *found;
+                    bestMismatchVertex = v;
                 } else if (score == bestMismatchScore) {
-                    if (get(vertex_index, g_, *found) < get(vertex_index, g_, bestMismatchVertex))
-                        bestMismatchVertex = *found;
+                    if (v < bestMismatchVertex) bestMismatchVertex = v;
                 }
             }
         }
@@ -412,7 +390,7 @@ vector<PacBio::Consensus::ScoredMutation>* PoaGraphImpl::findPossibleVariants(
             // the score of the mismatch node. I think it should return the
             // score
             // difference, no?
-            char base = vertexInfoMap_[bestMismatchVertex].Base;
+            char base = vertexInfo_[bestMismatchVertex].Base;
             variants->push_back(Mutation::Substitution(i + 1, base).WithScore(bestMismatchScore));
         }
     }
@@ -6,8 +6,6 @@
 #include <utility>
 #include <vector>
 
-#include <boost/foreach.hpp>
-#include <boost/graph/topological_sort.hpp>
 #include <boost/optional.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 
@@ -121,14 +119,13 @@ void SdpRangeFinder::InitRangeFinder(const PoaGraphImpl& poaGraph,
     std::cout << "RawAnchors length: " << anchors.size() << std::endl;
 #endif
 
-    std::map<VD, optional<Interval>> directRanges;
-    std::map<VD, Interval> fwdMarks, revMarks;
+    // indexed by vertex
+    const size_t numIds = poaGraph.g_.NumIds();
+    std::vector<optional<Interval>> directRanges(numIds);
+    std::vector<Interval> fwdMarks(numIds, emptyInterval), revMarks(numIds, emptyInterval);
+    alignableReadIntervalByVertex_.assign(numIds, emptyInterval);
 
-    std::vector<VD> sortedVertices(num_vertices(poaGraph.g_));
-    topological_sort(poaGraph.g_, sortedVertices.rbegin());
-    for (const VD v : sortedVertices) {
-        directRanges[v] = boost::none;
-    }
+    const std::vector<VD>& sortedVertices = poaGraph.g_.TopologicalOrder();
 
     // Find the "direct ranges" implied by the anchors between the
     // css and this read.  Possibly null.
@@ -151,40 +148,28 @@ void SdpRangeFinder::InitRangeFinder(const PoaGraphImpl& poaGraph,
     // letting a node with null direct range have a range that is the
     // union of the "forward stepped" ranges of its predecessors
     for (const VD v : sortedVertices) {
-        Vertex vExt = poaGraph.externalize(v);  // DEBUGGING
-
-        optional<Interval> directRange = directRanges.at(v);
+        const optional<Interval>& directRange = directRanges[v];
         if (directRange) {
             fwdMarks[v] = directRange.get();
         } else {
-            std::vector<Interval> predRangesStepped;
-            for (const ED& e : inEdges(v, poaGraph.g_)) {
-                VD pred = source(e, poaGraph.g_);
-                Vertex predExt = poaGraph.externalize(pred);  // DEBUGGING
-                Interval predRangeStepped = next(fwdMarks.at(pred), readLength);
-                predRangesStepped.push_back(predRangeStepped);
+            Interval fwdInterval = emptyInterval;
+            for (const VD pred : poaGraph.g_.Predecessors(v)) {
+                fwdInterval = RangeUnion(fwdInterval, next(fwdMarks[pred], readLength));
             }
-            Interval fwdInterval = RangeUnion(predRangesStepped);
             fwdMarks[v] = fwdInterval;
         }
     }
 
     // Do the same thing, but as a backwards recursion
     for (const VD v : boost::adaptors::reverse(sortedVertices)) {
-        Vertex vExt = poaGraph.externalize(v);  // DEBUGGING
-
-        optional<Interval> directRange = directRanges.at(v);
+        const optional<Interval>& directRange = directRanges[v];
         if (directRange) {
             revMarks[v] = directRange.get();
         } else {
-            std::vector<Interval> succRangesStepped;
-            BOOST_FOREACH (const ED& e, out_edges(v, poaGraph.g_)) {
-                VD succ = target(e, poaGraph.g_);
-                Vertex succExt = poaGraph.externalize(succ);  // DEBUGGING
-                Interval succRangeStepped = prev(revMarks.at(succ), 0);
-                succRangesStepped.push_back(succRangeStepped);
+            Interval revInterval = emptyInterval;
+            for (const VD succ : poaGraph.g_.Successors(v)) {
+                revInterval = RangeUnion(revInterval, prev(revMarks[succ], 0));
             }
-            Interval revInterval = RangeUnion(succRangesStepped);
             revMarks[v] = revInterval;
         }
     }
@@ -192,7 +177,7 @@ void SdpRangeFinder::InitRangeFinder(const PoaGraphImpl& poaGraph,
     // take hulls of extents from forward and reverse recursions
     for (const VD v : sortedVertices) {
         Vertex vExt = poaGraph.externalize(v);
-        alignableReadIntervalByVertex_[vExt] = RangeUnion(fwdMarks.at(v), revMarks.at(v));
+        alignableReadIntervalByVertex_[vExt] = RangeUnion(fwdMarks[v], revMarks[v]);
 #if DEBUG_RANGE_FINDER
         cout << vExt << "\t";
         if (anchorByVertex.find(vExt) != anchorByVertex.end()) {
@@ -4,7 +4,6 @@
 
 #include <algorithm>
 #include <cassert>
-#include <vector>
 
 namespace PacBio {
 namespace Poa {
@@ -27,18 +26,22 @@ size_t ArgMax(const VectorL<T>& v);
 // without
 //  cleaning it up/refactoring it quite a bit)
 //
+// The rows live in storage owned by someone else, so that many VectorLs can
+// share one buffer.
+//
 template <typename T>
 class VectorL
 {
 private:
-    std::vector<T> storage_;
+    T* storage_;
     size_t beginRow_;
     size_t endRow_;
 
 public:
-    VectorL(int beginRow, int endRow, T defaultVal = T())
-        : storage_(endRow - beginRow, defaultVal), beginRow_(beginRow), endRow_(endRow)
+    VectorL(T* storage, int beginRow, int endRow, T defaultVal = T())
+        : storage_(storage), beginRow_(beginRow), endRow_(endRow)
     {
+        std::fill(storage_, storage_ + (endRow_ - beginRow_), defaultVal);
     }
 
     T& operator[](size_t pos)
@@ -65,14 +68,14 @@ using std::distance;
 template <typename T>
 T Max(const VectorL<T>& v)
 {
-    return *max_element(v.storage_.begin(), v.storage_.end());
+    return *max_element(v.storage_, v.storage_ + (v.endRow_ - v.beginRow_));
 }
 
 template <typename T>
 size_t ArgMax(const VectorL<T>& v)
 {
     return v.beginRow_ +
-           distance(v.storage_.begin(), max_element(v.storage_.begin(), v.storage_.end()));
+           distance(v.storage_, max_element(v.storage_, v.storage_ + (v.endRow_ - v.beginRow_)));
 }
 
 }  // namespace detail
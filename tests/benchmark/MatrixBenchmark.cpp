@@ -0,0 +1,103 @@
+// Micro-benchmark for the banded DP matrix storage.
+//
+// Fills SparseMatrix and BandedMatrix with a drifting diagonal band, reading
+// the three neighboring cells for every cell written like the recursors do,
+// and repeatedly resets and refills them as happens for every ZMW and every
+// template change. Reports wall time and heap allocations per fill.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+#include "../src/matrix/BandedMatrix.h"
+#include "../src/matrix/SparseMatrix.h"
+
+namespace {
+
+std::atomic<size_t> nAllocs{0};
+
+}  // namespace anonymous
+
+void* operator new(size_t size)
+{
+    ++nAllocs;
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+using namespace PacBio::Consensus;  // NOLINT
+
+namespace {
+
+template <typename M>
+double Fill(M& mat, std::mt19937& gen, const size_t bandWidth)
+{
+    const size_t I = mat.Rows();
+    const size_t J = mat.Columns();
+    std::uniform_int_distribution<int> jitter(-2, 2);
+
+    double sum = 0.0;
+    size_t center = 0;
+    for (size_t j = 0; j < J; ++j) {
+        center = std::min(I - 1, static_cast<size_t>(
+                                     std::max<int>(0, static_cast<int>(j * I / J) + jitter(gen))));
+        const size_t begin = center > bandWidth / 2 ? center - bandWidth / 2 : 0;
+        const size_t end = std::min(begin + bandWidth, I);
+        mat.StartEditingColumn(j, begin, end);
+        for (size_t i = begin; i < end; ++i) {
+            double v = 1.0;
+            if (i > 0 && j > 0) v += mat(i - 1, j - 1);
+            if (i > 0) v += mat(i - 1, j);
+            if (j > 0) v += mat(i, j - 1);
+            mat.Set(i, j, v * 0.25);
+        }
+        mat.FinishEditingColumn(j, begin, end);
+        sum += mat(center, j);
+    }
+    return sum;
+}
+
+template <typename M>
+void Run(const std::string& name, const size_t I, const size_t J, const size_t bandWidth,
+         const size_t nFills)
+{
+    std::mt19937 gen(42);
+    M mat(I, J);
+    double sum = 0.0;
+
+    const size_t allocsBefore = nAllocs.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t n = 0; n < nFills; ++n) {
+        mat.Reset(I, J);
+        sum += Fill(mat, gen, bandWidth);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    const size_t allocs = nAllocs.load() - allocsBefore;
+
+    const double secs = std::chrono::duration<double>(stop - start).count();
+    std::printf("%-14s %6zu x %-6zu band %-4zu %10.3f ms/fill %12.1f allocs/fill (checksum %g)\n",
+                name.c_str(), I, J, bandWidth, 1e3 * secs / nFills,
+                static_cast<double>(allocs) / nFills, sum);
+}
+
+}  // namespace anonymous
+
+int main(int argc, char* argv[])
+{
+    const size_t nFills = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 50;
+
+    for (const size_t len : {1000, 10000}) {
+        for (const size_t bandWidth : {16, 32, 64}) {
+            Run<SparseMatrix>("SparseMatrix", len + 1, len + 1, bandWidth, nFills);
+            Run<BandedMatrix>("BandedMatrix", len + 1, len + 1, bandWidth, nFills);
+        }
+    }
+    return 0;
+}
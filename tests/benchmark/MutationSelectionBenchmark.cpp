@@ -0,0 +1,103 @@
+// Benchmark for picking the mutations to apply in a polishing round.
+//
+// Generates synthetic sets of favorable scored mutations over a template,
+// as found in early rounds of polishing a poor draft, and times the greedy
+// selection of well-separated mutations by BestMutations against the
+// quadratic list scan it replaced.
+//
+// Usage: bench_MutationSelectionBenchmark [separation [max. candidates to scan]]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <list>
+#include <random>
+#include <vector>
+
+#include <pacbio/consensus/Mutation.h>
+
+#include "../src/MutationSelector.h"
+
+using namespace PacBio::Consensus;  // NOLINT
+
+namespace {
+
+std::vector<Mutation> ScanBestMutations(std::list<ScoredMutation> scoredMuts,
+                                        const size_t separation)
+{
+    std::vector<Mutation> result;
+    while (!scoredMuts.empty()) {
+        const auto& mut =
+            *std::max_element(scoredMuts.begin(), scoredMuts.end(), ScoredMutation::ScoreComparer);
+        result.emplace_back(mut);
+
+        const size_t start = (separation < mut.Start()) ? mut.Start() - separation : 0;
+        const size_t end = mut.End() + separation;
+        scoredMuts.remove_if(
+            [start, end](const ScoredMutation& m) { return start <= m.End() && m.Start() < end; });
+    }
+    return result;
+}
+
+// n candidates spread over a template with one candidate every 5 bases
+std::vector<ScoredMutation> Candidates(const size_t n, std::mt19937* const gen)
+{
+    std::uniform_int_distribution<size_t> pos(0, 5 * n);
+    std::uniform_int_distribution<int> type(0, 2);
+    std::uniform_real_distribution<double> score(0.0, 100.0);
+
+    std::vector<ScoredMutation> result;
+    result.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const size_t start = pos(*gen);
+        const int t = type(*gen);
+        const auto mut = (t == 0) ? Mutation::Deletion(start, 1)
+                                  : (t == 1) ? Mutation::Insertion(start, 'A')
+                                             : Mutation::Substitution(start, 'C');
+        result.emplace_back(mut.WithScore(score(*gen)));
+    }
+    return result;
+}
+
+template <typename F>
+double Seconds(F&& f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+}  // namespace anonymous
+
+int main(int argc, char* argv[])
+{
+    const size_t separation = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 10;
+    const size_t maxScan = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 10000;
+
+    std::mt19937 gen(42);
+    for (const size_t n : {100, 1000, 10000, 100000}) {
+        const auto scoredMuts = Candidates(n, &gen);
+
+        std::vector<Mutation> best;
+        const double secs = Seconds([&]() { best = BestMutations(scoredMuts, separation); });
+        std::printf("BestMutations      %-7zu candidates %10.3f ms %7zu selected\n", n, 1e3 * secs,
+                    best.size());
+
+        if (n > maxScan) continue;
+        std::vector<Mutation> scanned;
+        const double scanSecs = Seconds([&]() {
+            scanned = ScanBestMutations(
+                std::list<ScoredMutation>(scoredMuts.cbegin(), scoredMuts.cend()), separation);
+        });
+        const bool same = std::equal(best.cbegin(), best.cend(), scanned.cbegin(), scanned.cend(),
+                                     [](const Mutation& lhs, const Mutation& rhs) {
+                                         return lhs.Start() == rhs.Start() &&
+                                                lhs.End() == rhs.End() && lhs.Type() == rhs.Type();
+                                     });
+        std::printf("ScanBestMutations  %-7zu candidates %10.3f ms %7zu selected%s\n", n,
+                    1e3 * scanSecs, scanned.size(), same ? "" : " (MISMATCH)");
+    }
+    return 0;
+}
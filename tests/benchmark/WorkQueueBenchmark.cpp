@@ -0,0 +1,66 @@
+// Contention benchmark for the ccs/gcpp work queues.
+//
+// Pushes many short tasks through WorkQueue and WorkStealingQueue, with a
+// single producer and a single in-order consumer like ccs and gcpp do, and
+// reports the task throughput for a range of thread counts and task sizes.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+
+#include <pacbio/parallel/WorkQueue.h>
+#include <pacbio/parallel/WorkStealingQueue.h>
+
+using namespace PacBio::Parallel;  // NOLINT
+
+namespace {
+
+size_t Task(const size_t seed, const size_t work)
+{
+    size_t x = seed;
+    for (size_t i = 0; i < work; ++i)
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    return x;
+}
+
+template <template <typename> class Q>
+void Run(const std::string& name, const size_t nThreads, const size_t nTasks, const size_t work)
+{
+    const auto start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    {
+        Q<size_t> queue(nThreads);
+        std::future<void> consumer = std::async(std::launch::async, [&queue, &checksum]() {
+            while (queue.ConsumeWith([&checksum](size_t x) { checksum ^= x; }))
+                ;
+        });
+        for (size_t i = 0; i < nTasks; ++i)
+            queue.ProduceWith(Task, i, work);
+        queue.Finalize();
+        consumer.get();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double secs = std::chrono::duration<double>(stop - start).count();
+    std::printf("%-18s threads %-3zu work %-6zu %12.0f tasks/s (checksum %zx)\n", name.c_str(),
+                nThreads, work, nTasks / secs, checksum);
+}
+
+}  // namespace anonymous
+
+int main(int argc, char* argv[])
+{
+    const size_t nTasks = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    const size_t maxThreads = std::max(2U, std::thread::hardware_concurrency());
+
+    for (const size_t work : {0, 1000, 10000}) {
+        for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+            Run<WorkQueue>("WorkQueue", nThreads, nTasks, work);
+            Run<WorkStealingQueue>("WorkStealingQueue", nThreads, nTasks, work);
+        }
+    }
+    return 0;
+}
@@ -54,6 +54,42 @@ TEST(ChimeraLabeler, MinimalEndToEnd)
     EXPECT_GT(labels[3].score, 1.0);
 }
 
+TEST(ChimeraLabeler, ShortlistAndThreadsMatchExhaustive)
+{
+    using namespace seqan;
+
+    SeqFileIn inputHandle(FILENAME2.c_str());
+
+    StringSet<CharString> ids;
+    StringSet<Dna5String> seqs;
+    readRecords(ids, seqs, inputHandle);
+
+    std::vector<std::string> idList;
+    std::vector<std::string> seqList;
+
+    for (size_t i = 0; i < length(ids); ++i) {
+        idList.emplace_back(toCString(static_cast<CharString>(ids[i])));
+        seqList.emplace_back(toCString(static_cast<CharString>(seqs[i])));
+    }
+
+    // Align each chunk to all possible parents on a single thread, ...
+    ChimeraLabeler exhaustive(1.0, 100, false, 0, 1);
+    const auto expected = exhaustive.LabelChimeras(idList, seqList);
+
+    // ... or only to the two parents sharing the most k-mers, on several threads
+    ChimeraLabeler shortlisted(1.0, 100, false, 2, 4);
+    const auto labels = shortlisted.LabelChimeras(idList, seqList);
+
+    ASSERT_EQ(expected.size(), labels.size());
+    for (size_t i = 0; i < labels.size(); ++i) {
+        EXPECT_EQ(expected[i].chimeraFlag, labels[i].chimeraFlag);
+        EXPECT_EQ(expected[i].leftParentId, labels[i].leftParentId);
+        EXPECT_EQ(expected[i].rightParentId, labels[i].rightParentId);
+        EXPECT_EQ(expected[i].crossover, labels[i].crossover);
+        EXPECT_DOUBLE_EQ(expected[i].score, labels[i].score);
+    }
+}
+
 #if EXTENSIVE_TESTING
 TEST(ChimeraLabeler, ExtensiveEndToEnd)
 {
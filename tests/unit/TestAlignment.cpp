@@ -1,5 +1,11 @@
 // Authors: David Alexander, Lance Hepler
 
+#include <memory>
+#include <random>
+#include <string>
+
+#include <boost/algorithm/string.hpp>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -9,6 +15,8 @@
 #include <pacbio/align/LocalAlignment.h>
 #include <pacbio/align/PairwiseAlignment.h>
 
+#include "RandomDNA.h"
+
 // fwd declarations
 namespace PacBio {
 namespace Align {
@@ -23,6 +31,7 @@ bool Rewrite3R(std::string* target, std::string* query, std::string* transcript,
 
 using namespace PacBio::Align;  // NOLINT
 using ::testing::ElementsAreArray;
+using boost::algorithm::erase_all_copy;
 
 TEST(PairwiseAlignmentTests, RepresentationTests)
 {
@@ -69,6 +78,40 @@ TEST(PairwiseAlignmentTests, GlobalAlignmentTests)
     delete a;
 }
 
+TEST(PairwiseAlignmentTests, BandedAlignmentTests)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> edit(0, 19);
+
+    for (size_t n = 0; n < 20; ++n) {
+        const std::string target = RandomDNA(200 + 10 * n, &gen);
+
+        // ~15% errors, and a 30 base deletion in every other query
+        std::string query;
+        for (size_t j = 0; j < target.size(); ++j) {
+            if (n % 2 == 1 && j >= 50 && j < 80) continue;
+            const size_t e = edit(gen);
+            if (e == 0) continue;
+            if (e == 1) query.push_back('A');
+            query.push_back(e == 2 ? 'C' : target[j]);
+        }
+
+        int score;
+        const std::unique_ptr<PairwiseAlignment> full(Align(target, query, &score));
+
+        for (const int bandWidth : {1, 4, 16, 64}) {
+            const AlignConfig config(AlignParams::Default(), AlignMode::GLOBAL, bandWidth);
+            int bandedScore;
+            const std::unique_ptr<PairwiseAlignment> banded(
+                Align(target, query, &bandedScore, config));
+            EXPECT_EQ(score, bandedScore);
+            EXPECT_EQ(full->Errors(), banded->Errors());
+            EXPECT_EQ(target, erase_all_copy(banded->Target(), "-"));
+            EXPECT_EQ(query, erase_all_copy(banded->Query(), "-"));
+        }
+    }
+}
+
 TEST(PairwiseAlignmentTests, TargetPositionsInQueryTest)
 {
     // MMM -> 0123
@@ -538,6 +581,13 @@ TEST(AffineAlignmentTests, LargeGapTest)
     PairwiseAlignment* a = AlignAffine(target, query);
     ASSERT_EQ(expectedAlignedTarget, a->Target());
     delete a;
+
+    // the gap is far outside a narrow band, which has to be widened
+    AffineAlignmentParams params = DefaultAffineAlignmentParams();
+    params.BandWidth = 8;
+    a = AlignAffine(target, query, params);
+    ASSERT_EQ(expectedAlignedTarget, a->Target());
+    delete a;
 }
 
 // ------------------ IUPAC-aware alignment tests ---------------------
@@ -685,6 +735,63 @@ TEST(LocalAlignmentTests, Simple)
     EXPECT_EQ(21, a.Score());
 }
 
+TEST(LocalAlignmentTests, ReusedAlignerMatchesLocalAlign)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> edit(0, 9);
+
+    const std::string query = RandomDNA(100, &gen);
+    LocalAligner aligner(query);
+
+    std::vector<std::string> targets;
+    for (size_t n = 0; n < 20; ++n) {
+        // ~20% errors, an N, and random flanks of the query
+        std::string target = RandomDNA(5 * n, &gen);
+        for (size_t j = 0; j < query.size(); ++j) {
+            const size_t e = edit(gen);
+            if (e == 0) continue;
+            if (e == 1) target.push_back('T');
+            target.push_back(e == 2 ? 'N' : query[j]);
+        }
+        target += RandomDNA(50 - 2 * n, &gen);
+        targets.push_back(target);
+    }
+    targets.push_back(RandomDNA(40, &gen));   // unrelated
+    targets.push_back(query.substr(30, 10));  // shorter than the query
+
+    const auto alignments = aligner.Align(targets);
+    const auto scores = aligner.Score(targets);
+    ASSERT_EQ(targets.size(), alignments.size());
+    ASSERT_EQ(targets.size(), scores.size());
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        const auto expected = LocalAlign(targets[i], query);
+        const auto& a = alignments[i];
+        EXPECT_EQ(expected.TargetBegin(), a.TargetBegin());
+        EXPECT_EQ(expected.TargetEnd(), a.TargetEnd());
+        EXPECT_EQ(expected.QueryBegin(), a.QueryBegin());
+        EXPECT_EQ(expected.QueryEnd(), a.QueryEnd());
+        EXPECT_EQ(expected.NumMismatches(), a.NumMismatches());
+        EXPECT_EQ(expected.Score(), a.Score());
+        EXPECT_EQ(expected.Cigar(), a.Cigar());
+        EXPECT_EQ(expected.CigarString(), a.CigarString());
+        EXPECT_EQ(expected.Score(), scores[i]);
+    }
+}
+
+TEST(LocalAlignmentTests, ReusedAlignerEdgeCases)
+{
+    EXPECT_THROW(LocalAligner(""), std::invalid_argument);
+
+    LocalAligner aligner("CTGAGCCGGTAAATC");
+    EXPECT_EQ(0, aligner.Score(""));
+    EXPECT_EQ(0, aligner.Align("").Score());
+    EXPECT_EQ(21, aligner.Score("CAGCCTTTCTGACCCGGAAATCAAAATAGGCACAACAAA"));
+
+    LocalAligner moved(std::move(aligner));
+    EXPECT_EQ(21, moved.Align("CAGCCTTTCTGACCCGGAAATCAAAATAGGCACAACAAA").Score());
+}
+
 // --------------- Semi-Global alignment tests ------------------
 
 TEST(SemiGlobalAlignmentTests, Simple)
@@ -2,8 +2,16 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <random>
+#include <string>
+
+#include <pacbio/consensus/ModelConfig.h>
 #include <pacbio/data/internal/BaseEncoding.h>
 
+#include "../src/ModelFactory.h"
+#include "../src/models/HelperFunctions.h"
+
 using namespace PacBio::Data::detail;
 
 TEST(AmbiguousBasesTest, TestNCBI2naValid)
@@ -491,3 +499,103 @@ TEST(AmbiguousBasesTest, TestAmbiguousBaseContainsPureBase)
     EXPECT_EQ(ambiguousBaseContainsPureBase(testBaseK, testBaseG), true);
     EXPECT_EQ(ambiguousBaseContainsPureBase(testBaseK, testBaseT), true);
 }
+
+namespace {
+
+using namespace PacBio::Consensus;  // NOLINT
+
+// calls f(p, c) for all haploid contexts contained in (prev, curr)
+template <typename Callable>
+void ForContainedContexts(const NCBI4na prev, const NCBI4na curr, Callable f)
+{
+    for (uint8_t p = 0; p < 4; ++p)
+        for (uint8_t c = 0; c < 4; ++c)
+            if (prev.Contains(NCBI2na::FromRaw(p)) && curr.Contains(NCBI2na::FromRaw(c)))
+                f(NCBI2na::FromRaw(p).GetNCBI4na(), NCBI2na::FromRaw(c).GetNCBI4na());
+}
+
+template <size_t EmissionContextNumber, size_t EmissionOutcomeNumber>
+void CheckAlleleEmissionTable()
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    double emissionPmf[3][EmissionContextNumber][EmissionOutcomeNumber];
+    for (auto& move : emissionPmf)
+        for (auto& ctx : move)
+            for (double& pr : ctx)
+                pr = dist(gen);
+
+    const auto table = MakeAlleleEmissionTable(emissionPmf);
+
+    for (const MoveType move : {MoveType::MATCH, MoveType::BRANCH, MoveType::STICK}) {
+        for (uint8_t p = 1; p < 16; ++p) {
+            const auto prev = NCBI4na::FromRaw(p);
+            for (uint8_t c = 1; c < 16; ++c) {
+                const auto curr = NCBI4na::FromRaw(c);
+                for (uint8_t e = 0; e < EmissionNumber(EmissionOutcomeNumber); ++e) {
+                    if (prev.IsPure() && curr.IsPure()) {
+                        EXPECT_EQ(EmissionTableLookup(emissionPmf, move, e, prev.GetNCBI2na(),
+                                                      curr.GetNCBI2na()),
+                                  table(move, e, prev, curr));
+                        continue;
+                    }
+
+                    // ambiguous contexts are the mean of their haploid contexts
+                    double sum = 0.0;
+                    size_t n = 0;
+                    ForContainedContexts(prev, curr, [&](const NCBI4na pp, const NCBI4na cc) {
+                        sum += table(move, e, pp, cc);
+                        ++n;
+                    });
+                    EXPECT_DOUBLE_EQ(sum / n, table(move, e, prev, curr));
+                }
+            }
+        }
+    }
+}
+
+}  // namespace anonymous
+
+TEST(AmbiguousBasesTest, AlleleEmissionTables)
+{
+    CheckAlleleEmissionTable<1, 2>();
+    CheckAlleleEmissionTable<8, 4>();
+    CheckAlleleEmissionTable<16, 12>();
+}
+
+TEST(AmbiguousBasesTest, AlleleExpectationTables)
+{
+    const SNR snr(10, 7, 5, 11);
+
+    for (const std::string& name : ModelFactory::SupportedModels()) {
+        SCOPED_TRACE(name);
+        const auto model = ModelFactory::Create(name, snr);
+
+        for (const MoveType move : {MoveType::MATCH, MoveType::BRANCH, MoveType::STICK}) {
+            for (const MomentType moment : {MomentType::FIRST, MomentType::SECOND}) {
+                for (uint8_t p = 1; p < 16; ++p) {
+                    const auto prev = NCBI4na::FromRaw(p);
+                    for (uint8_t c = 1; c < 16; ++c) {
+                        const auto curr = NCBI4na::FromRaw(c);
+                        if (prev.IsPure() && curr.IsPure()) continue;
+
+                        double sum = 0.0;
+                        size_t n = 0;
+                        ForContainedContexts(prev, curr, [&](const NCBI4na pp, const NCBI4na cc) {
+                            sum += model->ExpectedLLForEmission(move, pp, cc, moment);
+                            ++n;
+                        });
+                        const double expected = sum / n;
+                        const double actual =
+                            model->ExpectedLLForEmission(move, prev, curr, moment);
+                        if (std::isnan(expected))
+                            EXPECT_TRUE(std::isnan(actual));
+                        else
+                            EXPECT_DOUBLE_EQ(expected, actual);
+                    }
+                }
+            }
+        }
+    }
+}
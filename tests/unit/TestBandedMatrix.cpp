@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "../src/matrix/BandedMatrix.h"
+#include "../src/matrix/SparseMatrix.h"
+
+using namespace PacBio::Consensus;  // NOLINT
+
+namespace BandedMatrixTests {
+
+TEST(BandedMatrixTest, BasicTest)
+{
+    BandedMatrix bm(100, 3);
+    EXPECT_EQ(0, bm.AllocatedEntries());
+
+    bm.StartEditingColumn(1, 10, 20);
+    for (size_t i = 10; i < 20; i++)
+        bm.Set(i, 1, i);
+    bm.FinishEditingColumn(1, 10, 20);
+    EXPECT_LE(10, bm.AllocatedEntries());
+    EXPECT_EQ(10, bm.FilledEntries());
+
+    for (size_t i = 0; i < 100; i++) {
+        EXPECT_EQ(0, bm(i, 0));
+        EXPECT_EQ(0, bm(i, 2));
+        if (i >= 10 && i < 20)
+            EXPECT_EQ(i, bm(i, 1));
+        else
+            EXPECT_EQ(0, bm(i, 1));  // NOLINT
+    }
+
+    // grow the column on both sides while it is being edited
+    bm.StartEditingColumn(1, 10, 20);
+    for (size_t i = 10; i < 20; i++)
+        bm.Set(i, 1, i);
+    bm.Set(50, 1, 50);
+    bm.Set(0, 1, 100);
+    bm.FinishEditingColumn(1, 0, 51);
+    // refills count again
+    EXPECT_EQ(61, bm.FilledEntries());
+    for (size_t i = 0; i < 100; i++) {
+        if (i >= 10 && i < 20)
+            EXPECT_EQ(i, bm(i, 1));
+        else if (i == 50)
+            EXPECT_EQ(i, bm(i, 1));
+        else if (i == 0)
+            EXPECT_EQ(100, bm(i, 1));
+        else
+            EXPECT_EQ(0, bm(i, 1));  // NOLINT
+    }
+
+    bm.ClearColumn(1);
+    EXPECT_TRUE(bm.IsColumnEmpty(1));
+    for (size_t i = 0; i < 100; i++)
+        EXPECT_EQ(0, bm(i, 1));
+}
+
+// Drive a BandedMatrix and a SparseMatrix through the same random edits,
+// including refills with drifting bands that force relocation and compaction.
+void MatchesSparseMatrix(const CellPrecision precision)
+{
+    const size_t rows = 300;
+    const size_t cols = 200;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<size_t> width(0, 40);
+    std::uniform_int_distribution<size_t> shift(0, 20);
+    std::uniform_real_distribution<double> value(0.0, 1.0);
+
+    BandedMatrix bm(rows, cols, precision);
+    SparseMatrix sm(rows, cols);
+    // float cells hold the rounded values
+    const auto stored = [precision](const double v) {
+        return (precision == CellPrecision::FLOAT) ? static_cast<float>(v) : v;
+    };
+
+    for (size_t pass = 0; pass < 5; ++pass) {
+        if (pass == 3) {
+            bm.Reset(rows, cols);
+            sm.Reset(rows, cols);
+        }
+        for (size_t j = 0; j < cols; ++j) {
+            const size_t begin = std::min(j + shift(gen), rows - 1);
+            const size_t end = std::min(begin + width(gen), rows);
+            bm.StartEditingColumn(j, begin, end);
+            sm.StartEditingColumn(j, begin, end);
+            // write a bit beyond the hinted band, as the recursors do
+            const size_t setBegin = begin > 5 ? begin - 5 : 0;
+            const size_t setEnd = std::min(end + 30, rows);
+            // alternately through the typed view of the cells
+            bm.WithCells([&](const auto& cells) {
+                for (size_t i = setBegin; i < setEnd; ++i) {
+                    const double v = value(gen);
+                    if (pass % 2 == 0)
+                        bm.Set(i, j, v);
+                    else
+                        cells.Set(i, j, v);
+                    sm.Set(i, j, stored(v));
+                }
+            });
+            bm.FinishEditingColumn(j, setBegin, setEnd);
+            sm.FinishEditingColumn(j, setBegin, setEnd);
+        }
+
+        EXPECT_EQ(sm.UsedEntries(), bm.UsedEntries());
+        std::vector<double> bmRange(rows), smRange(rows);
+        for (size_t j = 0; j < cols; ++j) {
+            for (size_t i = 0; i < rows; ++i)
+                ASSERT_EQ(sm(i, j), bm(i, j));
+            bm.WithCells([&](const auto& cells) {
+                for (size_t i = 0; i < rows; ++i)
+                    ASSERT_EQ(sm(i, j), cells(i, j));
+            });
+            bm.CopyColumnRange(j, 0, rows, bmRange.data());
+            sm.CopyColumnRange(j, 0, rows, smRange.data());
+            EXPECT_EQ(smRange, bmRange);
+        }
+    }
+
+    const BandedMatrix copy(bm);
+    for (size_t j = 0; j < cols; ++j)
+        for (size_t i = 0; i < rows; ++i)
+            ASSERT_EQ(bm(i, j), copy(i, j));
+}
+
+TEST(BandedMatrixTest, MatchesSparseMatrix) { MatchesSparseMatrix(CellPrecision::DOUBLE); }
+
+TEST(BandedMatrixTest, MatchesSparseMatrixFloat) { MatchesSparseMatrix(CellPrecision::FLOAT); }
+
+TEST(BandedMatrixTest, SetPrecision)
+{
+    BandedMatrix bm(100, 3, CellPrecision::FLOAT);
+    EXPECT_EQ(CellPrecision::FLOAT, bm.Precision());
+    bm.StartEditingColumn(0, 0, 50);
+    bm.Set(10, 0, 0.1);
+    bm.FinishEditingColumn(0, 10, 11);
+    EXPECT_EQ(static_cast<float>(0.1), bm(10, 0));
+
+    // switching the precision clears the matrix but keeps its dimensions
+    bm.SetPrecision(CellPrecision::DOUBLE);
+    EXPECT_EQ(CellPrecision::DOUBLE, bm.Precision());
+    EXPECT_EQ(100, bm.Rows());
+    EXPECT_EQ(3, bm.Columns());
+    EXPECT_TRUE(bm.IsColumnEmpty(0));
+    EXPECT_EQ(0.0, bm(10, 0));
+    bm.StartEditingColumn(0, 0, 50);
+    bm.Set(10, 0, 0.1);
+    bm.FinishEditingColumn(0, 10, 11);
+    EXPECT_EQ(0.1, bm(10, 0));
+}
+
+TEST(BandedMatrixTest, KeepColumns)
+{
+    const size_t rows = 50;
+    BandedMatrix bm(rows, 10);
+    for (size_t j = 0; j < 10; ++j) {
+        bm.StartEditingColumn(j, j, j + 5);
+        for (size_t i = j; i < j + 5; ++i)
+            bm.Set(i, j, 100 * j + i);
+        bm.FinishEditingColumn(j, j, j + 5);
+    }
+
+    // keep 3 leading and 4 trailing columns, as after a 2 base insertion
+    BandedMatrix grown(bm);
+    grown.KeepColumns(12, 3, 4);
+    EXPECT_EQ(12, grown.Columns());
+    for (size_t j = 0; j < 12; ++j) {
+        const size_t old = (j < 3) ? j : j - 2;
+        const bool kept = j < 3 || j >= 8;
+        EXPECT_EQ(!kept, grown.IsColumnEmpty(j));
+        for (size_t i = 0; i < rows; ++i) {
+            if (kept && i >= old && i < old + 5)
+                EXPECT_EQ(100 * old + i, grown(i, j));
+            else
+                EXPECT_EQ(0, grown(i, j));
+        }
+    }
+
+    // refilling the cleared columns reuses the slots of the dropped ones
+    const size_t allocated = bm.AllocatedEntries();
+    bm.KeepColumns(10, 3, 4);
+    for (size_t j = 3; j < 6; ++j) {
+        bm.StartEditingColumn(j, 0, 2);
+        bm.Set(1, j, j);
+        bm.FinishEditingColumn(j, 1, 2);
+    }
+    EXPECT_EQ(allocated, bm.AllocatedEntries());
+    for (size_t j = 3; j < 7; ++j)
+        EXPECT_EQ((j < 6) ? j : 0, bm(1, j));
+}
+
+}  // namespace BandedMatrixTests
@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <pacbio/parallel/ForkJoinPool.h>
+
+#include "../src/matrix/BandedMatrix.h"
+#include "../src/matrix/BufferPool.h"
+
+using namespace PacBio::Consensus;  // NOLINT
+
+namespace BufferPoolTests {
+
+TEST(BufferPoolTest, TakeBestFit)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+
+    for (const size_t n : {100, 10, 1000}) {
+        std::vector<double> buffer;
+        buffer.reserve(n);
+        BufferPool::Give(std::move(buffer));
+    }
+    EXPECT_EQ(3, pool.NumBuffers());
+    EXPECT_EQ(1110 * sizeof(double), pool.RetainedBytes());
+
+    // the smallest buffer that fits
+    std::vector<double> buffer = BufferPool::Take(50);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(100, buffer.capacity());
+    // the largest buffer if none fits
+    buffer = BufferPool::Take(5000);
+    EXPECT_EQ(1000, buffer.capacity());
+    buffer = BufferPool::Take(0);
+    EXPECT_EQ(10, buffer.capacity());
+    // a new buffer once the pool is empty
+    buffer = BufferPool::Take(10);
+    EXPECT_EQ(0, buffer.capacity());
+    EXPECT_EQ(0, pool.RetainedBytes());
+}
+
+TEST(BufferPoolTest, CountsAllocations)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+    const size_t allocations = pool.Allocations();
+
+    // taking from an empty pool allocates nothing yet
+    std::vector<double> buffer = BufferPool::Take(10);
+    EXPECT_EQ(allocations, pool.Allocations());
+    BufferPool::Reserve(&buffer, 10);
+    EXPECT_EQ(allocations + 1, pool.Allocations());
+    BufferPool::Resize(&buffer, 10);
+    EXPECT_EQ(allocations + 1, pool.Allocations());
+    // growing past the capacity does
+    BufferPool::Resize(&buffer, 11);
+    EXPECT_EQ(allocations + 2, pool.Allocations());
+    BufferPool::Give(std::move(buffer));
+
+    // as does a pooled buffer that is too small
+    buffer = BufferPool::Take(100);
+    BufferPool::Reserve(&buffer, 100);
+    EXPECT_EQ(allocations + 3, pool.Allocations());
+    BufferPool::Give(std::move(buffer));
+
+    buffer = BufferPool::Take(50);
+    BufferPool::Reserve(&buffer, 50);
+    EXPECT_EQ(allocations + 3, pool.Allocations());
+    BufferPool::Give(std::move(buffer));
+    pool.Clear();
+}
+
+TEST(BufferPoolTest, RetainsBoundedMemory)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+
+    const size_t n = BufferPool::MAX_RETAINED_BYTES / sizeof(double) / 2;
+    for (size_t i = 0; i < 3; ++i) {
+        std::vector<double> buffer;
+        buffer.reserve(n);
+        BufferPool::Give(std::move(buffer));
+    }
+    EXPECT_EQ(2, pool.NumBuffers());
+    EXPECT_LE(pool.RetainedBytes(), BufferPool::MAX_RETAINED_BYTES);
+    pool.Clear();
+}
+
+TEST(BufferPoolTest, ReleasesBuffersIdleForAJob)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+
+    // a long job
+    {
+        std::vector<std::vector<double>> buffers;
+        for (const size_t n : {10, 100, 1000}) {
+            buffers.emplace_back(BufferPool::Take(n));
+            buffers.back().reserve(n);
+        }
+        EXPECT_EQ(3, pool.NumTaken());
+        for (auto& buffer : buffers)
+            BufferPool::Give(std::move(buffer));
+    }
+    EXPECT_EQ(0, pool.NumTaken());
+    EXPECT_EQ(3, pool.NumBuffers());
+
+    // a short one only keeps what it used
+    std::vector<double> buffer = BufferPool::Take(50);
+    EXPECT_EQ(100, buffer.capacity());
+    EXPECT_EQ(2, pool.NumBuffers());
+    BufferPool::Give(std::move(buffer));
+    EXPECT_EQ(1, pool.NumBuffers());
+    EXPECT_EQ(100 * sizeof(double), pool.RetainedBytes());
+
+    // and a matrix hands back its memory even if it never stored a cell
+    {
+        BandedMatrix bm(10, 10);
+        bm.StartEditingColumn(0, 0, 0);
+        bm.FinishEditingColumn(0, 0, 0);
+        EXPECT_EQ(1, pool.NumTaken());
+    }
+    EXPECT_EQ(0, pool.NumTaken());
+    EXPECT_EQ(1, pool.NumBuffers());
+    pool.Clear();
+}
+
+TEST(BufferPoolTest, MatricesReuseMemory)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+
+    size_t allocated;
+    {
+        BandedMatrix bm(1000, 1000);
+        for (size_t j = 0; j < 1000; ++j) {
+            bm.StartEditingColumn(j, j / 2, j / 2 + 20);
+            bm.FinishEditingColumn(j, j / 2, j / 2 + 20);
+        }
+        allocated = bm.AllocatedEntries();
+    }
+    EXPECT_EQ(1, pool.NumBuffers());
+    const size_t allocations = pool.Allocations();
+
+    // a new matrix continues with the memory of the old one
+    BandedMatrix bm(1000, 1000);
+    EXPECT_EQ(0, bm.AllocatedEntries());
+    bm.StartEditingColumn(0, 0, 20);
+    bm.FinishEditingColumn(0, 0, 20);
+    EXPECT_EQ(allocated, bm.AllocatedEntries());
+    EXPECT_EQ(0, pool.NumBuffers());
+    EXPECT_EQ(allocations, pool.Allocations());
+
+    // but not with the one of another thread
+    std::thread([allocated]() {
+        BandedMatrix other(1000, 1000);
+        other.StartEditingColumn(0, 0, 20);
+        other.FinishEditingColumn(0, 0, 20);
+        EXPECT_GT(allocated, other.AllocatedEntries());
+    }).join();
+}
+
+TEST(BufferPoolTest, MatricesFilledOnHelpersKeepTheCountBalanced)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+
+    std::vector<std::unique_ptr<BandedMatrix>> matrices;
+    for (size_t i = 0; i < 16; ++i)
+        matrices.emplace_back(std::make_unique<BandedMatrix>(100, 100));
+
+    PacBio::Parallel::ForkJoinPool& helpers = PacBio::Parallel::ForkJoinPool::ThreadLocal();
+    std::atomic_size_t next{0};
+    helpers.Run(4, [&]() {
+        for (size_t i; (i = next++) < matrices.size();) {
+            matrices[i]->StartEditingColumn(0, 0, 20);
+            matrices[i]->FinishEditingColumn(0, 0, 20);
+        }
+    });
+
+    // the helpers took nothing from their own pools
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic_size_t helpersTaken{0};
+    helpers.Run(4, [&]() {
+        if (std::this_thread::get_id() != caller)
+            helpersTaken += BufferPool::ThreadLocal().NumTaken();
+    });
+    EXPECT_EQ(0, helpersTaken.load());
+    EXPECT_LE(pool.NumTaken(), matrices.size());
+
+    matrices.clear();
+    EXPECT_EQ(0, pool.NumTaken());
+    pool.Clear();
+}
+
+TEST(BufferPoolTest, CopiedMatricesGiveBackNothing)
+{
+    BufferPool& pool = BufferPool::ThreadLocal();
+    pool.Clear();
+
+    {
+        BandedMatrix bm(100, 100);
+        bm.StartEditingColumn(0, 0, 20);
+        bm.FinishEditingColumn(0, 0, 20);
+        EXPECT_EQ(1, pool.NumTaken());
+        {
+            BandedMatrix copy(bm);
+            EXPECT_EQ(1, pool.NumTaken());
+        }
+        EXPECT_EQ(1, pool.NumTaken());
+        EXPECT_EQ(0, pool.NumBuffers());
+    }
+    EXPECT_EQ(0, pool.NumTaken());
+    EXPECT_EQ(1, pool.NumBuffers());
+    pool.Clear();
+}
+
+}  // namespace BufferPoolTests
@@ -10,6 +10,7 @@
 
 #include <pbcopper/cli/CLI.h>
 
+#include <pacbio/ccs/ChunkSizer.h>
 #include <pacbio/ccs/Consensus.h>
 #include <pacbio/ccs/ConsensusSettings.h>
 #include <pacbio/data/ReadId.h>
@@ -60,3 +61,32 @@ TEST(ConsensusTest, TestReadFilter)
     auto result3 = FilterReads(data, settings, &counter);
     EXPECT_EQ(1, counter.FilteredBySize);
 }
+
+TEST(ConsensusTest, ChunkSizer)
+{
+    ChunkSizer sizer(1000, 3);
+    EXPECT_FALSE(sizer.IsFull());
+
+    // short inserts are batched until the target number of bases is reached
+    sizer.AddZmw();
+    sizer.AddBases(400);
+    EXPECT_FALSE(sizer.IsFull());
+    sizer.AddZmw();
+    sizer.AddBases(600);
+    EXPECT_TRUE(sizer.IsFull());
+
+    // a single long insert fills a chunk on its own
+    sizer.Reset();
+    EXPECT_FALSE(sizer.IsFull());
+    sizer.AddZmw();
+    sizer.AddBases(5000);
+    EXPECT_TRUE(sizer.IsFull());
+
+    // but never batch more than the maximal number of ZMWs
+    sizer.Reset();
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_FALSE(sizer.IsFull());
+        sizer.AddZmw();
+    }
+    EXPECT_TRUE(sizer.IsFull());
+}
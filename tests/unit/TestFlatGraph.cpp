@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "../src/poa/FlatGraph.h"
+
+using namespace PacBio::Poa::detail;  // NOLINT
+
+namespace FlatGraphTests {
+
+std::vector<VD> ToVector(const VertexRange& range)
+{
+    return std::vector<VD>(range.begin(), range.end());
+}
+
+size_t Rank(const std::vector<VD>& order, const VD v)
+{
+    return std::find(order.begin(), order.end(), v) - order.begin();
+}
+
+// Build the graph 0 -> 2 -> 3 -> 1 with the detour 0 -> 4 -> 3
+// and a late edge 4 -> 2 between existing vertices
+TEST(FlatGraphTest, TopologicalOrder)
+{
+    FlatGraph g;
+    for (size_t i = 0; i < 5; ++i)
+        g.AddVertex();
+    const std::vector<std::pair<VD, VD>> edges = {{0, 2}, {2, 3}, {3, 1}, {0, 4}, {4, 3}, {4, 2}};
+    for (const auto& e : edges)
+        g.AddEdge(e.first, e.second);
+    g.AddEdge(2, 3);  // duplicate
+    g.Update();
+
+    EXPECT_EQ(5, g.NumVertices());
+    EXPECT_EQ(edges, g.Edges());
+    EXPECT_EQ(std::vector<VD>({0, 4}), ToVector(g.Predecessors(2)));
+    EXPECT_EQ(std::vector<VD>({2, 4}), ToVector(g.Predecessors(3)));
+    EXPECT_EQ(std::vector<VD>({2, 4}), ToVector(g.Successors(0)));
+    EXPECT_TRUE(g.Predecessors(0).empty());
+    EXPECT_TRUE(g.Successors(1).empty());
+
+    const std::vector<VD>& order = g.TopologicalOrder();
+    ASSERT_EQ(5, order.size());
+    for (const auto& e : edges)
+        EXPECT_LT(Rank(order, e.first), Rank(order, e.second));
+}
+
+TEST(FlatGraphTest, RemoveVertex)
+{
+    FlatGraph g;
+    for (size_t i = 0; i < 5; ++i)
+        g.AddVertex();
+    g.AddEdge(0, 2);
+    g.AddEdge(2, 3);
+    g.AddEdge(0, 4);
+    g.AddEdge(4, 3);
+    g.AddEdge(3, 1);
+    g.RemoveVertex(4);
+    g.Update();
+
+    EXPECT_FALSE(g.HasVertex(4));
+    EXPECT_EQ(4, g.NumVertices());
+    EXPECT_EQ(5, g.NumIds());
+    EXPECT_EQ(std::vector<VD>({0, 1, 2, 3}), g.Vertices());
+    EXPECT_EQ(std::vector<VD>({0, 2, 3, 1}), g.TopologicalOrder());
+    EXPECT_EQ(std::vector<VD>({2}), ToVector(g.Successors(0)));
+    EXPECT_EQ(std::vector<VD>({2}), ToVector(g.Predecessors(3)));
+    const std::vector<std::pair<VD, VD>> edges = {{0, 2}, {2, 3}, {3, 1}};
+    EXPECT_EQ(edges, g.Edges());
+
+    // descriptors are not reused
+    EXPECT_EQ(5, g.AddVertex());
+}
+
+}  // namespace FlatGraphTests
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <pacbio/parallel/ForkJoinPool.h>
+
+using namespace PacBio::Parallel;  // NOLINT
+
+namespace ForkJoinPoolTests {
+
+TEST(ForkJoinPoolTest, RunsOnEveryThread)
+{
+    ForkJoinPool pool;
+    for (const size_t nThreads : {1, 4, 2, 4}) {
+        std::mutex m;
+        std::set<std::thread::id> ids;
+        std::atomic_size_t nCalls{0};
+        pool.Run(nThreads, [&]() {
+            ++nCalls;
+            std::lock_guard<std::mutex> g(m);
+            ids.insert(std::this_thread::get_id());
+        });
+        EXPECT_EQ(nThreads, nCalls.load());
+        EXPECT_EQ(nThreads, ids.size());
+        EXPECT_EQ(1, ids.count(std::this_thread::get_id()));
+    }
+    // the helpers are reused
+    EXPECT_EQ(3, pool.NumHelpers());
+}
+
+TEST(ForkJoinPoolTest, SharesWork)
+{
+    ForkJoinPool pool;
+    const size_t n = 10000;
+    std::vector<int> done(n, 0);
+    for (size_t round = 0; round < 50; ++round) {
+        std::atomic_size_t next{0};
+        pool.Run(3, [&]() {
+            for (size_t i; (i = next++) < n;)
+                ++done[i];
+        });
+    }
+    for (const int d : done)
+        EXPECT_EQ(50, d);
+}
+
+TEST(ForkJoinPoolTest, RethrowsAfterAllReturn)
+{
+    ForkJoinPool pool;
+    std::atomic_size_t nReturned{0};
+    std::atomic_size_t nCalls{0};
+    EXPECT_THROW(pool.Run(4,
+                          [&]() {
+                              // one helper throws, the others finish
+                              if (nCalls++ == 1) throw std::runtime_error("helper");
+                              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                              ++nReturned;
+                          }),
+                 std::runtime_error);
+    EXPECT_EQ(3, nReturned.load());
+
+    // and the pool is still usable
+    nCalls = 0;
+    pool.Run(4, [&]() { ++nCalls; });
+    EXPECT_EQ(4, nCalls.load());
+}
+
+TEST(ForkJoinPoolTest, CountsHelperCpuTime)
+{
+    ForkJoinPool pool;
+    EXPECT_EQ(0, pool.HelperCpuNanoseconds());
+
+    // sleeping helpers take no CPU time, spinning ones do
+    pool.Run(2, []() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); });
+    const int64_t slept = pool.HelperCpuNanoseconds();
+    EXPECT_LT(slept, 5000000);
+
+    const auto start = std::chrono::steady_clock::now();
+    pool.Run(2, [start]() {
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(5))
+            ;
+    });
+    EXPECT_GT(pool.HelperCpuNanoseconds(), slept);
+}
+
+TEST(ForkJoinPoolTest, NestedRunStaysOnTheCallingThread)
+{
+    ForkJoinPool& pool = ForkJoinPool::ThreadLocal();
+    std::atomic_size_t nInner{0};
+    pool.Run(2, [&]() { ForkJoinPool::ThreadLocal().Run(3, [&]() { ++nInner; }); });
+    // the calling thread runs the inner loop alone, the helper on its own pool
+    EXPECT_EQ(4, nInner.load());
+}
+
+}  // namespace ForkJoinPoolTests
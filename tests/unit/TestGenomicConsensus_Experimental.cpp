@@ -1,6 +1,7 @@
 // Author: Derek Barnett
 
 #include <cstdint>
+#include <cstdio>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -20,6 +21,8 @@
 #include <pacbio/genomicconsensus/experimental/Input.h>
 #include <pacbio/genomicconsensus/experimental/Intervals.h>
 #include <pacbio/genomicconsensus/experimental/NoCallStyle.h>
+#include <pacbio/genomicconsensus/experimental/Output.h>
+#include <pacbio/genomicconsensus/experimental/ReadCache.h>
 #include <pacbio/genomicconsensus/experimental/ReferenceWindow.h>
 #include <pacbio/genomicconsensus/experimental/Settings.h>
 #include <pacbio/genomicconsensus/experimental/Sorting.h>
@@ -28,6 +31,9 @@
 #include <pacbio/genomicconsensus/experimental/WorkChunk.h>
 #include <pacbio/genomicconsensus/experimental/Workflow.h>
 #include <pacbio/genomicconsensus/experimental/arrow/ArrowModel.h>
+#include <pacbio/genomicconsensus/experimental/io/FastaWriter.h>
+#include <pacbio/genomicconsensus/experimental/io/FastqWriter.h>
+#include <pacbio/genomicconsensus/experimental/plurality/Plurality.h>
 #include <pacbio/genomicconsensus/experimental/plurality/PluralityModel.h>
 #include <pacbio/genomicconsensus/experimental/poa/PoaModel.h>
 
@@ -95,6 +101,38 @@ const std::vector<PacBio::BAM::BamRecord>& FilterSortTestReads()
     return reads;
 }
 
+std::string Slurp(const std::string& filename)
+{
+    std::ifstream in{filename};
+    std::stringstream contents;
+    contents << in.rdbuf();
+    std::remove(filename.c_str());
+    return contents.str();
+}
+
+WindowResult MakeOutputTestResult(const size_t start, const size_t end)
+{
+    const std::string name{"Barcode0--0_Cluster1_Phase1_NumReads297"};
+    std::string seq;
+    for (size_t i = start; i < end; ++i)
+        seq.push_back("ACGT"[i % 4]);
+    return WindowResult{Consensus{ReferenceWindow{name, {start, end}}, seq,
+                                  std::vector<uint8_t>(end - start, 20)},
+                        {}};
+}
+
+Settings MakeOutputTestSettings()
+{
+    const std::string name{"Barcode0--0_Cluster1_Phase1_NumReads297"};
+    Settings settings;
+    settings.referenceFilename = ChimeraFasta;
+    settings.fastaFilename = "output_test.fa";
+    settings.mode = ConsensusMode::ARROW;
+    settings.filterWindows = { ReferenceWindow{name, {0,30}},
+                               ReferenceWindow{name, {100,120}} };
+    return settings;
+}
+
 }  // namespace GenomicConsensusExperimentalTests
 
 // -----------------------
@@ -575,6 +613,125 @@ TEST(GenomicConsensusExperimentalTest, sequence_length_from_fasta)
     EXPECT_EQ(3152, seqLength);
 }
 
+// -----------------------
+// Output
+// -----------------------
+
+TEST(GenomicConsensusExperimentalTest, fasta_writer_wraps_lines_across_appended_sequences)
+{
+    Settings settings;
+    settings.fastaFilename = "fasta_writer_test.fa";
+    {
+        FastaWriter writer{settings};
+        writer.BeginRecord("first");
+        writer.Append(std::string(50, 'A'));
+        writer.Append(std::string(30, 'C'));
+        writer.Append(std::string(60, 'G'));
+        writer.EndRecord();
+        writer.BeginRecord("second");
+        writer.Append(std::string(70, 'T'));
+        writer.Append(std::string{});
+        writer.EndRecord();
+        writer.Write("third", "ACGT");
+    }
+
+    const std::string expected =
+        ">first\n" +
+        std::string(50, 'A') + std::string(20, 'C') + '\n' +
+        std::string(10, 'C') + std::string(60, 'G') + '\n' +
+        ">second\n" +
+        std::string(70, 'T') + '\n' +
+        ">third\n"
+        "ACGT\n";
+    EXPECT_EQ(expected, GenomicConsensusExperimentalTests::Slurp(settings.fastaFilename));
+}
+
+TEST(GenomicConsensusExperimentalTest, fastq_writer_joins_appended_sequences_and_qualities)
+{
+    Settings settings;
+    settings.fastqFilename = "fastq_writer_test.fq";
+    {
+        FastqWriter writer{settings};
+        writer.BeginRecord("first");
+        writer.Append("ACG", {0, 10, 20});
+        writer.Append("TT", {30, 40});
+        writer.EndRecord();
+        writer.Write("second", "GA", {1, 2});
+    }
+
+    const std::string expected =
+        "@first\n"
+        "ACGTT\n"
+        "+\n"
+        "!+5?I\n"
+        "@second\n"
+        "GA\n"
+        "+\n"
+        "\"#\n";
+    EXPECT_EQ(expected, GenomicConsensusExperimentalTests::Slurp(settings.fastqFilename));
+}
+
+TEST(GenomicConsensusExperimentalTest, output_writes_results_arriving_out_of_order)
+{
+    using GenomicConsensusExperimentalTests::MakeOutputTestResult;
+
+    const auto settings = GenomicConsensusExperimentalTests::MakeOutputTestSettings();
+    {
+        Output output{settings};
+        output.AddResult(MakeOutputTestResult(10, 20));
+        output.AddResult(MakeOutputTestResult(100, 110));
+        output.AddResult(MakeOutputTestResult(0, 10));
+        output.AddResult(MakeOutputTestResult(110, 120));
+        output.AddResult(MakeOutputTestResult(20, 30));
+        output.Finish();
+    }
+
+    const std::string expected =
+        ">Barcode0--0_Cluster1_Phase1_NumReads297_0_30|arrow\n"
+        "ACGTACGTACGTACGTACGTACGTACGTAC\n"
+        ">Barcode0--0_Cluster1_Phase1_NumReads297_100_120|arrow\n"
+        "ACGTACGTACGTACGTACGT\n";
+    EXPECT_EQ(expected, GenomicConsensusExperimentalTests::Slurp(settings.fastaFilename));
+}
+
+TEST(GenomicConsensusExperimentalTest, output_throws_on_results_that_do_not_tile)
+{
+    using GenomicConsensusExperimentalTests::MakeOutputTestResult;
+
+    const auto settings = GenomicConsensusExperimentalTests::MakeOutputTestSettings();
+    {   // gap at end of input
+        Output output{settings};
+        output.AddResult(MakeOutputTestResult(0, 10));
+        output.AddResult(MakeOutputTestResult(20, 30));
+        output.AddResult(MakeOutputTestResult(100, 120));
+        EXPECT_THROW(output.Finish(), std::runtime_error);
+    }
+    {   // record never started
+        Output output{settings};
+        output.AddResult(MakeOutputTestResult(0, 30));
+        EXPECT_THROW(output.Finish(), std::runtime_error);
+    }
+    {   // overlap
+        Output output{settings};
+        output.AddResult(MakeOutputTestResult(0, 10));
+        EXPECT_THROW(output.AddResult(MakeOutputTestResult(5, 15)), std::runtime_error);
+    }
+    {   // outside of the output windows
+        Output output{settings};
+        EXPECT_THROW(output.AddResult(MakeOutputTestResult(40, 50)), std::runtime_error);
+    }
+    {   // too many results waiting for a missing one
+        Output output{settings};
+        EXPECT_THROW(
+        {
+            for (size_t start = 1; start < 30; ++start)
+                output.AddResult(MakeOutputTestResult(start, start + 1));
+        },
+        std::runtime_error);
+    }
+    std::remove(settings.fastaFilename.c_str());
+}
+
 // -----------------------
 // Intervals
 // -----------------------
@@ -732,6 +889,33 @@ TEST(GenomicConsensusExperimentalTest, read_intervals_from_zmw_filter)
     EXPECT_EQ(11, intervals.size());
 }
 
+TEST(GenomicConsensusExperimentalTest, read_cache_matches_pbi_filter)
+{
+    const PacBio::BAM::BamFile bamFile{ GenomicConsensusExperimentalTests::All4merBam };
+    const PacBio::BAM::PbiRawData index{ bamFile.PacBioIndexFilename() };
+    const auto cache = ReadCache::For(GenomicConsensusExperimentalTests::All4merBam);
+    EXPECT_EQ(cache, ReadCache::For(GenomicConsensusExperimentalTests::All4merBam));
+
+    const auto& mappedData = index.MappedData();
+    for (const uint8_t minMapQV : { 0, 20 }) {
+        for (size_t start = 0; start < 500; start += 37) {
+            const ReferenceWindow window{"All4mer.V2.01_Insert", {start, start + 50}};
+
+            EXPECT_EQ(FilteredWindowIntervals(index, window, minMapQV),
+                      cache->IntervalsInWindow(window, minMapQV));
+
+            for (const auto row : cache->RowsInWindow(window, minMapQV)) {
+                const auto record = cache->Record(row);
+                EXPECT_EQ(mappedData.tStart_.at(row), record.ReferenceStart());
+                EXPECT_EQ(mappedData.tEnd_.at(row), record.ReferenceEnd());
+            }
+        }
+    }
+
+    const ReferenceWindow unknown{"not_a_reference", {0, 50}};
+    EXPECT_TRUE(cache->RowsInWindow(unknown, 0).empty());
+}
+
 TEST(GenomicConsensusExperimentalTest, hole_in_empty_intervals_is_full_window)
 {
     const Interval win{0,100};
@@ -1417,6 +1601,57 @@ TEST(GenomicConsensusExperimentalTest, reference_names_from_filter_windows)
 // Plurality-specific
 // -----------------------
 
+TEST(GenomicConsensusExperimentalTest, pileup_top_alleles_from_cigars)
+{
+    using Cigar = PacBio::BAM::Cigar;
+    using Pileup = Plurality::Pileup;
+
+    //    ref:   AC--GTAA-T
+    //    read0: ACGGGT-TTT
+    //    read1: ACGGGTAA-T
+    //    read2: AC-GG-AA-T
+    //    read3:     GTA     (from ref pos 2)
+
+    Pileup pileup{7};
+    pileup.AddRead(0, Cigar::FromStdString("2=2I2=1D1X1I1="), "ACGGGTTTT");
+    pileup.AddRead(0, Cigar::FromStdString("2=2I5="), "ACGGGTAAT");
+    pileup.AddRead(0, Cigar::FromStdString("2=1I1=1D3="), "ACGGAAT");
+    pileup.AddRead(2, Cigar::FromStdString("2S3=1S"), "TTGTAC");
+
+    const auto top2 = pileup.TopAlleles();
+    ASSERT_EQ(7, top2.size());
+
+    EXPECT_EQ("A", top2.at(0).firstAllele.bases);
+    EXPECT_EQ(3, top2.at(0).firstAllele.frequency);
+    EXPECT_EQ("", top2.at(0).secondAllele.bases);
+    EXPECT_EQ(0, top2.at(0).secondAllele.frequency);
+    EXPECT_EQ(3, top2.at(0).totalCoverage);
+
+    EXPECT_EQ("GGG", top2.at(2).firstAllele.bases);
+    EXPECT_EQ(2, top2.at(2).firstAllele.frequency);
+    EXPECT_EQ("G", top2.at(2).secondAllele.bases);  // tied with "GG", ordered by allele
+    EXPECT_EQ(1, top2.at(2).secondAllele.frequency);
+    EXPECT_EQ(4, top2.at(2).totalCoverage);
+
+    EXPECT_EQ("T", top2.at(3).firstAllele.bases);
+    EXPECT_EQ(3, top2.at(3).firstAllele.frequency);
+    EXPECT_EQ("-", top2.at(3).secondAllele.bases);
+    EXPECT_EQ(1, top2.at(3).secondAllele.frequency);
+    EXPECT_EQ(4, top2.at(3).totalCoverage);
+
+    EXPECT_EQ("A", top2.at(4).firstAllele.bases);
+    EXPECT_EQ(3, top2.at(4).firstAllele.frequency);
+    EXPECT_EQ("-", top2.at(4).secondAllele.bases);
+    EXPECT_EQ(1, top2.at(4).secondAllele.frequency);
+    EXPECT_EQ(4, top2.at(4).totalCoverage);
+
+    EXPECT_EQ("T", top2.at(6).firstAllele.bases);
+    EXPECT_EQ(2, top2.at(6).firstAllele.frequency);
+    EXPECT_EQ("TT", top2.at(6).secondAllele.bases);
+    EXPECT_EQ(1, top2.at(6).secondAllele.frequency);
+    EXPECT_EQ(3, top2.at(6).totalCoverage);
+}
+
 // -----------------------
 // Poa-specific
 // -----------------------
@@ -82,6 +82,23 @@ Read MkRead(const string& seq, const SNR& snr, const string& mdl, const vector<u
     return Read("NA", seq, ipds, pws, snr, mdl);
 }
 
+// Add longRead to the forward strand of tpl once per SNR in fwdSnrs, and its
+// reverse complement to the reverse strand once per SNR in revSnrs
+void AddLongReads(Integrator* const ai, const string& tpl, const string& mdl,
+                  const vector<SNR>& fwdSnrs = {snr}, const vector<SNR>& revSnrs = {snr})
+{
+    const vector<uint8_t> pws(longRead.length(), avgPw);
+    const string rcRead = ReverseComplement(longRead);
+    for (const SNR& readSnr : fwdSnrs)
+        EXPECT_EQ(State::VALID,
+                  ai->AddRead(MappedRead(MkRead(longRead, readSnr, mdl, pws), StrandType::FORWARD,
+                                         0, tpl.length(), true, true)));
+    for (const SNR& readSnr : revSnrs)
+        EXPECT_EQ(State::VALID,
+                  ai->AddRead(MappedRead(MkRead(rcRead, readSnr, mdl, pws), StrandType::REVERSE, 0,
+                                         tpl.length(), true, true)));
+}
+
 #if EXTENSIVE_TESTING
 TEST(IntegratorTest, TestLongTemplate)
 {
@@ -360,6 +377,145 @@ TEST(IntegratorTest, TestIntegratorEquivalenceDiTriRepeats)
     EXPECT_EQ(0, nerror);
 }
 
+// ApplyMutations only refills the alpha and beta columns around the mutated
+// sites, which must agree with filling from scratch round after round
+TEST(IntegratorTest, TestIncrementalRefill)
+{
+    std::mt19937 gen(42);
+    const string mdl = SP1C1v2;
+
+    Integrator ai1(longTpl, cfg);
+    AddLongReads(&ai1, longTpl, mdl);
+    EXPECT_EQ(2, ai1.NumEvaluators());
+    size_t filled = ai1.FilledEntries();
+    EXPECT_LT(0, filled);
+
+    std::uniform_int_distribution<size_t> nSites(1, 2);
+    for (size_t round = 0; round < 10; ++round) {
+        const string tpl(ai1);
+        std::uniform_int_distribution<size_t> site(1, tpl.length() - 2);
+        vector<Mutation> muts;
+        for (size_t k = nSites(gen); k > 0; --k) {
+            const size_t s = site(gen);
+            const vector<Mutation> possible = Mutations(tpl, s, s + 1);
+            std::uniform_int_distribution<size_t> pick(0, possible.size() - 1);
+            muts.emplace_back(possible[pick(gen)]);
+        }
+        // two mutations at one site cannot be applied together
+        if (muts.size() == 2 && muts[0].Start() == muts[1].Start()) muts.pop_back();
+
+        const string app = ApplyMutations(tpl, &muts);
+        ai1.ApplyMutations(&muts);
+        ASSERT_EQ(app, string(ai1));
+        // refills are counted too
+        EXPECT_LT(filled, ai1.FilledEntries());
+        filled = ai1.FilledEntries();
+
+        Integrator ai2(app, cfg);
+        AddLongReads(&ai2, app, mdl);
+        EXPECT_NEAR(ai2.LL(), ai1.LL(), 1e-9 * std::abs(ai2.LL()));
+    }
+}
+
+// Mutations scored right after an incremental refill must score as they do
+// on matrices filled from scratch, especially those next to the refilled
+// columns, which polishing tries next
+TEST(IntegratorTest, TestIncrementalRefillScores)
+{
+    std::mt19937 gen(7);
+    const string mdl = SP1C1v2;
+
+    Integrator ai1(longTpl, cfg);
+    AddLongReads(&ai1, longTpl, mdl);
+
+    for (size_t round = 0; round < 5; ++round) {
+        const string tpl(ai1);
+        std::uniform_int_distribution<size_t> site(1, tpl.length() - 2);
+        const size_t s = site(gen);
+        const vector<Mutation> possible = Mutations(tpl, s, s + 1);
+        std::uniform_int_distribution<size_t> pick(0, possible.size() - 1);
+        vector<Mutation> muts{possible[pick(gen)]};
+
+        const string app = ApplyMutations(tpl, &muts);
+        ai1.ApplyMutations(&muts);
+        ASSERT_EQ(app, string(ai1));
+
+        Integrator ai2(app, cfg);
+        AddLongReads(&ai2, app, mdl);
+        EXPECT_NEAR(ai2.LL(), ai1.LL(), 1e-9 * std::abs(ai2.LL()));
+
+        const size_t begin = (s > 40) ? s - 40 : 0;
+        const size_t end = std::min(s + 40, app.length());
+        for (const auto& mut : Mutations(app, begin, end))
+            EXPECT_NEAR(ai2.LL(mut), ai1.LL(mut), 1e-9 * std::abs(ai2.LL(mut))) << mut;
+    }
+}
+
+// Reads of a strand with the same model share one template, others keep a
+// Template of their own; either way they must follow mutations alike
+TEST(IntegratorTest, TestSharedTemplates)
+{
+    std::mt19937 gen(11);
+    const string mdl = SP1C1v2;
+    const SNR otherSnr(9, 6, 5, 10);
+
+    Integrator ai1(longTpl, cfg);
+    AddLongReads(&ai1, longTpl, mdl, {snr, snr}, {snr, otherSnr});
+
+    for (size_t round = 0; round < 5; ++round) {
+        const string tpl(ai1);
+        std::uniform_int_distribution<size_t> site(1, tpl.length() - 2);
+        const size_t s = site(gen);
+        const vector<Mutation> possible = Mutations(tpl, s, s + 1);
+        std::uniform_int_distribution<size_t> pick(0, possible.size() - 1);
+        vector<Mutation> muts{possible[pick(gen)]};
+
+        const string app = ApplyMutations(tpl, &muts);
+        if (round % 2 == 0)
+            ai1.ApplyMutation(muts.front());
+        else
+            ai1.ApplyMutations(&muts);
+        ASSERT_EQ(app, string(ai1));
+
+        Integrator ai2(app, cfg);
+        AddLongReads(&ai2, app, mdl, {snr, snr}, {snr, otherSnr});
+        const vector<double> exp = ai2.LLs();
+        const vector<double> obs = ai1.LLs();
+        ASSERT_EQ(exp.size(), obs.size());
+        for (size_t i = 0; i < exp.size(); ++i)
+            EXPECT_NEAR(exp[i], obs[i], 1e-9 * std::abs(exp[i]));
+    }
+}
+
+// Multi-base mutations are stitched between alpha and beta like single-base
+// ones, at the start, in the middle and at the end of the template
+TEST(IntegratorTest, TestMultiBaseMutations)
+{
+    std::mt19937 gen(42);
+    const string mdl = SP1C1v2;
+
+    Integrator ai(longTpl, cfg);
+    AddLongReads(&ai, longTpl, mdl);
+
+    const size_t L = longTpl.length();
+    for (size_t len = 2; len <= 4; ++len) {
+        for (const size_t start : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(137),
+                                   size_t(400), L - len - 2, L - len - 1, L - len}) {
+            const vector<Mutation> muts{Mutation::Deletion(start, len),
+                                        Mutation::Insertion(start, RandomDNA(len, &gen)),
+                                        Mutation::Substitution(start, RandomDNA(len, &gen))};
+            for (const auto& mut : muts) {
+                vector<Mutation> applied{mut};
+                const string app = ApplyMutations(longTpl, &applied);
+                Integrator exp(app, cfg);
+                AddLongReads(&exp, app, mdl);
+                EXPECT_NEAR(exp.LL(), ai.LL(mut), prec * std::abs(exp.LL())) << mut;
+            }
+        }
+    }
+    EXPECT_EQ(longTpl, string(ai));
+}
+
 TEST(IntegratorTest, TestP6C4NoCovAgainstCSharpModel)
 {
     const string tpl = "ACGTCGT";
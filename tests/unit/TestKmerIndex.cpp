@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <pacbio/chimera/KmerIndex.h>
+
+using namespace PacBio::Chimera;  // NOLINT
+
+namespace KmerIndexTests {
+
+TEST(KmerIndexTest, SharedKmers)
+{
+    KmerIndex index(4);
+    EXPECT_EQ(0, index.Add("ACGTACGTAA"));
+    EXPECT_EQ(1, index.Add("TTTTTTTTTT"));
+    EXPECT_EQ(2, index.Add("GGACGTACGG"));
+    EXPECT_EQ(3, index.Size());
+
+    // ACGT, CGTA, GTAC, TACG are shared with 0 and 2, GTAA only with 0
+    EXPECT_EQ((std::vector<size_t>{0, 2}), index.Candidates("ACGTACGTAA", 5));
+    EXPECT_EQ((std::vector<size_t>{0}), index.Candidates("ACGTACGTAA", 1));
+    EXPECT_EQ((std::vector<size_t>{1}), index.Candidates("CTTTTC", 5));
+    EXPECT_TRUE(index.Candidates("CCCCCC", 5).empty());
+    EXPECT_TRUE(index.Candidates("ACG", 5).empty());
+}
+
+TEST(KmerIndexTest, TiesFavorEarlierSequences)
+{
+    KmerIndex index(3);
+    index.Add("CCCAAA");
+    index.Add("AAACCC");
+    index.Add("AAAGGG");
+
+    EXPECT_EQ((std::vector<size_t>{0, 1}), index.Candidates("AAACCC", 2));
+    EXPECT_EQ((std::vector<size_t>{0}), index.Candidates("AAA", 1));
+}
+
+TEST(KmerIndexTest, EntriesOfSeveralSequences)
+{
+    KmerIndex index(3);
+    const std::string fwd = "AAACCC";
+    const std::string rev = "GGGTTT";
+    EXPECT_EQ(0, index.Add({fwd, rev}));
+    EXPECT_EQ(1, index.Add("CCCGGG"));
+    EXPECT_EQ(2, index.Size());
+
+    // both sequences count for the entry, shared k-mers only once
+    EXPECT_EQ((std::vector<size_t>{0}), index.Candidates("AAAGGGTTT", 1));
+    EXPECT_EQ((std::vector<size_t>{0}), index.Candidates("TTT", 5));
+    EXPECT_EQ((std::vector<size_t>{0, 1}), index.Candidates("CCCGGG", 5));
+}
+
+TEST(KmerIndexTest, SkipsAmbiguousBases)
+{
+    KmerIndex index(3);
+    index.Add("ACNGTA");
+    // ACN, CNG and NGT are no k-mers
+    EXPECT_TRUE(index.Candidates("ACGCNGT", 5).empty());
+    EXPECT_EQ((std::vector<size_t>{0}), index.Candidates("gta", 5));
+
+    index.Clear();
+    EXPECT_EQ(0, index.Size());
+    EXPECT_TRUE(index.Candidates("GTA", 5).empty());
+}
+
+TEST(KmerIndexTest, InvalidK)
+{
+    EXPECT_THROW(KmerIndex(0), std::invalid_argument);
+    EXPECT_THROW(KmerIndex(33), std::invalid_argument);
+    KmerIndex index(32);
+    index.Add(std::string(40, 'T'));
+    EXPECT_EQ((std::vector<size_t>{0}), index.Candidates(std::string(32, 'T'), 1));
+}
+
+}  // namespace KmerIndexTests
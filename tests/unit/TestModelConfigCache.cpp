@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <pacbio/consensus/ModelConfig.h>
+#include <pacbio/consensus/ModelSelection.h>
+#include <pacbio/data/Read.h>
+
+#include "../src/ModelFactory.h"
+
+using namespace PacBio::Consensus;  // NOLINT
+using PacBio::Data::SNR;
+
+namespace ModelConfigCacheTests {
+
+const std::string mdl = "P6-C4";
+
+// restores the default cache once a test is done with it
+struct ModelConfigCacheTest : public ::testing::Test
+{
+    void TearDown() override { ModelFactory::Cache().Configure(256, 0.0); }
+};
+
+void ExpectSamePopulation(const ModelConfig& expected, const ModelConfig& model)
+{
+    const std::string tpl = "ACGTTGCAACCGGTTA";
+    const auto lhs = expected.Populate(tpl);
+    const auto rhs = model.Populate(tpl);
+    ASSERT_EQ(lhs.size(), rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        EXPECT_EQ(lhs[i].Base, rhs[i].Base);
+        EXPECT_DOUBLE_EQ(lhs[i].Match, rhs[i].Match);
+        EXPECT_DOUBLE_EQ(lhs[i].Branch, rhs[i].Branch);
+        EXPECT_DOUBLE_EQ(lhs[i].Stick, rhs[i].Stick);
+        EXPECT_DOUBLE_EQ(lhs[i].Deletion, rhs[i].Deletion);
+    }
+}
+
+TEST_F(ModelConfigCacheTest, SharesModelsOfEqualSnr)
+{
+    ConfigureModelCache(4, 0.0);
+    const SNR snr(10, 7, 5, 11);
+
+    const auto first = ModelFactory::CreateShared(mdl, snr);
+    const auto second = ModelFactory::CreateShared(mdl, snr);
+    const auto other = ModelFactory::CreateShared(mdl, SNR(10, 7, 5, 11.01));
+
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_NE(first.get(), other.get());
+    EXPECT_EQ(1, ModelCacheStatistics().first);
+    EXPECT_EQ(2, ModelCacheStatistics().second);
+    EXPECT_EQ(2, ModelFactory::Cache().Size());
+    ExpectSamePopulation(*ModelFactory::Create(mdl, snr), *first);
+}
+
+TEST_F(ModelConfigCacheTest, QuantizesSnr)
+{
+    ConfigureModelCache(4, 0.5);
+    EXPECT_DOUBLE_EQ(0.5, ModelFactory::Cache().SnrResolution());
+
+    const auto first = ModelFactory::CreateShared(mdl, SNR(10.1, 7.2, 4.9, 11.0));
+    const auto second = ModelFactory::CreateShared(mdl, SNR(9.9, 7.1, 5.2, 10.8));
+    EXPECT_EQ(first.get(), second.get());
+
+    // the model is that of the rounded SNR, whichever read asked first
+    const SNR rounded = ModelFactory::Cache().Quantize(SNR(10.1, 7.2, 4.9, 11.0));
+    EXPECT_DOUBLE_EQ(10.0, rounded.A);
+    EXPECT_DOUBLE_EQ(7.0, rounded.C);
+    EXPECT_DOUBLE_EQ(5.0, rounded.G);
+    EXPECT_DOUBLE_EQ(11.0, rounded.T);
+    ExpectSamePopulation(*ModelFactory::Create(mdl, rounded), *first);
+
+    EXPECT_THROW(ConfigureModelCache(4, -1.0), std::invalid_argument);
+}
+
+TEST_F(ModelConfigCacheTest, DropsLeastRecentlyUsed)
+{
+    ConfigureModelCache(2, 0.0);
+    const SNR a(10, 7, 5, 11), b(9, 7, 5, 11), c(8, 7, 5, 11);
+
+    const auto modelA = ModelFactory::CreateShared(mdl, a);
+    ModelFactory::CreateShared(mdl, b);
+    ModelFactory::CreateShared(mdl, a);  // b is now the least recently used
+    ModelFactory::CreateShared(mdl, c);
+    EXPECT_EQ(2, ModelFactory::Cache().Size());
+
+    EXPECT_EQ(modelA.get(), ModelFactory::CreateShared(mdl, a).get());
+    ModelFactory::CreateShared(mdl, b);
+    EXPECT_EQ(2, ModelCacheStatistics().first);
+    EXPECT_EQ(4, ModelCacheStatistics().second);
+
+    // a capacity of 0 disables sharing
+    ConfigureModelCache(0, 0.0);
+    EXPECT_NE(ModelFactory::CreateShared(mdl, a).get(), ModelFactory::CreateShared(mdl, a).get());
+    EXPECT_EQ(0, ModelFactory::Cache().Size());
+}
+
+}  // namespace ModelConfigCacheTests
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <pacbio/consensus/Mutation.h>
+#include "../src/MutationSelector.h"
+
+using namespace PacBio::Consensus;  // NOLINT
+
+namespace {
+
+// The quadratic greedy selection BestMutations replaces
+std::vector<Mutation> ScanBestMutations(std::list<ScoredMutation> scoredMuts,
+                                        const size_t separation)
+{
+    std::vector<Mutation> result;
+    while (!scoredMuts.empty()) {
+        const auto& mut =
+            *std::max_element(scoredMuts.begin(), scoredMuts.end(), ScoredMutation::ScoreComparer);
+        result.emplace_back(mut);
+
+        const size_t start = (separation < mut.Start()) ? mut.Start() - separation : 0;
+        const size_t end = mut.End() + separation;
+        scoredMuts.remove_if(
+            [start, end](const ScoredMutation& m) { return start <= m.End() && m.Start() < end; });
+    }
+    return result;
+}
+
+std::vector<ScoredMutation> RandomScoredMutations(const size_t n, const size_t tplLength,
+                                                  std::mt19937* const gen)
+{
+    std::uniform_int_distribution<size_t> pos(0, tplLength - 1);
+    std::uniform_int_distribution<int> type(0, 2);
+    std::uniform_int_distribution<size_t> length(1, 3);
+    std::uniform_int_distribution<int> base(0, 3);
+    // coarse scores, so that there are plenty of ties
+    std::uniform_int_distribution<int> score(1, 20);
+
+    std::vector<ScoredMutation> result;
+    for (size_t i = 0; i < n; ++i) {
+        const size_t start = pos(*gen);
+        const std::string bases(length(*gen), "ACGT"[base(*gen)]);
+        const int t = type(*gen);
+        const auto mut = (t == 0)
+                             ? Mutation::Deletion(start, std::min(bases.size(), tplLength - start))
+                             : (t == 1) ? Mutation::Insertion(start, bases)
+                                        : Mutation::Substitution(start, bases.substr(0, 1));
+        result.emplace_back(mut.WithScore(score(*gen)));
+    }
+    return result;
+}
+
+}  // namespace anonymous
+
+TEST(MutationSelectorTest, RejectsMutationsWithinSeparation)
+{
+    MutationSelector selector(10);
+    EXPECT_TRUE(selector.TryAdd(Mutation::Substitution(50, 'A')));
+    // ends 10 before the selected one, or starts 10 after it
+    EXPECT_FALSE(selector.TryAdd(Mutation::Deletion(39, 1)));
+    EXPECT_FALSE(selector.TryAdd(Mutation::Insertion(60, 'C')));
+    EXPECT_TRUE(selector.TryAdd(Mutation::Substitution(61, 'G')));
+    EXPECT_TRUE(selector.TryAdd(Mutation::Substitution(38, 'T')));
+    // between two selected ones
+    EXPECT_FALSE(selector.TryAdd(Mutation::Deletion(45, 3)));
+    EXPECT_TRUE(selector.TryAdd(Mutation::Insertion(0, 'A')));
+    EXPECT_EQ(4u, selector.Selected().size());
+
+    EXPECT_THROW(MutationSelector(0), std::invalid_argument);
+}
+
+TEST(MutationSelectorTest, BestMutationsMatchesScan)
+{
+    std::mt19937 gen(42);
+    for (const size_t n : {0, 1, 10, 100, 1000}) {
+        for (const size_t separation : {1, 5, 10}) {
+            const auto scoredMuts = RandomScoredMutations(n, 2000, &gen);
+            const auto expected = ScanBestMutations(
+                std::list<ScoredMutation>(scoredMuts.cbegin(), scoredMuts.cend()), separation);
+            const auto selected = BestMutations(scoredMuts, separation);
+
+            ASSERT_EQ(expected.size(), selected.size());
+            for (size_t i = 0; i < expected.size(); ++i) {
+                EXPECT_EQ(expected[i].Start(), selected[i].Start());
+                EXPECT_EQ(expected[i].End(), selected[i].End());
+                EXPECT_EQ(expected[i].Type(), selected[i].Type());
+                EXPECT_EQ(expected[i].Bases(), selected[i].Bases());
+            }
+        }
+    }
+}
@@ -543,6 +543,36 @@ TEST(PoaConsensus, TestSpanningReads)
     delete pc;
 }
 
+TEST(PoaConsensus, TestRepeatedTryAddRead)
+{
+    // alignments against the same graph recycle their columns, in any order
+    const AlignConfig config = DefaultPoaConfig(AlignMode::LOCAL);
+    PoaGraph pg;
+    pg.AddRead("GATTACAGATTACA", config);
+    pg.AddRead("GATTACAGATACA", config);
+
+    const vector<string> reads = {"GATTACAGATTACA", "TGTAATCTGTAATC", "GATTACA",
+                                  "GATTACAGATTACAGATTACA"};
+    vector<float> scores;
+    for (const auto& read : reads) {
+        const PoaAlignmentMatrix* mat = pg.TryAddRead(read, config);
+        scores.push_back(mat->Score());
+        delete mat;
+    }
+
+    for (size_t n = 0; n < 3; ++n) {
+        const PoaAlignmentMatrix* mat1 = pg.TryAddRead(reads[n], config);
+        const PoaAlignmentMatrix* mat2 = pg.TryAddRead(reads[n + 1], config);
+        const PoaAlignmentMatrix* mat3 = pg.TryAddRead(reads[3 - n], config);
+        EXPECT_EQ(scores[n], mat1->Score());
+        EXPECT_EQ(scores[n + 1], mat2->Score());
+        EXPECT_EQ(scores[3 - n], mat3->Score());
+        delete mat2;
+        delete mat1;
+        delete mat3;
+    }
+}
+
 #if 0
 TEST(PoaConsensus, TestMutations)
 {
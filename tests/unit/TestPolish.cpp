@@ -3,17 +3,26 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <string>
 #include <tuple>
+#include <vector>
 
 using std::string;
+using std::vector;
 
 #include <pacbio/consensus/Integrator.h>
 #include <pacbio/consensus/Polish.h>
 #include <pacbio/data/Read.h>
 #include <pacbio/data/Sequence.h>
 
+#include "../src/matrix/BandedMatrix.h"
+#include "RandomDNA.h"
+
 using namespace PacBio::Consensus;  // NOLINT
 using namespace PacBio::Data;       // NOLINT
 
@@ -72,4 +81,182 @@ TEST(PolishTest, DiTriRepeat)
     EXPECT_TRUE(result.hasConverged);
     EXPECT_EQ(read, string(ai));
 }
+
+// Substitute roughly every tenth base of seq
+string Mutated(string seq, std::mt19937* const gen)
+{
+    std::uniform_int_distribution<size_t> pos(0, 9);
+    std::uniform_int_distribution<int> base(0, 3);
+    for (size_t i = 1; i + 1 < seq.length(); ++i)
+        if (pos(*gen) == 0) seq[i] = "ACGT"[base(*gen)];
+    return seq;
+}
+
+TEST(PolishTest, ThreadedScoringIsIdentical)
+{
+    std::mt19937 gen(42);
+    const string truth = RandomDNA(300, &gen);
+    const string draft = Mutated(truth, &gen);
+
+    vector<MappedRead> reads;
+    for (size_t i = 0; i < 8; ++i) {
+        const string seq = Mutated(truth, &gen);
+        if (i % 2 == 0)
+            reads.emplace_back(MkRead(seq, snr, mdl), StrandType::FORWARD, 0, draft.length(), true,
+                               true);
+        else
+            reads.emplace_back(MkRead(ReverseComplement(seq), snr, mdl), StrandType::REVERSE, 0,
+                               draft.length(), true, true);
+    }
+
+    Integrator serial(draft, IntegratorConfig());
+    Integrator threaded(draft, IntegratorConfig());
+    for (const auto& read : reads) {
+        serial.AddRead(read);
+        threaded.AddRead(read);
+    }
+
+    // batched mutation scoring is bit-identical to the single-mutation path
+    const auto muts = Mutations(serial);
+    const auto lls = threaded.LL(muts, 4);
+    ASSERT_EQ(muts.size(), lls.size());
+    for (size_t i = 0; i < muts.size(); ++i)
+        EXPECT_EQ(serial.LL(muts[i]), lls[i]);
+
+    const auto serialResult = Polish(&serial, PolishConfig());
+    const auto threadedResult = Polish(&threaded, PolishConfig(40, 10, 20, false, 4));
+
+    EXPECT_TRUE(serialResult.hasConverged);
+    EXPECT_EQ(serialResult.hasConverged, threadedResult.hasConverged);
+    EXPECT_EQ(serialResult.mutationsTested, threadedResult.mutationsTested);
+    EXPECT_EQ(serialResult.mutationsApplied, threadedResult.mutationsApplied);
+    EXPECT_EQ(string(serial), string(threaded));
+    EXPECT_EQ(serial.LL(), threaded.LL());
+}
+
+TEST(PolishTest, BatchedQVsAreIdentical)
+{
+    std::mt19937 gen(7);
+    const string truth = RandomDNA(400, &gen);
+
+    Integrator ai(truth, IntegratorConfig());
+    for (size_t i = 0; i < 6; ++i) {
+        const string seq = Mutated(truth, &gen);
+        if (i % 2 == 0)
+            ai.AddRead(MappedRead(MkRead(seq, snr, mdl), StrandType::FORWARD, 0, truth.length(),
+                                  true, true));
+        else
+            ai.AddRead(MappedRead(MkRead(ReverseComplement(seq), snr, mdl), StrandType::REVERSE, 0,
+                                  truth.length(), true, true));
+    }
+    // a read covering only part of the template
+    const string part = Mutated(truth.substr(100, 200), &gen);
+    ai.AddRead(MappedRead(MkRead(part, snr, mdl), StrandType::FORWARD, 100, 300, false, false));
+
+    // QVs assume a converged template
+    ASSERT_TRUE(Polish(&ai, PolishConfig()).hasConverged);
+    const size_t len = ai.TemplateLength();
+
+    // the batched path matches scoring one mutation at a time
+    const auto muts = Mutations(ai);
+    const auto lls = ai.LL(muts);
+    ASSERT_EQ(muts.size(), lls.size());
+    for (size_t i = 0; i < muts.size(); ++i)
+        EXPECT_EQ(ai.LL(muts[i]), lls[i]);
+
+    // reference QVs, scoring the candidates of each site one at a time
+    const double LL = ai.LL();
+    vector<double> qualSums(len), delSums(len), insSums(len), subSums(len);
+    for (const auto& m : muts) {
+        const size_t i = m.Start();
+        if (i >= len) continue;
+        const double score = ai.LL(m) - LL;
+        if (score >= 0.0) continue;
+        qualSums[i] += exp(score);
+        (m.IsDeletion() ? delSums : (m.Start() == m.End()) ? insSums : subSums)[i] += exp(score);
+    }
+    const auto toQV = [](const double scoreSum) {
+        const double pr =
+            std::max(1.0 - 1.0 / (1.0 + scoreSum), std::numeric_limits<double>::min());
+        return static_cast<int>(round(-10.0 * log10(pr)));
+    };
+
+    const auto qvs = ConsensusQVs(ai);
+    const auto threadedQVs = ConsensusQVs(ai, 4);
+    const auto quals = ConsensusQualities(ai, 3);
+    ASSERT_EQ(len, qvs.Qualities.size());
+    for (size_t i = 0; i < len; ++i) {
+        EXPECT_EQ(toQV(qualSums[i]), qvs.Qualities[i]);
+        EXPECT_EQ(toQV(delSums[i]), qvs.DeletionQVs[i]);
+        EXPECT_EQ(toQV(insSums[i]), qvs.InsertionQVs[i]);
+        EXPECT_EQ(toQV(subSums[i]), qvs.SubstitutionQVs[i]);
+    }
+    EXPECT_EQ(qvs.Qualities, threadedQVs.Qualities);
+    EXPECT_EQ(qvs.DeletionQVs, threadedQVs.DeletionQVs);
+    EXPECT_EQ(qvs.InsertionQVs, threadedQVs.InsertionQVs);
+    EXPECT_EQ(qvs.SubstitutionQVs, threadedQVs.SubstitutionQVs);
+    EXPECT_EQ(qvs.Qualities, quals);
+}
+
+struct CellPrecisionGuard
+{
+    CellPrecisionGuard() : precision_{GetCellPrecision()} {}
+    ~CellPrecisionGuard() { SetCellPrecision(precision_); }
+    const CellPrecision precision_;
+};
+
+// Polish the same reads with matrices of the given cell precision
+std::tuple<string, QualityValues> PolishWith(const CellPrecision precision, const string& draft,
+                                             const vector<MappedRead>& reads)
+{
+    SetCellPrecision(precision);
+    // no Z-score filter, the reads are far from the draft
+    Integrator ai(draft, IntegratorConfig(std::numeric_limits<double>::quiet_NaN()));
+    for (const auto& read : reads)
+        EXPECT_EQ(State::VALID, ai.AddRead(read));
+    Polish(&ai, PolishConfig());
+    // the matrices kept the requested precision rather than falling back
+    for (size_t i = 0; i < reads.size(); ++i) {
+        EXPECT_EQ(precision, dynamic_cast<const BandedMatrix&>(ai.Alpha(i)).Precision());
+        EXPECT_EQ(precision, dynamic_cast<const BandedMatrix&>(ai.Beta(i)).Precision());
+    }
+    return std::make_tuple(string(ai), ConsensusQVs(ai));
+}
+
+TEST(PolishTest, SinglePrecisionMatchesDouble)
+{
+    const CellPrecisionGuard guard;
+    std::mt19937 gen(11);
+
+    for (const size_t len : {500, 3000}) {
+        const string truth = RandomDNA(len, &gen);
+        const string draft = Mutated(truth, &gen);
+        vector<MappedRead> reads;
+        for (size_t i = 0; i < 8; ++i) {
+            const string seq = Mutated(truth, &gen);
+            if (i % 2 == 0)
+                reads.emplace_back(MkRead(seq, snr, mdl), StrandType::FORWARD, 0, draft.length(),
+                                   true, true);
+            else
+                reads.emplace_back(MkRead(ReverseComplement(seq), snr, mdl), StrandType::REVERSE, 0,
+                                   draft.length(), true, true);
+        }
+
+        string dblCss, fltCss;
+        QualityValues dblQVs, fltQVs;
+        std::tie(dblCss, dblQVs) = PolishWith(CellPrecision::DOUBLE, draft, reads);
+        std::tie(fltCss, fltQVs) = PolishWith(CellPrecision::FLOAT, draft, reads);
+
+        // the same consensus, and QVs within rounding of each other
+        ASSERT_EQ(dblCss, fltCss);
+        ASSERT_EQ(dblQVs.Qualities.size(), fltQVs.Qualities.size());
+        for (size_t i = 0; i < dblQVs.Qualities.size(); ++i) {
+            EXPECT_NEAR(dblQVs.Qualities[i], fltQVs.Qualities[i], 1);
+            EXPECT_NEAR(dblQVs.DeletionQVs[i], fltQVs.DeletionQVs[i], 1);
+            EXPECT_NEAR(dblQVs.InsertionQVs[i], fltQVs.InsertionQVs[i], 1);
+            EXPECT_NEAR(dblQVs.SubstitutionQVs[i], fltQVs.SubstitutionQVs[i], 1);
+        }
+    }
+}
+
 }  // namespace PolishTests
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <pacbio/consensus/AbstractMatrix.h>
+#include <pacbio/consensus/Integrator.h>
+#include <pacbio/consensus/Mutation.h>
+#include <pacbio/data/Read.h>
+
+#include "../src/RecursorKernels.h"
+#include "Mutations.h"
+#include "RandomDNA.h"
+
+using std::string;
+using std::vector;
+
+using namespace PacBio::Consensus;  // NOLINT
+using namespace PacBio::Data;       // NOLINT
+
+namespace RecursorTests {
+
+const double prec = 1e-9;
+const SNR snr(10, 7, 5, 11);
+const IntegratorConfig cfg(std::numeric_limits<double>::quiet_NaN());
+
+// Restores the process-wide fill kernel when leaving scope
+struct FillKernelGuard
+{
+    FillKernelGuard() : kernel_{GetFillKernel()} {}
+    ~FillKernelGuard() { SetFillKernel(kernel_); }
+    const FillKernel kernel_;
+};
+
+// Sets the process-wide cell precision, restoring it when leaving scope
+struct CellPrecisionGuard
+{
+    explicit CellPrecisionGuard(const CellPrecision precision) : precision_{GetCellPrecision()}
+    {
+        SetCellPrecision(precision);
+    }
+    ~CellPrecisionGuard() { SetCellPrecision(precision_); }
+    const CellPrecision precision_;
+};
+
+// Introduce roughly 10% substitution/insertion/deletion errors
+string Noisy(const string& tpl, std::mt19937* const gen)
+{
+    std::uniform_int_distribution<int> event(0, 29);
+    std::uniform_int_distribution<int> base(0, 3);
+    static const char bases[] = "ACGT";
+    string read;
+    for (size_t i = 0; i < tpl.length(); ++i) {
+        // keep the pinned ends intact
+        const int e = (i == 0 || i + 1 == tpl.length()) ? 3 : event(*gen);
+        if (e == 0) continue;                   // deletion
+        if (e == 1) read += bases[base(*gen)];  // insertion
+        read += (e == 2) ? bases[base(*gen)] : tpl[i];
+    }
+    return read;
+}
+
+struct Scores
+{
+    double LL;
+    vector<double> mutationLLs;
+};
+
+Scores ScoreWith(const FillKernel kernel, const string& tpl, const vector<string>& reads,
+                 const vector<vector<uint8_t>>& pws, const vector<Mutation>& muts,
+                 const string& mdl)
+{
+    SetFillKernel(kernel);
+    Integrator ai(tpl, cfg);
+    for (size_t i = 0; i < reads.size(); ++i) {
+        const Read read("N/A", reads[i], vector<uint8_t>(reads[i].length(), 0), pws[i], snr, mdl);
+        EXPECT_EQ(State::VALID,
+                  ai.AddRead(MappedRead(read, StrandType::FORWARD, 0, tpl.length(), true, true)));
+    }
+    Scores scores{ai.LL(), {}};
+    for (const auto& mut : muts)
+        scores.mutationLLs.emplace_back(ai.LL(mut));
+    return scores;
+}
+
+void FillKernelEquivalence(const string& mdl, const CellPrecision precision = CellPrecision::DOUBLE)
+{
+    const FillKernelGuard guard;
+    const CellPrecisionGuard precisionGuard(precision);
+    std::mt19937 gen(42);
+
+    for (const size_t tplLength : {20, 150, 600}) {
+        const string tpl = RandomDNA(tplLength, &gen);
+        vector<string> reads;
+        vector<vector<uint8_t>> pws;
+        for (size_t i = 0; i < 5; ++i) {
+            reads.emplace_back(Noisy(tpl, &gen));
+            pws.emplace_back(RandomPW(reads.back().length(), &gen));
+        }
+        const vector<Mutation> muts = Mutations(tpl, 0, std::min<size_t>(tplLength, 40));
+
+        const Scores scalar = ScoreWith(FillKernel::SCALAR, tpl, reads, pws, muts, mdl);
+        const Scores vectorized = ScoreWith(FillKernel::VECTORIZED, tpl, reads, pws, muts, mdl);
+
+        ASSERT_TRUE(std::isfinite(scalar.LL));
+        EXPECT_NEAR(scalar.LL, vectorized.LL, prec);
+        ASSERT_EQ(scalar.mutationLLs.size(), vectorized.mutationLLs.size());
+        for (size_t i = 0; i < scalar.mutationLLs.size(); ++i)
+            EXPECT_NEAR(scalar.mutationLLs[i], vectorized.mutationLLs[i], prec);
+    }
+}
+
+// The mutation scoring recursions look emissions up in per-read tables,
+// tabulated on the fly for ambiguous contexts; compare them against a
+// cell-by-cell fill over the mutated template
+void AmbiguousMutationEquivalence(const string& mdl)
+{
+    const FillKernelGuard guard;
+    std::mt19937 gen(7);
+
+    const string tpl = RandomDNA(150, &gen);
+    vector<string> reads;
+    vector<vector<uint8_t>> pws;
+    for (size_t i = 0; i < 3; ++i) {
+        reads.emplace_back(Noisy(tpl, &gen));
+        pws.emplace_back(RandomPW(reads.back().length(), &gen));
+    }
+
+    vector<Mutation> muts;
+    for (size_t site = 20; site < 130; site += 11) {
+        muts.emplace_back(Mutation::Substitution(site, "RYSWKM"[site % 6]));
+        muts.emplace_back(Mutation::Insertion(site, "RYSWKM"[(site + 1) % 6]));
+    }
+
+    const Scores extended = ScoreWith(FillKernel::VECTORIZED, tpl, reads, pws, muts, mdl);
+    for (size_t i = 0; i < muts.size(); ++i) {
+        vector<Mutation> mut{muts[i]};
+        const Scores filled =
+            ScoreWith(FillKernel::SCALAR, ApplyMutations(tpl, &mut), reads, pws, {}, mdl);
+        ASSERT_TRUE(std::isfinite(filled.LL));
+        EXPECT_NEAR(0.0, 1.0 - extended.mutationLLs[i] / filled.LL, 1e-4) << muts[i];
+    }
+}
+
+TEST(RecursorTest, FillKernelEquivalenceP6C4) { FillKernelEquivalence("P6-C4"); }
+TEST(RecursorTest, FillKernelEquivalenceSP1C1) { FillKernelEquivalence("S/P1-C1.1"); }
+TEST(RecursorTest, FillKernelEquivalenceSP1C1v2) { FillKernelEquivalence("S/P1-C1.2"); }
+TEST(RecursorTest, FillKernelEquivalenceSP2C2v5) { FillKernelEquivalence("S/P2-C2/5.0"); }
+TEST(RecursorTest, FillKernelEquivalenceFloatCells)
+{
+    FillKernelEquivalence("P6-C4", CellPrecision::FLOAT);
+    FillKernelEquivalence("S/P2-C2/5.0", CellPrecision::FLOAT);
+}
+
+TEST(RecursorTest, AmbiguousMutationEquivalenceP6C4) { AmbiguousMutationEquivalence("P6-C4"); }
+TEST(RecursorTest, AmbiguousMutationEquivalenceSP2C2v5)
+{
+    AmbiguousMutationEquivalence("S/P2-C2/5.0");
+}
+
+TEST(RecursorTest, FillKernelInstructionSet) { EXPECT_FALSE(FillKernelInstructionSet().empty()); }
+
+}  // namespace RecursorTests
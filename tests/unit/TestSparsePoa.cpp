@@ -12,6 +12,7 @@
 #include <pacbio/denovo/PoaConsensus.h>
 #include <pacbio/denovo/SparsePoa.h>
 
+#include "RandomDNA.h"
 #include "TestData.h"
 #include "TestUtility.h"
 
@@ -108,6 +109,10 @@ TEST(SparsePoaTest, TestOrientation)
     EXPECT_FALSE(summaries[0].ReverseComplementedRead);
     EXPECT_TRUE(summaries[1].ReverseComplementedRead);
     EXPECT_FALSE(summaries[2].ReverseComplementedRead);
+
+    // too short for the seeds to tell the strands apart
+    EXPECT_EQ(0, sp.OrientationCounts().BySeeds);
+    EXPECT_EQ(2, sp.OrientationCounts().ByAlignment);
 }
 
 TEST(SparsePoaTest, TestZmw6251)
@@ -260,5 +265,36 @@ TEST(SparsePoaTest, SingleAndHalfNTimes)
         EXPECT_EQ(Interval(0, len / 3), summaries[id2].ExtentOnRead);
         EXPECT_EQ(Interval(len - len / 3, len), summaries[id2].ExtentOnConsensus);
         EXPECT_TRUE(summaries[id2].ReverseComplementedRead);
+
+        // the seeds alone suffice to orient the second read
+        EXPECT_EQ(1, sp.OrientationCounts().BySeeds);
+        EXPECT_EQ(0, sp.OrientationCounts().ByAlignment);
     }
 }
+
+// Reads with too few seed hits on either strand, here 14 bases of a long
+// consensus, are oriented by aligning both strands
+TEST(SparsePoaTest, ShortReadsOrientedByAlignment)
+{
+    std::mt19937 gen(42);
+    const std::string seq = RandomDNA(1000, &gen);
+    const std::string fwd = seq.substr(300, 14);
+    const std::string rev = rc(seq.substr(600, 14));
+
+    SparsePoa sp;
+    sp.OrientAndAddRead(seq);
+    const SparsePoa::ReadKey fwdId = sp.OrientAndAddRead(fwd);
+    const SparsePoa::ReadKey revId = sp.OrientAndAddRead(rev);
+    ASSERT_THAT(fwdId, Ge(0));
+    ASSERT_THAT(revId, Ge(0));
+
+    EXPECT_EQ(0, sp.OrientationCounts().BySeeds);
+    EXPECT_EQ(2, sp.OrientationCounts().ByAlignment);
+
+    vector<PoaAlignmentSummary> summaries;
+    EXPECT_EQ(seq, sp.FindConsensus(1, &summaries)->Sequence);
+    EXPECT_FALSE(summaries[fwdId].ReverseComplementedRead);
+    EXPECT_EQ(Interval(300, 314), summaries[fwdId].ExtentOnConsensus);
+    EXPECT_TRUE(summaries[revId].ReverseComplementedRead);
+    EXPECT_EQ(Interval(600, 614), summaries[revId].ExtentOnConsensus);
+}
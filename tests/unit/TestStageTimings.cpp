@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <time.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <pacbio/ccs/StageTimings.h>
+#include <pacbio/parallel/ForkJoinPool.h>
+
+#include "../src/matrix/BufferPool.h"
+
+using namespace PacBio::CCS;  // NOLINT
+
+namespace StageTimingsTests {
+
+TEST(StageTimingsTest, ScopedTimer)
+{
+    StageTimings timings;
+    {
+        ScopedStageTimer timer(Stage::POLISH, &timings);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(5, Timed(Stage::POLISH, &timings, []() { return 5; }));
+
+    EXPECT_EQ(2, timings[Stage::POLISH].Calls);
+    EXPECT_GE(timings[Stage::POLISH].WallMilliseconds, 5.0);
+    // sleeping takes no CPU time
+    EXPECT_LT(timings[Stage::POLISH].CpuMilliseconds, timings[Stage::POLISH].WallMilliseconds);
+    EXPECT_EQ(0, timings[Stage::POA].Calls);
+}
+
+TEST(StageTimingsTest, CountsHelperThreads)
+{
+    // a fresh thread, with a pool of helpers of its own
+    std::thread([]() {
+        using PacBio::Consensus::BufferPool;
+        using PacBio::Parallel::ForkJoinPool;
+
+        StageTimings timings;
+        const int64_t allocations = ThreadBufferAllocations();
+        const std::thread::id caller = std::this_thread::get_id();
+        {
+            ScopedStageTimer timer(Stage::POLISH, &timings);
+            ForkJoinPool::ThreadLocal().Run(3, [caller]() {
+                if (std::this_thread::get_id() == caller) return;
+
+                // each helper allocates one buffer and spins for 20 ms of CPU
+                std::vector<double> buffer = BufferPool::Take(1000);
+                BufferPool::Reserve(&buffer, 1000);
+                BufferPool::Give(std::move(buffer));
+
+                timespec start, now;
+                clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+                do
+                    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+                while ((now.tv_sec - start.tv_sec) * 1000000000 + now.tv_nsec - start.tv_nsec <
+                       20000000);
+            });
+        }
+        EXPECT_EQ(allocations + 2, ThreadBufferAllocations());
+        EXPECT_GE(timings[Stage::POLISH].CpuMilliseconds, 40.0);
+    }).join();
+}
+
+TEST(StageTimingsTest, MergeByThread)
+{
+    const size_t index = ThreadIndex();
+    EXPECT_EQ(index, ThreadIndex());
+    size_t otherIndex;
+    std::thread([&otherIndex]() { otherIndex = ThreadIndex(); }).join();
+    EXPECT_NE(index, otherIndex);
+
+    ThreadTimings timings;
+    timings[0].Zmws = 2;
+    timings[0][Stage::QVS].Calls = 1;
+    ThreadTimings other;
+    other[0].Zmws = 3;
+    other[0].MatrixCells = 100;
+    other[1].FlipFlops = 7;
+    timings += other;
+
+    ASSERT_EQ(2, timings.size());
+    EXPECT_EQ(5, timings[0].Zmws);
+    EXPECT_EQ(100, timings[0].MatrixCells);
+    EXPECT_EQ(1, timings[0][Stage::QVS].Calls);
+    EXPECT_EQ(7, timings[1].FlipFlops);
+}
+
+TEST(StageTimingsTest, WriteJson)
+{
+    ThreadTimings timings;
+    timings[0].Zmws = 2;
+    timings[0][Stage::POA].Calls = 2;
+    timings[0][Stage::POA].WallMilliseconds = 1.5;
+    timings[3].Zmws = 1;
+    timings[3].BufferAllocations = 4;
+    timings[3].PoaOrientedByAlignment = 2;
+
+    std::stringstream json;
+    WriteStageTimings(json, timings);
+
+    boost::property_tree::ptree pt;
+    ASSERT_NO_THROW(boost::property_tree::read_json(json, pt));
+    EXPECT_EQ(2, pt.get_child("threads").size());
+    EXPECT_EQ(3, pt.get<int>("total.zmws"));
+    EXPECT_EQ(4, pt.get<int>("total.buffer_allocations"));
+    EXPECT_EQ(2, pt.get<int>("total.poa_oriented_by_alignment"));
+    EXPECT_EQ(2, pt.get<int>("total.stages.poa.calls"));
+    EXPECT_DOUBLE_EQ(1.5, pt.get<double>("total.stages.poa.wall_ms"));
+    EXPECT_EQ(0, pt.get<int>("total.stages.write.calls"));
+}
+
+}  // namespace StageTimingsTests
@@ -318,6 +318,102 @@ TEST(TemplateTest, TestPinning)
     }
 }
 
+TEST(TemplateTest, SharedTemplateViews)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> randType(0, 2);
+    std::uniform_int_distribution<int> randBase(0, 3);
+    const string bases = "ACGT";
+
+    string tpl = RandomDNA(80, &gen);
+    const std::shared_ptr<const ModelConfig> cfg = ModelFactory::Create(mdl, snr);
+    const auto store = std::make_shared<TemplateStore>(tpl, cfg);
+
+    // windows of reads spanning the template, either end, or neither
+    const vector<tuple<size_t, size_t, bool, bool>> windows = {
+        make_tuple(0, 80, true, true), make_tuple(0, 50, true, false),
+        make_tuple(30, 80, false, true), make_tuple(20, 60, false, false),
+        make_tuple(41, 43, false, false)};
+    vector<Template> templates;
+    vector<TemplateView> views;
+    for (const auto& w : windows) {
+        size_t start, end;
+        bool pinStart, pinEnd;
+        tie(start, end, pinStart, pinEnd) = w;
+        templates.emplace_back(tpl.substr(start, end - start), cfg, start, end, pinStart, pinEnd);
+        views.emplace_back(store, start, end, pinStart, pinEnd);
+    }
+
+    for (size_t round = 0; round < 40; ++round) {
+        // a few single base mutations at distinct sites
+        vector<Mutation> muts;
+        for (size_t pos = randBase(gen); pos < tpl.size(); pos += 7 + randBase(gen)) {
+            const char base = bases[randBase(gen)];
+            switch (randType(gen)) {
+                case 0:
+                    muts.emplace_back(Mutation::Insertion(pos, base));
+                    break;
+                case 1:
+                    muts.emplace_back(Mutation::Deletion(pos, 1));
+                    break;
+                default:
+                    muts.emplace_back(Mutation::Substitution(pos, base));
+            }
+            if (round % 2 == 1) break;
+        }
+
+        tpl = ApplyMutations(tpl, &muts);
+        if (muts.size() == 1)
+            store->ApplyMutation(muts.front());
+        else
+            store->ApplyMutations(&muts);
+        ASSERT_EQ(tpl.size(), store->Length());
+
+        for (size_t i = 0; i < views.size(); ++i) {
+            bool tplThrew = false, viewThrew = false;
+            bool tplApplied = false, viewApplied = false;
+            try {
+                tplApplied = (muts.size() == 1) ? templates[i].ApplyMutation(muts.front())
+                                                : templates[i].ApplyMutations(&muts);
+            } catch (const TemplateTooSmall&) {
+                tplThrew = true;
+            }
+            try {
+                viewApplied = (muts.size() == 1) ? views[i].ApplyMutation(muts.front())
+                                                 : views[i].ApplyMutations(&muts);
+            } catch (const TemplateTooSmall&) {
+                viewThrew = true;
+            }
+            ASSERT_EQ(tplThrew, viewThrew);
+            if (tplThrew) continue;
+
+            EXPECT_EQ(tplApplied, viewApplied);
+            EXPECT_EQ(templates[i].Start(), views[i].Start());
+            EXPECT_EQ(ToString(templates[i]), ToString(views[i]));
+            EXPECT_EQ(templates[i], views[i]);
+        }
+    }
+}
+
+TEST(TemplateTest, StaleTemplateViewThrows)
+{
+    const auto store =
+        std::make_shared<TemplateStore>("ACGTACGTACGT", ModelFactory::Create(mdl, snr));
+    TemplateView view(store, 2, 10, false, false);
+    TemplateView stale(store, 2, 10, false, false);
+
+    store->ApplyMutation(Mutation::Substitution(5, 'A'));
+    EXPECT_TRUE(view.ApplyMutation(Mutation::Substitution(5, 'A')));
+    EXPECT_NO_THROW(stale[0]);
+
+    // stale missed the first mutation, its window points at freed positions
+    store->ApplyMutation(Mutation::Insertion(7, 'C'));
+    EXPECT_TRUE(view.ApplyMutation(Mutation::Insertion(7, 'C')));
+    EXPECT_EQ('T', view[1].Base);
+    EXPECT_THROW(stale[0], std::runtime_error);
+    EXPECT_THROW(stale.ApplyMutation(Mutation::Insertion(7, 'C')), std::runtime_error);
+}
+
 TEST(TemplateTest, NullTemplate)
 {
     const string tpl = "ACGT";
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <pacbio/parallel/WorkStealingQueue.h>
+
+using namespace PacBio::Parallel;  // NOLINT
+
+namespace WorkStealingQueueTests {
+
+size_t Identity(const size_t i)
+{
+    // make later tasks finish first now and then to exercise the sequencer
+    if (i % 7 == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+    return i;
+}
+
+TEST(WorkStealingQueueTest, ResultsInProductionOrder)
+{
+    const size_t nTasks = 5000;
+    std::vector<size_t> results;
+    {
+        WorkStealingQueue<size_t> queue(4, 8);
+        std::future<void> consumer = std::async(std::launch::async, [&queue, &results]() {
+            while (queue.ConsumeWith([&results](size_t i) { results.emplace_back(i); }))
+                ;
+        });
+        for (size_t i = 0; i < nTasks; ++i)
+            queue.ProduceWith(Identity, i);
+        queue.Finalize();
+        consumer.get();
+    }
+
+    ASSERT_EQ(nTasks, results.size());
+    for (size_t i = 0; i < nTasks; ++i)
+        EXPECT_EQ(i, results[i]);
+}
+
+// A slow task holds back only the consumer: the producer keeps producing and
+// the other workers keep working while its result is awaited
+TEST(WorkStealingQueueTest, SlowTaskDoesNotStallProducer)
+{
+    const size_t nTasks = 200;
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    std::atomic<size_t> nDone{0};
+    const auto task = [&opened, &nDone](const size_t i) {
+        if (i == 0) opened.wait();
+        ++nDone;
+        return i;
+    };
+
+    std::vector<size_t> results;
+    {
+        WorkStealingQueue<size_t> queue(2, 2);
+        std::future<void> consumer = std::async(std::launch::async, [&queue, &results]() {
+            while (queue.ConsumeWith([&results](size_t i) { results.emplace_back(i); }))
+                ;
+        });
+        std::future<void> producer = std::async(std::launch::async, [&queue, &task]() {
+            for (size_t i = 0; i < nTasks; ++i)
+                queue.ProduceWith(task, i);
+        });
+
+        const auto status = producer.wait_for(std::chrono::seconds(10));
+        for (size_t i = 0; i < 1000 && nDone.load() < nTasks - 1; ++i)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const size_t doneBeforeGate = nDone.load();
+        EXPECT_TRUE(results.empty());
+
+        gate.set_value();
+        producer.get();
+        queue.Finalize();
+        consumer.get();
+
+        EXPECT_EQ(std::future_status::ready, status);
+        EXPECT_EQ(nTasks - 1, doneBeforeGate);
+    }
+
+    ASSERT_EQ(nTasks, results.size());
+    for (size_t i = 0; i < nTasks; ++i)
+        EXPECT_EQ(i, results[i]);
+}
+
+// Given maxResults, the producer waits for the consumer once that many
+// results are not yet consumed, finished or not
+TEST(WorkStealingQueueTest, BoundedResults)
+{
+    const size_t nTasks = 100;
+    const size_t maxResults = 5;
+    std::atomic<size_t> nProduced{0};
+
+    std::vector<size_t> results;
+    {
+        WorkStealingQueue<size_t> queue(2, 0, maxResults);
+        std::future<void> producer = std::async(std::launch::async, [&queue, &nProduced]() {
+            for (size_t i = 0; i < nTasks; ++i) {
+                queue.ProduceWith(Identity, i);
+                ++nProduced;
+            }
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(maxResults, nProduced.load());
+
+        std::future<void> consumer = std::async(std::launch::async, [&queue, &results]() {
+            while (queue.ConsumeWith([&results](size_t i) { results.emplace_back(i); }))
+                ;
+        });
+        producer.get();
+        queue.Finalize();
+        consumer.get();
+    }
+
+    ASSERT_EQ(nTasks, results.size());
+    for (size_t i = 0; i < nTasks; ++i)
+        EXPECT_EQ(i, results[i]);
+}
+
+TEST(WorkStealingQueueTest, MoveOnlyArguments)
+{
+    const auto deref = [](std::unique_ptr<size_t>& p) { return *p; };
+    size_t sum = 0;
+    {
+        WorkStealingQueue<size_t> queue(2);
+        std::future<void> consumer = std::async(std::launch::async, [&queue, &sum]() {
+            while (queue.ConsumeWith([&sum](size_t i) { sum += i; }))
+                ;
+        });
+        for (size_t i = 0; i < 100; ++i)
+            queue.ProduceWith(deref, std::make_unique<size_t>(i));
+        queue.Finalize();
+        consumer.get();
+    }
+    EXPECT_EQ(4950, sum);
+}
+
+TEST(WorkStealingQueueTest, EmptyQueue)
+{
+    WorkStealingQueue<int> queue(2);
+    queue.Finalize();
+    EXPECT_FALSE(queue.ConsumeWith([](int) {}));
+}
+
+TEST(WorkStealingQueueTest, TaskExceptionReachesProducer)
+{
+    const auto thrower = [](const size_t i) -> size_t {
+        if (i == 3) throw std::runtime_error("task failed");
+        return i;
+    };
+
+    WorkStealingQueue<size_t>* queue = new WorkStealingQueue<size_t>(2, 2);
+    std::future<size_t> consumer = std::async(std::launch::async, [queue]() {
+        size_t n = 0;
+        while (queue->ConsumeWith([&n](size_t) { ++n; }))
+            ;
+        return n;
+    });
+
+    bool thrown = false;
+    try {
+        for (size_t i = 0; i < 1000; ++i)
+            queue->ProduceWith(thrower, i);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    queue->Finalize();
+
+    EXPECT_TRUE(thrown);
+    EXPECT_EQ(3, consumer.get());
+    // the destructor rethrows the failure like WorkQueue's does
+    EXPECT_THROW(delete queue, std::runtime_error);
+}
+
+}  // namespace WorkStealingQueueTests